@@ -751,6 +751,7 @@ void idAASFileLocal::Clear()
 	portals.Clear();
 	portalIndex.Clear();
 	clusters.Clear();
+	routingTables.Clear();
 }
 
 /*
@@ -893,6 +894,15 @@ bool idAASFileLocal::Write( const idStr& fileName, unsigned int mapFileCRC )
 	}
 	aasFile->WriteFloatString( "}\n" );
 	
+	// write out the optional precomputed routing tables
+	for( i = 0; i < routingTables.Num(); i++ )
+	{
+		aasFile->WriteFloatString( "routingTable %d {\n", routingTables[i].travelFlags );
+		WriteRoutingCache( aasFile, "areaCache", routingTables[i].areaTravelTimes, routingTables[i].areaReachabilities );
+		WriteRoutingCache( aasFile, "portalCache", routingTables[i].portalTravelTimes, routingTables[i].portalReachabilities );
+		aasFile->WriteFloatString( "}\n" );
+	}
+	
 	// close file
 	fileSystem->CloseFile( aasFile );
 	
@@ -1271,6 +1281,153 @@ bool idAASFileLocal::ParseClusters( idLexer& src )
 	return true;
 }
 
+/*
+================
+idAASFileLocal::NumAreaRoutingEntries
+
+  number of entries in the area cache of a routing table
+================
+*/
+int idAASFileLocal::NumAreaRoutingEntries() const
+{
+	int i, num;
+	
+	num = 0;
+	for( i = 0; i < clusters.Num(); i++ )
+	{
+		num += clusters[i].numReachableAreas * clusters[i].numReachableAreas;
+	}
+	return num;
+}
+
+/*
+================
+idAASFileLocal::WriteRoutingCache
+
+  Unreachable entries have a zero travel time and are run length encoded
+  as a negative count, every other entry is written as a travel time and
+  reachability number pair.
+================
+*/
+void idAASFileLocal::WriteRoutingCache( idFile* fp, const char* name, const idList<unsigned short, TAG_AAS>& travelTimes, const idList<byte, TAG_AAS>& reachabilities ) const
+{
+	int i, numZero, numTokens;
+	
+	fp->WriteFloatString( "\t%s %d {\n\t\t", name, travelTimes.Num() );
+	numZero = numTokens = 0;
+	for( i = 0; i <= travelTimes.Num(); i++ )
+	{
+		if( i < travelTimes.Num() && travelTimes[i] == 0 )
+		{
+			numZero++;
+			continue;
+		}
+		if( numZero )
+		{
+			fp->WriteFloatString( "%d ", -numZero );
+			numZero = 0;
+			numTokens++;
+		}
+		if( i < travelTimes.Num() )
+		{
+			fp->WriteFloatString( "%d %d ", travelTimes[i], reachabilities[i] );
+			numTokens += 2;
+		}
+		if( numTokens >= 32 )
+		{
+			fp->WriteFloatString( "\n\t\t" );
+			numTokens = 0;
+		}
+	}
+	fp->WriteFloatString( "\n\t}\n" );
+}
+
+/*
+================
+idAASFileLocal::ParseRoutingCache
+================
+*/
+bool idAASFileLocal::ParseRoutingCache( idLexer& src, idList<unsigned short, TAG_AAS>& travelTimes, idList<byte, TAG_AAS>& reachabilities, int numEntries )
+{
+	int i, n, num;
+	
+	num = src.ParseInt();
+	if( num != numEntries )
+	{
+		src.Warning( "routing cache has %d entries instead of %d", num, numEntries );
+		return false;
+	}
+	if( !src.ExpectTokenString( "{" ) )
+	{
+		return false;
+	}
+	travelTimes.SetNum( num );
+	reachabilities.SetNum( num );
+	for( i = 0; i < num; )
+	{
+		n = src.ParseInt();
+		if( n < 0 )
+		{
+			if( i - n > num )
+			{
+				src.Warning( "routing cache run past the end" );
+				return false;
+			}
+			memset( travelTimes.Ptr() + i, 0, -n * sizeof( travelTimes[0] ) );
+			memset( reachabilities.Ptr() + i, 0, -n * sizeof( reachabilities[0] ) );
+			i -= n;
+		}
+		else
+		{
+			travelTimes[i] = n;
+			reachabilities[i] = src.ParseInt();
+			i++;
+		}
+	}
+	if( !src.ExpectTokenString( "}" ) )
+	{
+		return false;
+	}
+	return true;
+}
+
+/*
+================
+idAASFileLocal::ParseRoutingTable
+================
+*/
+bool idAASFileLocal::ParseRoutingTable( idLexer& src )
+{
+	aasRoutingTable_t& table = routingTables.Alloc();
+	
+	table.travelFlags = src.ParseInt();
+	if( !src.ExpectTokenString( "{" ) )
+	{
+		return false;
+	}
+	if( !src.ExpectTokenString( "areaCache" ) )
+	{
+		return false;
+	}
+	if( !ParseRoutingCache( src, table.areaTravelTimes, table.areaReachabilities, NumAreaRoutingEntries() ) )
+	{
+		return false;
+	}
+	if( !src.ExpectTokenString( "portalCache" ) )
+	{
+		return false;
+	}
+	if( !ParseRoutingCache( src, table.portalTravelTimes, table.portalReachabilities, areas.Num() * portals.Num() ) )
+	{
+		return false;
+	}
+	if( !src.ExpectTokenString( "}" ) )
+	{
+		return false;
+	}
+	return true;
+}
+
 /*
 ================
 idAASFileLocal::FinishAreas
@@ -1430,6 +1587,13 @@ bool idAASFileLocal::Load( const idStr& fileName, unsigned int mapFileCRC )
 				return false;
 			}
 		}
+		else if( token == "routingTable" )
+		{
+			if( !ParseRoutingTable( src ) )
+			{
+				return false;
+			}
+		}
 		else
 		{
 			src.Error( "idAASFileLocal::Load: bad token \"%s\"", token.c_str() );
@@ -1472,6 +1636,11 @@ int idAASFileLocal::MemorySize() const
 	size += portals.Size();
 	size += portalIndex.Size();
 	size += clusters.Size();
+	for( int i = 0; i < routingTables.Num(); i++ )
+	{
+		size += routingTables[i].areaTravelTimes.Size() + routingTables[i].areaReachabilities.Size();
+		size += routingTables[i].portalTravelTimes.Size() + routingTables[i].portalReachabilities.Size();
+	}
 	size += sizeof( idReachability_Walk ) * NumReachabilities();
 	
 	return size;
@@ -1487,6 +1656,11 @@ void idAASFileLocal::PrintInfo() const
 	common->Printf( "%6d KB file size\n", MemorySize() >> 10 );
 	common->Printf( "%6d areas\n", areas.Num() );
 	common->Printf( "%6d max tree depth\n", MaxTreeDepth() );
+	for( int i = 0; i < routingTables.Num(); i++ )
+	{
+		common->Printf( "%6d KB precomputed routing for travel flags 0x%x\n", ( routingTables[i].areaTravelTimes.Size() + routingTables[i].areaReachabilities.Size() +
+						routingTables[i].portalTravelTimes.Size() + routingTables[i].portalReachabilities.Size() ) >> 10, routingTables[i].travelFlags );
+	}
 	ReportRoutingEfficiency();
 }
 
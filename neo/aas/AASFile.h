@@ -202,6 +202,18 @@ typedef struct aasCluster_s
 	int							firstPortal;		// first cluster portal in the index
 } aasCluster_t;
 
+// precomputed routing for one combination of travel flags
+// the area cache of every cluster stores numReachableAreas * numReachableAreas entries, one row per goal area
+// the portal cache stores numPortals entries for every goal area
+typedef struct aasRoutingTable_s
+{
+	int							travelFlags;		// travel flags the tables were calculated with
+	idList<unsigned short, TAG_AAS>	areaTravelTimes;	// travel times within the clusters
+	idList<byte, TAG_AAS>		areaReachabilities;	// reachabilities used within the clusters
+	idList<unsigned short, TAG_AAS>	portalTravelTimes;	// travel times from the portals to the goal areas
+	idList<byte, TAG_AAS>		portalReachabilities;	// reachabilities used from the portals
+} aasRoutingTable_t;
+
 // trace through the world
 typedef struct aasTrace_s
 {
@@ -422,6 +434,23 @@ public:
 		areas[index].travelFlags &= ~flag;
 	}
 	
+	int							GetNumRoutingTables() const
+	{
+		return routingTables.Num();
+	}
+	const aasRoutingTable_t& 	GetRoutingTable( int index ) const
+	{
+		return routingTables[index];
+	}
+	void						AddRoutingTable( const aasRoutingTable_t& table )
+	{
+		routingTables.Append( table );
+	}
+	void						ClearRoutingTables()
+	{
+		routingTables.Clear();
+	}
+	
 	virtual idVec3				EdgeCenter( int edgeNum ) const = 0;
 	virtual idVec3				FaceCenter( int faceNum ) const = 0;
 	virtual idVec3				AreaCenter( int areaNum ) const = 0;
@@ -436,6 +465,7 @@ public:
 	virtual void				PushPointIntoAreaNum( int areaNum, idVec3& point ) const = 0;
 	virtual bool				Trace( aasTrace_t& trace, const idVec3& start, const idVec3& end ) const = 0;
 	virtual void				PrintInfo() const = 0;
+	virtual bool				Write( const idStr& fileName, unsigned int mapFileCRC ) = 0;
 	
 protected:
 	idStr						name;
@@ -452,6 +482,7 @@ protected:
 	idList<aasPortal_t, TAG_AAS>			portals;
 	idList<aasIndex_t, TAG_AAS>			portalIndex;
 	idList<aasCluster_t, TAG_AAS>		clusters;
+	idList<aasRoutingTable_t, TAG_AAS>	routingTables;
 	idAASSettings				settings;
 };
 
@@ -64,7 +64,7 @@ public:
 	
 public:
 	bool						Load( const idStr& fileName, unsigned int mapFileCRC );
-	bool						Write( const idStr& fileName, unsigned int mapFileCRC );
+	virtual bool				Write( const idStr& fileName, unsigned int mapFileCRC );
 	
 	int							MemorySize() const;
 	void						ReportRoutingEfficiency() const;
@@ -87,6 +87,10 @@ private:
 	bool						ParseNodes( idLexer& src );
 	bool						ParsePortals( idLexer& src );
 	bool						ParseClusters( idLexer& src );
+	bool						ParseRoutingTable( idLexer& src );
+	bool						ParseRoutingCache( idLexer& src, idList<unsigned short, TAG_AAS>& travelTimes, idList<byte, TAG_AAS>& reachabilities, int numEntries );
+	void						WriteRoutingCache( idFile* fp, const char* name, const idList<unsigned short, TAG_AAS>& travelTimes, const idList<byte, TAG_AAS>& reachabilities ) const;
+	int							NumAreaRoutingEntries() const;
 	
 private:
 	int							BoundsReachableAreaNum_r( int nodeNum, const idBounds& bounds, const int areaFlags, const int excludeTravelFlags ) const;
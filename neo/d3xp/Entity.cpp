@@ -1704,6 +1704,14 @@ bool idEntity::UpdateRenderEntity( renderEntity_s* renderEntity, const renderVie
 		{
 			currentTime = gameLocal.GetTimeGroupTime( renderEntity->timeGroup );
 		}
+		
+		// keep showing the last frame of distant or hidden entities, entities that weren't
+		// drawn in the previous frame get a new frame since their last one may be stale
+		if( animator->LODSkipsFrame() && ( gameRenderWorld->GetEntityLastVisibleFrame( modelDefHandle ) >= renderSystem->GetFrameCount() - 1 ) )
+		{
+			return false;
+		}
+		
 		return animator->CreateFrame( currentTime, false );
 	}
 	
@@ -2971,6 +2979,8 @@ bool idEntity::RunPhysics()
 		return false;
 	}
 	
+	idScopedThinkProfile profile( THINKPROF_PHYSICS, this );
+	
 	const int startTime = gameLocal.previousTime;
 	const int endTime = gameLocal.time;
 	
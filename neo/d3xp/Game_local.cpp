@@ -332,6 +332,8 @@ void idGameLocal::Init()
 	idEvent::Init();
 	idClass::Init();
 	
+	animStage.Init();
+	
 	InitConsoleCommands();
 	
 	shellHandler = new( TAG_SWF ) idMenuHandler_Shell();
@@ -434,6 +436,7 @@ void idGameLocal::Shutdown()
 	Clear();
 	
 	// shut down the animation manager
+	animStage.Shutdown();
 	animationLib.Shutdown();
 	
 	Printf( "--------------------------------------\n" );
@@ -979,6 +982,7 @@ void idGameLocal::LoadMap( const char* mapName, int randseed )
 	spawnedEntities.Clear();
 	activeEntities.Clear();
 	aimAssistEntities.Clear();
+	physicsIslands.Clear();
 	numEntitiesToDeactivate = 0;
 	sortTeamMasters = false;
 	sortPushers = false;
@@ -1643,6 +1647,7 @@ void idGameLocal::MapShutdown()
 	
 	clip.Shutdown();
 	idClipModel::ClearTraceModelCache();
+	animPoseCache.Shutdown();
 	
 	common->UpdateLevelLoadPacifier();
 	
@@ -2478,6 +2483,9 @@ idGameLocal::RunEntityThink
 */
 void idGameLocal::RunEntityThink( idEntity& ent, idUserCmdMgr& userCmdMgr )
 {
+	idScopedThinkProfile profile( THINKPROF_THINK, &ent );
+	idEntity* oldProfileEntity = thinkProfiler.SetCurrentEntity( &ent );
+	
 	if( ent.entityNumber < MAX_PLAYERS )
 	{
 		// Players may run more than one think per frame in MP,
@@ -2490,6 +2498,8 @@ void idGameLocal::RunEntityThink( idEntity& ent, idUserCmdMgr& userCmdMgr )
 		// Non-player entities always run one think.
 		ent.Think();
 	}
+	
+	thinkProfiler.SetCurrentEntity( oldProfileEntity );
 }
 
 idCVar g_recordTrace( "g_recordTrace", "0", CVAR_BOOL, "" );
@@ -2504,7 +2514,7 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 	idEntity* 	ent;
 	int			num;
 	float		ms;
-	idTimer		timer_think, timer_events, timer_singlethink;
+	idTimer		timer_think, timer_events, timer_anim, timer_singlethink;
 	
 	idPlayer*	player;
 	const renderView_t* view;
@@ -2611,6 +2621,11 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 		timer_think.Clear();
 		timer_think.Start();
 		
+		thinkProfiler.BeginFrame();
+		scriptProfiler.BeginFrame();
+		physicsIslands.BeginFrame();
+		animPoseCache.BeginFrame();
+		
 		// let entities think
 		if( g_timeentities.GetFloat() )
 		{
@@ -2667,6 +2682,9 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 		
 		RunTimeGroup2( cmdMgr );
 		
+		// put touching bodies to rest together
+		physicsIslands.EndFrame();
+		
 		// Run catch-up for any client projectiles.
 		// This is done after the main think so that all projectiles will be up-to-date
 		// when snapshots are created.
@@ -2709,6 +2727,14 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 		
 		timer_events.Stop();
 		
+		// create the frames of the animators in view
+		timer_anim.Clear();
+		timer_anim.Start();
+		animStage.Run();
+		timer_anim.Stop();
+		
+		thinkProfiler.EndFrame();
+		
 		// free the player pvs
 		FreePlayerPVS();
 		
@@ -2721,9 +2747,9 @@ void idGameLocal::RunFrame( idUserCmdMgr& cmdMgr, gameReturn_t& ret )
 		// display how long it took to calculate the current game frame
 		if( g_frametime.GetBool() )
 		{
-			Printf( "game %d: all:%.1f th:%.1f ev:%.1f %d ents \n",
-					time, timer_think.Milliseconds() + timer_events.Milliseconds(),
-					timer_think.Milliseconds(), timer_events.Milliseconds(), num );
+			Printf( "game %d: all:%.1f th:%.1f ev:%.1f an:%.1f %d ents \n",
+					time, timer_think.Milliseconds() + timer_events.Milliseconds() + timer_anim.Milliseconds(),
+					timer_think.Milliseconds(), timer_events.Milliseconds(), timer_anim.Milliseconds(), num );
 		}
 		
 		BuildReturnValue( ret );
@@ -94,8 +94,10 @@ void gameError( const char* fmt, ... );
 
 #include "physics/Clip.h"
 #include "physics/Push.h"
+#include "physics/Physics_Islands.h"
 
 #include "Pvs.h"
+#include "ThinkProfiler.h"
 #include "Leaderboards.h"
 #include "MultiplayerGame.h"
 
@@ -317,6 +319,9 @@ public:
 	
 	idClip					clip;					// collision detection
 	idPush					push;					// geometric pushing
+	idPhysicsIslands		physicsIslands;			// rigid bodies and articulated figures that sleep together
+	idAnimPoseCache			animPoseCache;			// blended poses shared by animators in sync
+	idAnimStage				animStage;				// creates the frames of the animators in view on job threads
 	idPVS					pvs;					// potential visible set
 	
 	idTestModel* 			testmodel;				// for development testing of models
@@ -912,5 +917,6 @@ const int	CINEMATIC_SKIP_DELAY	= SEC2MS( 2.0f );
 #include "script/Script_Compiler.h"
 #include "script/Script_Interpreter.h"
 #include "script/Script_Thread.h"
+#include "script/Script_Profiler.h"
 
 #endif	/* !__GAME_LOCAL_H__ */
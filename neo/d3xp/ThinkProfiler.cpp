@@ -0,0 +1,414 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "Game_local.h"
+
+idCVar g_profileThink( "g_profileThink", "0", CVAR_GAME | CVAR_BOOL, "records per entity think, physics, animation and script time, see profileThinkTop and profileThinkTrace" );
+
+idThinkProfiler thinkProfiler;
+
+static const char* thinkProfileCategoryNames[THINKPROF_NUM_CATEGORIES] =
+{
+	"think",
+	"physics",
+	"anim",
+	"script"
+};
+
+static const char* thinkProfileGroupNames[THINKPROF_NUM_GROUPS] =
+{
+	"entity",
+	"class",
+	"def"
+};
+
+static const int THINKPROF_NO_ENTITY = ENTITYNUM_NONE;	// script and events run outside of any entity think
+
+/*
+================
+idThinkProfiler::idThinkProfiler
+================
+*/
+idThinkProfiler::idThinkProfiler()
+{
+	enabled = false;
+	frameNum = 0;
+	numFrames = 0;
+	currentEntity = NULL;
+	traceFramesLeft = 0;
+	traceStartTime = 0;
+}
+
+/*
+================
+idThinkProfiler::GetCategoryName
+================
+*/
+const char* idThinkProfiler::GetCategoryName( thinkProfileCategory_t category )
+{
+	return thinkProfileCategoryNames[category];
+}
+
+/*
+================
+idThinkProfiler::BeginFrame
+================
+*/
+void idThinkProfiler::BeginFrame()
+{
+	enabled = g_profileThink.GetBool() || traceFramesLeft > 0;
+	if( !enabled )
+	{
+		return;
+	}
+	
+	if( frameTimes.Num() != MAX_GENTITIES )
+	{
+		frameTimes.SetNum( MAX_GENTITIES );
+		memset( frameTimes.Ptr(), 0, frameTimes.Allocated() );
+	}
+	
+	frameNum++;
+	frameEntities.SetNum( 0 );
+	currentEntity = NULL;
+}
+
+/*
+================
+idThinkProfiler::EndFrame
+================
+*/
+void idThinkProfiler::EndFrame()
+{
+	if( !enabled )
+	{
+		return;
+	}
+	
+	for( int i = 0; i < frameEntities.Num(); i++ )
+	{
+		const int entityNum = frameEntities[i];
+		const entityFrameTimes_t& times = frameTimes[entityNum];
+		const idEntity* ent = ( entityNum != THINKPROF_NO_ENTITY ) ? gameLocal.entities[entityNum] : NULL;
+		
+		const char* names[THINKPROF_NUM_GROUPS];
+		if( ent != NULL )
+		{
+			names[THINKPROF_GROUP_ENTITY] = ent->GetName();
+			names[THINKPROF_GROUP_CLASS] = ent->GetClassname();
+			names[THINKPROF_GROUP_DEF] = ent->GetEntityDefName();
+		}
+		else
+		{
+			const char* name = ( entityNum == THINKPROF_NO_ENTITY ) ? "<events>" : "<removed>";
+			names[THINKPROF_GROUP_ENTITY] = name;
+			names[THINKPROF_GROUP_CLASS] = name;
+			names[THINKPROF_GROUP_DEF] = name;
+		}
+		
+		for( int group = 0; group < THINKPROF_NUM_GROUPS; group++ )
+		{
+			thinkProfileStats_t& s = FindStats( ( thinkProfileGroup_t )group, names[group] );
+			s.count++;
+			for( int c = 0; c < THINKPROF_NUM_CATEGORIES; c++ )
+			{
+				s.time[c] += times.time[c];
+				s.maxTime[c] = Max( s.maxTime[c], times.time[c] );
+			}
+		}
+	}
+	numFrames++;
+	currentEntity = NULL;
+	
+	if( traceFramesLeft > 0 )
+	{
+		traceFramesLeft--;
+		if( traceFramesLeft == 0 )
+		{
+			WriteTrace();
+		}
+	}
+}
+
+/*
+================
+idThinkProfiler::SetCurrentEntity
+
+  Returns the previous current entity so calls can be nested.
+================
+*/
+idEntity* idThinkProfiler::SetCurrentEntity( idEntity* ent )
+{
+	idEntity* old = currentEntity;
+	currentEntity = ent;
+	return old;
+}
+
+/*
+================
+idThinkProfiler::AddTime
+================
+*/
+void idThinkProfiler::AddTime( thinkProfileCategory_t category, const idEntity* ent, uint64 startTime, uint64 endTime )
+{
+	if( !enabled )
+	{
+		return;
+	}
+	
+	if( ent == NULL )
+	{
+		ent = currentEntity;
+	}
+	const int entityNum = ( ent != NULL ) ? ent->entityNumber : THINKPROF_NO_ENTITY;
+	
+	entityFrameTimes_t& times = frameTimes[entityNum];
+	if( times.frameNum != frameNum )
+	{
+		memset( times.time, 0, sizeof( times.time ) );
+		times.frameNum = frameNum;
+		frameEntities.Append( entityNum );
+	}
+	times.time[category] += endTime - startTime;
+	
+	if( traceFramesLeft > 0 )
+	{
+		thinkProfileTraceEvent_t& event = traceEvents.Alloc();
+		event.name = ( ent != NULL ) ? ent->GetName() : "<events>";
+		event.category = category;
+		event.startTime = startTime;
+		event.duration = endTime - startTime;
+	}
+}
+
+/*
+================
+idThinkProfiler::FindStats
+================
+*/
+thinkProfileStats_t& idThinkProfiler::FindStats( thinkProfileGroup_t group, const char* name )
+{
+	idList<thinkProfileStats_t>& list = stats[group];
+	idHashIndex& hash = statsHash[group];
+	
+	const int key = hash.GenerateKey( name, false );
+	for( int i = hash.First( key ); i != -1; i = hash.Next( i ) )
+	{
+		if( list[i].name.Icmp( name ) == 0 )
+		{
+			return list[i];
+		}
+	}
+	
+	hash.Add( key, list.Num() );
+	thinkProfileStats_t& s = list.Alloc();
+	s.name = name;
+	s.count = 0;
+	memset( s.time, 0, sizeof( s.time ) );
+	memset( s.maxTime, 0, sizeof( s.maxTime ) );
+	return s;
+}
+
+/*
+================
+idThinkProfiler::Reset
+================
+*/
+void idThinkProfiler::Reset()
+{
+	for( int i = 0; i < THINKPROF_NUM_GROUPS; i++ )
+	{
+		stats[i].Clear();
+		statsHash[i].Clear();
+	}
+	numFrames = 0;
+}
+
+/*
+================
+idThinkProfiler::PrintTop
+================
+*/
+void idThinkProfiler::PrintTop( thinkProfileGroup_t group, thinkProfileCategory_t sortCategory, int num ) const
+{
+	const idList<thinkProfileStats_t>& list = stats[group];
+	
+	if( numFrames == 0 )
+	{
+		gameLocal.Printf( "no frames profiled, set g_profileThink 1\n" );
+		return;
+	}
+	
+	// sort indexes by total time in the requested category
+	idList<int> order;
+	order.SetNum( list.Num() );
+	for( int i = 0; i < list.Num(); i++ )
+	{
+		order[i] = i;
+	}
+	for( int i = 1; i < order.Num(); i++ )
+	{
+		int index = order[i];
+		int j = i - 1;
+		for( ; j >= 0 && list[order[j]].time[sortCategory] < list[index].time[sortCategory]; j-- )
+		{
+			order[j + 1] = order[j];
+		}
+		order[j + 1] = index;
+	}
+	
+	const float scale = 0.001f / numFrames;
+	gameLocal.Printf( "top %d by %s over %d frames (ms per frame, max in brackets):\n", num, thinkProfileGroupNames[group], numFrames );
+	gameLocal.Printf( "%-40s %16s %16s %16s %16s\n", thinkProfileGroupNames[group], "think", "physics", "anim", "script" );
+	for( int i = 0; i < order.Num() && i < num; i++ )
+	{
+		const thinkProfileStats_t& s = list[order[i]];
+		idStr line = va( "%-40s", s.name.c_str() );
+		for( int c = 0; c < THINKPROF_NUM_CATEGORIES; c++ )
+		{
+			line += va( " %7.3f (%6.2f)", s.time[c] * scale, s.maxTime[c] * 0.001f );
+		}
+		gameLocal.Printf( "%s\n", line.c_str() );
+	}
+}
+
+/*
+================
+idThinkProfiler::StartTrace
+================
+*/
+void idThinkProfiler::StartTrace( const char* fileName, int numFrames )
+{
+	traceFileName = fileName;
+	traceFileName.DefaultFileExtension( ".json" );
+	traceFramesLeft = numFrames;
+	traceStartTime = Sys_Microseconds();
+	traceEvents.Clear();
+}
+
+/*
+================
+idThinkProfiler::WriteTrace
+
+  Writes the Chrome trace event format, each record is a complete event.
+================
+*/
+void idThinkProfiler::WriteTrace()
+{
+	idFileLocal file( fileSystem->OpenFileWrite( traceFileName ) );
+	if( file == NULL )
+	{
+		gameLocal.Warning( "couldn't write %s", traceFileName.c_str() );
+		traceEvents.Clear();
+		return;
+	}
+	
+	file->Printf( "{\"traceEvents\":[\n" );
+	for( int i = 0; i < traceEvents.Num(); i++ )
+	{
+		const thinkProfileTraceEvent_t& event = traceEvents[i];
+		idStr name = event.name;
+		name.Replace( "\\", "\\\\" );
+		name.Replace( "\"", "\\\"" );
+		file->Printf( "{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%lld,\"dur\":%lld,\"pid\":1,\"tid\":1}%s\n",
+					  name.c_str(), thinkProfileCategoryNames[event.category], ( long long )( event.startTime - traceStartTime ),
+					  ( long long )event.duration, ( i < traceEvents.Num() - 1 ) ? "," : "" );
+	}
+	file->Printf( "]}\n" );
+	
+	gameLocal.Printf( "wrote %d trace events to %s\n", traceEvents.Num(), traceFileName.c_str() );
+	traceEvents.Clear();
+}
+
+/*
+================
+profileThinkTop_f
+================
+*/
+CONSOLE_COMMAND( profileThinkTop, "lists the most expensive entities: [entity|class|def] [think|physics|anim|script] [count]", 0 )
+{
+	thinkProfileGroup_t group = THINKPROF_GROUP_CLASS;
+	thinkProfileCategory_t category = THINKPROF_THINK;
+	int num = 20;
+	
+	for( int i = 1; i < args.Argc(); i++ )
+	{
+		const char* arg = args.Argv( i );
+		bool found = false;
+		for( int j = 0; j < THINKPROF_NUM_GROUPS; j++ )
+		{
+			if( idStr::Icmp( arg, thinkProfileGroupNames[j] ) == 0 )
+			{
+				group = ( thinkProfileGroup_t )j;
+				found = true;
+			}
+		}
+		for( int j = 0; j < THINKPROF_NUM_CATEGORIES; j++ )
+		{
+			if( idStr::Icmp( arg, thinkProfileCategoryNames[j] ) == 0 )
+			{
+				category = ( thinkProfileCategory_t )j;
+				found = true;
+			}
+		}
+		if( !found )
+		{
+			num = Max( 1, atoi( arg ) );
+		}
+	}
+	
+	thinkProfiler.PrintTop( group, category, num );
+}
+
+/*
+================
+profileThinkReset_f
+================
+*/
+CONSOLE_COMMAND( profileThinkReset, "clears the aggregated think profile", 0 )
+{
+	thinkProfiler.Reset();
+}
+
+/*
+================
+profileThinkTrace_f
+================
+*/
+CONSOLE_COMMAND( profileThinkTrace, "captures the think profile of the next frames to a Chrome trace file: [frames] [filename]", 0 )
+{
+	int numFrames = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 60;
+	const char* fileName = ( args.Argc() > 2 ) ? args.Argv( 2 ) : "thinkprofile.json";
+	
+	thinkProfiler.StartTrace( fileName, numFrames );
+	gameLocal.Printf( "tracing %d frames\n", numFrames );
+}
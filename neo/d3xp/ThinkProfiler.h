@@ -0,0 +1,168 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __THINKPROFILER_H__
+#define __THINKPROFILER_H__
+
+/*
+===============================================================================
+
+	Think profiler.
+
+	Records the time every entity spends in think, physics, animation and
+	script each game frame, aggregates the times by entity, spawn class and
+	entityDef, and can capture a number of frames to a Chrome trace file
+	(chrome://tracing). Times are inclusive, so physics, animation and script
+	time spent inside an entity think is also part of its think time.
+
+===============================================================================
+*/
+
+class idEntity;
+
+enum thinkProfileCategory_t
+{
+	THINKPROF_THINK,
+	THINKPROF_PHYSICS,
+	THINKPROF_ANIM,
+	THINKPROF_SCRIPT,
+	THINKPROF_NUM_CATEGORIES
+};
+
+enum thinkProfileGroup_t
+{
+	THINKPROF_GROUP_ENTITY,
+	THINKPROF_GROUP_CLASS,
+	THINKPROF_GROUP_DEF,
+	THINKPROF_NUM_GROUPS
+};
+
+typedef struct thinkProfileStats_s
+{
+	idStr					name;
+	int						count;				// number of frames this name was active in
+	uint64					time[THINKPROF_NUM_CATEGORIES];
+	uint64					maxTime[THINKPROF_NUM_CATEGORIES];
+} thinkProfileStats_t;
+
+typedef struct thinkProfileTraceEvent_s
+{
+	idStr					name;
+	thinkProfileCategory_t	category;
+	uint64					startTime;
+	uint64					duration;
+} thinkProfileTraceEvent_t;
+
+class idThinkProfiler
+{
+public:
+							idThinkProfiler();
+	
+	bool					IsEnabled() const
+	{
+		return enabled;
+	}
+	
+	void					BeginFrame();
+	void					EndFrame();
+	
+	// sets the entity that script time and unattributed time is charged to
+	idEntity* 				SetCurrentEntity( idEntity* ent );
+	idEntity* 				GetCurrentEntity() const
+	{
+		return currentEntity;
+	}
+	
+	void					AddTime( thinkProfileCategory_t category, const idEntity* ent, uint64 startTime, uint64 endTime );
+	
+	void					Reset();
+	void					PrintTop( thinkProfileGroup_t group, thinkProfileCategory_t sortCategory, int num ) const;
+	void					StartTrace( const char* fileName, int numFrames );
+	
+	static const char* 		GetCategoryName( thinkProfileCategory_t category );
+	
+private:
+	typedef struct entityFrameTimes_s
+	{
+		uint64				time[THINKPROF_NUM_CATEGORIES];
+		int					frameNum;			// frame the times belong to
+	} entityFrameTimes_t;
+	
+	bool					enabled;
+	int						frameNum;
+	int						numFrames;			// number of frames aggregated since the last reset
+	idEntity* 				currentEntity;
+	
+	idList<entityFrameTimes_t>	frameTimes;		// indexed by entity number
+	idList<int>				frameEntities;		// entities with times in the current frame
+	
+	idList<thinkProfileStats_t>	stats[THINKPROF_NUM_GROUPS];
+	idHashIndex				statsHash[THINKPROF_NUM_GROUPS];
+	
+	idStr					traceFileName;
+	int						traceFramesLeft;
+	uint64					traceStartTime;
+	idList<thinkProfileTraceEvent_t>	traceEvents;
+	
+	thinkProfileStats_t& 	FindStats( thinkProfileGroup_t group, const char* name );
+	void					WriteTrace();
+};
+
+extern idThinkProfiler		thinkProfiler;
+
+/*
+================================================
+idScopedThinkProfile
+
+Charges the time between construction and destruction to the given entity.
+Only reads the clock when the profiler is enabled.
+================================================
+*/
+class idScopedThinkProfile
+{
+public:
+	idScopedThinkProfile( thinkProfileCategory_t category, const idEntity* ent ) :
+		category( category ), ent( ent ), startTime( thinkProfiler.IsEnabled() ? Sys_Microseconds() : 0 )
+	{
+	}
+	~idScopedThinkProfile()
+	{
+		if( startTime != 0 )
+		{
+			thinkProfiler.AddTime( category, ent, startTime, Sys_Microseconds() );
+		}
+	}
+	
+private:
+	thinkProfileCategory_t	category;
+	const idEntity* 		ent;
+	uint64					startTime;
+};
+
+#endif /* !__THINKPROFILER_H__ */
@@ -59,6 +59,16 @@ idAASLocal::idAASLocal
 idAASLocal::idAASLocal()
 {
 	file = NULL;
+	numRoutingChanges = 0;
+	routingChangeSerial = 1;
+	numRoutingTableHits = 0;
+	numRoutingCacheUpdates = 0;
+	searchNum = 0;
+	searchCorridor = 0;
+	numSearchNodes = 0;
+	numSearchFallbacks = 0;
+	numRoutingNodes = 0;
+	wallEdgeTravelFlags = 0;
 }
 
 /*
@@ -107,6 +117,12 @@ void idAASLocal::Shutdown()
 {
 	if( file )
 	{
+		searchAreas.Clear();
+		searchPortals.Clear();
+		searchHeap.Clear();
+		searchClusters.Clear();
+		wallEdges.Clear();
+		areaWallEdges.Clear();
 		ShutdownRouting();
 		RemoveAllObstacles();
 		AASFileManager->FreeAAS( file );
@@ -142,6 +142,12 @@ public:
 	virtual void				ShowFlyPath( const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin ) const = 0;
 	// Find the nearest goal which satisfies the callback.
 	virtual bool				FindNearestGoal( aasGoal_t& goal, int areaNum, const idVec3 origin, const idVec3& target, int travelFlags, aasObstacle_t* obstacles, int numObstacles, idAASCallback& callback ) const = 0;
+	// Precompute the routing for the given travel flags and store it in the AAS file.
+	virtual bool				BuildRoutingTables( const int* travelFlags, int numTravelFlags ) = 0;
+	// Time route queries between random areas with and without the precomputed routing.
+	virtual void				RoutingBenchmark( int numQueries, int travelFlags ) = 0;
+	// Compare the hierarchical A* routing with the routing cache for random area pairs.
+	virtual void				CompareRouting( int numQueries, int travelFlags ) = 0;
 };
 
 #endif /* !__AAS_H__ */
@@ -0,0 +1,601 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+
+#include "AAS_local.h"
+#include "../Game_local.h"		// for print and error
+
+/*
+===============================================================================
+
+	Hierarchical A*
+
+	Single goal routing without flooding whole clusters. The cluster portals
+	are searched first with straight line travel time estimates, which gives
+	a corridor of clusters between the start and the goal. The route is then
+	refined with an A* search over the areas in the corridor using the same
+	travel times as the routing cache. If the corridor turns out to be a dead
+	end the area search is repeated without the corridor.
+
+===============================================================================
+*/
+
+// travel time per unit of distance when walking, the fastest area travel
+#define SEARCH_TRAVELTIME_SCALE		( 100.0f / 300.0f )
+
+/*
+============
+BoundsDistance
+============
+*/
+static float BoundsDistance( const idBounds& bounds, const idVec3& point )
+{
+	int i;
+	idVec3 delta;
+	
+	for( i = 0; i < 3; i++ )
+	{
+		if( point[i] < bounds[0][i] )
+		{
+			delta[i] = bounds[0][i] - point[i];
+		}
+		else if( point[i] > bounds[1][i] )
+		{
+			delta[i] = point[i] - bounds[1][i];
+		}
+		else
+		{
+			delta[i] = 0.0f;
+		}
+	}
+	return delta.Length();
+}
+
+/*
+============
+idAASLocal::NewSearch
+============
+*/
+void idAASLocal::NewSearch() const
+{
+	if( searchAreas.Num() != file->GetNumAreas() || searchNum >= INT_MAX - 1 )
+	{
+		// forget all nodes
+		searchAreas.SetNum( file->GetNumAreas() );
+		searchPortals.SetNum( file->GetNumPortals() + 1 );
+		searchClusters.SetNum( file->GetNumClusters() );
+		memset( searchAreas.Ptr(), 0, searchAreas.Size() );
+		memset( searchPortals.Ptr(), 0, searchPortals.Size() );
+		memset( searchClusters.Ptr(), 0, searchClusters.Size() );
+		searchNum = 0;
+	}
+	searchNum++;
+	searchHeap.SetNum( 0 );
+}
+
+/*
+============
+idAASLocal::SearchNode
+============
+*/
+aasSearchNode_t& idAASLocal::SearchNode( idList<aasSearchNode_t, TAG_AAS>& nodes, int nodeNum ) const
+{
+	aasSearchNode_t& node = nodes[nodeNum];
+	
+	if( node.searchNum != searchNum )
+	{
+		node.searchNum = searchNum;
+		node.travelTime = INT_MAX;
+		node.closed = false;
+		node.reach = NULL;
+		node.parent = -1;
+	}
+	return node;
+}
+
+/*
+============
+idAASLocal::PushSearchNode
+============
+*/
+void idAASLocal::PushSearchNode( int node, int cost ) const
+{
+	int i, parent;
+	
+	i = searchHeap.Num();
+	searchHeap.Alloc();
+	
+	// move the node up the heap
+	while( i > 0 )
+	{
+		parent = ( i - 1 ) >> 1;
+		if( searchHeap[parent].cost <= cost )
+		{
+			break;
+		}
+		searchHeap[i] = searchHeap[parent];
+		i = parent;
+	}
+	searchHeap[i].cost = cost;
+	searchHeap[i].node = node;
+}
+
+/*
+============
+idAASLocal::PopSearchNode
+============
+*/
+int idAASLocal::PopSearchNode() const
+{
+	int i, child, num, node;
+	aasSearchHeapNode_t last;
+	
+	node = searchHeap[0].node;
+	last = searchHeap[searchHeap.Num() - 1];
+	num = searchHeap.Num() - 1;
+	searchHeap.SetNum( num );
+	
+	// move the last node down from the top of the heap
+	for( i = 0; ; i = child )
+	{
+		child = ( i << 1 ) + 1;
+		if( child >= num )
+		{
+			break;
+		}
+		if( child + 1 < num && searchHeap[child + 1].cost < searchHeap[child].cost )
+		{
+			child++;
+		}
+		if( last.cost <= searchHeap[child].cost )
+		{
+			break;
+		}
+		searchHeap[i] = searchHeap[child];
+	}
+	if( num > 0 )
+	{
+		searchHeap[i] = last;
+	}
+	return node;
+}
+
+/*
+============
+idAASLocal::AreaInCorridor
+============
+*/
+bool idAASLocal::AreaInCorridor( int areaNum ) const
+{
+	int clusterNum;
+	
+	clusterNum = file->GetArea( areaNum ).cluster;
+	if( clusterNum > 0 )
+	{
+		return ( searchClusters[clusterNum] == searchCorridor );
+	}
+	const aasPortal_t& portal = file->GetPortal( -clusterNum );
+	return ( searchClusters[portal.clusters[0]] == searchCorridor || searchClusters[portal.clusters[1]] == searchCorridor );
+}
+
+/*
+============
+idAASLocal::FindClusterCorridor
+
+  A* over the cluster portals, marks the clusters along the way with the corridor number.
+============
+*/
+bool idAASLocal::FindClusterCorridor( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags ) const
+{
+	int i, j, side, node, goalNode, portalNum, badTravelFlags, t;
+	int clusters[2], goalClusters[2];
+	const aasArea_t* goalArea;
+	
+	NewSearch();
+	searchCorridor = searchNum;
+	
+	badTravelFlags = ~travelFlags;
+	goalArea = &file->GetArea( goalAreaNum );
+	goalNode = file->GetNumPortals();
+	
+	// the clusters the start and goal area are part of
+	for( i = 0; i < 2; i++ )
+	{
+		const aasArea_t& area = ( i == 0 ) ? file->GetArea( areaNum ) : *goalArea;
+		int* c = ( i == 0 ) ? clusters : goalClusters;
+		if( area.cluster > 0 )
+		{
+			c[0] = c[1] = area.cluster;
+		}
+		else
+		{
+			c[0] = file->GetPortal( -area.cluster ).clusters[0];
+			c[1] = file->GetPortal( -area.cluster ).clusters[1];
+		}
+	}
+	
+	node = -1;
+	idVec3 start = origin;
+	int startTime = 0;
+	
+	while( 1 )
+	{
+		if( node >= 0 )
+		{
+			aasSearchNode_t& current = searchPortals[node];
+			if( current.closed )
+			{
+				if( !searchHeap.Num() )
+				{
+					return false;
+				}
+				node = PopSearchNode();
+				continue;
+			}
+			current.closed = true;
+			numSearchNodes++;
+			
+			if( node == goalNode )
+			{
+				break;
+			}
+			
+			const aasPortal_t& portal = file->GetPortal( node );
+			clusters[0] = portal.clusters[0];
+			clusters[1] = portal.clusters[1];
+			start = file->GetArea( portal.areaNum ).center;
+			startTime = current.travelTime;
+		}
+		
+		for( side = 0; side < 2; side++ )
+		{
+			if( side == 1 && clusters[1] == clusters[0] )
+			{
+				break;
+			}
+			
+			// the goal is in this cluster
+			if( clusters[side] == goalClusters[0] || clusters[side] == goalClusters[1] )
+			{
+				t = startTime + idMath::Ftoi( BoundsDistance( goalArea->bounds, start ) * SEARCH_TRAVELTIME_SCALE );
+				aasSearchNode_t& goal = SearchNode( searchPortals, goalNode );
+				if( !goal.closed && t < goal.travelTime )
+				{
+					goal.travelTime = t;
+					goal.parent = node;
+					PushSearchNode( goalNode, t );
+				}
+			}
+			
+			const aasCluster_t& cluster = file->GetCluster( clusters[side] );
+			for( j = 0; j < cluster.numPortals; j++ )
+			{
+				portalNum = file->GetPortalIndex( cluster.firstPortal + j );
+				if( portalNum == node )
+				{
+					continue;
+				}
+				
+				const aasPortal_t& portal = file->GetPortal( portalNum );
+				const aasArea_t& portalArea = file->GetArea( portal.areaNum );
+				
+				// skip closed portals
+				if( portalArea.travelFlags & badTravelFlags )
+				{
+					continue;
+				}
+				
+				t = startTime + idMath::Ftoi( ( portalArea.center - start ).LengthFast() * SEARCH_TRAVELTIME_SCALE );
+				aasSearchNode_t& next = SearchNode( searchPortals, portalNum );
+				if( next.closed || t >= next.travelTime )
+				{
+					continue;
+				}
+				next.travelTime = t;
+				next.parent = node;
+				PushSearchNode( portalNum, t + idMath::Ftoi( BoundsDistance( goalArea->bounds, portalArea.center ) * SEARCH_TRAVELTIME_SCALE ) );
+			}
+		}
+		
+		if( !searchHeap.Num() )
+		{
+			return false;
+		}
+		node = PopSearchNode();
+	}
+	
+	// mark the clusters along the portals in the corridor
+	for( i = 0; i < 2; i++ )
+	{
+		const aasArea_t& area = ( i == 0 ) ? file->GetArea( areaNum ) : *goalArea;
+		if( area.cluster > 0 )
+		{
+			searchClusters[area.cluster] = searchCorridor;
+		}
+		else
+		{
+			searchClusters[file->GetPortal( -area.cluster ).clusters[0]] = searchCorridor;
+			searchClusters[file->GetPortal( -area.cluster ).clusters[1]] = searchCorridor;
+		}
+	}
+	for( node = searchPortals[goalNode].parent; node >= 0; node = searchPortals[node].parent )
+	{
+		searchClusters[file->GetPortal( node ).clusters[0]] = searchCorridor;
+		searchClusters[file->GetPortal( node ).clusters[1]] = searchCorridor;
+	}
+	return true;
+}
+
+/*
+============
+idAASLocal::FindAreaPath
+
+  A* over the areas with the travel times used by the routing cache.
+============
+*/
+bool idAASLocal::FindAreaPath( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags, bool useCorridor, int& travelTime, idReachability** reach ) const
+{
+	int node, nextAreaNum, badTravelFlags, t;
+	idReachability* r;
+	const aasArea_t* goalArea, *nextArea;
+	
+	NewSearch();
+	
+	badTravelFlags = ~travelFlags;
+	goalArea = &file->GetArea( goalAreaNum );
+	
+	aasSearchNode_t& start = SearchNode( searchAreas, areaNum );
+	start.travelTime = 0;
+	start.entry = origin;
+	PushSearchNode( areaNum, 0 );
+	
+	while( searchHeap.Num() )
+	{
+		node = PopSearchNode();
+		
+		aasSearchNode_t& current = searchAreas[node];
+		if( current.closed )
+		{
+			continue;
+		}
+		current.closed = true;
+		numSearchNodes++;
+		
+		if( node == goalAreaNum )
+		{
+			// walk back to the reachability leaving the start area
+			r = current.reach;
+			while( r->fromAreaNum != areaNum )
+			{
+				r = searchAreas[r->fromAreaNum].reach;
+			}
+			*reach = r;
+			// the routing cache starts with a travel time of 1 at the goal area
+			travelTime = current.travelTime + 1;
+			return true;
+		}
+		
+		for( r = file->GetArea( node ).reach; r; r = r->next )
+		{
+			// if the reachability uses an undesired travel type
+			if( r->travelType & badTravelFlags )
+			{
+				continue;
+			}
+			
+			nextAreaNum = r->toAreaNum;
+			nextArea = &file->GetArea( nextAreaNum );
+			
+			// if traveling through the next area requires an undesired travel flag
+			if( nextArea->travelFlags & badTravelFlags )
+			{
+				continue;
+			}
+			
+			if( useCorridor && !AreaInCorridor( nextAreaNum ) )
+			{
+				continue;
+			}
+			
+			// travel time through the current area plus the travel time of the reachability
+			t = current.travelTime + AreaTravelTime( node, current.entry, r->start ) + r->travelTime;
+			
+			// if we are not allowed to fly avoid areas near ledges
+			if( ( badTravelFlags & TFL_FLY ) && nextAreaNum != goalAreaNum && ( nextArea->flags & AREA_LEDGE ) )
+			{
+				t += LEDGE_TRAVELTIME_PANALTY;
+			}
+			
+			aasSearchNode_t& next = SearchNode( searchAreas, nextAreaNum );
+			if( next.closed || t >= next.travelTime )
+			{
+				continue;
+			}
+			next.travelTime = t;
+			next.entry = r->end;
+			next.reach = r;
+			PushSearchNode( nextAreaNum, t + idMath::Ftoi( BoundsDistance( goalArea->bounds, r->end ) * SEARCH_TRAVELTIME_SCALE ) );
+		}
+	}
+	return false;
+}
+
+/*
+============
+idAASLocal::HierarchicalRouteToGoalArea
+============
+*/
+bool idAASLocal::HierarchicalRouteToGoalArea( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach ) const
+{
+	travelTime = 0;
+	*reach = NULL;
+	
+	if( areaNum == goalAreaNum )
+	{
+		return true;
+	}
+	
+	if( !( file->GetArea( areaNum ).flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) ) )
+	{
+		return false;
+	}
+	
+	if( FindClusterCorridor( areaNum, origin, goalAreaNum, travelFlags ) )
+	{
+		if( FindAreaPath( areaNum, origin, goalAreaNum, travelFlags, true, travelTime, reach ) )
+		{
+			return true;
+		}
+	}
+	
+	// the corridor estimate was a dead end
+	numSearchFallbacks++;
+	return FindAreaPath( areaNum, origin, goalAreaNum, travelFlags, false, travelTime, reach );
+}
+
+/*
+============
+idAASLocal::CompareRouting
+============
+*/
+void idAASLocal::CompareRouting( int numQueries, int travelFlags )
+{
+	int i, pass, numFound[2], numMismatch, numSameReach, numCompared, maxTimeDiff, numNodes[2], travelTime;
+	float timeRatio;
+	uint64 time[2];
+	idReachability* reach;
+	idList<int> areas, queryAreas;
+	idList<int> cacheTimes;
+	idList<idReachability*> cacheReach;
+	
+	if( !file )
+	{
+		return;
+	}
+	
+	for( i = 1; i < file->GetNumAreas(); i++ )
+	{
+		if( file->GetArea( i ).flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) )
+		{
+			areas.Append( i );
+		}
+	}
+	if( areas.Num() < 2 )
+	{
+		return;
+	}
+	
+	idRandom random( 0 );
+	queryAreas.SetNum( numQueries * 2 );
+	for( i = 0; i < queryAreas.Num(); i++ )
+	{
+		queryAreas[i] = areas[random.RandomInt( areas.Num() )];
+	}
+	cacheTimes.SetNum( numQueries );
+	cacheReach.SetNum( numQueries );
+	
+	const bool hierarchicalRouting = aas_hierarchicalRouting.GetBool();
+	aas_hierarchicalRouting.SetBool( false );
+	
+	numMismatch = numSameReach = numCompared = maxTimeDiff = 0;
+	timeRatio = 0.0f;
+	
+	for( pass = 0; pass < 2; pass++ )
+	{
+		// start the routing cache empty
+		while( cacheListStart )
+		{
+			DeleteOldestCache();
+		}
+		numRoutingNodes = 0;
+		numSearchNodes = 0;
+		numSearchFallbacks = 0;
+		numFound[pass] = 0;
+		
+		uint64 startTime = Sys_Microseconds();
+		for( i = 0; i < numQueries; i++ )
+		{
+			const int areaNum = queryAreas[i * 2 + 0];
+			const int goalAreaNum = queryAreas[i * 2 + 1];
+			const idVec3& origin = file->GetArea( areaNum ).center;
+			
+			if( pass == 0 )
+			{
+				if( RouteToGoalArea( areaNum, origin, goalAreaNum, travelFlags, travelTime, &reach ) )
+				{
+					numFound[pass]++;
+					cacheTimes[i] = travelTime;
+					cacheReach[i] = reach;
+				}
+				else
+				{
+					cacheTimes[i] = -1;
+				}
+				continue;
+			}
+			
+			if( !HierarchicalRouteToGoalArea( areaNum, origin, goalAreaNum, travelFlags, travelTime, &reach ) )
+			{
+				if( cacheTimes[i] >= 0 )
+				{
+					numMismatch++;
+				}
+				continue;
+			}
+			numFound[pass]++;
+			if( cacheTimes[i] < 0 )
+			{
+				numMismatch++;
+				continue;
+			}
+			if( reach == cacheReach[i] )
+			{
+				numSameReach++;
+			}
+			if( cacheTimes[i] > 0 )
+			{
+				timeRatio += ( float ) travelTime / cacheTimes[i];
+				numCompared++;
+			}
+			maxTimeDiff = Max( maxTimeDiff, abs( travelTime - cacheTimes[i] ) );
+		}
+		time[pass] = Sys_Microseconds() - startTime;
+		numNodes[pass] = ( pass == 0 ) ? numRoutingNodes : numSearchNodes;
+	}
+	
+	aas_hierarchicalRouting.SetBool( hierarchicalRouting );
+	
+	gameLocal.Printf( "%d queries between %d reachable areas\n", numQueries, areas.Num() );
+	gameLocal.Printf( "routing cache:  %6d routes, %8d nodes expanded, %6d usec\n", numFound[0], numNodes[0], ( int ) time[0] );
+	gameLocal.Printf( "hierarchical:   %6d routes, %8d nodes expanded, %6d usec, %d corridor fallbacks\n", numFound[1], numNodes[1], ( int ) time[1], numSearchFallbacks );
+	gameLocal.Printf( "%d reachability mismatches, %d of %d routes start with the same reachability\n", numMismatch, numSameReach, numFound[1] );
+	gameLocal.Printf( "average travel time ratio %.3f, largest travel time difference %d\n", numCompared ? timeRatio / numCompared : 0.0f, maxTimeDiff );
+}
@@ -32,6 +32,14 @@ If you have questions concerning this license or the applicable additional terms
 #include "AAS.h"
 #include "../Pvs.h"
 
+#define CACHETYPE_AREA				1
+#define CACHETYPE_PORTAL			2
+
+#define MAX_ROUTING_CACHE_MEMORY	(2*1024*1024)
+
+#define LEDGE_TRAVELTIME_PANALTY	250
+
+#define MAX_AREA_WALL_EDGES			256
 
 class idRoutingCache
 {
@@ -39,6 +47,7 @@ class idRoutingCache
 	
 public:
 	idRoutingCache( int size );
+	idRoutingCache( int size, unsigned short* travelTimes, byte* reachabilities );
 	~idRoutingCache();
 	
 	int							Size() const;
@@ -56,6 +65,19 @@ private:
 	unsigned short				startTravelTime;		// travel time to start with
 	unsigned char* 				reachabilities;			// reachabilities used for routing
 	unsigned short* 			travelTimes;			// travel time for every area
+	bool						isView;					// true if the travel times and reachabilities are owned by a routing table
+};
+
+
+class idRoutingTable
+{
+	friend class idAASLocal;
+	
+private:
+	const aasRoutingTable_t* 	table;					// precomputed routing stored in the AAS file
+	idRoutingCache** 			areaCache;				// views into the area cache, indexed like idAASLocal::areaCacheIndex
+	idRoutingCache** 			portalCache;			// views into the portal cache for each goal area
+	int* 						portalCacheCheck;		// routing change serial the portal cache of each goal area was checked at, negative if it was invalid
 };
 
 
@@ -86,6 +108,23 @@ private:
 };
 
 
+typedef struct aasSearchNode_s
+{
+	int							searchNum;				// search the node was last reached in
+	int							travelTime;				// travel time from the start
+	bool						closed;					// true once the node has been expanded
+	idVec3						entry;					// point the area was entered at
+	idReachability* 			reach;					// reachability used to enter the area
+	int							parent;					// previous portal on the cluster level
+} aasSearchNode_t;
+
+typedef struct aasSearchHeapNode_s
+{
+	int							cost;					// travel time plus estimated travel time to the goal
+	int							node;					// area or portal number
+} aasSearchHeapNode_t;
+
+
 class idAASLocal : public idAAS
 {
 public:
@@ -122,6 +161,9 @@ public:
 	virtual void				ShowWalkPath( const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin ) const;
 	virtual void				ShowFlyPath( const idVec3& origin, int goalAreaNum, const idVec3& goalOrigin ) const;
 	virtual bool				FindNearestGoal( aasGoal_t& goal, int areaNum, const idVec3 origin, const idVec3& target, int travelFlags, aasObstacle_t* obstacles, int numObstacles, idAASCallback& callback ) const;
+	virtual bool				BuildRoutingTables( const int* travelFlags, int numTravelFlags );
+	virtual void				RoutingBenchmark( int numQueries, int travelFlags );
+	virtual void				CompareRouting( int numQueries, int travelFlags );
 	
 private:
 	idAASFile* 					file;
@@ -142,6 +184,31 @@ private:	// routing data
 	mutable int					totalCacheMemory;		// total cache memory used
 	idList<idRoutingObstacle*, TAG_AAS>	obstacleList;			// list with obstacles
 	
+private:	// precomputed routing
+	idList<idRoutingTable, TAG_AAS>	routingTables;		// views into the precomputed routing of the AAS file
+	idList<int, TAG_AAS>		clusterAreaOffset;		// offset of each cluster into the area cache views and tables
+	idList<int, TAG_AAS>		clusterChanges;			// number of disabled areas and reachabilities in each cluster
+	int							numRoutingChanges;		// total number of disabled areas and reachabilities
+	int							routingChangeSerial;	// incremented every time an area or reachability is disabled or enabled
+	mutable int					numRoutingTableHits;	// number of cache requests served from the precomputed routing
+	mutable int					numRoutingCacheUpdates;	// number of cache requests that flooded the areas or portals
+	
+private:	// hierarchical routing
+	mutable idList<aasSearchNode_t, TAG_AAS>	searchAreas;	// area level search state
+	mutable idList<aasSearchNode_t, TAG_AAS>	searchPortals;	// cluster level search state, the last node is the goal
+	mutable idList<aasSearchHeapNode_t, TAG_AAS>	searchHeap;	// open nodes of the current search
+	mutable idList<int, TAG_AAS>	searchClusters;		// corridor number of each cluster
+	mutable int					searchNum;				// number of the current search
+	mutable int					searchCorridor;			// number of the current cluster corridor
+	mutable int					numSearchNodes;			// nodes expanded by the hierarchical searches
+	mutable int					numSearchFallbacks;		// searches that could not be completed in the cluster corridor
+	mutable int					numRoutingNodes;		// areas and portals expanded by the routing cache updates
+	
+private:	// wall edges
+	mutable idList<int, TAG_AAS>	wallEdges;			// number of wall edges followed by the edges for each cached area
+	mutable idList<int, TAG_AAS>	areaWallEdges;		// offset of each area into wallEdges, -1 if not calculated yet
+	mutable int					wallEdgeTravelFlags;	// travel flags the wall edges are cached for
+	
 private:	// routing
 	bool						SetupRouting();
 	void						ShutdownRouting();
@@ -169,7 +236,30 @@ private:	// routing
 	void						GetBoundsAreas_r( int nodeNum, const idBounds& bounds, idList<int>& areas ) const;
 	void						SetObstacleState( const idRoutingObstacle* obstacle, bool enable );
 	
+private:	// precomputed routing
+	void						SetupRoutingTables();
+	void						ShutdownRoutingTables();
+	void						ChangeRoutingTableState( int areaNum, int change );
+	int							RoutingTablesMemory() const;
+	idRoutingCache* 			GetRoutingTableAreaCache( int clusterNum, int clusterAreaNum, int travelFlags ) const;
+	idRoutingCache* 			GetRoutingTablePortalCache( int areaNum, int travelFlags ) const;
+	bool						IsAreaInCluster( int areaNum, int clusterNum ) const;
+	bool						IsRoutingTablePortalCacheValid( const idRoutingTable& routingTable, int areaNum ) const;
+	void						CalculateRoutingTable( aasRoutingTable_t& table, int travelFlags );
+	
+private:	// hierarchical routing
+	bool						HierarchicalRouteToGoalArea( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags, int& travelTime, idReachability** reach ) const;
+	bool						FindClusterCorridor( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags ) const;
+	bool						FindAreaPath( int areaNum, const idVec3& origin, int goalAreaNum, int travelFlags, bool useCorridor, int& travelTime, idReachability** reach ) const;
+	bool						AreaInCorridor( int areaNum ) const;
+	void						NewSearch() const;
+	aasSearchNode_t& 			SearchNode( idList<aasSearchNode_t, TAG_AAS>& nodes, int nodeNum ) const;
+	void						PushSearchNode( int node, int cost ) const;
+	int							PopSearchNode() const;
+	
 private:	// pathing
+	int							CalculateAreaWallEdges( int areaNum, int travelFlags, int* edges, int maxEdges ) const;
+	int							GetAreaWallEdges( int areaNum, const int** edges ) const;
 	bool						EdgeSplitPoint( idVec3& split, int edgeNum, const idPlane& plane ) const;
 	bool						FloorEdgeSplitPoint( idVec3& split, int areaNum, const idPlane& splitPlane, const idPlane& frontPlane, bool closest ) const;
 	idVec3						SubSampleWalkPath( int areaNum, const idVec3& origin, const idVec3& start, const idVec3& end, int travelFlags, int& endAreaNum ) const;
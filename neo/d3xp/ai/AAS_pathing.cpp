@@ -685,6 +685,139 @@ void idAASLocal::SortWallEdges( int* edges, int numEdges ) const
 	}
 }
 
+/*
+============
+idAASLocal::CalculateAreaWallEdges
+
+  Finds the floor edges of the area that are not shared with another floor face and not crossed by a reachability.
+============
+*/
+int idAASLocal::CalculateAreaWallEdges( int areaNum, int travelFlags, int* edges, int maxEdges ) const
+{
+	int i, j, k, l, face1Num, face2Num, edge1Num, edge2Num, numEdges, absEdge1Num;
+	const aasArea_t* area;
+	const aasFace_t* face1, *face2;
+	idReachability* reach;
+	
+	numEdges = 0;
+	area = &file->GetArea( areaNum );
+	
+	for( i = 0; i < area->numFaces; i++ )
+	{
+		face1Num = file->GetFaceIndex( area->firstFace + i );
+		face1 = &file->GetFace( abs( face1Num ) );
+		
+		if( !( face1->flags & FACE_FLOOR ) )
+		{
+			continue;
+		}
+		
+		for( j = 0; j < face1->numEdges; j++ )
+		{
+			edge1Num = file->GetEdgeIndex( face1->firstEdge + j );
+			absEdge1Num = abs( edge1Num );
+			
+			// test if the edge is shared by another floor face of this area
+			for( k = 0; k < area->numFaces; k++ )
+			{
+				if( k == i )
+				{
+					continue;
+				}
+				face2Num = file->GetFaceIndex( area->firstFace + k );
+				face2 = &file->GetFace( abs( face2Num ) );
+				
+				if( !( face2->flags & FACE_FLOOR ) )
+				{
+					continue;
+				}
+				
+				for( l = 0; l < face2->numEdges; l++ )
+				{
+					edge2Num = abs( file->GetEdgeIndex( face2->firstEdge + l ) );
+					if( edge2Num == absEdge1Num )
+					{
+						break;
+					}
+				}
+				if( l < face2->numEdges )
+				{
+					break;
+				}
+			}
+			if( k < area->numFaces )
+			{
+				continue;
+			}
+			
+			// test if the edge is used by a reachability
+			for( reach = area->reach; reach; reach = reach->next )
+			{
+				if( reach->travelType & travelFlags )
+				{
+					if( reach->edgeNum == absEdge1Num )
+					{
+						break;
+					}
+				}
+			}
+			if( reach )
+			{
+				continue;
+			}
+			
+			// test if the edge is already in the list
+			for( k = 0; k < numEdges; k++ )
+			{
+				if( edge1Num == edges[k] )
+				{
+					break;
+				}
+			}
+			if( k < numEdges )
+			{
+				continue;
+			}
+			
+			// add the edge to the list
+			edges[numEdges++] = edge1Num;
+			if( numEdges >= maxEdges )
+			{
+				return numEdges;
+			}
+		}
+	}
+	return numEdges;
+}
+
+/*
+============
+idAASLocal::GetAreaWallEdges
+
+  The wall edges only depend on the AAS geometry and the travel types of the reachabilities, which
+  are not changed by disabling reachabilities, so they are cached for the first travel flags used.
+============
+*/
+int idAASLocal::GetAreaWallEdges( int areaNum, const int** edges ) const
+{
+	int i, numEdges;
+	int areaEdges[MAX_AREA_WALL_EDGES];
+	
+	if( areaWallEdges[areaNum] < 0 )
+	{
+		numEdges = CalculateAreaWallEdges( areaNum, wallEdgeTravelFlags, areaEdges, MAX_AREA_WALL_EDGES );
+		areaWallEdges[areaNum] = wallEdges.Num();
+		wallEdges.Append( numEdges );
+		for( i = 0; i < numEdges; i++ )
+		{
+			wallEdges.Append( areaEdges[i] );
+		}
+	}
+	
+	*edges = wallEdges.Ptr() + areaWallEdges[areaNum] + 1;
+	return wallEdges[areaWallEdges[areaNum]];
+}
+
 /*
 ============
 idAASLocal::GetWallEdges
@@ -692,11 +825,12 @@ idAASLocal::GetWallEdges
 */
 int idAASLocal::GetWallEdges( int areaNum, const idBounds& bounds, int travelFlags, int* edges, int maxEdges ) const
 {
-	int i, j, k, l, face1Num, face2Num, edge1Num, edge2Num, numEdges, absEdge1Num;
+	int i, k, numEdges, numAreaEdges;
 	int* areaQueue, curArea, queueStart, queueEnd;
+	int localEdges[MAX_AREA_WALL_EDGES];
+	const int* areaEdges;
 	byte* areasVisited;
 	const aasArea_t* area;
-	const aasFace_t* face1, *face2;
 	idReachability* reach;
 	
 	if( !file )
@@ -704,6 +838,18 @@ int idAASLocal::GetWallEdges( int areaNum, const idBounds& bounds, int travelFla
 		return 0;
 	}
 	
+	if( areaWallEdges.Num() != file->GetNumAreas() )
+	{
+		areaWallEdges.SetNum( file->GetNumAreas() );
+		for( i = 0; i < areaWallEdges.Num(); i++ )
+		{
+			areaWallEdges[i] = -1;
+		}
+		wallEdges.Clear();
+		wallEdges.SetGranularity( 1024 );
+		wallEdgeTravelFlags = travelFlags;
+	}
+	
 	numEdges = 0;
 	
 	areasVisited = ( byte* ) _alloca16( file->GetNumAreas() );
@@ -720,89 +866,35 @@ int idAASLocal::GetWallEdges( int areaNum, const idBounds& bounds, int travelFla
 	
 		area = &file->GetArea( curArea );
 		
-		for( i = 0; i < area->numFaces; i++ )
+		if( travelFlags == wallEdgeTravelFlags )
 		{
-			face1Num = file->GetFaceIndex( area->firstFace + i );
-			face1 = &file->GetFace( abs( face1Num ) );
-			
-			if( !( face1->flags & FACE_FLOOR ) )
+			numAreaEdges = GetAreaWallEdges( curArea, &areaEdges );
+		}
+		else
+		{
+			numAreaEdges = CalculateAreaWallEdges( curArea, travelFlags, localEdges, MAX_AREA_WALL_EDGES );
+			areaEdges = localEdges;
+		}
+		for( i = 0; i < numAreaEdges; i++ )
+		{
+			// test if the edge is already in the list
+			for( k = 0; k < numEdges; k++ )
+			{
+				if( areaEdges[i] == edges[k] )
+				{
+					break;
+				}
+			}
+			if( k < numEdges )
 			{
 				continue;
 			}
 			
-			for( j = 0; j < face1->numEdges; j++ )
+			// add the edge to the list
+			edges[numEdges++] = areaEdges[i];
+			if( numEdges >= maxEdges )
 			{
-				edge1Num = file->GetEdgeIndex( face1->firstEdge + j );
-				absEdge1Num = abs( edge1Num );
-				
-				// test if the edge is shared by another floor face of this area
-				for( k = 0; k < area->numFaces; k++ )
-				{
-					if( k == i )
-					{
-						continue;
-					}
-					face2Num = file->GetFaceIndex( area->firstFace + k );
-					face2 = &file->GetFace( abs( face2Num ) );
-					
-					if( !( face2->flags & FACE_FLOOR ) )
-					{
-						continue;
-					}
-					
-					for( l = 0; l < face2->numEdges; l++ )
-					{
-						edge2Num = abs( file->GetEdgeIndex( face2->firstEdge + l ) );
-						if( edge2Num == absEdge1Num )
-						{
-							break;
-						}
-					}
-					if( l < face2->numEdges )
-					{
-						break;
-					}
-				}
-				if( k < area->numFaces )
-				{
-					continue;
-				}
-				
-				// test if the edge is used by a reachability
-				for( reach = area->reach; reach; reach = reach->next )
-				{
-					if( reach->travelType & travelFlags )
-					{
-						if( reach->edgeNum == absEdge1Num )
-						{
-							break;
-						}
-					}
-				}
-				if( reach )
-				{
-					continue;
-				}
-				
-				// test if the edge is already in the list
-				for( k = 0; k < numEdges; k++ )
-				{
-					if( edge1Num == edges[k] )
-					{
-						break;
-					}
-				}
-				if( k < numEdges )
-				{
-					continue;
-				}
-				
-				// add the edge to the list
-				edges[numEdges++] = edge1Num;
-				if( numEdges >= maxEdges )
-				{
-					return numEdges;
-				}
+				return numEdges;
 			}
 		}
 		
@@ -33,13 +33,6 @@ If you have questions concerning this license or the applicable additional terms
 #include "AAS_local.h"
 #include "../Game_local.h"		// for print and error
 
-#define CACHETYPE_AREA				1
-#define CACHETYPE_PORTAL			2
-
-#define MAX_ROUTING_CACHE_MEMORY	(2*1024*1024)
-
-#define LEDGE_TRAVELTIME_PANALTY	250
-
 /*
 ============
 idRoutingCache::idRoutingCache
@@ -59,6 +52,29 @@ idRoutingCache::idRoutingCache( int size )
 	memset( reachabilities, 0, size * sizeof( reachabilities[0] ) );
 	travelTimes = new( TAG_AAS ) unsigned short[size];
 	memset( travelTimes, 0, size * sizeof( travelTimes[0] ) );
+	isView = false;
+}
+
+/*
+============
+idRoutingCache::idRoutingCache
+
+  cache that uses travel times and reachabilities owned by a precomputed routing table
+============
+*/
+idRoutingCache::idRoutingCache( int size, unsigned short* travelTimes, byte* reachabilities )
+{
+	areaNum = 0;
+	cluster = 0;
+	next = prev = NULL;
+	time_next = time_prev = NULL;
+	travelFlags = 0;
+	startTravelTime = 0;
+	type = 0;
+	this->size = size;
+	this->reachabilities = reachabilities;
+	this->travelTimes = travelTimes;
+	isView = true;
 }
 
 /*
@@ -68,6 +84,10 @@ idRoutingCache::~idRoutingCache
 */
 idRoutingCache::~idRoutingCache()
 {
+	if( isView )
+	{
+		return;
+	}
 	delete [] reachabilities;
 	delete [] travelTimes;
 }
@@ -328,6 +348,7 @@ bool idAASLocal::SetupRouting()
 {
 	CalculateAreaTravelTimes();
 	SetupRoutingCache();
+	SetupRoutingTables();
 	return true;
 }
 
@@ -338,6 +359,7 @@ idAASLocal::ShutdownRouting
 */
 void idAASLocal::ShutdownRouting()
 {
+	ShutdownRoutingTables();
 	DeleteAreaTravelTimes();
 	ShutdownRoutingCache();
 }
@@ -375,6 +397,10 @@ void idAASLocal::RoutingStats() const
 	gameLocal.Printf( "%6d area travel times (%d KB)\n", numAreaTravelTimes, ( numAreaTravelTimes * sizeof( unsigned short ) ) >> 10 );
 	gameLocal.Printf( "%6d area cache entries (%d KB)\n", areaCacheIndexSize, ( areaCacheIndexSize * sizeof( idRoutingCache* ) ) >> 10 );
 	gameLocal.Printf( "%6d portal cache entries (%d KB)\n", portalCacheIndexSize, ( portalCacheIndexSize * sizeof( idRoutingCache* ) ) >> 10 );
+	gameLocal.Printf( "%6d precomputed routing tables (%d KB)\n", routingTables.Num(), RoutingTablesMemory() >> 10 );
+	gameLocal.Printf( "%6d disabled areas and reachabilities\n", numRoutingChanges );
+	gameLocal.Printf( "%6d cache requests served from the routing tables\n", numRoutingTableHits );
+	gameLocal.Printf( "%6d cache updates\n", numRoutingCacheUpdates );
 }
 
 /*
@@ -416,6 +442,7 @@ void idAASLocal::DisableArea( int areaNum )
 	}
 	
 	file->SetAreaTravelFlag( areaNum, TFL_INVALID );
+	ChangeRoutingTableState( areaNum, 1 );
 	
 	RemoveRoutingCacheUsingArea( areaNum );
 }
@@ -435,6 +462,7 @@ void idAASLocal::EnableArea( int areaNum )
 	}
 	
 	file->RemoveAreaTravelFlag( areaNum, TFL_INVALID );
+	ChangeRoutingTableState( areaNum, -1 );
 	
 	RemoveRoutingCacheUsingArea( areaNum );
 }
@@ -605,6 +633,9 @@ void idAASLocal::SetObstacleState( const idRoutingObstacle* obstacle, bool enabl
 				{
 					rev_reach->travelType |= TFL_INVALID;
 					rev_reach->disableCount++;
+					// the disabled reachability is only enabled again when the obstacle is removed
+					ChangeRoutingTableState( rev_reach->fromAreaNum, 1 );
+					ChangeRoutingTableState( rev_reach->toAreaNum, 1 );
 				}
 			}
 		}
@@ -868,6 +899,7 @@ void idAASLocal::UpdateAreaRoutingCache( idRoutingCache* areaCache ) const
 		updateListStart = curUpdate->next;
 		
 		curUpdate->isInList = false;
+		numRoutingNodes++;
 		
 		for( i = 0, reach = file->GetArea( curUpdate->areaNum ).rev_reach; reach; reach = reach->rev_next, i++ )
 		{
@@ -961,6 +993,12 @@ idRoutingCache* idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 	
 	// number of the area in the cluster
 	clusterAreaNum = ClusterAreaNum( clusterNum, areaNum );
+	// use the precomputed routing if nothing changed in the cluster
+	cache = GetRoutingTableAreaCache( clusterNum, clusterAreaNum, travelFlags );
+	if( cache )
+	{
+		return cache;
+	}
 	// pointer to the cache for the area in the cluster
 	clusterCache = areaCacheIndex[clusterNum][clusterAreaNum];
 	// check if cache without undesired travel flags already exists
@@ -988,6 +1026,7 @@ idRoutingCache* idAASLocal::GetAreaRoutingCache( int clusterNum, int areaNum, in
 		}
 		areaCacheIndex[clusterNum][clusterAreaNum] = cache;
 		UpdateAreaRoutingCache( cache );
+		numRoutingCacheUpdates++;
 	}
 	LinkCache( cache );
 	return cache;
@@ -1035,6 +1074,7 @@ void idAASLocal::UpdatePortalRoutingCache( idRoutingCache* portalCache ) const
 		updateListStart = curUpdate->next;
 		// current update is removed from the list
 		curUpdate->isInList = false;
+		numRoutingNodes++;
 		
 		cluster = &file->GetCluster( curUpdate->cluster );
 		cache = GetAreaRoutingCache( curUpdate->cluster, curUpdate->areaNum, portalCache->travelFlags );
@@ -1107,6 +1147,13 @@ idRoutingCache* idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 {
 	idRoutingCache* cache;
 	
+	// use the precomputed routing if nothing changed since it was calculated
+	cache = GetRoutingTablePortalCache( areaNum, travelFlags );
+	if( cache )
+	{
+		return cache;
+	}
+	
 	// check if cache without undesired travel flags already exists
 	for( cache = portalCacheIndex[areaNum]; cache; cache = cache->next )
 	{
@@ -1132,6 +1179,7 @@ idRoutingCache* idAASLocal::GetPortalRoutingCache( int clusterNum, int areaNum,
 		}
 		portalCacheIndex[areaNum] = cache;
 		UpdatePortalRoutingCache( cache );
+		numRoutingCacheUpdates++;
 	}
 	LinkCache( cache );
 	return cache;
@@ -1175,6 +1223,11 @@ bool idAASLocal::RouteToGoalArea( int areaNum, const idVec3 origin, int goalArea
 		return false;
 	}
 	
+	if( aas_hierarchicalRouting.GetBool() )
+	{
+		return HierarchicalRouteToGoalArea( areaNum, origin, goalAreaNum, travelFlags, travelTime, reach );
+	}
+	
 	while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY )
 	{
 		DeleteOldestCache();
@@ -0,0 +1,615 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+
+#include "AAS_local.h"
+#include "../Game_local.h"		// for print and error
+
+/*
+===============================================================================
+
+	Precomputed routing
+
+	The AAS file can store the complete area and portal routing cache for
+	a combination of travel flags. As long as no area or reachability in a
+	cluster is disabled the routing cache requests for that cluster are
+	served directly from the tables instead of flooding the areas.
+
+	Disabling areas and reachabilities can only make routes longer, so the
+	portal table of a goal area stays valid as long as none of its routes
+	pass through a cluster with disabled areas or reachabilities. Only the
+	goal areas with routes through such a cluster fall back to flooding the
+	portals.
+
+===============================================================================
+*/
+
+/*
+============
+idAASLocal::SetupRoutingTables
+============
+*/
+void idAASLocal::SetupRoutingTables()
+{
+	int i, offset;
+	
+	clusterAreaOffset.SetNum( file->GetNumClusters() + 1 );
+	for( offset = 0, i = 0; i < file->GetNumClusters(); i++ )
+	{
+		clusterAreaOffset[i] = offset;
+		offset += file->GetCluster( i ).numReachableAreas;
+	}
+	clusterAreaOffset[i] = offset;
+	
+	clusterChanges.SetNum( file->GetNumClusters() );
+	for( i = 0; i < clusterChanges.Num(); i++ )
+	{
+		clusterChanges[i] = 0;
+	}
+	numRoutingChanges = 0;
+	routingChangeSerial = 1;
+	
+	// areas may have been disabled before the routing was setup
+	for( i = 1; i < file->GetNumAreas(); i++ )
+	{
+		if( file->GetArea( i ).travelFlags & TFL_INVALID )
+		{
+			ChangeRoutingTableState( i, 1 );
+		}
+	}
+	
+	numRoutingTableHits = 0;
+	numRoutingCacheUpdates = 0;
+	
+	routingTables.SetNum( file->GetNumRoutingTables() );
+	for( i = 0; i < routingTables.Num(); i++ )
+	{
+		routingTables[i].table = &file->GetRoutingTable( i );
+		routingTables[i].areaCache = ( idRoutingCache** ) Mem_ClearedAlloc( offset * sizeof( idRoutingCache* ), TAG_AAS );
+		routingTables[i].portalCache = ( idRoutingCache** ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( idRoutingCache* ), TAG_AAS );
+		routingTables[i].portalCacheCheck = ( int* ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( int ), TAG_AAS );
+	}
+}
+
+/*
+============
+idAASLocal::ShutdownRoutingTables
+============
+*/
+void idAASLocal::ShutdownRoutingTables()
+{
+	int i, j;
+	
+	for( i = 0; i < routingTables.Num(); i++ )
+	{
+		for( j = 0; j < clusterAreaOffset[clusterAreaOffset.Num() - 1]; j++ )
+		{
+			delete routingTables[i].areaCache[j];
+		}
+		for( j = 0; j < file->GetNumAreas(); j++ )
+		{
+			delete routingTables[i].portalCache[j];
+		}
+		Mem_Free( routingTables[i].areaCache );
+		Mem_Free( routingTables[i].portalCache );
+		Mem_Free( routingTables[i].portalCacheCheck );
+	}
+	routingTables.Clear();
+	clusterAreaOffset.Clear();
+	clusterChanges.Clear();
+	numRoutingChanges = 0;
+}
+
+/*
+============
+idAASLocal::ChangeRoutingTableState
+
+  keeps track of the number of disabled areas and reachabilities in each cluster
+============
+*/
+void idAASLocal::ChangeRoutingTableState( int areaNum, int change )
+{
+	int clusterNum;
+	
+	if( clusterChanges.Num() == 0 )
+	{
+		return;
+	}
+	
+	clusterNum = file->GetArea( areaNum ).cluster;
+	if( clusterNum > 0 )
+	{
+		clusterChanges[clusterNum] += change;
+	}
+	else if( clusterNum < 0 )
+	{
+		// a portal is part of both the front and back cluster
+		clusterChanges[file->GetPortal( -clusterNum ).clusters[0]] += change;
+		clusterChanges[file->GetPortal( -clusterNum ).clusters[1]] += change;
+	}
+	numRoutingChanges += change;
+	routingChangeSerial++;
+}
+
+/*
+============
+idAASLocal::RoutingTablesMemory
+============
+*/
+int idAASLocal::RoutingTablesMemory() const
+{
+	int i, size;
+	
+	size = 0;
+	for( i = 0; i < routingTables.Num(); i++ )
+	{
+		const aasRoutingTable_t* table = routingTables[i].table;
+		size += table->areaTravelTimes.Size() + table->areaReachabilities.Size();
+		size += table->portalTravelTimes.Size() + table->portalReachabilities.Size();
+	}
+	return size;
+}
+
+/*
+============
+idAASLocal::GetRoutingTableAreaCache
+============
+*/
+idRoutingCache* idAASLocal::GetRoutingTableAreaCache( int clusterNum, int clusterAreaNum, int travelFlags ) const
+{
+	int i, numReachableAreas, offset;
+	
+	if( !aas_useRoutingTables.GetBool() || clusterChanges[clusterNum] != 0 )
+	{
+		return NULL;
+	}
+	
+	numReachableAreas = file->GetCluster( clusterNum ).numReachableAreas;
+	if( clusterAreaNum >= numReachableAreas )
+	{
+		return NULL;
+	}
+	
+	for( i = 0; i < routingTables.Num(); i++ )
+	{
+		const idRoutingTable& routingTable = routingTables[i];
+		
+		if( routingTable.table->travelFlags != travelFlags || routingTable.table->areaTravelTimes.Num() == 0 )
+		{
+			continue;
+		}
+		
+		idRoutingCache*& cache = routingTable.areaCache[clusterAreaOffset[clusterNum] + clusterAreaNum];
+		if( !cache )
+		{
+			// the area cache of all clusters is stored one after the other, each a square with a row per goal area
+			offset = 0;
+			for( int j = 0; j < clusterNum; j++ )
+			{
+				offset += file->GetCluster( j ).numReachableAreas * file->GetCluster( j ).numReachableAreas;
+			}
+			offset += clusterAreaNum * numReachableAreas;
+			
+			cache = new( TAG_AAS ) idRoutingCache( numReachableAreas,
+												   const_cast<unsigned short*>( routingTable.table->areaTravelTimes.Ptr() + offset ),
+												   const_cast<byte*>( routingTable.table->areaReachabilities.Ptr() + offset ) );
+			cache->type = CACHETYPE_AREA;
+			cache->cluster = clusterNum;
+			cache->startTravelTime = 1;
+			cache->travelFlags = travelFlags;
+		}
+		numRoutingTableHits++;
+		return cache;
+	}
+	return NULL;
+}
+
+/*
+============
+idAASLocal::GetRoutingTablePortalCache
+============
+*/
+idRoutingCache* idAASLocal::GetRoutingTablePortalCache( int areaNum, int travelFlags ) const
+{
+	int i;
+	
+	if( !aas_useRoutingTables.GetBool() )
+	{
+		return NULL;
+	}
+	
+	// the tables only store the routing towards reachable goal areas
+	if( !( file->GetArea( areaNum ).flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) ) )
+	{
+		return NULL;
+	}
+	
+	for( i = 0; i < routingTables.Num(); i++ )
+	{
+		const idRoutingTable& routingTable = routingTables[i];
+		
+		if( routingTable.table->travelFlags != travelFlags || routingTable.table->portalTravelTimes.Num() == 0 )
+		{
+			continue;
+		}
+		
+		idRoutingCache*& cache = routingTable.portalCache[areaNum];
+		if( !cache )
+		{
+			const int offset = areaNum * file->GetNumPortals();
+			cache = new( TAG_AAS ) idRoutingCache( file->GetNumPortals(),
+												   const_cast<unsigned short*>( routingTable.table->portalTravelTimes.Ptr() + offset ),
+												   const_cast<byte*>( routingTable.table->portalReachabilities.Ptr() + offset ) );
+			cache->type = CACHETYPE_PORTAL;
+			cache->areaNum = areaNum;
+			cache->startTravelTime = 1;
+			cache->travelFlags = travelFlags;
+		}
+		if( !IsRoutingTablePortalCacheValid( routingTable, areaNum ) )
+		{
+			return NULL;
+		}
+		numRoutingTableHits++;
+		return cache;
+	}
+	return NULL;
+}
+
+/*
+============
+idAASLocal::IsAreaInCluster
+
+  portal areas are part of both the front and back cluster
+============
+*/
+bool idAASLocal::IsAreaInCluster( int areaNum, int clusterNum ) const
+{
+	int areaClusterNum;
+	
+	areaClusterNum = file->GetArea( areaNum ).cluster;
+	if( areaClusterNum < 0 )
+	{
+		const aasPortal_t& portal = file->GetPortal( -areaClusterNum );
+		return ( portal.clusters[0] == clusterNum || portal.clusters[1] == clusterNum );
+	}
+	return ( areaClusterNum == clusterNum );
+}
+
+/*
+============
+idAASLocal::IsRoutingTablePortalCacheValid
+
+  The portal cache of a goal area is a tree of routes, the route from a portal
+  continues along the routes of the portals it passes. A route passes through a
+  cluster only if it leaves one of the portals of the cluster into the cluster,
+  so the cache is valid as long as the goal area is not in a changed cluster and
+  none of the portals of a changed cluster lead into that cluster.
+============
+*/
+bool idAASLocal::IsRoutingTablePortalCacheValid( const idRoutingTable& routingTable, int areaNum ) const
+{
+	int i, j, portalNum;
+	const idRoutingCache* cache;
+	const idReachability* reach;
+	bool valid;
+	
+	if( numRoutingChanges == 0 )
+	{
+		return true;
+	}
+	
+	int& check = routingTable.portalCacheCheck[areaNum];
+	if( abs( check ) == routingChangeSerial )
+	{
+		return ( check > 0 );
+	}
+	
+	cache = routingTable.portalCache[areaNum];
+	valid = true;
+	for( i = 0; i < clusterChanges.Num() && valid; i++ )
+	{
+		if( clusterChanges[i] == 0 )
+		{
+			continue;
+		}
+		if( IsAreaInCluster( areaNum, i ) )
+		{
+			valid = false;
+			break;
+		}
+		const aasCluster_t& cluster = file->GetCluster( i );
+		for( j = 0; j < cluster.numPortals; j++ )
+		{
+			portalNum = file->GetPortalIndex( cluster.firstPortal + j );
+			if( cache->travelTimes[portalNum] == 0 )
+			{
+				continue;
+			}
+			reach = GetAreaReachability( file->GetPortal( portalNum ).areaNum, cache->reachabilities[portalNum] );
+			if( reach != NULL && IsAreaInCluster( reach->toAreaNum, i ) )
+			{
+				valid = false;
+				break;
+			}
+		}
+	}
+	
+	check = valid ? routingChangeSerial : -routingChangeSerial;
+	return valid;
+}
+
+/*
+============
+idAASLocal::CalculateRoutingTable
+============
+*/
+void idAASLocal::CalculateRoutingTable( aasRoutingTable_t& table, int travelFlags )
+{
+	int i, j, side, numEntries, offset, numReachableAreas;
+	idList<int> clusterAreas;
+	idList<unsigned short, TAG_AAS> portalTravelTimes;
+	idList<byte, TAG_AAS> portalReachabilities;
+	
+	table.travelFlags = travelFlags;
+	
+	// map the areas of each cluster to area numbers, portals are part of two clusters
+	clusterAreas.AssureSize( clusterAreaOffset[clusterAreaOffset.Num() - 1], 0 );
+	for( i = 1; i < file->GetNumAreas(); i++ )
+	{
+		const aasArea_t& area = file->GetArea( i );
+		if( area.cluster > 0 )
+		{
+			if( area.clusterAreaNum < file->GetCluster( area.cluster ).numReachableAreas )
+			{
+				clusterAreas[clusterAreaOffset[area.cluster] + area.clusterAreaNum] = i;
+			}
+		}
+		else if( area.cluster < 0 )
+		{
+			const aasPortal_t& portal = file->GetPortal( -area.cluster );
+			for( side = 0; side < 2; side++ )
+			{
+				if( portal.clusterAreaNum[side] < file->GetCluster( portal.clusters[side] ).numReachableAreas )
+				{
+					clusterAreas[clusterAreaOffset[portal.clusters[side]] + portal.clusterAreaNum[side]] = i;
+				}
+			}
+		}
+	}
+	
+	// flood every cluster from each of its areas
+	numEntries = 0;
+	for( i = 0; i < file->GetNumClusters(); i++ )
+	{
+		numEntries += file->GetCluster( i ).numReachableAreas * file->GetCluster( i ).numReachableAreas;
+	}
+	table.areaTravelTimes.SetNum( numEntries );
+	table.areaReachabilities.SetNum( numEntries );
+	
+	offset = 0;
+	for( i = 0; i < file->GetNumClusters(); i++ )
+	{
+		numReachableAreas = file->GetCluster( i ).numReachableAreas;
+		for( j = 0; j < numReachableAreas; j++ )
+		{
+			idRoutingCache cache( numReachableAreas );
+			cache.type = CACHETYPE_AREA;
+			cache.cluster = i;
+			cache.areaNum = clusterAreas[clusterAreaOffset[i] + j];
+			cache.startTravelTime = 1;
+			cache.travelFlags = travelFlags;
+			UpdateAreaRoutingCache( &cache );
+			
+			memcpy( table.areaTravelTimes.Ptr() + offset, cache.travelTimes, numReachableAreas * sizeof( cache.travelTimes[0] ) );
+			memcpy( table.areaReachabilities.Ptr() + offset, cache.reachabilities, numReachableAreas * sizeof( cache.reachabilities[0] ) );
+			offset += numReachableAreas;
+		}
+		common->UpdateLevelLoadPacifier();
+	}
+	assert( offset == numEntries );
+	
+	// install the area routing so the portal floods below read it instead of flooding the clusters again
+	idRoutingTable& routingTable = routingTables.Alloc();
+	routingTable.table = &table;
+	routingTable.areaCache = ( idRoutingCache** ) Mem_ClearedAlloc( clusterAreas.Num() * sizeof( idRoutingCache* ), TAG_AAS );
+	routingTable.portalCache = ( idRoutingCache** ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( idRoutingCache* ), TAG_AAS );
+	routingTable.portalCacheCheck = ( int* ) Mem_ClearedAlloc( file->GetNumAreas() * sizeof( int ), TAG_AAS );
+	
+	// flood the portals towards every reachable goal area
+	portalTravelTimes.SetNum( file->GetNumAreas() * file->GetNumPortals() );
+	portalReachabilities.SetNum( portalTravelTimes.Num() );
+	memset( portalTravelTimes.Ptr(), 0, portalTravelTimes.Size() );
+	memset( portalReachabilities.Ptr(), 0, portalReachabilities.Size() );
+	
+	for( i = 1; i < file->GetNumAreas(); i++ )
+	{
+		const aasArea_t& area = file->GetArea( i );
+		if( !( area.flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) ) )
+		{
+			continue;
+		}
+		
+		idRoutingCache cache( file->GetNumPortals() );
+		cache.type = CACHETYPE_PORTAL;
+		cache.cluster = ( area.cluster > 0 ) ? area.cluster : file->GetPortal( -area.cluster ).clusters[0];
+		cache.areaNum = i;
+		cache.startTravelTime = 1;
+		cache.travelFlags = travelFlags;
+		UpdatePortalRoutingCache( &cache );
+		
+		memcpy( portalTravelTimes.Ptr() + i * file->GetNumPortals(), cache.travelTimes, file->GetNumPortals() * sizeof( cache.travelTimes[0] ) );
+		memcpy( portalReachabilities.Ptr() + i * file->GetNumPortals(), cache.reachabilities, file->GetNumPortals() * sizeof( cache.reachabilities[0] ) );
+		
+		// the floods may have created caches for clusters that changed
+		while( totalCacheMemory > MAX_ROUTING_CACHE_MEMORY )
+		{
+			DeleteOldestCache();
+		}
+		
+		if( ( i & 255 ) == 0 )
+		{
+			common->UpdateLevelLoadPacifier();
+		}
+	}
+	
+	table.portalTravelTimes = portalTravelTimes;
+	table.portalReachabilities = portalReachabilities;
+}
+
+/*
+============
+idAASLocal::BuildRoutingTables
+============
+*/
+bool idAASLocal::BuildRoutingTables( const int* travelFlags, int numTravelFlags )
+{
+	int i;
+	idList<int> disabledAreas;
+	idList<aasRoutingTable_t> tables;
+	
+	if( !file )
+	{
+		return false;
+	}
+	
+	if( obstacleList.Num() )
+	{
+		gameLocal.Warning( "cannot build the routing tables for '%s' while there are routing obstacles", file->GetName() );
+		return false;
+	}
+	
+	int startTime = Sys_Milliseconds();
+	
+	// build the routing with all areas enabled, closed doors may have disabled cluster portals
+	for( i = 1; i < file->GetNumAreas(); i++ )
+	{
+		if( file->GetArea( i ).travelFlags & TFL_INVALID )
+		{
+			disabledAreas.Append( i );
+			EnableArea( i );
+		}
+	}
+	
+	// the tables are calculated from scratch, without using previously stored tables
+	ShutdownRoutingTables();
+	file->ClearRoutingTables();
+	SetupRoutingTables();
+	
+	tables.SetNum( numTravelFlags );
+	for( i = 0; i < numTravelFlags; i++ )
+	{
+		CalculateRoutingTable( tables[i], travelFlags[i] );
+	}
+	
+	ShutdownRoutingTables();
+	for( i = 0; i < tables.Num(); i++ )
+	{
+		file->AddRoutingTable( tables[i] );
+	}
+	SetupRoutingTables();
+	
+	for( i = 0; i < disabledAreas.Num(); i++ )
+	{
+		DisableArea( disabledAreas[i] );
+	}
+	
+	gameLocal.Printf( "calculated %d routing tables (%d KB) in %d msec\n", routingTables.Num(), RoutingTablesMemory() >> 10, Sys_Milliseconds() - startTime );
+	
+	return file->Write( file->GetName(), file->GetCRC() );
+}
+
+/*
+============
+idAASLocal::RoutingBenchmark
+============
+*/
+void idAASLocal::RoutingBenchmark( int numQueries, int travelFlags )
+{
+	int i, pass, travelTime, numRoutes;
+	idReachability* reach;
+	idList<int> areas;
+	
+	if( !file )
+	{
+		return;
+	}
+	
+	for( i = 1; i < file->GetNumAreas(); i++ )
+	{
+		if( file->GetArea( i ).flags & ( AREA_REACHABLE_WALK | AREA_REACHABLE_FLY ) )
+		{
+			areas.Append( i );
+		}
+	}
+	if( areas.Num() < 2 )
+	{
+		return;
+	}
+	
+	const bool useRoutingTables = aas_useRoutingTables.GetBool();
+	
+	for( pass = 0; pass < 2; pass++ )
+	{
+		aas_useRoutingTables.SetBool( pass != 0 );
+		
+		// start each pass with an empty routing cache
+		while( cacheListStart )
+		{
+			DeleteOldestCache();
+		}
+		numRoutingTableHits = 0;
+		numRoutingCacheUpdates = 0;
+		
+		idRandom random( 0 );
+		int maxCacheMemory = 0;
+		numRoutes = 0;
+		
+		uint64 startTime = Sys_Microseconds();
+		for( i = 0; i < numQueries; i++ )
+		{
+			int areaNum = areas[random.RandomInt( areas.Num() )];
+			int goalAreaNum = areas[random.RandomInt( areas.Num() )];
+			if( RouteToGoalArea( areaNum, file->GetArea( areaNum ).center, goalAreaNum, travelFlags, travelTime, &reach ) )
+			{
+				numRoutes++;
+			}
+			maxCacheMemory = Max( maxCacheMemory, totalCacheMemory );
+		}
+		uint64 endTime = Sys_Microseconds();
+		
+		const float seconds = Max( 1.0f, ( float )( endTime - startTime ) ) * 1e-6f;
+		gameLocal.Printf( "%s: %d queries, %d routes, %.0f queries/sec, %d cache updates, %d table hits, %d KB max cache, %d KB tables\n",
+						  pass ? "precomputed" : "dynamic", numQueries, numRoutes, numQueries / seconds, numRoutingCacheUpdates, numRoutingTableHits,
+						  maxCacheMemory >> 10, pass ? RoutingTablesMemory() >> 10 : 0 );
+	}
+	
+	aas_useRoutingTables.SetBool( useRoutingTables );
+}
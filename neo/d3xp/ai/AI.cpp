@@ -303,6 +303,7 @@ idAI::idAI()
 {
 	aas					= NULL;
 	travelFlags			= TFL_WALK | TFL_AIR;
+	memset( &obstacleCache, 0, sizeof( obstacleCache ) );
 	
 	kickForce			= 2048.0f;
 	ignore_obstacles	= false;
@@ -2942,7 +2943,7 @@ void idAI::CheckObstacleAvoidance( const idVec3& goalPos, idVec3& newPos )
 	
 	obstacle = NULL;
 	AI_OBSTACLE_IN_PATH = false;
-	foundPath = FindPathAroundObstacles( &physicsObj, aas, enemy.GetEntity(), origin, goalPos, path );
+	foundPath = FindPathAroundObstacles( &physicsObj, aas, enemy.GetEntity(), origin, goalPos, path, &obstacleCache );
 	if( ai_showObstacleAvoidance.GetBool() )
 	{
 		gameRenderWorld->DebugLine( colorBlue, goalPos + idVec3( 1.0f, 1.0f, 0.0f ), goalPos + idVec3( 1.0f, 1.0f, 64.0f ), 1 );
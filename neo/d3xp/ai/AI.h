@@ -130,6 +130,17 @@ typedef struct obstaclePath_s
 	idEntity* 			seekPosObstacle;			// if != NULL the obstacle containing the seek position
 } obstaclePath_t;
 
+// obstacle avoidance result that can be reused while nothing changes
+typedef struct obstaclePathCache_s
+{
+	bool				valid;						// true if the path was stored
+	bool				foundPath;					// result of the obstacle avoidance
+	idVec3				startPos;					// start position the path was found for
+	idVec3				seekPos;					// seek position the path was found for
+	unsigned int		obstacleCRC;				// checksum of the obstacles the path was found with
+	obstaclePath_t		path;						// path around the obstacles
+} obstaclePathCache_t;
+
 // path prediction
 typedef enum
 {
@@ -293,7 +304,7 @@ public:
 	static void				List_f( const idCmdArgs& args );
 	
 	// Finds a path around dynamic obstacles.
-	static bool				FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas, const idEntity* ignore, const idVec3& startPos, const idVec3& seekPos, obstaclePath_t& path );
+	static bool				FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas, const idEntity* ignore, const idVec3& startPos, const idVec3& seekPos, obstaclePath_t& path, obstaclePathCache_t* cache = NULL );
 	// Frees any nodes used for the dynamic obstacle avoidance.
 	static void				FreeObstacleAvoidanceNodes();
 	// Predicts movement, returns true if a stop event was triggered.
@@ -313,6 +324,8 @@ protected:
 	idMoveState				move;
 	idMoveState				savedMove;
 	
+	obstaclePathCache_t		obstacleCache;		// last obstacle avoidance path
+	
 	float					kickForce;
 	bool					ignore_obstacles;
 	float					blockedRadius;
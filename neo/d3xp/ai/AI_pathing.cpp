@@ -94,6 +94,268 @@ void pathNode_s::Init()
 idBlockAlloc<pathNode_t, 128>	pathNodeAllocator;
 
 
+/*
+===============================================================================
+
+	Obstacle Grid
+
+	The clip models of the actors and moveables are hashed into a grid on the
+	floor plane once per frame so the obstacle avoidance of all AI does not
+	have to go through the clip sectors. The grid only stores which clip
+	models are near a cell, the current bounds are tested when the grid is
+	queried. Entities spawned during the frame are added in the next frame.
+
+===============================================================================
+*/
+
+const float OBSTACLE_GRID_CELL_SIZE		= 128.0f;
+const float OBSTACLE_GRID_MARGIN		= 64.0f;		// room for obstacles that move during the frame
+
+typedef struct gridObstacle_s
+{
+	idEntityPtr<idEntity>	entity;
+	int					clipModelNum;
+	int					queryNum;
+} gridObstacle_t;
+
+typedef struct gridCell_s
+{
+	int					x, y;
+	int					obstacle;
+} gridCell_t;
+
+class idObstacleGrid
+{
+public:
+	idObstacleGrid();
+	
+	void				Clear();
+	int					ClipModelsTouchingBounds( const idBounds& bounds, int contentMask, idClipModel** clipModelList, int maxCount );
+	
+private:
+	int					frameNum;
+	int					frameTime;
+	int					queryNum;
+	idList<gridObstacle_t>	obstacles;
+	idList<gridCell_t>	cells;
+	idHashIndex			cellHash;
+	
+	void				Build();
+	void				TestObstacle( gridObstacle_t& obstacle, const idBounds& bounds, int contentMask, idClipModel** clipModelList, int maxCount, int& count );
+	static int			CellKey( int x, int y );
+	static int			CellNum( float f );
+};
+
+idObstacleGrid			obstacleGrid;
+
+// obstacle avoidance statistics
+typedef struct obstacleStats_s
+{
+	int					frameNum;
+	int					numQueries;
+	int					numReused;
+	int					numObstacles;
+	uint64				time;
+} obstacleStats_t;
+
+static obstacleStats_t	obstacleStats;
+
+/*
+============
+idObstacleGrid::idObstacleGrid
+============
+*/
+idObstacleGrid::idObstacleGrid()
+{
+	frameNum = -1;
+	frameTime = -1;
+	queryNum = 0;
+}
+
+/*
+============
+idObstacleGrid::Clear
+============
+*/
+void idObstacleGrid::Clear()
+{
+	frameNum = -1;
+	frameTime = -1;
+	obstacles.Clear();
+	cells.Clear();
+	cellHash.Free();
+}
+
+/*
+============
+idObstacleGrid::CellKey
+============
+*/
+int idObstacleGrid::CellKey( int x, int y )
+{
+	return ( x * 73856093 ) ^ ( y * 19349663 );
+}
+
+/*
+============
+idObstacleGrid::CellNum
+============
+*/
+int idObstacleGrid::CellNum( float f )
+{
+	return idMath::Ftoi( idMath::Floor( f * ( 1.0f / OBSTACLE_GRID_CELL_SIZE ) ) );
+}
+
+/*
+============
+idObstacleGrid::Build
+============
+*/
+void idObstacleGrid::Build()
+{
+	int i, x, y;
+	idEntity* ent;
+	idPhysics* physics;
+	idClipModel* clipModel;
+	idBounds bounds;
+	
+	frameNum = gameLocal.framenum;
+	frameTime = gameLocal.time;
+	obstacles.SetNum( 0 );
+	cells.SetNum( 0 );
+	cellHash.Clear();
+	
+	for( ent = gameLocal.spawnedEntities.Next(); ent != NULL; ent = ent->spawnNode.Next() )
+	{
+		// only actors and moveables are considered obstacles
+		if( !ent->IsType( idActor::Type ) && !ent->IsType( idMoveable::Type ) )
+		{
+			continue;
+		}
+		
+		physics = ent->GetPhysics();
+		for( i = 0; i < physics->GetNumClipModels(); i++ )
+		{
+			clipModel = physics->GetClipModel( i );
+			if( !clipModel || !clipModel->IsLinked() || !clipModel->IsTraceModel() )
+			{
+				continue;
+			}
+			
+			gridObstacle_t& obstacle = obstacles.Alloc();
+			obstacle.entity = ent;
+			obstacle.clipModelNum = i;
+			obstacle.queryNum = queryNum;
+			
+			bounds = clipModel->GetAbsBounds().Expand( OBSTACLE_GRID_MARGIN );
+			for( x = CellNum( bounds[0].x ); x <= CellNum( bounds[1].x ); x++ )
+			{
+				for( y = CellNum( bounds[0].y ); y <= CellNum( bounds[1].y ); y++ )
+				{
+					gridCell_t& cell = cells.Alloc();
+					cell.x = x;
+					cell.y = y;
+					cell.obstacle = obstacles.Num() - 1;
+					cellHash.Add( CellKey( x, y ), cells.Num() - 1 );
+				}
+			}
+		}
+	}
+}
+
+/*
+============
+idObstacleGrid::TestObstacle
+============
+*/
+void idObstacleGrid::TestObstacle( gridObstacle_t& obstacle, const idBounds& bounds, int contentMask, idClipModel** clipModelList, int maxCount, int& count )
+{
+	idEntity* ent;
+	idClipModel* clipModel;
+	
+	// avoid duplicates in the list
+	if( obstacle.queryNum == queryNum )
+	{
+		return;
+	}
+	obstacle.queryNum = queryNum;
+	
+	ent = obstacle.entity.GetEntity();
+	if( !ent || obstacle.clipModelNum >= ent->GetPhysics()->GetNumClipModels() )
+	{
+		return;
+	}
+	clipModel = ent->GetPhysics()->GetClipModel( obstacle.clipModelNum );
+	if( !clipModel || !clipModel->IsLinked() || !clipModel->IsEnabled() )
+	{
+		return;
+	}
+	if( !( clipModel->GetContents() & contentMask ) )
+	{
+		return;
+	}
+	if( !clipModel->GetAbsBounds().IntersectsBounds( bounds ) )
+	{
+		return;
+	}
+	if( count < maxCount )
+	{
+		clipModelList[count++] = clipModel;
+	}
+}
+
+/*
+============
+idObstacleGrid::ClipModelsTouchingBounds
+============
+*/
+int idObstacleGrid::ClipModelsTouchingBounds( const idBounds& bounds, int contentMask, idClipModel** clipModelList, int maxCount )
+{
+	int i, x, y, x0, y0, x1, y1, count;
+	idBounds testBounds;
+	
+	if( frameNum != gameLocal.framenum || frameTime != gameLocal.time )
+	{
+		Build();
+	}
+	
+	queryNum++;
+	count = 0;
+	
+	testBounds = bounds.Expand( CM_BOX_EPSILON );
+	
+	x0 = CellNum( testBounds[0].x );
+	y0 = CellNum( testBounds[0].y );
+	x1 = CellNum( testBounds[1].x );
+	y1 = CellNum( testBounds[1].y );
+	
+	// if the bounds cover more cells than there are obstacles just test all of them
+	if( ( x1 - x0 + 1 ) * ( y1 - y0 + 1 ) > obstacles.Num() )
+	{
+		for( i = 0; i < obstacles.Num(); i++ )
+		{
+			TestObstacle( obstacles[i], testBounds, contentMask, clipModelList, maxCount, count );
+		}
+		return count;
+	}
+	
+	for( x = x0; x <= x1; x++ )
+	{
+		for( y = y0; y <= y1; y++ )
+		{
+			for( i = cellHash.First( CellKey( x, y ) ); i != -1; i = cellHash.Next( i ) )
+			{
+				if( cells[i].x == x && cells[i].y == y )
+				{
+					TestObstacle( obstacles[cells[i].obstacle], testBounds, contentMask, clipModelList, maxCount, count );
+				}
+			}
+		}
+	}
+	return count;
+}
+
+
 /*
 ============
 LineIntersectsPath
@@ -378,7 +640,14 @@ int GetObstacles( const idPhysics* physics, const idAAS* aas, const idEntity* ig
 	clipMask = physics->GetClipMask();
 	
 	// find all obstacles touching the clip bounds
-	numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	if( ai_obstacleGrid.GetBool() )
+	{
+		numListedClipModels = obstacleGrid.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	}
+	else
+	{
+		numListedClipModels = gameLocal.clip.ClipModelsTouchingBounds( clipBounds, clipMask, clipModelList, MAX_GENTITIES );
+	}
 	
 	for( i = 0; i < numListedClipModels && numObstacles < MAX_OBSTACLES; i++ )
 	{
@@ -1089,15 +1358,29 @@ idAI::FindPathAroundObstacles
   Finds a path around dynamic obstacles using a path tree with clockwise and counter clockwise edge walks.
 ============
 */
-bool idAI::FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas, const idEntity* ignore, const idVec3& startPos, const idVec3& seekPos, obstaclePath_t& path )
+bool idAI::FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas, const idEntity* ignore, const idVec3& startPos, const idVec3& seekPos, obstaclePath_t& path, obstaclePathCache_t* cache )
 {
-	int numObstacles, areaNum, insideObstacle;
+	int i, numObstacles, areaNum, insideObstacle;
+	unsigned int obstacleCRC;
 	obstacle_t obstacles[MAX_OBSTACLES];
 	idBounds clipBounds;
 	idBounds bounds;
 	pathNode_t* root;
 	bool pathToGoalExists;
 	
+	if( obstacleStats.frameNum != gameLocal.framenum )
+	{
+		if( ai_showObstacleStats.GetBool() && obstacleStats.numQueries )
+		{
+			gameLocal.Printf( "%d: obstacle avoidance: %d queries, %d paths reused, %d obstacles, %d usec\n", obstacleStats.frameNum,
+							  obstacleStats.numQueries, obstacleStats.numReused, obstacleStats.numObstacles, ( int ) obstacleStats.time );
+		}
+		memset( &obstacleStats, 0, sizeof( obstacleStats ) );
+		obstacleStats.frameNum = gameLocal.framenum;
+	}
+	obstacleStats.numQueries++;
+	uint64 startTime = Sys_Microseconds();
+	
 	path.seekPos = seekPos;
 	path.firstObstacle = NULL;
 	path.startPosOutsideObstacles = startPos;
@@ -1120,6 +1403,30 @@ bool idAI::FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas,
 	
 	// get all the nearby obstacles
 	numObstacles = GetObstacles( physics, aas, ignore, areaNum, path.startPosOutsideObstacles, path.seekPosOutsideObstacles, obstacles, MAX_OBSTACLES, clipBounds );
+	obstacleStats.numObstacles += numObstacles;
+	
+	// reuse the previous path if the obstacles and the seek position did not change and the AI did not move far
+	if( cache && ai_obstaclePathReuse.GetFloat() > 0.0f )
+	{
+		CRC32_InitChecksum( obstacleCRC );
+		for( i = 0; i < numObstacles; i++ )
+		{
+			CRC32_UpdateChecksum( obstacleCRC, &obstacles[i].entity, sizeof( obstacles[i].entity ) );
+			CRC32_UpdateChecksum( obstacleCRC, &obstacles[i].winding[0], obstacles[i].winding.GetNumPoints() * sizeof( idVec2 ) );
+		}
+		CRC32_FinishChecksum( obstacleCRC );
+		
+		if( cache->valid && cache->obstacleCRC == obstacleCRC && cache->seekPos.Compare( seekPos, 1.0f ) &&
+				( cache->startPos - startPos ).LengthSqr() < Square( ai_obstaclePathReuse.GetFloat() ) )
+		{
+			path = cache->path;
+			obstacleStats.numReused++;
+			obstacleStats.time += Sys_Microseconds() - startTime;
+			return cache->foundPath;
+		}
+		cache->valid = false;
+		cache->obstacleCRC = obstacleCRC;
+	}
 	
 	// get a source position outside the obstacles
 	GetPointOutsideObstacles( obstacles, numObstacles, path.startPosOutsideObstacles.ToVec2(), &insideObstacle, NULL );
@@ -1140,6 +1447,7 @@ bool idAI::FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas,
 	{
 		if( ( seekPos.ToVec2() - startPos.ToVec2() ).LengthSqr() > Square( 2.0f ) )
 		{
+			obstacleStats.time += Sys_Microseconds() - startTime;
 			return false;
 		}
 	}
@@ -1162,6 +1470,17 @@ bool idAI::FindPathAroundObstacles( const idPhysics* physics, const idAAS* aas,
 	// free the tree
 	FreePathTree_r( root );
 	
+	if( cache && ai_obstaclePathReuse.GetFloat() > 0.0f )
+	{
+		cache->valid = true;
+		cache->foundPath = pathToGoalExists;
+		cache->startPos = startPos;
+		cache->seekPos = seekPos;
+		cache->path = path;
+	}
+	
+	obstacleStats.time += Sys_Microseconds() - startTime;
+	
 	return pathToGoalExists;
 }
 
@@ -1173,6 +1492,7 @@ idAI::FreeObstacleAvoidanceNodes
 void idAI::FreeObstacleAvoidanceNodes()
 {
 	pathNodeAllocator.Shutdown();
+	obstacleGrid.Clear();
 }
 
 
@@ -33,11 +33,17 @@ If you have questions concerning this license or the applicable additional terms
 #include "../Game_local.h"
 
 idCVar binaryLoadAnim( "binaryLoadAnim", "1", 0, "enable binary load/write of idMD5Anim" );
+idCVar anim_compress( "anim_compress", "0", CVAR_BOOL, "quantize anims and drop the frames that can be interpolated from the key frames when they are loaded" );
+idCVar anim_compressTranslationError( "anim_compressTranslationError", "0.01", CVAR_FLOAT, "largest error of a compressed joint translation" );
+idCVar anim_compressRotationError( "anim_compressRotationError", "0.0002", CVAR_FLOAT, "largest error of a compressed joint quaternion component" );
 
-static const byte B_ANIM_MD5_VERSION = 101;
+static const byte B_ANIM_MD5_VERSION = 103;
+static const byte B_ANIM_MD5_VERSION_UNCOMPRESSED = 101;	// binaries written before anim compression, still loaded
+static const byte B_ANIM_MD5_VERSION_QUANTIZED = 102;		// binaries written before raw components, still loaded
 static const unsigned int B_ANIM_MD5_MAGIC = ( 'B' << 24 ) | ( 'M' << 16 ) | ( 'D' << 8 ) | B_ANIM_MD5_VERSION;
 
 static const int JOINT_FRAME_PAD	= 1;	// one extra to be able to read one more float than is necessary
+static const int MAX_KEY_FRAME_SPAN	= 32;	// most frames between two key frames of a compressed anim
 
 bool idAnimManager::forceExport = false;
 
@@ -60,6 +66,7 @@ idMD5Anim::idMD5Anim()
 	frameRate	= 24;
 	animLength	= 0;
 	numAnimatedComponents = 0;
+	compressed = false;
 	totaldelta.Zero();
 }
 
@@ -85,6 +92,7 @@ void idMD5Anim::Free()
 	frameRate	= 24;
 	animLength	= 0;
 	numAnimatedComponents = 0;
+	compressed = false;
 	//name		= "";
 	
 	totaldelta.Zero();
@@ -92,6 +100,12 @@ void idMD5Anim::Free()
 	jointInfo.Clear();
 	bounds.Clear();
 	componentFrames.Clear();
+	frameKeys.Clear();
+	keyFrames.Clear();
+	componentBias.Clear();
+	componentScale.Clear();
+	rawComponents.Clear();
+	rawKeyFrames.Clear();
 }
 
 /*
@@ -167,6 +181,8 @@ idMD5Anim::Allocated
 size_t idMD5Anim::Allocated() const
 {
 	size_t	size = bounds.Allocated() + jointInfo.Allocated() + componentFrames.Allocated() + name.Allocated();
+	size += baseFrame.Allocated() + frameKeys.Allocated() + keyFrames.Allocated() + componentBias.Allocated() + componentScale.Allocated();
+	size += rawComponents.Allocated() + rawKeyFrames.Allocated();
 	return size;
 }
 
@@ -178,9 +194,6 @@ idMD5Anim::LoadAnim
 bool idMD5Anim::LoadAnim( const char* filename )
 {
 
-	idLexer	parser( LEXFL_ALLOWPATHNAMES | LEXFL_NOSTRINGESCAPECHARS | LEXFL_NOSTRINGCONCAT );
-	idToken	token;
-	
 	idStr generatedFileName = "generated/anim/";
 	generatedFileName.AppendPath( filename );
 	generatedFileName.SetFileExtension( ".bMD5anim" );
@@ -200,6 +213,39 @@ bool idMD5Anim::LoadAnim( const char* filename )
 		return true;
 	}
 	
+	if( !ParseAnim( filename ) )
+	{
+		return false;
+	}
+	
+	if( anim_compress.GetBool() )
+	{
+		Compress();
+	}
+	
+	if( binaryLoadAnim.GetBool() )
+	{
+		idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
+		idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
+		WriteBinary( outputFile, sourceTimeStamp );
+	}
+	
+	// done
+	return true;
+}
+
+/*
+====================
+idMD5Anim::ParseAnim
+
+Loads the anim from the source text without using or writing the binary.
+====================
+*/
+bool idMD5Anim::ParseAnim( const char* filename )
+{
+	idLexer	parser( LEXFL_ALLOWPATHNAMES | LEXFL_NOSTRINGESCAPECHARS | LEXFL_NOSTRINGCONCAT );
+	idToken	token;
+	
 	if( !parser.LoadFile( filename ) )
 	{
 		return false;
@@ -394,14 +440,6 @@ bool idMD5Anim::LoadAnim( const char* filename )
 	// we don't count last frame because it would cause a 1 frame pause at the end
 	animLength = ( ( numFrames - 1 ) * 1000 + frameRate - 1 ) / frameRate;
 	
-	if( binaryLoadAnim.GetBool() )
-	{
-		idLib::Printf( "Writing %s\n", generatedFileName.c_str() );
-		idFileLocal outputFile( fileSystem->OpenFileWrite( generatedFileName, "fs_basepath" ) );
-		WriteBinary( outputFile, sourceTimeStamp );
-	}
-	
-	// done
 	return true;
 }
 
@@ -420,7 +458,8 @@ bool idMD5Anim::LoadBinary( idFile* file, ID_TIME_T sourceTimeStamp )
 	
 	unsigned int magic = 0;
 	file->ReadBig( magic );
-	if( magic != B_ANIM_MD5_MAGIC )
+	const byte version = magic & 0xFF;
+	if( ( magic & ~0xFF ) != ( B_ANIM_MD5_MAGIC & ~0xFF ) || version < B_ANIM_MD5_VERSION_UNCOMPRESSED || version > B_ANIM_MD5_VERSION )
 	{
 		return false;
 	}
@@ -483,11 +522,58 @@ bool idMD5Anim::LoadBinary( idFile* file, ID_TIME_T sourceTimeStamp )
 		j.w = 0.0f;
 	}
 	
+	// older binaries don't have the flag and are never compressed
+	compressed = false;
+	if( version > B_ANIM_MD5_VERSION_UNCOMPRESSED )
+	{
+		file->ReadBig( compressed );
+	}
+	if( !fileSystem->InProductionMode() && compressed != anim_compress.GetBool() )
+	{
+		// regenerate the binary with or without compression
+		return false;
+	}
+	
 	file->ReadBig( num );
-	componentFrames.SetNum( num + JOINT_FRAME_PAD );
-	for( int i = 0; i < componentFrames.Num(); i++ )
+	if( compressed )
 	{
-		file->ReadFloat( componentFrames[i] );
+		frameKeys.SetNum( num );
+		for( int i = 0; i < num; i++ )
+		{
+			file->ReadBig( frameKeys[i].key );
+			file->ReadFloat( frameKeys[i].lerp );
+		}
+		
+		file->ReadBig( num );
+		keyFrames.SetNum( num );
+		file->ReadBigArray( keyFrames.Ptr(), num );
+		
+		componentBias.SetNum( numAnimatedComponents );
+		componentScale.SetNum( numAnimatedComponents );
+		file->ReadBigArray( componentBias.Ptr(), numAnimatedComponents );
+		file->ReadBigArray( componentScale.Ptr(), numAnimatedComponents );
+		
+		// older compressed binaries quantized every component
+		rawComponents.Clear();
+		rawKeyFrames.Clear();
+		if( version > B_ANIM_MD5_VERSION_QUANTIZED )
+		{
+			file->ReadBig( num );
+			rawComponents.SetNum( num );
+			file->ReadBigArray( rawComponents.Ptr(), num );
+			
+			file->ReadBig( num );
+			rawKeyFrames.SetNum( num );
+			file->ReadBigArray( rawKeyFrames.Ptr(), num );
+		}
+	}
+	else
+	{
+		componentFrames.SetNum( num + JOINT_FRAME_PAD );
+		for( int i = 0; i < componentFrames.Num(); i++ )
+		{
+			file->ReadFloat( componentFrames[i] );
+		}
 	}
 	
 	//file->ReadString( name );
@@ -549,10 +635,35 @@ void idMD5Anim::WriteBinary( idFile* file, ID_TIME_T sourceTimeStamp )
 		file->WriteVec3( j.t );
 	}
 	
-	file->WriteBig( componentFrames.Num() - JOINT_FRAME_PAD );
-	for( int i = 0; i < componentFrames.Num(); i++ )
+	file->WriteBig( compressed );
+	if( compressed )
 	{
-		file->WriteFloat( componentFrames[i] );
+		file->WriteBig( frameKeys.Num() );
+		for( int i = 0; i < frameKeys.Num(); i++ )
+		{
+			file->WriteBig( frameKeys[i].key );
+			file->WriteFloat( frameKeys[i].lerp );
+		}
+		
+		file->WriteBig( keyFrames.Num() );
+		file->WriteBigArray( keyFrames.Ptr(), keyFrames.Num() );
+		
+		file->WriteBigArray( componentBias.Ptr(), numAnimatedComponents );
+		file->WriteBigArray( componentScale.Ptr(), numAnimatedComponents );
+		
+		file->WriteBig( rawComponents.Num() );
+		file->WriteBigArray( rawComponents.Ptr(), rawComponents.Num() );
+		
+		file->WriteBig( rawKeyFrames.Num() );
+		file->WriteBigArray( rawKeyFrames.Ptr(), rawKeyFrames.Num() );
+	}
+	else
+	{
+		file->WriteBig( componentFrames.Num() - JOINT_FRAME_PAD );
+		for( int i = 0; i < componentFrames.Num(); i++ )
+		{
+			file->WriteFloat( componentFrames[i] );
+		}
 	}
 	
 	//file->WriteString( name );
@@ -560,6 +671,365 @@ void idMD5Anim::WriteBinary( idFile* file, ID_TIME_T sourceTimeStamp )
 	//file->WriteBig( ref_count );
 }
 
+/*
+====================
+idMD5Anim::GetFrameComponents
+
+Returns the animated components of a frame starting at firstComponent,
+compressed anims decode them into the buffer.
+====================
+*/
+const float* idMD5Anim::GetFrameComponents( int framenum, int firstComponent, int numComponents, float* buffer ) const
+{
+	if( !compressed )
+	{
+		return &componentFrames[ framenum * numAnimatedComponents + firstComponent ];
+	}
+	
+	const animFrameKey_t& frameKey = frameKeys[ framenum ];
+	const unsigned short* key1 = &keyFrames[ frameKey.key * numAnimatedComponents + firstComponent ];
+	const unsigned short* key2 = ( frameKey.lerp > 0.0f ) ? key1 + numAnimatedComponents : key1;
+	
+	SIMDProcessor->DecompressComponents( buffer, key1, key2, frameKey.lerp, &componentBias[ firstComponent ], &componentScale[ firstComponent ], numComponents );
+	
+	// the raw components decompressed to zero, interpolate their float key frames
+	const int numRawComponents = rawComponents.Num();
+	for( int i = 0; i < numRawComponents; i++ )
+	{
+		const int component = rawComponents[ i ] - firstComponent;
+		if( component < 0 )
+		{
+			continue;
+		}
+		if( component >= numComponents )
+		{
+			break;
+		}
+		const float a = rawKeyFrames[ frameKey.key * numRawComponents + i ];
+		const float b = ( frameKey.lerp > 0.0f ) ? rawKeyFrames[ ( frameKey.key + 1 ) * numRawComponents + i ] : a;
+		buffer[ component ] = a + ( b - a ) * frameKey.lerp;
+	}
+	
+	return buffer;
+}
+
+/*
+====================
+KeySpanWithinError
+
+Checks if every frame from one key frame up to and including the next can be
+interpolated from them, which also covers the quantization error of the key
+frames. Components with a zero scale are interpolated from their float values.
+====================
+*/
+static bool KeySpanWithinError( const unsigned short* quantized, const float* values, const float* bias, const float* scale, const float* tolerance, int numComponents, int key1, int key2 )
+{
+	const unsigned short* q1 = quantized + key1 * numComponents;
+	const unsigned short* q2 = quantized + key2 * numComponents;
+	const float* v1 = values + key1 * numComponents;
+	const float* v2 = values + key2 * numComponents;
+	
+	for( int frame = key1; frame <= key2; frame++ )
+	{
+		const float lerp = ( float )( frame - key1 ) / ( float )( key2 - key1 );
+		const float* v = values + frame * numComponents;
+		for( int i = 0; i < numComponents; i++ )
+		{
+			float value;
+			if( scale[i] != 0.0f )
+			{
+				const float a = q1[i];
+				const float b = q2[i];
+				value = bias[i] + scale[i] * ( a + ( b - a ) * lerp );
+			}
+			else
+			{
+				value = v1[i] + ( v2[i] - v1[i] ) * lerp;
+			}
+			if( idMath::Fabs( value - v[i] ) > tolerance[i] )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+====================
+idMD5Anim::Compress
+
+Folds the components that don't change by more than their error bound into
+the base frame, quantizes the others to 16 bits over their range and only
+keeps the key frames needed to linearly interpolate the frames in between
+within anim_compressTranslationError and anim_compressRotationError.
+Components with a range so large that the quantization step alone exceeds
+twice their error bound keep their key frames as floats.
+====================
+*/
+void idMD5Anim::Compress()
+{
+	if( compressed )
+	{
+		return;
+	}
+	
+	const float translationError = anim_compressTranslationError.GetFloat();
+	const float rotationError = anim_compressRotationError.GetFloat();
+	
+	idList<float> tolerance;
+	idList<float> minValue;
+	idList<float> maxValue;
+	
+	tolerance.SetNum( numAnimatedComponents );
+	minValue.SetNum( numAnimatedComponents );
+	maxValue.SetNum( numAnimatedComponents );
+	
+	// find the error bound and the range of every component
+	for( int i = 0; i < numJoints; i++ )
+	{
+		int component = jointInfo[ i ].firstComponent;
+		for( int bit = 0; bit < 6; bit++ )
+		{
+			if( jointInfo[ i ].animBits & BIT( bit ) )
+			{
+				tolerance[ component++ ] = ( bit < ANIM_BIT_QX ) ? translationError : rotationError;
+			}
+		}
+	}
+	
+	for( int i = 0; i < numAnimatedComponents; i++ )
+	{
+		minValue[ i ] = idMath::INFINITY;
+		maxValue[ i ] = -idMath::INFINITY;
+		for( int j = 0; j < numFrames; j++ )
+		{
+			const float value = componentFrames[ j * numAnimatedComponents + i ];
+			minValue[ i ] = Min( minValue[ i ], value );
+			maxValue[ i ] = Max( maxValue[ i ], value );
+		}
+	}
+	
+	// fold the constant components into the base frame
+	idList<int> components;
+	for( int i = 0; i < numJoints; i++ )
+	{
+		jointAnimInfo_t& info = jointInfo[ i ];
+		
+		int component = info.firstComponent;
+		int animBits = 0;
+		int firstComponent = components.Num();
+		for( int bit = 0; bit < 6; bit++ )
+		{
+			if( !( info.animBits & BIT( bit ) ) )
+			{
+				continue;
+			}
+			
+			if( maxValue[ component ] - minValue[ component ] <= 2.0f * tolerance[ component ] )
+			{
+				const float value = ( minValue[ component ] + maxValue[ component ] ) * 0.5f;
+				if( bit < ANIM_BIT_QX )
+				{
+					baseFrame[ i ].t[ bit - ANIM_BIT_TX ] = value;
+				}
+				else
+				{
+					baseFrame[ i ].q[ bit - ANIM_BIT_QX ] = value;
+				}
+			}
+			else
+			{
+				animBits |= BIT( bit );
+				components.Append( component );
+			}
+			component++;
+		}
+		
+		if( ( info.animBits & ~animBits ) & ( ANIM_QX | ANIM_QY | ANIM_QZ ) )
+		{
+			baseFrame[ i ].q.w = baseFrame[ i ].q.CalcW();
+		}
+		
+		info.animBits = animBits;
+		info.firstComponent = animBits ? firstComponent : 0;
+	}
+	
+	// quantize the remaining components over their range
+	const int numComponents = components.Num();
+	
+	idList<float> values;
+	idList<float> keyTolerance;
+	idList<unsigned short> quantized;
+	
+	values.SetNum( numFrames * numComponents );
+	keyTolerance.SetNum( numComponents );
+	quantized.SetNum( numFrames * numComponents );
+	componentBias.SetNum( numComponents );
+	componentScale.SetNum( numComponents );
+	
+	for( int i = 0; i < numComponents; i++ )
+	{
+		const int component = components[ i ];
+		
+		componentBias[ i ] = minValue[ component ];
+		componentScale[ i ] = ( maxValue[ component ] - minValue[ component ] ) / 65535.0f;
+		keyTolerance[ i ] = tolerance[ component ];
+		
+		if( componentScale[ i ] > 2.0f * keyTolerance[ i ] )
+		{
+			// rounding to the nearest step would already exceed the error bound
+			componentBias[ i ] = 0.0f;
+			componentScale[ i ] = 0.0f;
+			rawComponents.Append( i );
+		}
+		
+		for( int j = 0; j < numFrames; j++ )
+		{
+			const float value = componentFrames[ j * numAnimatedComponents + component ];
+			values[ j * numComponents + i ] = value;
+			if( componentScale[ i ] != 0.0f )
+			{
+				const int q = idMath::Ftoi( ( value - componentBias[ i ] ) / componentScale[ i ] + 0.5f );
+				quantized[ j * numComponents + i ] = ( unsigned short )idMath::ClampInt( 0, 65535, q );
+			}
+			else
+			{
+				quantized[ j * numComponents + i ] = 0;
+			}
+		}
+	}
+	
+	// pick the key frames
+	idList<int> keys;
+	keys.Append( 0 );
+	while( keys[ keys.Num() - 1 ] < numFrames - 1 )
+	{
+		const int key = keys[ keys.Num() - 1 ];
+		int next = key + 1;
+		for( int end = key + 2; ( end < numFrames ) && ( end - key <= MAX_KEY_FRAME_SPAN ); end++ )
+		{
+			if( !KeySpanWithinError( quantized.Ptr(), values.Ptr(), componentBias.Ptr(), componentScale.Ptr(), keyTolerance.Ptr(), numComponents, key, end ) )
+			{
+				break;
+			}
+			next = end;
+		}
+		keys.Append( next );
+	}
+	
+	keyFrames.SetNum( keys.Num() * numComponents );
+	for( int i = 0; i < keys.Num(); i++ )
+	{
+		memcpy( &keyFrames[ i * numComponents ], &quantized[ keys[ i ] * numComponents ], numComponents * sizeof( quantized[ 0 ] ) );
+	}
+	
+	rawKeyFrames.SetNum( keys.Num() * rawComponents.Num() );
+	for( int i = 0; i < keys.Num(); i++ )
+	{
+		for( int j = 0; j < rawComponents.Num(); j++ )
+		{
+			rawKeyFrames[ i * rawComponents.Num() + j ] = values[ keys[ i ] * numComponents + rawComponents[ j ] ];
+		}
+	}
+	
+	frameKeys.SetNum( numFrames );
+	for( int i = 0, key = 0; i < numFrames; i++ )
+	{
+		while( ( key < keys.Num() - 1 ) && ( keys[ key + 1 ] <= i ) )
+		{
+			key++;
+		}
+		frameKeys[ i ].key = key;
+		if( key < keys.Num() - 1 )
+		{
+			frameKeys[ i ].lerp = ( float )( i - keys[ key ] ) / ( float )( keys[ key + 1 ] - keys[ key ] );
+		}
+		else
+		{
+			frameKeys[ i ].lerp = 0.0f;
+		}
+	}
+	
+	componentFrames.Clear();
+	numAnimatedComponents = numComponents;
+	compressed = true;
+}
+
+/*
+====================
+idMD5Anim::IsCompressed
+====================
+*/
+bool idMD5Anim::IsCompressed() const
+{
+	return compressed;
+}
+
+/*
+====================
+idMD5Anim::CompareFrames
+
+Finds the largest difference between the joints of every frame of another
+version of the same anim, positions are compared in model space.
+====================
+*/
+void idMD5Anim::CompareFrames( const idMD5Anim& other, float& maxPosError, float& maxAngleError ) const
+{
+	maxPosError = 0.0f;
+	maxAngleError = 0.0f;
+	
+	if( ( other.numJoints != numJoints ) || ( other.numFrames != numFrames ) )
+	{
+		maxPosError = idMath::INFINITY;
+		maxAngleError = idMath::INFINITY;
+		return;
+	}
+	
+	int* index = ( int* )_alloca16( numJoints * sizeof( index[ 0 ] ) );
+	int* parents = ( int* )_alloca16( numJoints * sizeof( parents[ 0 ] ) );
+	idJointQuat* joints1 = ( idJointQuat* )_alloca16( numJoints * sizeof( joints1[ 0 ] ) );
+	idJointQuat* joints2 = ( idJointQuat* )_alloca16( numJoints * sizeof( joints2[ 0 ] ) );
+	idJointMat* mats1 = ( idJointMat* )_alloca16( numJoints * sizeof( mats1[ 0 ] ) );
+	idJointMat* mats2 = ( idJointMat* )_alloca16( numJoints * sizeof( mats2[ 0 ] ) );
+	
+	for( int i = 0; i < numJoints; i++ )
+	{
+		index[ i ] = i;
+		parents[ i ] = jointInfo[ i ].parentNum;
+	}
+	
+	for( int i = 0; i < numFrames; i++ )
+	{
+		frameBlend_t frame = { 0 };
+		frame.frame1 = i;
+		frame.frame2 = i;
+		frame.frontlerp = 1.0f;
+		frame.backlerp = 0.0f;
+		
+		GetInterpolatedFrame( frame, joints1, index, numJoints );
+		other.GetInterpolatedFrame( frame, joints2, index, numJoints );
+		
+		for( int j = 0; j < numJoints; j++ )
+		{
+			const idQuat& q1 = joints1[ j ].q;
+			const idQuat& q2 = joints2[ j ].q;
+			const float dot = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+			maxAngleError = Max( maxAngleError, RAD2DEG( 2.0f * idMath::ACos( idMath::Fabs( dot ) ) ) );
+		}
+		
+		SIMDProcessor->ConvertJointQuatsToJointMats( mats1, joints1, numJoints );
+		SIMDProcessor->ConvertJointQuatsToJointMats( mats2, joints2, numJoints );
+		SIMDProcessor->TransformJoints( mats1, parents, 1, numJoints - 1 );
+		SIMDProcessor->TransformJoints( mats2, parents, 1, numJoints - 1 );
+		
+		for( int j = 0; j < numJoints; j++ )
+		{
+			maxPosError = Max( maxPosError, ( mats1[ j ].ToVec3() - mats2[ j ].ToVec3() ).Length() );
+		}
+	}
+}
+
 /*
 ====================
 idMD5Anim::IncreaseRefs
@@ -688,8 +1158,11 @@ void idMD5Anim::GetOrigin( idVec3& offset, int time, int cyclecount ) const
 	frameBlend_t frame;
 	ConvertTimeToFrame( time, cyclecount, frame );
 	
-	const float* componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float* componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float buffer1[ 6 ];
+	float buffer2[ 6 ];
+	const int numComponents = idMath::BitCount( jointInfo[ 0 ].animBits );
+	const float* componentPtr1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+	const float* componentPtr2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 	
 	if( jointInfo[ 0 ].animBits & ANIM_TX )
 	{
@@ -734,8 +1207,11 @@ void idMD5Anim::GetOriginRotation( idQuat& rotation, int time, int cyclecount )
 	frameBlend_t frame;
 	ConvertTimeToFrame( time, cyclecount, frame );
 	
-	const float*	jointframe1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-	const float*	jointframe2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+	float			buffer1[ 6 ];
+	float			buffer2[ 6 ];
+	const int		numComponents = idMath::BitCount( animBits );
+	const float*	jointframe1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+	const float*	jointframe2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 	
 	if( animBits & ANIM_TX )
 	{
@@ -852,8 +1328,11 @@ void idMD5Anim::GetBounds( idBounds& bnds, int time, int cyclecount ) const
 	idVec3 offset = baseFrame[ 0 ].t;
 	if( jointInfo[ 0 ].animBits & ( ANIM_TX | ANIM_TY | ANIM_TZ ) )
 	{
-		const float* componentPtr1 = &componentFrames[ numAnimatedComponents * frame.frame1 + jointInfo[ 0 ].firstComponent ];
-		const float* componentPtr2 = &componentFrames[ numAnimatedComponents * frame.frame2 + jointInfo[ 0 ].firstComponent ];
+		float buffer1[ 6 ];
+		float buffer2[ 6 ];
+		const int numComponents = idMath::BitCount( jointInfo[ 0 ].animBits );
+		const float* componentPtr1 = GetFrameComponents( frame.frame1, jointInfo[ 0 ].firstComponent, numComponents, buffer1 );
+		const float* componentPtr2 = GetFrameComponents( frame.frame2, jointInfo[ 0 ].firstComponent, numComponents, buffer2 );
 		
 		if( jointInfo[ 0 ].animBits & ANIM_TX )
 		{
@@ -971,8 +1450,16 @@ void idMD5Anim::GetInterpolatedFrame( frameBlend_t& frame, idJointQuat* joints,
 	idJointQuat* blendJoints = ( idJointQuat* )_alloca16( baseFrame.Num() * sizeof( blendJoints[ 0 ] ) );
 	int* lerpIndex = ( int* )_alloca16( baseFrame.Num() * sizeof( lerpIndex[ 0 ] ) );
 	
-	const float* frame1 = &componentFrames[frame.frame1 * numAnimatedComponents];
-	const float* frame2 = &componentFrames[frame.frame2 * numAnimatedComponents];
+	float* buffer1 = NULL;
+	float* buffer2 = NULL;
+	if( compressed )
+	{
+		buffer1 = ( float* )_alloca16( ( numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( buffer1[ 0 ] ) );
+		buffer2 = ( float* )_alloca16( ( numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( buffer2[ 0 ] ) );
+	}
+	
+	const float* frame1 = GetFrameComponents( frame.frame1, 0, numAnimatedComponents, buffer1 );
+	const float* frame2 = GetFrameComponents( frame.frame2, 0, numAnimatedComponents, buffer2 );
 	
 	int numLerpJoints = DecodeInterpolatedFrames( joints, blendJoints, lerpIndex, frame1, frame2, jointInfo.Ptr(), index, numIndexes );
 	
@@ -1058,7 +1545,13 @@ void idMD5Anim::GetSingleFrame( int framenum, idJointQuat* joints, const int* in
 		return;
 	}
 	
-	const float* frame = &componentFrames[framenum * numAnimatedComponents];
+	float* buffer = NULL;
+	if( compressed )
+	{
+		buffer = ( float* )_alloca16( ( numAnimatedComponents + JOINT_FRAME_PAD ) * sizeof( buffer[ 0 ] ) );
+	}
+	
+	const float* frame = GetFrameComponents( framenum, 0, numAnimatedComponents, buffer );
 	
 	DecodeSingleFrame( joints, frame, jointInfo.Ptr(), index, numIndexes );
 }
@@ -1304,6 +1797,75 @@ void idAnimManager::ListAnims() const
 	gameLocal.Printf( "%d memory used in %d joint names\n", namesize, jointnames.Num() );
 }
 
+/*
+================
+idAnimManager::ReportCompression
+
+Compresses the source of every loaded anim and lists how much memory it
+saves and how far the joints end up from the uncompressed anim.
+================
+*/
+void idAnimManager::ReportCompression( const char* filter ) const
+{
+	int			i;
+	idMD5Anim**	animptr;
+	size_t		size;
+	size_t		compressedSize;
+	float		posError;
+	float		angleError;
+	float		maxPosError;
+	float		maxAngleError;
+	int			num;
+	
+	gameLocal.Printf( "     bytes compressed  ratio  max error  max angle : anim\n" );
+	
+	num = 0;
+	size = 0;
+	compressedSize = 0;
+	maxPosError = 0.0f;
+	maxAngleError = 0.0f;
+	for( i = 0; i < animations.Num(); i++ )
+	{
+		animptr = animations.GetIndex( i );
+		if( animptr == NULL || *animptr == NULL )
+		{
+			continue;
+		}
+		
+		const char* name = ( *animptr )->Name();
+		if( filter != NULL && !idStr::Filter( filter, name, false ) )
+		{
+			continue;
+		}
+		
+		idMD5Anim source;
+		if( !source.ParseAnim( name ) )
+		{
+			gameLocal.Printf( "couldn't load the source of %s\n", name );
+			continue;
+		}
+		
+		idMD5Anim compressedAnim = source;
+		compressedAnim.Compress();
+		source.CompareFrames( compressedAnim, posError, angleError );
+		
+		gameLocal.Printf( "%10d %10d %5.1f%% %10.4f %10.4f : %s\n", ( int )source.Size(), ( int )compressedAnim.Size(),
+						  100.0f * compressedAnim.Size() / source.Size(), posError, angleError, name );
+						
+		size += source.Size();
+		compressedSize += compressedAnim.Size();
+		maxPosError = Max( maxPosError, posError );
+		maxAngleError = Max( maxAngleError, angleError );
+		num++;
+	}
+	
+	if( num )
+	{
+		gameLocal.Printf( "%d anims: %d bytes compressed to %d (%.1f%%), max error %.4f units, %.4f degrees\n", num, ( int )size, ( int )compressedSize,
+						  100.0f * compressedSize / size, maxPosError, maxAngleError );
+	}
+}
+
 /*
 ================
 idAnimManager::FlushUnusedAnims
@@ -44,6 +44,9 @@ const int ANIMCHANNEL_LEGS			= 2;
 const int ANIMCHANNEL_HEAD			= 3;
 const int ANIMCHANNEL_EYELIDS		= 4;
 
+// number of ints in the key of a shared pose, see idAnimator::CreatePoseKey
+const int ANIM_PoseKeySize			= 2 + ANIM_NumAnimChannels * ANIM_MaxAnimsPerChannel * ( 9 + ANIM_MaxSyncedAnims );
+
 // for converting from 24 frames per second to milliseconds
 ID_INLINE int FRAME2MS( int framenum )
 {
@@ -75,6 +78,12 @@ typedef struct
 	int						firstComponent;
 } jointAnimInfo_t;
 
+typedef struct
+{
+	int						key;		// the frame is interpolated between this key frame and the next one
+	float					lerp;
+} animFrameKey_t;
+
 typedef struct
 {
 	jointHandle_t			num;
@@ -218,6 +227,18 @@ private:
 	idVec3					totaldelta;
 	mutable int				ref_count;
 	
+	// compressed anims keep quantized key frames instead of componentFrames
+	bool					compressed;
+	idList<animFrameKey_t, TAG_MD5_ANIM>	frameKeys;
+	idList<unsigned short, TAG_MD5_ANIM>	keyFrames;
+	idList<float, TAG_MD5_ANIM>			componentBias;
+	idList<float, TAG_MD5_ANIM>			componentScale;
+	// components with a range too large to quantize within the error bound, their scale is zero
+	idList<int, TAG_MD5_ANIM>			rawComponents;
+	idList<float, TAG_MD5_ANIM>			rawKeyFrames;
+	
+	const float*			GetFrameComponents( int framenum, int firstComponent, int numComponents, float* buffer ) const;
+	
 public:
 	idMD5Anim();
 	~idMD5Anim();
@@ -230,9 +251,14 @@ public:
 		return sizeof( *this ) + Allocated();
 	};
 	bool					LoadAnim( const char* filename );
+	bool					ParseAnim( const char* filename );
 	bool					LoadBinary( idFile* file, ID_TIME_T sourceTimeStamp );
 	void					WriteBinary( idFile* file, ID_TIME_T sourceTimeStamp );
 	
+	void					Compress();
+	bool					IsCompressed() const;
+	void					CompareFrames( const idMD5Anim& other, float& maxPosError, float& maxAngleError ) const;
+	
 	void					IncreaseRefs() const;
 	void					DecreaseRefs() const;
 	int						NumRefs() const;
@@ -343,18 +369,23 @@ public:
 	const char* 				GetJointName( int jointHandle ) const;
 	int							NumJointsOnChannel( int channel ) const;
 	const int* 					GetChannelJoints( int channel ) const;
+	const int* 					GetChannelLODJoints( int channel ) const;
+	int							NumChannelLODJoints( int channel, int maxDepth ) const;
 	
 	const idVec3& 				GetVisualOffset() const;
 	
 private:
 	void						CopyDecl( const idDeclModelDef* decl );
 	bool						ParseAnim( idLexer& src, int numDefaultAnims );
+	void						SetupLODJoints();
 	
 private:
 	idVec3						offset;
 	idList<jointInfo_t, TAG_ANIM>			joints;
 	idList<int, TAG_ANIM>					jointParents;
 	idList<int, TAG_ANIM>					channelJoints[ ANIM_NumAnimChannels ];
+	idList<int, TAG_ANIM>					jointDepths;
+	idList<int, TAG_ANIM>					channelLODJoints[ ANIM_NumAnimChannels ];	// channel joints sorted by their depth in the hierarchy
 	idRenderModel* 				modelHandle;
 	idList<idAnim*, TAG_ANIM>			anims;
 	const idDeclSkin* 			skin;
@@ -396,7 +427,7 @@ private:
 	void						SetFrame( const idDeclModelDef* modelDef, int animnum, int frame, int currenttime, int blendtime );
 	void						CycleAnim( const idDeclModelDef* modelDef, int animnum, int currenttime, int blendtime );
 	void						PlayAnim( const idDeclModelDef* modelDef, int animnum, int currenttime, int blendtime );
-	bool						BlendAnim( int currentTime, int channel, int numJoints, idJointQuat* blendFrame, float& blendWeight, bool removeOrigin, bool overrideBlend, bool printInfo ) const;
+	bool						BlendAnim( int currentTime, int channel, int jointDepth, int numJoints, idJointQuat* blendFrame, float& blendWeight, bool removeOrigin, bool overrideBlend, bool printInfo ) const;
 	void						BlendOrigin( int currentTime, idVec3& blendPos, float& blendWeight, bool removeOriginOffset ) const;
 	void						BlendDelta( int fromtime, int totime, idVec3& blendDelta, float& blendWeight ) const;
 	void						BlendDeltaRotation( int fromtime, int totime, idQuat& blendDelta, float& blendWeight ) const;
@@ -513,6 +544,9 @@ public:
 	void						ForceUpdate();
 	void						ClearForceUpdate();
 	bool						CreateFrame( int animtime, bool force );
+	bool						NeedsFrame( int animtime ) const;
+	void						SetLOD( int interval, int jointDepth );
+	bool						LODSkipsFrame() const;
 	bool						FrameHasChanged( int animtime ) const;
 	void						GetDelta( int fromtime, int totime, idVec3& delta ) const;
 	bool						GetDeltaRotation( int fromtime, int totime, idMat3& delta ) const;
@@ -560,6 +594,9 @@ public:
 private:
 	void						FreeData();
 	void						PushAnims( int channel, int currentTime, int blendTime );
+	bool						BlendChannels( int currentTime, int numJoints, idJointQuat* jointFrame, bool debugInfo ) const;
+	bool						BlendCachedChannels( int currentTime, int numJoints, idJointQuat* jointFrame ) const;
+	int							CreatePoseKey( int currentTime, int key[ ANIM_PoseKeySize ] ) const;
 	
 private:
 	const idDeclModelDef* 		modelDef;
@@ -575,6 +612,10 @@ private:
 	bool						removeOriginOffset;
 	bool						forceUpdate;
 	
+	int							lodInterval;			// frames between new frames for rendering
+	int							lodJointDepth;			// only blend the joints up to this depth, 0 = all joints
+	idList<idJointQuat, TAG_ANIM>			lodJointFrame;			// last blended pose, the joints beyond lodJointDepth stay in it
+	
 	idBounds					frameBounds;
 	
 	float						AFPoseBlendWeight;
@@ -585,6 +626,131 @@ private:
 	int							AFPoseTime;
 };
 
+/*
+==============================================================================================
+
+	idAnimPoseCache
+
+	Blended poses of the animators updated this frame.  Animators of the same
+	model that play the same anims at the same frames with the same weights
+	share one pose instead of decoding and blending the anims again.
+
+==============================================================================================
+*/
+
+const int ANIM_PoseCachePoses		= 2048;
+const int ANIM_PoseCacheKeys		= 64 * 1024;
+const int ANIM_PoseCacheJoints		= 64 * 1024;
+
+typedef struct animPose_s
+{
+	const idDeclModelDef*	modelDef;
+	int						firstKey;
+	int						numKeys;
+	int						firstJoint;
+	int						numJoints;
+	bool					hasAnim;
+} animPose_t;
+
+class idAnimPoseCache
+{
+public:
+	idAnimPoseCache();
+	
+	void						BeginFrame();
+	void						Shutdown();
+	
+	const animPose_t*			FindPose( const idDeclModelDef* modelDef, const int* key, int numKeys );
+	void						AddPose( const idDeclModelDef* modelDef, const int* key, int numKeys, const idJointQuat* jointFrame, int numJoints, bool hasAnim );
+	const idJointQuat*			GetJoints( const animPose_t& pose ) const;
+	void						VerifyPose( const animPose_t& pose, const idJointQuat* jointFrame );
+	
+private:
+	idList<animPose_t, TAG_ANIM>	poses;
+	idList<int, TAG_ANIM>		keys;
+	idList<idJointQuat, TAG_ANIM>	joints;
+	idHashIndex					poseHash;
+	
+	int							numHits;
+	int							numMisses;
+	int							numDropped;			// poses that didn't fit in the cache
+	int							numVerified;
+	float						maxPosError;
+	float						maxAngleError;
+	
+	idSysMutex					mutex;				// the anim stage looks up and adds poses from job threads
+	
+	static int					PoseHash( const idDeclModelDef* modelDef, const int* key, int numKeys );
+};
+
+/*
+==============================================================================================
+
+	idAnimStage
+
+	Creates the frames of the animators in view at the end of the game frame
+	on job threads, instead of lazily on the game thread when the renderer or
+	physics first asks for the joints.  Runs after all entities have thought
+	and the events were serviced, so articulated figure poses and joint mods
+	of the frame are in place.  Animators that change after the stage still
+	create their frame lazily.
+
+	The stage also picks the animation level of detail of every animated
+	entity from its distance to the nearest player view and from when the
+	renderer last drew it.  Distant and hidden entities create a new frame
+	for rendering only every few frames, far entities can blend a reduced
+	joint set as well.
+
+==============================================================================================
+*/
+
+enum animLOD_t
+{
+	ANIMLOD_FULL,
+	ANIMLOD_NEAR,
+	ANIMLOD_FAR,
+	ANIMLOD_HIDDEN,
+	ANIMLOD_NUM_LEVELS
+};
+
+typedef struct animStageJob_s
+{
+	idAnimator*					animator;
+	int							time;
+} animStageJob_t;
+
+class idAnimStage
+{
+public:
+	idAnimStage();
+	
+	void						Init();
+	void						Shutdown();
+	
+	int							Run();
+	void						StartBenchmark( int numFrames );
+	
+	void						CountFrame();
+	void						CountJoints( int num );
+	
+private:
+	idParallelJobList*			jobList;
+	idList<animStageJob_t, TAG_ANIM>	jobs;
+	
+	idSysInterlockedInteger		numFrames;			// frames created since the last Run
+	idSysInterlockedInteger		numJoints;			// joints blended since the last Run
+	int							numLOD[ ANIMLOD_NUM_LEVELS ];
+	
+	int							benchmarkFrames;	// frames left in the benchmark
+	int							benchmarkNumFrames[2];
+	int							benchmarkNumAnimators[2];
+	uint64						benchmarkTime[2];
+	
+	void						FinishBenchmark();
+	void						UpdateLOD();
+	void						PrintStats() const;
+};
+
 /*
 ==============================================================================================
 
@@ -606,6 +772,7 @@ public:
 	void						Preload( const idPreloadManifest& manifest );
 	void						ReloadAnims();
 	void						ListAnims() const;
+	void						ReportCompression( const char* filter ) const;
 	int							JointIndex( const char* name );
 	const char* 				JointName( int index ) const;
 	
@@ -2263,7 +2263,7 @@ void idAnimBlend::CallFrameCommands( idEntity* ent, int fromtime, int totime ) c
 idAnimBlend::BlendAnim
 =====================
 */
-bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJointQuat* blendFrame, float& blendWeight, bool removeOriginOffset, bool overrideBlend, bool printInfo ) const
+bool idAnimBlend::BlendAnim( int currentTime, int channel, int jointDepth, int numJoints, idJointQuat* blendFrame, float& blendWeight, bool removeOriginOffset, bool overrideBlend, bool printInfo ) const
 {
 	int				i;
 	float			lerp;
@@ -2275,6 +2275,8 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 	idJointQuat*		mixFrame;
 	int				numAnims;
 	int				time;
+	const int*		index;
+	int				numIndex;
 	
 	const idAnim* anim = Anim();
 	if( !anim )
@@ -2310,6 +2312,18 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 		jointFrame = ( idJointQuat* )_alloca16( numJoints * sizeof( *jointFrame ) );
 	}
 	
+	// distant animators only blend the joints near the root
+	if( jointDepth > 0 )
+	{
+		index = modelDef->GetChannelLODJoints( channel );
+		numIndex = modelDef->NumChannelLODJoints( channel, jointDepth );
+	}
+	else
+	{
+		index = modelDef->GetChannelJoints( channel );
+		numIndex = modelDef->NumJointsOnChannel( channel );
+	}
+	
 	time = AnimTime( currentTime );
 	
 	numAnims = anim->NumAnims();
@@ -2318,13 +2332,14 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 		md5anim = anim->MD5Anim( 0 );
 		if( frame )
 		{
-			md5anim->GetSingleFrame( frame - 1, jointFrame, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+			md5anim->GetSingleFrame( frame - 1, jointFrame, index, numIndex );
 		}
 		else
 		{
 			md5anim->ConvertTimeToFrame( time, cycle, frametime );
-			md5anim->GetInterpolatedFrame( frametime, jointFrame, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+			md5anim->GetInterpolatedFrame( frametime, jointFrame, index, numIndex );
 		}
+		gameLocal.animStage.CountJoints( numIndex );
 	}
 	else
 	{
@@ -2350,17 +2365,18 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 				md5anim = anim->MD5Anim( i );
 				if( frame )
 				{
-					md5anim->GetSingleFrame( frame - 1, ptr, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+					md5anim->GetSingleFrame( frame - 1, ptr, index, numIndex );
 				}
 				else
 				{
-					md5anim->GetInterpolatedFrame( frametime, ptr, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+					md5anim->GetInterpolatedFrame( frametime, ptr, index, numIndex );
 				}
+				gameLocal.animStage.CountJoints( numIndex );
 				
 				// only blend after the first anim is mixed in
 				if( ptr != jointFrame )
 				{
-					SIMDProcessor->BlendJoints( jointFrame, ptr, lerp, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+					SIMDProcessor->BlendJoints( jointFrame, ptr, lerp, index, numIndex );
 				}
 				
 				ptr = mixFrame;
@@ -2395,9 +2411,7 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 		blendWeight = weight;
 		if( channel != ANIMCHANNEL_ALL )
 		{
-			const int* index = modelDef->GetChannelJoints( channel );
-			const int num = modelDef->NumJointsOnChannel( channel );
-			for( i = 0; i < num; i++ )
+			for( i = 0; i < numIndex; i++ )
 			{
 				int j = index[i];
 				blendFrame[j].t = jointFrame[j].t;
@@ -2409,7 +2423,7 @@ bool idAnimBlend::BlendAnim( int currentTime, int channel, int numJoints, idJoin
 	{
 		blendWeight += weight;
 		lerp = weight / blendWeight;
-		SIMDProcessor->BlendJoints( blendFrame, jointFrame, lerp, modelDef->GetChannelJoints( channel ), modelDef->NumJointsOnChannel( channel ) );
+		SIMDProcessor->BlendJoints( blendFrame, jointFrame, lerp, index, numIndex );
 	}
 	
 	if( printInfo )
@@ -2703,9 +2717,11 @@ idDeclModelDef::idDeclModelDef()
 	modelHandle	= NULL;
 	skin		= NULL;
 	offset.Zero();
+	jointDepths.Clear();
 	for( int i = 0; i < ANIM_NumAnimChannels; i++ )
 	{
 		channelJoints[i].Clear();
+		channelLODJoints[i].Clear();
 	}
 }
 
@@ -2754,9 +2770,11 @@ void idDeclModelDef::CopyDecl( const idDeclModelDef* decl )
 	memcpy( joints.Ptr(), decl->joints.Ptr(), decl->joints.Num() * sizeof( joints[0] ) );
 	jointParents.SetNum( decl->jointParents.Num() );
 	memcpy( jointParents.Ptr(), decl->jointParents.Ptr(), decl->jointParents.Num() * sizeof( jointParents[0] ) );
+	jointDepths = decl->jointDepths;
 	for( i = 0; i < ANIM_NumAnimChannels; i++ )
 	{
 		channelJoints[i] = decl->channelJoints[i];
+		channelLODJoints[i] = decl->channelLODJoints[i];
 	}
 }
 
@@ -2773,9 +2791,11 @@ void idDeclModelDef::FreeData()
 	modelHandle	= NULL;
 	skin = NULL;
 	offset.Zero();
+	jointDepths.Clear();
 	for( int i = 0; i < ANIM_NumAnimChannels; i++ )
 	{
 		channelJoints[i].Clear();
+		channelLODJoints[i].Clear();
 	}
 }
 
@@ -3529,9 +3549,50 @@ bool idDeclModelDef::Parse( const char* text, const int textLength, bool allowBi
 	anims.SetGranularity( 1 );
 	anims.SetNum( anims.Num() );
 	
+	SetupLODJoints();
+	
 	return true;
 }
 
+/*
+=====================
+idDeclModelDef::SetupLODJoints
+
+Sorts the joints of every channel by their depth in the hierarchy, so the
+joints up to any depth are at the start of the list.
+=====================
+*/
+void idDeclModelDef::SetupLODJoints()
+{
+	int i, j, depth, maxDepth;
+	
+	// parents always come before their children
+	maxDepth = 0;
+	jointDepths.SetNum( joints.Num() );
+	for( i = 0; i < joints.Num(); i++ )
+	{
+		jointDepths[ i ] = ( jointParents[ i ] != INVALID_JOINT ) ? jointDepths[ jointParents[ i ] ] + 1 : 0;
+		maxDepth = Max( maxDepth, jointDepths[ i ] );
+	}
+	
+	for( i = 0; i < ANIM_NumAnimChannels; i++ )
+	{
+		channelLODJoints[ i ].SetGranularity( 1 );
+		channelLODJoints[ i ].SetNum( 0 );
+		channelLODJoints[ i ].Resize( channelJoints[ i ].Num() );
+		for( depth = 0; depth <= maxDepth; depth++ )
+		{
+			for( j = 0; j < channelJoints[ i ].Num(); j++ )
+			{
+				if( jointDepths[ channelJoints[ i ][ j ] ] == depth )
+				{
+					channelLODJoints[ i ].Append( channelJoints[ i ][ j ] );
+				}
+			}
+		}
+	}
+}
+
 /*
 =====================
 idDeclModelDef::HasAnim
@@ -3772,6 +3833,49 @@ const int* idDeclModelDef::GetChannelJoints( int channel ) const
 	return channelJoints[ channel ].Ptr();
 }
 
+/*
+=====================
+idDeclModelDef::GetChannelLODJoints
+=====================
+*/
+const int* idDeclModelDef::GetChannelLODJoints( int channel ) const
+{
+	if( ( channel < 0 ) || ( channel >= ANIM_NumAnimChannels ) )
+	{
+		gameLocal.Error( "idDeclModelDef::GetChannelLODJoints : channel out of range" );
+		return NULL;
+	}
+	return channelLODJoints[ channel ].Ptr();
+}
+
+/*
+=====================
+idDeclModelDef::NumChannelLODJoints
+
+Returns the number of joints on the channel up to the depth in the hierarchy.
+=====================
+*/
+int idDeclModelDef::NumChannelLODJoints( int channel, int maxDepth ) const
+{
+	int num;
+	
+	if( ( channel < 0 ) || ( channel >= ANIM_NumAnimChannels ) )
+	{
+		gameLocal.Error( "idDeclModelDef::NumChannelLODJoints : channel out of range" );
+		return 0;
+	}
+	
+	const idList<int, TAG_ANIM>& list = channelLODJoints[ channel ];
+	for( num = 0; num < list.Num(); num++ )
+	{
+		if( jointDepths[ list[ num ] ] > maxDepth )
+		{
+			break;
+		}
+	}
+	return num;
+}
+
 /*
 =====================
 idDeclModelDef::GetVisualOffset
@@ -3805,12 +3909,15 @@ idAnimator::idAnimator()
 	stoppedAnimatingUpdate	= false;
 	removeOriginOffset		= false;
 	forceUpdate				= false;
+	lodInterval				= 1;
+	lodJointDepth			= 0;
 	
 	frameBounds.Clear();
 	
 	AFPoseJoints.SetGranularity( 1 );
 	AFPoseJointMods.SetGranularity( 1 );
 	AFPoseJointFrame.SetGranularity( 1 );
+	lodJointFrame.SetGranularity( 1 );
 	
 	ClearAFPose();
 	
@@ -3843,6 +3950,7 @@ size_t idAnimator::Allocated() const
 	size_t	size;
 	
 	size = jointMods.Allocated() + numJoints * sizeof( joints[0] ) + jointMods.Num() * sizeof( jointMods[ 0 ] ) + AFPoseJointMods.Allocated() + AFPoseJointFrame.Allocated() + AFPoseJoints.Allocated();
+	size += lodJointFrame.Allocated();
 	
 	return size;
 }
@@ -4046,6 +4154,8 @@ void idAnimator::FreeData()
 	joints = NULL;
 	numJoints = 0;
 	
+	lodJointFrame.Clear();
+	
 	modelDef = NULL;
 	
 	ForceUpdate();
@@ -5046,6 +5156,8 @@ void idAnimator::ServiceAnims( int fromtime, int totime )
 		return;
 	}
 	
+	idScopedThinkProfile profile( THINKPROF_ANIM, entity );
+	
 	if( modelDef->ModelHandle() )
 	{
 		blend = channels[ 0 ];
@@ -5150,76 +5262,19 @@ bool idAnimator::FrameHasChanged( int currentTime ) const
 
 /*
 =====================
-idAnimator::CreateFrame
+idAnimator::BlendChannels
+
+Blends the anims of all channels into the joint frame, returns false
+when no anim was blended in.
 =====================
 */
-bool idAnimator::CreateFrame( int currentTime, bool force )
+bool idAnimator::BlendChannels( int currentTime, int numJoints, idJointQuat* jointFrame, bool debugInfo ) const
 {
 	int					i, j;
-	int					numJoints;
-	int					parentNum;
 	bool				hasAnim;
-	bool				debugInfo;
 	float				baseBlend;
 	float				blendWeight;
 	const idAnimBlend* 	blend;
-	const int* 			jointParent;
-	const jointMod_t* 	jointMod;
-	const idJointQuat* 	defaultPose;
-	
-	static idCVar		r_showSkel( "r_showSkel", "0", CVAR_RENDERER | CVAR_INTEGER, "", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
-	
-	if( !modelDef || !modelDef->ModelHandle() )
-	{
-		return false;
-	}
-	
-	if( !force && !r_showSkel.GetInteger() )
-	{
-		if( lastTransformTime == currentTime )
-		{
-			return false;
-		}
-		if( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) )
-		{
-			return false;
-		}
-	}
-	
-	lastTransformTime = currentTime;
-	stoppedAnimatingUpdate = false;
-	
-	if( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) )
-	{
-		debugInfo = true;
-		gameLocal.Printf( "---------------\n%d: entity '%s':\n", gameLocal.time, entity->GetName() );
-		gameLocal.Printf( "model '%s':\n", modelDef->GetModelName() );
-	}
-	else
-	{
-		debugInfo = false;
-	}
-	
-	// init the joint buffer
-	if( AFPoseJoints.Num() )
-	{
-		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
-		defaultPose = AFPoseJointFrame.Ptr();
-	}
-	else
-	{
-		defaultPose = modelDef->GetDefaultPose();
-	}
-	
-	if( !defaultPose )
-	{
-		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
-		return false;
-	}
-	
-	numJoints = modelDef->Joints().Num();
-	idJointQuat* jointFrame = ( idJointQuat* )_alloca16( numJoints * sizeof( jointFrame[0] ) );
-	SIMDProcessor->Memcpy( jointFrame, defaultPose, numJoints * sizeof( jointFrame[0] ) );
 	
 	hasAnim = false;
 	
@@ -5228,7 +5283,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 	blend = channels[ ANIMCHANNEL_ALL ];
 	for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ )
 	{
-		if( blend->BlendAnim( currentTime, ANIMCHANNEL_ALL, numJoints, jointFrame, baseBlend, removeOriginOffset, false, debugInfo ) )
+		if( blend->BlendAnim( currentTime, ANIMCHANNEL_ALL, lodJointDepth, numJoints, jointFrame, baseBlend, removeOriginOffset, false, debugInfo ) )
 		{
 			hasAnim = true;
 			if( baseBlend >= 1.0f )
@@ -5256,7 +5311,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 			blend = channels[ i ];
 			for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ )
 			{
-				if( blend->BlendAnim( currentTime, i, numJoints, jointFrame, blendWeight, removeOriginOffset, false, debugInfo ) )
+				if( blend->BlendAnim( currentTime, i, lodJointDepth, numJoints, jointFrame, blendWeight, removeOriginOffset, false, debugInfo ) )
 				{
 					hasAnim = true;
 					if( blendWeight >= 1.0f )
@@ -5281,7 +5336,7 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 		blendWeight = baseBlend;
 		for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ )
 		{
-			if( blend->BlendAnim( currentTime, ANIMCHANNEL_EYELIDS, numJoints, jointFrame, blendWeight, removeOriginOffset, true, debugInfo ) )
+			if( blend->BlendAnim( currentTime, ANIMCHANNEL_EYELIDS, lodJointDepth, numJoints, jointFrame, blendWeight, removeOriginOffset, true, debugInfo ) )
 			{
 				hasAnim = true;
 				if( blendWeight >= 1.0f )
@@ -5293,6 +5348,214 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 		}
 	}
 	
+	return hasAnim;
+}
+
+/*
+=====================
+idAnimator::BlendCachedChannels
+
+Same as BlendChannels, but takes the pose from the pose cache when an
+animator of the same model already blended it this frame.
+=====================
+*/
+bool idAnimator::BlendCachedChannels( int currentTime, int numJoints, idJointQuat* jointFrame ) const
+{
+	int					key[ ANIM_PoseKeySize ];
+	int					numKeys;
+	bool				hasAnim;
+	const animPose_t* 	pose;
+	
+	numKeys = CreatePoseKey( currentTime, key );
+	pose = gameLocal.animPoseCache.FindPose( modelDef, key, numKeys );
+	if( !pose )
+	{
+		hasAnim = BlendChannels( currentTime, numJoints, jointFrame, false );
+		gameLocal.animPoseCache.AddPose( modelDef, key, numKeys, jointFrame, numJoints, hasAnim );
+		return hasAnim;
+	}
+	
+	if( g_animPoseCache.GetInteger() > 1 )
+	{
+		// blend the pose anyway to measure how far the shared pose is off
+		BlendChannels( currentTime, numJoints, jointFrame, false );
+		gameLocal.animPoseCache.VerifyPose( *pose, jointFrame );
+	}
+	
+	SIMDProcessor->Memcpy( jointFrame, gameLocal.animPoseCache.GetJoints( *pose ), numJoints * sizeof( jointFrame[0] ) );
+	
+	return pose->hasAnim;
+}
+
+/*
+=====================
+idAnimator::CreatePoseKey
+
+Fills in everything the blended pose of the channels depends on besides
+the model, so animators of the same model with the same key have the same
+pose.  With g_animPoseCacheSteps set the interpolation between frames and
+the blend weights are rounded, letting animators that are almost in sync
+share a pose as well.
+=====================
+*/
+int idAnimator::CreatePoseKey( int currentTime, int key[ ANIM_PoseKeySize ] ) const
+{
+	int					i, j, k;
+	int					numKeys;
+	float				steps;
+	const idAnimBlend* 	blend;
+	const idAnim*		anim;
+	
+	steps = g_animPoseCacheSteps.GetInteger();
+	
+	numKeys = 0;
+	key[ numKeys++ ] = removeOriginOffset;
+	key[ numKeys++ ] = lodJointDepth;
+	for( i = 0; i < ANIM_NumAnimChannels; i++ )
+	{
+		blend = channels[ i ];
+		for( j = 0; j < ANIM_MaxAnimsPerChannel; j++, blend++ )
+		{
+			anim = blend->Anim();
+			if( !anim )
+			{
+				continue;
+			}
+			
+			frameBlend_t frametime = { 0 };
+			if( !blend->frame )
+			{
+				anim->MD5Anim( 0 )->ConvertTimeToFrame( blend->AnimTime( currentTime ), blend->cycle, frametime );
+			}
+			
+			key[ numKeys++ ] = i * ANIM_MaxAnimsPerChannel + j;
+			key[ numKeys++ ] = blend->animNum;
+			key[ numKeys++ ] = blend->frame;
+			key[ numKeys++ ] = blend->allowMove | ( ( ( blend->endtime >= 0 ) && ( currentTime >= blend->endtime ) ) << 1 );
+			key[ numKeys++ ] = frametime.cycleCount;
+			key[ numKeys++ ] = frametime.frame1;
+			key[ numKeys++ ] = frametime.frame2;
+			if( steps > 0.0f )
+			{
+				key[ numKeys++ ] = idMath::Ftoi( frametime.backlerp * steps );
+				key[ numKeys++ ] = idMath::Ftoi( blend->GetWeight( currentTime ) * steps );
+				if( anim->NumAnims() > 1 )
+				{
+					for( k = 0; k < anim->NumAnims(); k++ )
+					{
+						key[ numKeys++ ] = idMath::Ftoi( blend->animWeights[ k ] * steps );
+					}
+				}
+			}
+			else
+			{
+				key[ numKeys++ ] = *reinterpret_cast<const int*>( &frametime.backlerp );
+				
+				const float weight = blend->GetWeight( currentTime );
+				key[ numKeys++ ] = *reinterpret_cast<const int*>( &weight );
+				if( anim->NumAnims() > 1 )
+				{
+					for( k = 0; k < anim->NumAnims(); k++ )
+					{
+						key[ numKeys++ ] = *reinterpret_cast<const int*>( &blend->animWeights[ k ] );
+					}
+				}
+			}
+		}
+	}
+	
+	assert( numKeys <= ANIM_PoseKeySize );
+	return numKeys;
+}
+
+/*
+=====================
+idAnimator::CreateFrame
+=====================
+*/
+bool idAnimator::CreateFrame( int currentTime, bool force )
+{
+	int					i, j;
+	int					numJoints;
+	int					parentNum;
+	bool				hasAnim;
+	bool				debugInfo;
+	const int* 			jointParent;
+	const jointMod_t* 	jointMod;
+	const idJointQuat* 	defaultPose;
+	
+	if( !modelDef || !modelDef->ModelHandle() )
+	{
+		return false;
+	}
+	
+	if( !force && !r_showSkel.GetInteger() && !NeedsFrame( currentTime ) )
+	{
+		return false;
+	}
+	
+	lastTransformTime = currentTime;
+	stoppedAnimatingUpdate = false;
+	
+	idScopedThinkProfile profile( THINKPROF_ANIM, entity );
+	gameLocal.animStage.CountFrame();
+	
+	if( entity && ( ( g_debugAnim.GetInteger() == entity->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) ) )
+	{
+		debugInfo = true;
+		gameLocal.Printf( "---------------\n%d: entity '%s':\n", gameLocal.time, entity->GetName() );
+		gameLocal.Printf( "model '%s':\n", modelDef->GetModelName() );
+	}
+	else
+	{
+		debugInfo = false;
+	}
+	
+	// init the joint buffer
+	if( AFPoseJoints.Num() )
+	{
+		// initialize with AF pose anim for the case where there are no other animations and no AF pose joint modifications
+		defaultPose = AFPoseJointFrame.Ptr();
+	}
+	else
+	{
+		defaultPose = modelDef->GetDefaultPose();
+	}
+	
+	if( !defaultPose )
+	{
+		//gameLocal.Warning( "idAnimator::CreateFrame: no defaultPose on '%s'", modelDef->Name() );
+		return false;
+	}
+	
+	numJoints = modelDef->Joints().Num();
+	
+	// animators that only blend the joints near the root keep the other joints in their last pose
+	const bool keepLastPose = ( lodJointDepth > 0 ) && ( lodJointFrame.Num() == numJoints ) && !AFPoseJoints.Num();
+	if( keepLastPose )
+	{
+		defaultPose = lodJointFrame.Ptr();
+	}
+	
+	idJointQuat* jointFrame = ( idJointQuat* )_alloca16( numJoints * sizeof( jointFrame[0] ) );
+	SIMDProcessor->Memcpy( jointFrame, defaultPose, numJoints * sizeof( jointFrame[0] ) );
+	
+	// animators playing the same anims in sync share the blended pose
+	if( g_animPoseCache.GetInteger() && !AFPoseJoints.Num() && !debugInfo && !keepLastPose )
+	{
+		hasAnim = BlendCachedChannels( currentTime, numJoints, jointFrame );
+	}
+	else
+	{
+		hasAnim = BlendChannels( currentTime, numJoints, jointFrame, debugInfo );
+	}
+	
+	if( hasAnim && g_animLOD.GetBool() )
+	{
+		lodJointFrame.SetNum( numJoints );
+		SIMDProcessor->Memcpy( lodJointFrame.Ptr(), jointFrame, numJoints * sizeof( jointFrame[0] ) );
+	}
+	
 	// blend the articulated figure pose
 	if( BlendAFPose( jointFrame ) )
 	{
@@ -5428,12 +5691,69 @@ bool idAnimator::CreateFrame( int currentTime, bool force )
 
 /*
 =====================
-idAnimator::ForceUpdate
+idAnimator::NeedsFrame
+
+Returns true if CreateFrame has to create a new frame for the time.
 =====================
 */
-void idAnimator::ForceUpdate()
+bool idAnimator::NeedsFrame( int currentTime ) const
 {
-	lastTransformTime = -1;
+	if( lastTransformTime == currentTime )
+	{
+		return false;
+	}
+	if( lastTransformTime != -1 && !stoppedAnimatingUpdate && !IsAnimating( currentTime ) )
+	{
+		return false;
+	}
+	return true;
+}
+
+/*
+=====================
+idAnimator::SetLOD
+=====================
+*/
+void idAnimator::SetLOD( int interval, int jointDepth )
+{
+	lodInterval = Max( 1, interval );
+	
+	if( jointDepth != lodJointDepth )
+	{
+		// show the new joint set right away
+		lodJointDepth = jointDepth;
+		ForceUpdate();
+	}
+}
+
+/*
+=====================
+idAnimator::LODSkipsFrame
+
+Returns true if the renderer should keep showing the last frame.  Only
+frames created for rendering are skipped, joint queries always get a frame
+for the current time.
+=====================
+*/
+bool idAnimator::LODSkipsFrame() const
+{
+	if( ( lodInterval <= 1 ) || ( lastTransformTime == -1 ) || ( entity == NULL ) )
+	{
+		return false;
+	}
+	
+	// spread the animators over the frames
+	return ( ( gameLocal.framenum + entity->entityNumber ) % lodInterval ) != 0;
+}
+
+/*
+=====================
+idAnimator::ForceUpdate
+=====================
+*/
+void idAnimator::ForceUpdate()
+{
+	lastTransformTime = -1;
 	forceUpdate = true;
 }
 
@@ -5740,6 +6060,543 @@ const idVec3& idAnimator::TotalMovementDelta( int animNum ) const
 	}
 }
 
+/***********************************************************************
+
+	idAnimPoseCache
+	
+***********************************************************************/
+
+/*
+=====================
+idAnimPoseCache::idAnimPoseCache
+=====================
+*/
+idAnimPoseCache::idAnimPoseCache()
+{
+	numHits = 0;
+	numMisses = 0;
+	numDropped = 0;
+	numVerified = 0;
+	maxPosError = 0.0f;
+	maxAngleError = 0.0f;
+}
+
+/*
+=====================
+idAnimPoseCache::BeginFrame
+
+Poses are only shared within a frame.
+=====================
+*/
+void idAnimPoseCache::BeginFrame()
+{
+	if( g_animPoseCacheStats.GetBool() && ( numHits || numMisses ) )
+	{
+		gameLocal.Printf( "anim poses: %4d hits, %4d misses, %3d dropped, %4d poses, %6d joints\n", numHits, numMisses, numDropped, poses.Num(), joints.Num() );
+		if( numVerified )
+		{
+			gameLocal.Printf( "anim poses: %4d verified, max error %.4f units, %.4f degrees\n", numVerified, maxPosError, maxAngleError );
+		}
+	}
+	
+	numHits = 0;
+	numMisses = 0;
+	numDropped = 0;
+	numVerified = 0;
+	maxPosError = 0.0f;
+	maxAngleError = 0.0f;
+	
+	poses.SetNum( 0 );
+	keys.SetNum( 0 );
+	joints.SetNum( 0 );
+	poseHash.Clear();
+}
+
+/*
+=====================
+idAnimPoseCache::Shutdown
+=====================
+*/
+void idAnimPoseCache::Shutdown()
+{
+	poses.Clear();
+	keys.Clear();
+	joints.Clear();
+	poseHash.Free();
+}
+
+/*
+=====================
+idAnimPoseCache::PoseHash
+=====================
+*/
+int idAnimPoseCache::PoseHash( const idDeclModelDef* modelDef, const int* key, int numKeys )
+{
+	int hash;
+	int i;
+	
+	hash = ( int )( ( intptr_t )modelDef >> 4 );
+	for( i = 0; i < numKeys; i++ )
+	{
+		hash = hash * 31 + key[ i ];
+	}
+	return hash;
+}
+
+/*
+=====================
+idAnimPoseCache::FindPose
+=====================
+*/
+const animPose_t* idAnimPoseCache::FindPose( const idDeclModelDef* modelDef, const int* key, int numKeys )
+{
+	int i;
+	
+	idScopedCriticalSection lock( mutex );
+	
+	for( i = poseHash.First( PoseHash( modelDef, key, numKeys ) ); i != -1; i = poseHash.Next( i ) )
+	{
+		const animPose_t& pose = poses[ i ];
+		if( ( pose.modelDef == modelDef ) && ( pose.numKeys == numKeys ) && !memcmp( &keys[ pose.firstKey ], key, numKeys * sizeof( key[0] ) ) )
+		{
+			numHits++;
+			return &pose;
+		}
+	}
+	
+	numMisses++;
+	return NULL;
+}
+
+/*
+=====================
+idAnimPoseCache::AddPose
+=====================
+*/
+void idAnimPoseCache::AddPose( const idDeclModelDef* modelDef, const int* key, int numKeys, const idJointQuat* jointFrame, int numJoints, bool hasAnim )
+{
+	animPose_t pose;
+	
+	idScopedCriticalSection lock( mutex );
+	
+	if( ( poses.Num() >= ANIM_PoseCachePoses ) || ( keys.Num() + numKeys > ANIM_PoseCacheKeys ) || ( joints.Num() + numJoints > ANIM_PoseCacheJoints ) )
+	{
+		numDropped++;
+		return;
+	}
+	
+	// allocate the whole cache the first time it's used so it never grows
+	if( !joints.Size() )
+	{
+		poses.Resize( ANIM_PoseCachePoses );
+		keys.Resize( ANIM_PoseCacheKeys );
+		joints.Resize( ANIM_PoseCacheJoints );
+	}
+	
+	pose.modelDef = modelDef;
+	pose.firstKey = keys.Num();
+	pose.numKeys = numKeys;
+	pose.firstJoint = joints.Num();
+	pose.numJoints = numJoints;
+	pose.hasAnim = hasAnim;
+	
+	keys.SetNum( pose.firstKey + numKeys );
+	memcpy( &keys[ pose.firstKey ], key, numKeys * sizeof( key[0] ) );
+	
+	joints.SetNum( pose.firstJoint + numJoints );
+	SIMDProcessor->Memcpy( &joints[ pose.firstJoint ], jointFrame, numJoints * sizeof( jointFrame[0] ) );
+	
+	poseHash.Add( PoseHash( modelDef, key, numKeys ), poses.Append( pose ) );
+}
+
+/*
+=====================
+idAnimPoseCache::GetJoints
+=====================
+*/
+const idJointQuat* idAnimPoseCache::GetJoints( const animPose_t& pose ) const
+{
+	return &joints[ pose.firstJoint ];
+}
+
+/*
+=====================
+idAnimPoseCache::VerifyPose
+
+Compares a shared pose with the pose blended by the animator itself.
+=====================
+*/
+void idAnimPoseCache::VerifyPose( const animPose_t& pose, const idJointQuat* jointFrame )
+{
+	const idJointQuat* 	poseJoints;
+	float				posError;
+	float				angleError;
+	float				dot;
+	int					i;
+	
+	idScopedCriticalSection lock( mutex );
+	
+	poseJoints = GetJoints( pose );
+	for( i = 0; i < pose.numJoints; i++ )
+	{
+		const idQuat& q1 = poseJoints[ i ].q;
+		const idQuat& q2 = jointFrame[ i ].q;
+		dot = q1.x * q2.x + q1.y * q2.y + q1.z * q2.z + q1.w * q2.w;
+		
+		posError = ( poseJoints[ i ].t - jointFrame[ i ].t ).Length();
+		angleError = RAD2DEG( 2.0f * idMath::ACos( idMath::Fabs( dot ) ) );
+		maxPosError = Max( maxPosError, posError );
+		maxAngleError = Max( maxAngleError, angleError );
+	}
+	numVerified++;
+}
+
+/***********************************************************************
+
+	idAnimStage
+	
+***********************************************************************/
+
+/*
+=====================
+CreateAnimFrameJob
+=====================
+*/
+static void CreateAnimFrameJob( animStageJob_t* job )
+{
+	job->animator->CreateFrame( job->time, false );
+}
+
+REGISTER_PARALLEL_JOB( CreateAnimFrameJob, "CreateAnimFrameJob" );
+
+/*
+=====================
+idAnimStage::idAnimStage
+=====================
+*/
+idAnimStage::idAnimStage()
+{
+	jobList = NULL;
+	benchmarkFrames = 0;
+	benchmarkNumFrames[0] = benchmarkNumFrames[1] = 0;
+	benchmarkNumAnimators[0] = benchmarkNumAnimators[1] = 0;
+	benchmarkTime[0] = benchmarkTime[1] = 0;
+	memset( numLOD, 0, sizeof( numLOD ) );
+}
+
+/*
+=====================
+idAnimStage::Init
+=====================
+*/
+void idAnimStage::Init()
+{
+	jobList = parallelJobManager->AllocJobList( JOBLIST_GAME, JOBLIST_PRIORITY_MEDIUM, MAX_GENTITIES, 0, NULL );
+}
+
+/*
+=====================
+idAnimStage::Shutdown
+=====================
+*/
+void idAnimStage::Shutdown()
+{
+	if( jobList != NULL )
+	{
+		parallelJobManager->FreeJobList( jobList );
+		jobList = NULL;
+	}
+	jobs.Clear();
+	benchmarkFrames = 0;
+}
+
+/*
+=====================
+idAnimStage::Run
+
+Creates the frames of the animators in view, returns the number of animators updated.
+=====================
+*/
+int idAnimStage::Run()
+{
+	idEntity*	ent;
+	idAnimator*	animator;
+	bool		parallel;
+	bool		benchmark;
+	uint64		startTime;
+	int			time;
+	int			i;
+	
+	if( g_animLODStats.GetBool() )
+	{
+		PrintStats();
+	}
+	numFrames.SetValue( 0 );
+	numJoints.SetValue( 0 );
+	
+	UpdateLOD();
+	
+	parallel = g_animStage.GetBool();
+	benchmark = false;
+	
+	if( benchmarkFrames > 0 )
+	{
+		benchmarkFrames--;
+		if( benchmarkFrames == 0 )
+		{
+			FinishBenchmark();
+		}
+		else
+		{
+			// alternate every frame so both modes see the same game situations
+			parallel = ( benchmarkFrames & 1 ) != 0;
+			benchmark = true;
+		}
+	}
+	
+	if( !parallel && !benchmark )
+	{
+		return 0;
+	}
+	
+	startTime = Sys_Microseconds();
+	
+	jobs.SetNum( 0 );
+	for( ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() )
+	{
+		if( ent->IsHidden() || ( ent->GetModelDefHandle() == -1 ) )
+		{
+			continue;
+		}
+		
+		animator = ent->GetAnimator();
+		if( animator == NULL || animator->ModelHandle() == NULL )
+		{
+			continue;
+		}
+		
+		// animators printing debug info are left to the game thread
+		if( ( g_debugAnim.GetInteger() == ent->entityNumber ) || ( g_debugAnim.GetInteger() == -2 ) )
+		{
+			continue;
+		}
+		
+		time = gameLocal.GetTimeGroupTime( ent->GetRenderEntity()->timeGroup );
+		if( !animator->NeedsFrame( time ) || animator->LODSkipsFrame() )
+		{
+			continue;
+		}
+		
+		// the frames of animators out of view are only created when something asks for their joints
+		if( !gameLocal.InPlayerPVS( ent ) )
+		{
+			continue;
+		}
+		
+		animStageJob_t& job = jobs.Alloc();
+		job.animator = animator;
+		job.time = time;
+	}
+	
+	// the think profiler times frames from the game thread only
+	if( parallel && jobList != NULL && !thinkProfiler.IsEnabled() )
+	{
+		for( i = 0; i < jobs.Num(); i++ )
+		{
+			jobList->AddJob( ( jobRun_t )CreateAnimFrameJob, &jobs[ i ] );
+		}
+		jobList->Submit();
+		jobList->Wait();
+	}
+	else
+	{
+		for( i = 0; i < jobs.Num(); i++ )
+		{
+			CreateAnimFrameJob( &jobs[ i ] );
+		}
+	}
+	
+	if( benchmark )
+	{
+		benchmarkNumFrames[ parallel ]++;
+		benchmarkNumAnimators[ parallel ] += jobs.Num();
+		benchmarkTime[ parallel ] += Sys_Microseconds() - startTime;
+	}
+	
+	return jobs.Num();
+}
+
+/*
+=====================
+idAnimStage::UpdateLOD
+
+Picks the animation level of detail of the animated entities from their
+distance to the nearest player view and from when they were last drawn.
+=====================
+*/
+void idAnimStage::UpdateLOD()
+{
+	idEntity*	ent;
+	idAnimator*	animator;
+	idVec3		viewOrigins[ MAX_CLIENTS ];
+	int			numViews;
+	int			renderFrame;
+	int			lastVisibleFrame;
+	float		distSqr;
+	float		nearDistSqr;
+	float		farDistSqr;
+	animLOD_t	lod;
+	int			i;
+	
+	memset( numLOD, 0, sizeof( numLOD ) );
+	
+	// cinematics are seen through cameras away from the players
+	const bool enabled = g_animLOD.GetBool() && !gameLocal.inCinematic;
+	
+	numViews = 0;
+	for( i = 0; i < gameLocal.numClients; i++ )
+	{
+		ent = gameLocal.entities[ i ];
+		if( ent != NULL && ent->IsType( idPlayer::Type ) )
+		{
+			viewOrigins[ numViews++ ] = static_cast<idPlayer*>( ent )->firstPersonViewOrigin;
+		}
+	}
+	
+	nearDistSqr = Square( g_animLODNearDistance.GetFloat() );
+	farDistSqr = Square( g_animLODFarDistance.GetFloat() );
+	renderFrame = renderSystem->GetFrameCount();
+	
+	for( ent = gameLocal.activeEntities.Next(); ent != NULL; ent = ent->activeNode.Next() )
+	{
+		animator = ent->GetAnimator();
+		if( animator == NULL || animator->ModelHandle() == NULL )
+		{
+			continue;
+		}
+		
+		lod = ANIMLOD_FULL;
+		if( enabled && numViews )
+		{
+			distSqr = idMath::INFINITY;
+			for( i = 0; i < numViews; i++ )
+			{
+				distSqr = Min( distSqr, ( ent->GetPhysics()->GetOrigin() - viewOrigins[ i ] ).LengthSqr() );
+			}
+			
+			lastVisibleFrame = gameRenderWorld->GetEntityLastVisibleFrame( ent->GetModelDefHandle() );
+			if( renderFrame - lastVisibleFrame > g_animLODHiddenFrames.GetInteger() )
+			{
+				lod = ANIMLOD_HIDDEN;
+			}
+			else if( distSqr > farDistSqr )
+			{
+				lod = ANIMLOD_FAR;
+			}
+			else if( distSqr > nearDistSqr )
+			{
+				lod = ANIMLOD_NEAR;
+			}
+		}
+		
+		switch( lod )
+		{
+			case ANIMLOD_FULL:
+				animator->SetLOD( 1, 0 );
+				break;
+			case ANIMLOD_NEAR:
+				animator->SetLOD( g_animLODNearInterval.GetInteger(), 0 );
+				break;
+			case ANIMLOD_FAR:
+				animator->SetLOD( g_animLODFarInterval.GetInteger(), g_animLODFarJointDepth.GetInteger() );
+				break;
+			default:
+				animator->SetLOD( g_animLODHiddenInterval.GetInteger(), g_animLODFarJointDepth.GetInteger() );
+				break;
+		}
+		numLOD[ lod ]++;
+	}
+}
+
+/*
+=====================
+idAnimStage::CountFrame
+=====================
+*/
+void idAnimStage::CountFrame()
+{
+	numFrames.Increment();
+}
+
+/*
+=====================
+idAnimStage::CountJoints
+=====================
+*/
+void idAnimStage::CountJoints( int num )
+{
+	numJoints.Add( num );
+}
+
+/*
+=====================
+idAnimStage::PrintStats
+
+Prints the frames created and joints blended since the last Run, which
+includes the frames the renderer asked for after the last game frame.
+=====================
+*/
+void idAnimStage::PrintStats() const
+{
+	gameLocal.Printf( "anim lod: %3d full, %3d near, %3d far, %3d hidden, %3d frames, %6d joints\n",
+					  numLOD[ ANIMLOD_FULL ], numLOD[ ANIMLOD_NEAR ], numLOD[ ANIMLOD_FAR ], numLOD[ ANIMLOD_HIDDEN ],
+					  numFrames.GetValue(), numJoints.GetValue() );
+}
+
+/*
+=====================
+idAnimStage::StartBenchmark
+
+Creates the frames on the game thread and on job threads on alternate frames and compares their times
+=====================
+*/
+void idAnimStage::StartBenchmark( int numFrames )
+{
+	if( benchmarkFrames > 0 )
+	{
+		gameLocal.Printf( "anim stage benchmark already running\n" );
+		return;
+	}
+	
+	benchmarkNumFrames[0] = benchmarkNumFrames[1] = 0;
+	benchmarkNumAnimators[0] = benchmarkNumAnimators[1] = 0;
+	benchmarkTime[0] = benchmarkTime[1] = 0;
+	
+	// the last Run only prints the results
+	benchmarkFrames = numFrames * 2 + 1;
+	
+	gameLocal.Printf( "benchmarking the anim stage over %d frames\n", numFrames * 2 );
+}
+
+/*
+=====================
+idAnimStage::FinishBenchmark
+=====================
+*/
+void idAnimStage::FinishBenchmark()
+{
+	const float serial = benchmarkTime[0] * 0.001f / Max( 1, benchmarkNumFrames[0] );
+	const float parallel = benchmarkTime[1] * 0.001f / Max( 1, benchmarkNumFrames[1] );
+	
+	gameLocal.Printf( "anim stage over %d frames on %s:\n", benchmarkNumFrames[0] + benchmarkNumFrames[1], gameLocal.GetMapName() );
+	gameLocal.Printf( "   game thread: %7.3f ms per frame, %5.1f animators\n", serial, benchmarkNumAnimators[0] / ( float )Max( 1, benchmarkNumFrames[0] ) );
+	gameLocal.Printf( "   job threads: %7.3f ms per frame, %5.1f animators\n", parallel, benchmarkNumAnimators[1] / ( float )Max( 1, benchmarkNumFrames[1] ) );
+	if( parallel > 0.0f )
+	{
+		gameLocal.Printf( "       speedup: %7.2fx\n", serial / parallel );
+	}
+}
+
 /***********************************************************************
 
 	Util functions
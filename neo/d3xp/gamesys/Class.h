@@ -309,6 +309,10 @@ public:
 	static idTypeInfo* 			GetType( int num );
 	
 private:
+	friend class idEvent;
+	
+	idLinkList<idEvent>			scheduledEvents;		// so events can be cancelled without searching the event queues
+	
 	classSpawnFunc_t			CallSpawnFunc( idTypeInfo* cls );
 	
 	bool						PostEventArgs( const idEventDef* ev, int time, int numargs, ... );
@@ -40,6 +40,8 @@ Event are used for scheduling tasks and for linking script commands.
 #include "../Game_local.h"
 
 #define MAX_EVENTSPERFRAME			4096
+#define EVENT_ARG_POOLS				10			// argument block sizes from 16 to 8192 bytes
+#define EVENT_ARG_MIN_BLOCK			16
 //#define CREATE_EVENT_CODE
 
 /***********************************************************************
@@ -91,6 +93,7 @@ idEventDef::idEventDef( const char* command, const char* formatspec, char return
 	// make sure the format for the args is valid, calculate the formatspecindex, and the offsets for each arg
 	bits = 0;
 	argsize = 0;
+	argPool = 0;
 	memset( argOffset, 0, sizeof( argOffset ) );
 	for( i = 0; i < numargs; i++ )
 	{
@@ -144,6 +147,18 @@ idEventDef::idEventDef( const char* command, const char* formatspec, char return
 		}
 	}
 	
+	// pick the smallest argument blocks the args fit in
+	while( ( size_t )( EVENT_ARG_MIN_BLOCK << argPool ) < argsize )
+	{
+		argPool++;
+	}
+	if( argPool >= EVENT_ARG_POOLS )
+	{
+		eventError = true;
+		sprintf( eventErrorMsg, "idEventDef::idEventDef : Args too large for '%s' event.", name );
+		return;
+	}
+	
 	// calculate the formatspecindex
 	formatspecIndex = ( 1 << ( numargs + D_EVENT_MAXARGS ) ) | bits;
 	
@@ -234,6 +249,582 @@ const idEventDef* idEventDef::FindEvent( const char* name )
 	return NULL;
 }
 
+/***********************************************************************
+
+  idEventTimerWheel
+
+  Hierarchical timer wheel holding the scheduled events.  The root wheel
+  has a slot for every millisecond of the current 256 msec, every further
+  level has 64 slots that each cover a whole turn of the level below.
+  When the serviced time crosses into the next slot of a level, that slot
+  is cascaded down into the finer levels, so every event is moved at most
+  once per level and scheduling, cancelling and servicing are all O(1)
+  amortized.  Events are serviced in time order and events scheduled for
+  the same time in the order they were scheduled, as with the old sorted
+  list.  Events scheduled for a time the wheel has already passed go into
+  a small sorted overdue list that is serviced first.
+
+***********************************************************************/
+
+#define EVENT_WHEEL_LEVELS			5
+#define EVENT_WHEEL_ROOT_BITS		8
+#define EVENT_WHEEL_LEVEL_BITS		6
+#define EVENT_WHEEL_ROOT_SLOTS		( 1 << EVENT_WHEEL_ROOT_BITS )
+#define EVENT_WHEEL_LEVEL_SLOTS		( 1 << EVENT_WHEEL_LEVEL_BITS )
+#define EVENT_WHEEL_SLOTS			( EVENT_WHEEL_ROOT_SLOTS + ( EVENT_WHEEL_LEVELS - 1 ) * EVENT_WHEEL_LEVEL_SLOTS )
+
+class idEventTimerWheel
+{
+public:
+	idEventTimerWheel();
+	
+	void					Clear();
+	void					Insert( idEvent* event );
+	void					Remove( idEvent* event );
+	idEvent* 				NextDue( int time );
+	int						Num() const
+	{
+		return num;
+	}
+	void					GetEvents( idList<idEvent*>& list ) const;
+	
+	static int				CompareEvents( const idEvent* a, const idEvent* b );
+	
+private:
+	idLinkList<idEvent>		overdue;					// sorted by time
+	idLinkList<idEvent>		slots[ EVENT_WHEEL_SLOTS ];
+	int						levelNum[ EVENT_WHEEL_LEVELS ];
+	int						position;					// next msec to service, every earlier event is overdue
+	int						num;
+	
+	int						NumInWheel() const;
+	void					Cascade();
+	
+	static int				LevelShift( int level );
+	static int				SlotIndex( int level, int time );
+};
+
+/*
+================
+idEventTimerWheel::idEventTimerWheel
+================
+*/
+idEventTimerWheel::idEventTimerWheel()
+{
+	memset( levelNum, 0, sizeof( levelNum ) );
+	position = 0;
+	num = 0;
+}
+
+/*
+================
+idEventTimerWheel::LevelShift
+================
+*/
+int idEventTimerWheel::LevelShift( int level )
+{
+	if( level == 0 )
+	{
+		return 0;
+	}
+	return EVENT_WHEEL_ROOT_BITS + ( level - 1 ) * EVENT_WHEEL_LEVEL_BITS;
+}
+
+/*
+================
+idEventTimerWheel::SlotIndex
+================
+*/
+int idEventTimerWheel::SlotIndex( int level, int time )
+{
+	if( level == 0 )
+	{
+		return time & ( EVENT_WHEEL_ROOT_SLOTS - 1 );
+	}
+	return EVENT_WHEEL_ROOT_SLOTS + ( level - 1 ) * EVENT_WHEEL_LEVEL_SLOTS + ( ( ( unsigned int )time >> LevelShift( level ) ) & ( EVENT_WHEEL_LEVEL_SLOTS - 1 ) );
+}
+
+/*
+================
+idEventTimerWheel::NumInWheel
+================
+*/
+int idEventTimerWheel::NumInWheel() const
+{
+	int total = 0;
+	for( int i = 0; i < EVENT_WHEEL_LEVELS; i++ )
+	{
+		total += levelNum[ i ];
+	}
+	return total;
+}
+
+/*
+================
+idEventTimerWheel::Clear
+================
+*/
+void idEventTimerWheel::Clear()
+{
+	overdue.Clear();
+	for( int i = 0; i < EVENT_WHEEL_SLOTS; i++ )
+	{
+		slots[ i ].Clear();
+	}
+	memset( levelNum, 0, sizeof( levelNum ) );
+	position = 0;
+	num = 0;
+}
+
+/*
+================
+idEventTimerWheel::Insert
+================
+*/
+void idEventTimerWheel::Insert( idEvent* event )
+{
+	idEvent*	prev;
+	int			level;
+	
+	assert( event->queue == NULL );
+	
+	// an empty wheel can be wound back to the first event instead of treating it as overdue
+	if( ( num == 0 ) && ( event->time < position ) )
+	{
+		position = event->time;
+	}
+	
+	event->queue = this;
+	num++;
+	
+	if( event->time < position )
+	{
+		// new events are usually the latest ones, so search from the end
+		prev = overdue.Prev();
+		while( ( prev != NULL ) && ( prev->time > event->time ) )
+		{
+			prev = prev->eventNode.Prev();
+		}
+		
+		if( prev != NULL )
+		{
+			event->eventNode.InsertAfter( prev->eventNode );
+		}
+		else
+		{
+			event->eventNode.AddToFront( overdue );
+		}
+		event->wheelLevel = -1;
+		return;
+	}
+	
+	// find the finest level whose current turn includes the event
+	const unsigned int time = event->time;
+	const unsigned int current = position;
+	for( level = 0; level < EVENT_WHEEL_LEVELS - 1; level++ )
+	{
+		if( ( time >> LevelShift( level + 1 ) ) == ( current >> LevelShift( level + 1 ) ) )
+		{
+			break;
+		}
+	}
+	
+	event->eventNode.AddToEnd( slots[ SlotIndex( level, event->time ) ] );
+	event->wheelLevel = level;
+	levelNum[ level ]++;
+}
+
+/*
+================
+idEventTimerWheel::Remove
+================
+*/
+void idEventTimerWheel::Remove( idEvent* event )
+{
+	assert( event->queue == this );
+	
+	event->eventNode.Remove();
+	if( event->wheelLevel >= 0 )
+	{
+		levelNum[ event->wheelLevel ]--;
+	}
+	event->queue = NULL;
+	num--;
+}
+
+/*
+================
+idEventTimerWheel::Cascade
+
+Called when the wheel position enters a new turn of the root wheel
+================
+*/
+void idEventTimerWheel::Cascade()
+{
+	idEvent* event;
+	
+	// start at the coarsest level that rolled over, so events trickle all the way down
+	for( int level = EVENT_WHEEL_LEVELS - 1; level > 0; level-- )
+	{
+		if( position & ( ( 1 << LevelShift( level ) ) - 1 ) )
+		{
+			continue;
+		}
+		
+		idLinkList<idEvent>& slot = slots[ SlotIndex( level, position ) ];
+		while( ( event = slot.Next() ) != NULL )
+		{
+			Remove( event );
+			Insert( event );
+		}
+	}
+}
+
+/*
+================
+idEventTimerWheel::NextDue
+
+Removes and returns the next event scheduled at or before the given time, NULL if there is none
+================
+*/
+idEvent* idEventTimerWheel::NextDue( int time )
+{
+	idEvent* event;
+	
+	event = overdue.Next();
+	if( ( event != NULL ) && ( event->time <= time ) )
+	{
+		Remove( event );
+		return event;
+	}
+	
+	while( position <= time )
+	{
+		event = slots[ SlotIndex( 0, position ) ].Next();
+		if( event != NULL )
+		{
+			Remove( event );
+			return event;
+		}
+		
+		if( NumInWheel() == 0 )
+		{
+			// nothing to cascade, jump straight to the end
+			position = time + 1;
+			break;
+		}
+		
+		if( levelNum[ 0 ] == 0 )
+		{
+			// skip the rest of this turn of the root wheel
+			position = Min( ( position | ( EVENT_WHEEL_ROOT_SLOTS - 1 ) ) + 1, time + 1 );
+		}
+		else
+		{
+			position++;
+		}
+		
+		if( ( position & ( EVENT_WHEEL_ROOT_SLOTS - 1 ) ) == 0 )
+		{
+			Cascade();
+		}
+	}
+	
+	return NULL;
+}
+
+/*
+================
+idEventTimerWheel::CompareEvents
+================
+*/
+int idEventTimerWheel::CompareEvents( const idEvent* a, const idEvent* b )
+{
+	if( a->time != b->time )
+	{
+		return ( a->time < b->time ) ? -1 : 1;
+	}
+	return a->sequence - b->sequence;
+}
+
+class idSort_EventsByTime : public idSort_Quick< idEvent*, idSort_EventsByTime >
+{
+public:
+	int Compare( idEvent* const& a, idEvent* const& b ) const
+	{
+		return idEventTimerWheel::CompareEvents( a, b );
+	}
+};
+
+/*
+================
+idEventTimerWheel::GetEvents
+
+Lists all events in the order they will be serviced
+================
+*/
+void idEventTimerWheel::GetEvents( idList<idEvent*>& list ) const
+{
+	idEvent* event;
+	
+	list.SetNum( 0 );
+	for( event = overdue.Next(); event != NULL; event = event->eventNode.Next() )
+	{
+		list.Append( event );
+	}
+	for( int i = 0; i < EVENT_WHEEL_SLOTS; i++ )
+	{
+		for( event = slots[ i ].Next(); event != NULL; event = event->eventNode.Next() )
+		{
+			list.Append( event );
+		}
+	}
+	list.SortWithTemplate( idSort_EventsByTime() );
+}
+
+/***********************************************************************
+
+  idEventArgPool
+
+  Storage for the arguments of scheduled events.  The blocks are split
+  into size classes and every event definition picks its size class when
+  it is constructed.  Blocks are carved from chunks that are allocated in
+  Init for every size class an event uses, and freed blocks go back on the
+  free list of their size class, so posting and servicing events does no
+  heap allocation.  A size class only grows by another chunk when all its
+  blocks are in use, and the chunks are kept until Shutdown.
+
+***********************************************************************/
+
+#define EVENT_ARG_CHUNK_SIZE		( 16 * 1024 )
+#define EVENT_ARG_CHUNK_BLOCKS		8			// minimum number of blocks in a chunk
+#define EVENT_ARG_CHUNK_HEADER		16			// keeps the blocks 16 byte aligned
+
+class idEventArgPool
+{
+public:
+	idEventArgPool();
+	
+	void					Init();
+	void					Shutdown();
+	byte* 					Alloc( int pool );
+	void					Free( byte* data, int pool );
+	void					PrintStats() const;
+	
+	int						NumAllocs() const
+	{
+		return numAllocs;
+	}
+	int						NumHeapAllocs() const
+	{
+		return numHeapAllocs;
+	}
+	
+	static int				BlockSize( int pool )
+	{
+		return EVENT_ARG_MIN_BLOCK << pool;
+	}
+	
+private:
+	typedef struct eventArgBlock_s
+	{
+		struct eventArgBlock_s* 	next;
+	} eventArgBlock_t;
+	
+	eventArgBlock_t* 		freeList[ EVENT_ARG_POOLS ];
+	int						numBlocks[ EVENT_ARG_POOLS ];
+	int						numUsed[ EVENT_ARG_POOLS ];
+	int						peakUsed[ EVENT_ARG_POOLS ];
+	byte* 					chunks;						// linked through the first bytes of every chunk
+	int						numAllocs;					// blocks handed out since Init
+	int						numHeapAllocs;				// chunks allocated since Init
+	
+	void					AllocChunk( int pool );
+};
+
+/*
+================
+idEventArgPool::idEventArgPool
+================
+*/
+idEventArgPool::idEventArgPool()
+{
+	memset( freeList, 0, sizeof( freeList ) );
+	memset( numBlocks, 0, sizeof( numBlocks ) );
+	memset( numUsed, 0, sizeof( numUsed ) );
+	memset( peakUsed, 0, sizeof( peakUsed ) );
+	chunks = NULL;
+	numAllocs = 0;
+	numHeapAllocs = 0;
+}
+
+/*
+================
+idEventArgPool::Init
+
+Preallocates blocks for every size class used by an event definition.
+================
+*/
+void idEventArgPool::Init()
+{
+	bool	used[ EVENT_ARG_POOLS ];
+	int		i;
+	
+	Shutdown();
+	
+	memset( used, 0, sizeof( used ) );
+	for( i = 0; i < idEventDef::NumEventCommands(); i++ )
+	{
+		const idEventDef* ev = idEventDef::GetEventCommand( i );
+		if( ev->GetArgSize() )
+		{
+			used[ ev->GetArgPool() ] = true;
+		}
+	}
+	
+	for( i = 0; i < EVENT_ARG_POOLS; i++ )
+	{
+		if( used[ i ] )
+		{
+			AllocChunk( i );
+		}
+	}
+}
+
+/*
+================
+idEventArgPool::Shutdown
+================
+*/
+void idEventArgPool::Shutdown()
+{
+	byte* next;
+	
+	while( chunks )
+	{
+		next = *reinterpret_cast<byte**>( chunks );
+		Mem_Free16( chunks );
+		chunks = next;
+	}
+	
+	memset( freeList, 0, sizeof( freeList ) );
+	memset( numBlocks, 0, sizeof( numBlocks ) );
+	memset( numUsed, 0, sizeof( numUsed ) );
+	memset( peakUsed, 0, sizeof( peakUsed ) );
+	numAllocs = 0;
+	numHeapAllocs = 0;
+}
+
+/*
+================
+idEventArgPool::AllocChunk
+================
+*/
+void idEventArgPool::AllocChunk( int pool )
+{
+	eventArgBlock_t*	block;
+	byte*				chunk;
+	int					blockSize;
+	int					count;
+	int					i;
+	
+	blockSize = BlockSize( pool );
+	count = Max( EVENT_ARG_CHUNK_SIZE / blockSize, EVENT_ARG_CHUNK_BLOCKS );
+	
+	chunk = ( byte* )Mem_Alloc16( EVENT_ARG_CHUNK_HEADER + count * blockSize, TAG_BLOCKALLOC );
+	*reinterpret_cast<byte**>( chunk ) = chunks;
+	chunks = chunk;
+	numHeapAllocs++;
+	
+	// link the blocks in address order
+	for( i = count - 1; i >= 0; i-- )
+	{
+		block = reinterpret_cast<eventArgBlock_t*>( chunk + EVENT_ARG_CHUNK_HEADER + i * blockSize );
+		block->next = freeList[ pool ];
+		freeList[ pool ] = block;
+	}
+	numBlocks[ pool ] += count;
+}
+
+/*
+================
+idEventArgPool::Alloc
+================
+*/
+byte* idEventArgPool::Alloc( int pool )
+{
+	eventArgBlock_t* block;
+	
+	assert( pool >= 0 && pool < EVENT_ARG_POOLS );
+	
+	if( !freeList[ pool ] )
+	{
+		AllocChunk( pool );
+	}
+	
+	block = freeList[ pool ];
+	freeList[ pool ] = block->next;
+	
+	numUsed[ pool ]++;
+	if( numUsed[ pool ] > peakUsed[ pool ] )
+	{
+		peakUsed[ pool ] = numUsed[ pool ];
+	}
+	numAllocs++;
+	
+	return reinterpret_cast<byte*>( block );
+}
+
+/*
+================
+idEventArgPool::Free
+================
+*/
+void idEventArgPool::Free( byte* data, int pool )
+{
+	eventArgBlock_t* block;
+	
+	assert( pool >= 0 && pool < EVENT_ARG_POOLS );
+	assert( numUsed[ pool ] > 0 );
+	
+	block = reinterpret_cast<eventArgBlock_t*>( data );
+	block->next = freeList[ pool ];
+	freeList[ pool ] = block;
+	numUsed[ pool ]--;
+}
+
+/*
+================
+idEventArgPool::PrintStats
+================
+*/
+void idEventArgPool::PrintStats() const
+{
+	int	numEvents[ EVENT_ARG_POOLS ];
+	int	i;
+	
+	memset( numEvents, 0, sizeof( numEvents ) );
+	for( i = 0; i < idEventDef::NumEventCommands(); i++ )
+	{
+		const idEventDef* ev = idEventDef::GetEventCommand( i );
+		if( ev->GetArgSize() )
+		{
+			numEvents[ ev->GetArgPool() ]++;
+		}
+	}
+	
+	gameLocal.Printf( "block size  events  blocks    used    peak\n" );
+	gameLocal.Printf( "----------  ------  ------  ------  ------\n" );
+	for( i = 0; i < EVENT_ARG_POOLS; i++ )
+	{
+		if( numEvents[ i ] || numBlocks[ i ] )
+		{
+			gameLocal.Printf( "%10d  %6d  %6d  %6d  %6d\n", BlockSize( i ), numEvents[ i ], numBlocks[ i ], numUsed[ i ], peakUsed[ i ] );
+		}
+	}
+	gameLocal.Printf( "%d blocks allocated from %d chunks\n", numAllocs, numHeapAllocs );
+}
+
 /***********************************************************************
 
   idEvent
@@ -241,13 +832,19 @@ const idEventDef* idEventDef::FindEvent( const char* name )
 ***********************************************************************/
 
 static idLinkList<idEvent> FreeEvents;
-static idLinkList<idEvent> EventQueue;
-static idLinkList<idEvent> FastEventQueue;
+static idEventTimerWheel EventQueue;
+static idEventTimerWheel FastEventQueue;
+static idEventArgPool EventArgPool;
 static idEvent EventPool[ MAX_EVENTS ];
 
-bool idEvent::initialized = false;
+static int eventSequence = 0;
 
-idDynamicBlockAlloc<byte, 16* 1024, 256>	idEvent::eventDataAllocator;
+// event counts since the last ServiceEvents, see g_eventStats
+static int numEventsScheduled = 0;
+static int numEventsFired = 0;
+static int numEventsCancelled = 0;
+
+bool idEvent::initialized = false;
 
 /*
 ================
@@ -292,7 +889,7 @@ idEvent* idEvent::Alloc( const idEventDef* evdef, int numargs, va_list args )
 	size = evdef->GetArgSize();
 	if( size )
 	{
-		ev->data = eventDataAllocator.Alloc( size );
+		ev->data = EventArgPool.Alloc( evdef->GetArgPool() );
 		memset( ev->data, 0, size );
 	}
 	else
@@ -414,9 +1011,15 @@ idEvent::Free
 */
 void idEvent::Free()
 {
+	if( queue )
+	{
+		queue->Remove( this );
+	}
+	objectNode.Remove();
+	
 	if( data )
 	{
-		eventDataAllocator.Free( data );
+		EventArgPool.Free( data, eventdef->GetArgPool() );
 		data = NULL;
 	}
 	
@@ -436,8 +1039,6 @@ idEvent::Schedule
 */
 void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 {
-	idEvent* event;
-	
 	assert( initialized );
 	if( !initialized )
 	{
@@ -447,49 +1048,45 @@ void idEvent::Schedule( idClass* obj, const idTypeInfo* type, int time )
 	object = obj;
 	typeinfo = type;
 	
-	// wraps after 24 days...like I care. ;)
-	this->time = gameLocal.time + time;
+	if( queue )
+	{
+		queue->Remove( this );
+	}
 	
-	eventNode.Remove();
+	objectNode.SetOwner( this );
+	objectNode.AddToEnd( obj->scheduledEvents );
+	sequence = eventSequence++;
+	numEventsScheduled++;
 	
+	// wraps after 24 days...like I care. ;)
 	if( obj->IsType( idEntity::Type ) && ( ( ( idEntity* )( obj ) )->timeGroup == TIME_GROUP2 ) )
 	{
-		event = FastEventQueue.Next();
-		while( ( event != NULL ) && ( this->time >= event->time ) )
-		{
-			event = event->eventNode.Next();
-		}
-		
-		if( event )
-		{
-			eventNode.InsertBefore( event->eventNode );
-		}
-		else
-		{
-			eventNode.AddToEnd( FastEventQueue );
-		}
-		
-		return;
+		this->time = gameLocal.time + time;
+		FastEventQueue.Insert( this );
 	}
 	else
 	{
 		this->time = gameLocal.slow.time + time;
+		EventQueue.Insert( this );
 	}
-	
-	event = EventQueue.Next();
-	while( ( event != NULL ) && ( this->time >= event->time ) )
-	{
-		event = event->eventNode.Next();
-	}
-	
-	if( event )
-	{
-		eventNode.InsertBefore( event->eventNode );
-	}
-	else
+}
+
+/*
+================
+idEvent::Reschedule
+
+Puts a restored event back into a queue, its time is already set
+================
+*/
+void idEvent::Reschedule( idEventTimerWheel& eventQueue )
+{
+	objectNode.SetOwner( this );
+	if( object != NULL )
 	{
-		eventNode.AddToEnd( EventQueue );
+		objectNode.AddToEnd( object->scheduledEvents );
 	}
+	sequence = eventSequence++;
+	eventQueue.Insert( this );
 }
 
 /*
@@ -507,27 +1104,13 @@ void idEvent::CancelEvents( const idClass* obj, const idEventDef* evdef )
 		return;
 	}
 	
-	for( event = EventQueue.Next(); event != NULL; event = next )
+	for( event = obj->scheduledEvents.Next(); event != NULL; event = next )
 	{
-		next = event->eventNode.Next();
-		if( event->object == obj )
+		next = event->objectNode.Next();
+		if( !evdef || ( evdef == event->eventdef ) )
 		{
-			if( !evdef || ( evdef == event->eventdef ) )
-			{
-				event->Free();
-			}
-		}
-	}
-	
-	for( event = FastEventQueue.Next(); event != NULL; event = next )
-	{
-		next = event->eventNode.Next();
-		if( event->object == obj )
-		{
-			if( !evdef || ( evdef == event->eventdef ) )
-			{
-				event->Free();
-			}
+			event->Free();
+			numEventsCancelled++;
 		}
 	}
 }
@@ -541,19 +1124,20 @@ void idEvent::ClearEventList()
 {
 	int i;
 	
-	//
-	// initialize lists
-	//
-	FreeEvents.Clear();
-	EventQueue.Clear();
-	
 	//
 	// add the events to the free list
 	//
+	FreeEvents.Clear();
 	for( i = 0; i < MAX_EVENTS; i++ )
 	{
 		EventPool[ i ].Free();
 	}
+	
+	//
+	// reset the queues
+	//
+	EventQueue.Clear();
+	FastEventQueue.Clear();
 }
 
 /*
@@ -577,17 +1161,17 @@ void idEvent::ServiceEvents()
 	byte*		data;
 	const char*  materialName;
 	
+	if( g_eventStats.GetBool() )
+	{
+		gameLocal.Printf( "events: %4d scheduled, %4d fired, %4d cancelled, %4d pending\n", numEventsScheduled, numEventsFired, numEventsCancelled, EventQueue.Num() + FastEventQueue.Num() );
+	}
+	numEventsScheduled = 0;
+	numEventsFired = 0;
+	numEventsCancelled = 0;
+	
 	num = 0;
-	while( !EventQueue.IsListEmpty() )
+	while( ( event = EventQueue.NextDue( gameLocal.time ) ) != NULL )
 	{
-		event = EventQueue.Next();
-		assert( event );
-		
-		if( event->time > gameLocal.time )
-		{
-			break;
-		}
-		
 		common->UpdateLevelLoadPacifier();
 		
 		// copy the data into the local args array and set up pointers
@@ -642,10 +1226,11 @@ void idEvent::ServiceEvents()
 			}
 		}
 		
-		// the event is removed from its list so that if then object
-		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		// the event is already out of the queue, also take it out of the object's
+		// list so that if the object is deleted, the event won't be freed twice
+		event->objectNode.Remove();
 		assert( event->object );
+		numEventsFired++;
 		event->object->ProcessEventArgPtr( ev, args );
 		
 #if 0
@@ -692,16 +1277,8 @@ void idEvent::ServiceFastEvents()
 	const char*  materialName;
 	
 	num = 0;
-	while( !FastEventQueue.IsListEmpty() )
+	while( ( event = FastEventQueue.NextDue( gameLocal.fast.time ) ) != NULL )
 	{
-		event = FastEventQueue.Next();
-		assert( event );
-		
-		if( event->time > gameLocal.fast.time )
-		{
-			break;
-		}
-		
 		// copy the data into the local args array and set up pointers
 		ev = event->eventdef;
 		formatspec = ev->GetArgFormat();
@@ -754,10 +1331,11 @@ void idEvent::ServiceFastEvents()
 			}
 		}
 		
-		// the event is removed from its list so that if then object
-		// is deleted, the event won't be freed twice
-		event->eventNode.Remove();
+		// the event is already out of the queue, also take it out of the object's
+		// list so that if the object is deleted, the event won't be freed twice
+		event->objectNode.Remove();
 		assert( event->object );
+		numEventsFired++;
 		event->object->ProcessEventArgPtr( ev, args );
 		
 #if 0
@@ -811,7 +1389,7 @@ void idEvent::Init()
 	
 	ClearEventList();
 	
-	eventDataAllocator.Init();
+	EventArgPool.Init();
 	
 	gameLocal.Printf( "...%i event definitions\n", idEventDef::NumEventCommands() );
 	
@@ -836,7 +1414,7 @@ void idEvent::Shutdown()
 	
 	ClearEventList();
 	
-	eventDataAllocator.Shutdown();
+	EventArgPool.Shutdown();
 	
 	// say it is now shutdown
 	initialized = false;
@@ -850,7 +1428,7 @@ idEvent::Save
 void idEvent::Save( idSaveGame* savefile )
 {
 	char* str;
-	int i, size;
+	int i, j, size;
 	idEvent*	event;
 	byte* dataPtr;
 	bool validTrace;
@@ -858,12 +1436,15 @@ void idEvent::Save( idSaveGame* savefile )
 	// RB: for missing D_EVENT_STRING
 	idStr s;
 	// RB end
+	idList<idEvent*> events;
 	
-	savefile->WriteInt( EventQueue.Num() );
+	// the events are written in the order they'll be serviced, just like the old sorted queues
+	EventQueue.GetEvents( events );
+	savefile->WriteInt( events.Num() );
 	
-	event = EventQueue.Next();
-	while( event != NULL )
+	for( j = 0; j < events.Num(); j++ )
 	{
+		event = events[ j ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
@@ -933,23 +1514,21 @@ void idEvent::Save( idSaveGame* savefile )
 			}
 		}
 		assert( size == ( int )event->eventdef->GetArgSize() );
-		event = event->eventNode.Next();
 	}
 	
 	// Save the Fast EventQueue
-	savefile->WriteInt( FastEventQueue.Num() );
+	FastEventQueue.GetEvents( events );
+	savefile->WriteInt( events.Num() );
 	
-	event = FastEventQueue.Next();
-	while( event != NULL )
+	for( j = 0; j < events.Num(); j++ )
 	{
+		event = events[ j ];
 		savefile->WriteInt( event->time );
 		savefile->WriteString( event->eventdef->GetName() );
 		savefile->WriteString( event->typeinfo->classname );
 		savefile->WriteObject( event->object );
 		savefile->WriteInt( event->eventdef->GetArgSize() );
 		savefile->Write( event->data, event->eventdef->GetArgSize() );
-		
-		event = event->eventNode.Next();
 	}
 }
 
@@ -981,7 +1560,6 @@ void idEvent::Restore( idRestoreGame* savefile )
 		
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( EventQueue );
 		
 		savefile->ReadInt( event->time );
 		
@@ -1015,7 +1593,7 @@ void idEvent::Restore( idRestoreGame* savefile )
 		}
 		if( argsize )
 		{
-			event->data = eventDataAllocator.Alloc( argsize );
+			event->data = EventArgPool.Alloc( event->eventdef->GetArgPool() );
 			format = event->eventdef->GetArgFormat();
 			assert( format );
 			for( j = 0, size = 0; j < event->eventdef->GetNumArgs(); ++j )
@@ -1085,6 +1663,8 @@ void idEvent::Restore( idRestoreGame* savefile )
 		{
 			event->data = NULL;
 		}
+		
+		event->Reschedule( EventQueue );
 	}
 	
 	// Restore the Fast EventQueue
@@ -1099,7 +1679,6 @@ void idEvent::Restore( idRestoreGame* savefile )
 		
 		event = FreeEvents.Next();
 		event->eventNode.Remove();
-		event->eventNode.AddToEnd( FastEventQueue );
 		
 		savefile->ReadInt( event->time );
 		
@@ -1131,13 +1710,15 @@ void idEvent::Restore( idRestoreGame* savefile )
 		}
 		if( argsize )
 		{
-			event->data = eventDataAllocator.Alloc( argsize );
+			event->data = EventArgPool.Alloc( event->eventdef->GetArgPool() );
 			savefile->Read( event->data, argsize );
 		}
 		else
 		{
 			event->data = NULL;
 		}
+		
+		event->Reschedule( FastEventQueue );
 	}
 }
 
@@ -1191,7 +1772,115 @@ void idEvent::SaveTrace( idSaveGame* savefile, const trace_t& trace )
 	savefile->WriteInt( trace.c.id );
 }
 
+/*
+================
+eventArgStats
+================
+*/
+CONSOLE_COMMAND( eventArgStats, "lists the blocks of the event argument pools", 0 )
+{
+	EventArgPool.PrintStats();
+}
+
+/*
+================
+eventArgStress
 
+Posts events with every kind of argument block on a temporary entity and
+cancels them again, reporting how many blocks and heap allocations the
+event argument pools needed.  Only the first pass should ever have to
+grow the pools.
+================
+*/
+CONSOLE_COMMAND( eventArgStress, "posts and cancels events on a temporary entity to test the event argument pools: [count] [passes]", 0 )
+{
+	const idEventDef* 	stressEvents[ 4 ] = { &EV_SetShaderParm, &EV_SetAngles, &EV_SetSkin, &EV_SetOwner };
+	idEntity*			ent;
+	idRandom			random;
+	idVec3				vec;
+	int					count;
+	int					numPasses;
+	int					maxCount;
+	int					pass;
+	int					time;
+	int					i;
+	int					numAllocs;
+	int					numHeapAllocs;
+	uint64				startTime;
+	
+	if( !idEvent::initialized || gameLocal.GameState() != GAMESTATE_ACTIVE )
+	{
+		gameLocal.Printf( "no map loaded\n" );
+		return;
+	}
+	
+	count = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 2000;
+	numPasses = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : 4;
+	
+	// leave some free events for the game
+	maxCount = MAX_EVENTS - EventQueue.Num() - FastEventQueue.Num() - 256;
+	if( count > maxCount )
+	{
+		count = maxCount;
+	}
+	if( count <= 0 || numPasses <= 0 )
+	{
+		return;
+	}
+	
+	vec.Zero();
+	
+	gameLocal.Printf( "before: %d blocks allocated from %d chunks\n", EventArgPool.NumAllocs(), EventArgPool.NumHeapAllocs() );
+	
+	for( pass = 0; pass < numPasses; pass++ )
+	{
+		ent = gameLocal.SpawnEntityType( idEntity::Type );
+		if( ent == NULL )
+		{
+			return;
+		}
+		
+		numAllocs = EventArgPool.NumAllocs();
+		numHeapAllocs = EventArgPool.NumHeapAllocs();
+		startTime = Sys_Microseconds();
+		
+		for( i = 0; i < count; i++ )
+		{
+			// far enough in the future to never be serviced
+			time = SEC2MS( 3600 ) + random.RandomInt( SEC2MS( 60 ) );
+			switch( i % 4 )
+			{
+				case 0 :
+					ent->PostEventMS( &EV_SetShaderParm, time, 0, 1.0f );
+					break;
+				case 1 :
+					ent->PostEventMS( &EV_SetAngles, time, vec );
+					break;
+				case 2 :
+					ent->PostEventMS( &EV_SetSkin, time, "" );
+					break;
+				case 3 :
+					ent->PostEventMS( &EV_SetOwner, time, ent );
+					break;
+			}
+			
+			// now and then free all events of a kind so the blocks are reused in a different order
+			if( random.RandomInt( 64 ) == 0 )
+			{
+				ent->CancelEvents( stressEvents[ random.RandomInt( 4 ) ] );
+			}
+		}
+		
+		// cancels the remaining events
+		delete ent;
+		
+		gameLocal.Printf( "pass %d: %d events, %d blocks allocated, %d heap allocations, %d usec\n", pass + 1, count,
+						  EventArgPool.NumAllocs() - numAllocs, EventArgPool.NumHeapAllocs() - numHeapAllocs, ( int )( Sys_Microseconds() - startTime ) );
+	}
+	
+	gameLocal.Printf( "after: %d blocks allocated from %d chunks\n", EventArgPool.NumAllocs(), EventArgPool.NumHeapAllocs() );
+	EventArgPool.PrintStats();
+}
 
 #ifdef CREATE_EVENT_CODE
 /*
@@ -66,6 +66,7 @@ private:
 	int							numargs;
 	size_t						argsize;
 	int							argOffset[ D_EVENT_MAXARGS ];
+	int							argPool;			// size class of the event argument pool
 	int							eventnum;
 	const idEventDef* 			next;
 	
@@ -83,6 +84,7 @@ public:
 	int							GetNumArgs() const;
 	size_t						GetArgSize() const;
 	int							GetArgOffset( int arg ) const;
+	int							GetArgPool() const;
 	
 	static int					NumEventCommands();
 	static const idEventDef*		GetEventCommand( int eventnum );
@@ -91,9 +93,12 @@ public:
 
 class idSaveGame;
 class idRestoreGame;
+class idEventTimerWheel;
 
 class idEvent
 {
+	friend class idEventTimerWheel;
+	
 private:
 	const idEventDef*			eventdef;
 	byte*						data;
@@ -102,9 +107,12 @@ private:
 	const idTypeInfo*			typeinfo;
 	
 	idLinkList<idEvent>			eventNode;
+	idLinkList<idEvent>			objectNode;			// in the list of events scheduled on the object
+	idEventTimerWheel*			queue;				// queue the event is scheduled in, NULL if it isn't
+	int							wheelLevel;			// timer wheel level in the queue, -1 if overdue
+	int							sequence;			// orders events scheduled for the same time
 	
-	static idDynamicBlockAlloc<byte, 16* 1024, 256> eventDataAllocator;
-	
+	void						Reschedule( idEventTimerWheel& eventQueue );
 	
 public:
 	static bool					initialized;
@@ -216,6 +224,16 @@ ID_INLINE int idEventDef::GetArgOffset( int arg ) const
 	return argOffset[ arg ];
 }
 
+/*
+================
+idEventDef::GetArgPool
+================
+*/
+ID_INLINE int idEventDef::GetArgPool() const
+{
+	return argPool;
+}
+
 /*
 ================
 idEventDef::GetEventNum
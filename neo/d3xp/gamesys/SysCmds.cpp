@@ -1634,6 +1634,152 @@ static void Cmd_ListAnims_f( const idCmdArgs& args )
 	}
 }
 
+/*
+==================
+Cmd_ReportAnimCompression_f
+==================
+*/
+static void Cmd_ReportAnimCompression_f( const idCmdArgs& args )
+{
+	animationLib.ReportCompression( ( args.Argc() > 1 ) ? args.Argv( 1 ) : NULL );
+}
+
+/*
+==================
+Cmd_AnimStageBenchmark_f
+==================
+*/
+static void Cmd_AnimStageBenchmark_f( const idCmdArgs& args )
+{
+	const int numFrames = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 600;
+	gameLocal.animStage.StartBenchmark( numFrames );
+}
+
+/*
+==================
+SkinModelDef
+
+Skins the model of a model def on the CPU through every frame of all its anims
+and returns the time spent skinning in microseconds.
+==================
+*/
+static uint64 SkinModelDef( const idDeclModelDef* modelDef, int& numAnims, int& numFrames, int64& numVerts )
+{
+	idRenderModel* model = modelDef->ModelHandle();
+	if( model == NULL || model->IsDefaultModel() || model->NumJoints() == 0 )
+	{
+		return 0;
+	}
+	
+	renderEntity_t ent;
+	memset( &ent, 0, sizeof( ent ) );
+	ent.customSkin = modelDef->GetDefaultSkin();
+	ent.numJoints = model->NumJoints();
+	ent.joints = ( idJointMat* )Mem_Alloc16( SIMD_ROUND_JOINTS( ent.numJoints ) * sizeof( *ent.joints ), TAG_JOINTMAT );
+	
+	idRenderModel* skinnedModel = NULL;
+	uint64 time = 0;
+	for( int i = 1; i < modelDef->NumAnims(); i++ )
+	{
+		const idAnim* anim = modelDef->GetAnim( i );
+		const idMD5Anim* md5anim = ( anim != NULL ) ? anim->MD5Anim( 0 ) : NULL;
+		if( md5anim == NULL || md5anim->NumJoints() != ent.numJoints )
+		{
+			continue;
+		}
+		
+		numAnims++;
+		for( int frame = 0; frame < md5anim->NumFrames(); frame++ )
+		{
+			const int frameTime = md5anim->Length() * frame / Max( 1, md5anim->NumFrames() - 1 );
+			gameEdit->ANIM_CreateAnimFrame( model, md5anim, ent.numJoints, ent.joints, frameTime, modelDef->GetVisualOffset(), false );
+			SIMD_INIT_LAST_JOINT( ent.joints, ent.numJoints );
+			
+			const uint64 startTime = Sys_Microseconds();
+			skinnedModel = model->InstantiateDynamicModel( &ent, NULL, skinnedModel );
+			time += Sys_Microseconds() - startTime;
+			
+			if( skinnedModel == NULL )
+			{
+				break;
+			}
+			
+			numFrames++;
+			for( int j = 0; j < skinnedModel->NumSurfaces(); j++ )
+			{
+				numVerts += skinnedModel->Surface( j )->geometry->numVerts;
+			}
+		}
+	}
+	
+	delete skinnedModel;
+	Mem_Free16( ent.joints );
+	
+	return time;
+}
+
+/*
+==================
+Cmd_SkinningBenchmark_f
+
+Skins every MD5 model def through all its anims on the CPU, first with the
+scalar path, then with SIMD and then with SIMD and the meshes in parallel jobs.
+==================
+*/
+static void Cmd_SkinningBenchmark_f( const idCmdArgs& args )
+{
+	const char* filter = ( args.Argc() > 1 ) ? args.Argv( 1 ) : NULL;
+	
+	static const char* passNames[] = { "scalar", "SIMD", "SIMD + jobs" };
+	
+	const bool restoreGPUSkinning = cvarSystem->GetCVarBool( "r_useGPUSkinning" );
+	const bool restoreSIMDSkinning = cvarSystem->GetCVarBool( "r_useSIMDSkinning" );
+	const bool restoreParallelSkinning = cvarSystem->GetCVarBool( "r_useParallelSkinning" );
+	
+	// parse everything up front so the loading isn't part of the first pass
+	const int numModelDefs = declManager->GetNumDecls( DECL_MODELDEF );
+	for( int i = 0; i < numModelDefs; i++ )
+	{
+		declManager->DeclByIndex( DECL_MODELDEF, i, true );
+	}
+	
+	cvarSystem->SetCVarBool( "r_useGPUSkinning", false );
+	
+	for( int pass = 0; pass < 3; pass++ )
+	{
+		cvarSystem->SetCVarBool( "r_useSIMDSkinning", ( pass > 0 ) );
+		cvarSystem->SetCVarBool( "r_useParallelSkinning", ( pass > 1 ) );
+		
+		int numModels = 0;
+		int numAnims = 0;
+		int numFrames = 0;
+		int64 numVerts = 0;
+		uint64 time = 0;
+		for( int i = 0; i < numModelDefs; i++ )
+		{
+			const idDeclModelDef* modelDef = static_cast<const idDeclModelDef*>( declManager->DeclByIndex( DECL_MODELDEF, i, false ) );
+			if( modelDef == NULL || modelDef->ModelHandle() == NULL || modelDef->NumAnims() <= 1 )
+			{
+				continue;
+			}
+			if( filter != NULL && !idStr::Filter( filter, modelDef->GetName(), false ) )
+			{
+				continue;
+			}
+			time += SkinModelDef( modelDef, numAnims, numFrames, numVerts );
+			numModels++;
+		}
+		
+		const double seconds = Max( time, ( uint64 )1 ) * 0.000001;
+		gameLocal.Printf( "%-12s %4d models, %5d anims, %7d frames, %10lld verts in %7.1f ms, %6.2f million verts/sec\n",
+						  passNames[pass], numModels, numAnims, numFrames, numVerts, time * 0.001, numVerts / seconds * 0.000001 );
+	}
+	
+	cvarSystem->SetCVarBool( "r_useGPUSkinning", restoreGPUSkinning );
+	cvarSystem->SetCVarBool( "r_useSIMDSkinning", restoreSIMDSkinning );
+	cvarSystem->SetCVarBool( "r_useParallelSkinning", restoreParallelSkinning );
+}
+
 /*
 ==================
 Cmd_AASStats_f
@@ -1660,6 +1806,101 @@ static void Cmd_AASStats_f( const idCmdArgs& args )
 	}
 }
 
+/*
+==================
+Cmd_AASBuildRoutingTables_f
+==================
+*/
+static void Cmd_AASBuildRoutingTables_f( const idCmdArgs& args )
+{
+	int aasNum, i, numTravelFlags;
+	int travelFlags[16];
+	
+	if( !gameLocal.CheatsOk() )
+	{
+		return;
+	}
+	
+	aasNum = aas_test.GetInteger();
+	idAAS* aas = gameLocal.GetAAS( aasNum );
+	if( !aas )
+	{
+		gameLocal.Printf( "No aas #%d loaded\n", aasNum );
+		return;
+	}
+	
+	numTravelFlags = 0;
+	for( i = 1; i < args.Argc() && numTravelFlags < 16; i++ )
+	{
+		travelFlags[numTravelFlags++] = atoi( args.Argv( i ) );
+	}
+	if( !numTravelFlags )
+	{
+		travelFlags[numTravelFlags++] = TFL_WALK | TFL_AIR;
+	}
+	
+	if( !aas->BuildRoutingTables( travelFlags, numTravelFlags ) )
+	{
+		gameLocal.Printf( "failed to build the routing tables for aas #%d\n", aasNum );
+	}
+}
+
+/*
+==================
+Cmd_AASRoutingBenchmark_f
+==================
+*/
+static void Cmd_AASRoutingBenchmark_f( const idCmdArgs& args )
+{
+	int aasNum, numQueries, travelFlags;
+	
+	if( !gameLocal.CheatsOk() )
+	{
+		return;
+	}
+	
+	aasNum = aas_test.GetInteger();
+	idAAS* aas = gameLocal.GetAAS( aasNum );
+	if( !aas )
+	{
+		gameLocal.Printf( "No aas #%d loaded\n", aasNum );
+		return;
+	}
+	
+	numQueries = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 10000;
+	travelFlags = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : ( TFL_WALK | TFL_AIR );
+	
+	aas->RoutingBenchmark( numQueries, travelFlags );
+}
+
+/*
+==================
+Cmd_AASCompareRouting_f
+==================
+*/
+static void Cmd_AASCompareRouting_f( const idCmdArgs& args )
+{
+	int aasNum, numQueries, travelFlags;
+	
+	if( !gameLocal.CheatsOk() )
+	{
+		return;
+	}
+	
+	aasNum = aas_test.GetInteger();
+	idAAS* aas = gameLocal.GetAAS( aasNum );
+	if( !aas )
+	{
+		gameLocal.Printf( "No aas #%d loaded\n", aasNum );
+		return;
+	}
+	
+	numQueries = ( args.Argc() > 1 ) ? atoi( args.Argv( 1 ) ) : 1000;
+	travelFlags = ( args.Argc() > 2 ) ? atoi( args.Argv( 2 ) ) : ( TFL_WALK | TFL_AIR );
+	
+	aas->CompareRouting( numQueries, travelFlags );
+}
+
 /*
 ==================
 Cmd_TestDamage_f
@@ -2252,6 +2493,82 @@ static void Cmd_DisasmScript_f( const idCmdArgs& args )
 	gameLocal.program.Disassemble();
 }
 
+/*
+==================
+Cmd_ScriptBenchmark_f
+
+Compiles every map script with and without the bytecode optimizer
+==================
+*/
+static void Cmd_ScriptBenchmark_f( const idCmdArgs& args )
+{
+	int				i;
+	int				pass;
+	int				numStatements[ 2 ];
+	int				compileTime[ 2 ];
+	int				totalStatements[ 2 ];
+	int				totalTime[ 2 ];
+	int				startTime;
+	int				firstStatement;
+	int				numFailed;
+	char*			src;
+	bool			optimize;
+	idFileList*		files;
+	
+	if( gameLocal.GameState() != GAMESTATE_NOMAP )
+	{
+		gameLocal.Printf( "scriptBenchmark can only be run without a map loaded\n" );
+		return;
+	}
+	
+	optimize = g_scriptOptimize.GetBool();
+	firstStatement = gameLocal.program.NumStatements();
+	totalStatements[ 0 ] = totalStatements[ 1 ] = 0;
+	totalTime[ 0 ] = totalTime[ 1 ] = 0;
+	numFailed = 0;
+	
+	files = fileSystem->ListFilesTree( "maps", ".script", true );
+	for( i = 0; i < files->GetNumFiles(); i++ )
+	{
+		if( fileSystem->ReadFile( files->GetFile( i ), ( void** )&src, NULL ) < 0 )
+		{
+			continue;
+		}
+		
+		for( pass = 0; pass < 2; pass++ )
+		{
+			g_scriptOptimize.SetBool( pass != 0 );
+			
+			startTime = Sys_Microseconds();
+			if( !gameLocal.program.CompileText( files->GetFile( i ), src, true ) )
+			{
+				numFailed++;
+			}
+			compileTime[ pass ] = Sys_Microseconds() - startTime;
+			numStatements[ pass ] = gameLocal.program.NumStatements() - firstStatement;
+			
+			totalStatements[ pass ] += numStatements[ pass ];
+			totalTime[ pass ] += compileTime[ pass ];
+			
+			// throw away the map script again
+			gameLocal.program.Restart();
+		}
+		
+		fileSystem->FreeFile( src );
+		
+		gameLocal.Printf( "%6d -> %6d statements, %6d / %6d usec: %s\n", numStatements[ 0 ], numStatements[ 1 ], compileTime[ 0 ], compileTime[ 1 ], files->GetFile( i ) );
+	}
+	
+	g_scriptOptimize.SetBool( optimize );
+	
+	gameLocal.Printf( "%d map scripts, %d failed to compile\n", files->GetNumFiles(), numFailed / 2 );
+	gameLocal.Printf( "%d statements unoptimized, %d optimized (%.1f%% removed)\n", totalStatements[ 0 ], totalStatements[ 1 ], totalStatements[ 0 ] ? ( totalStatements[ 0 ] - totalStatements[ 1 ] ) * 100.0f / totalStatements[ 0 ] : 0.0f );
+	gameLocal.Printf( "%d usec compiling, %d usec compiling and optimizing\n", totalTime[ 0 ], totalTime[ 1 ] );
+	gameLocal.Printf( "use g_scriptOpcodeStats and scriptOpcodeStats in game to compare executed statements\n" );
+	
+	fileSystem->FreeFileList( files );
+}
+
 /*
 ==================
 Cmd_TestSave_f
@@ -2717,7 +3034,13 @@ void idGameLocal::InitConsoleCommands()
 	cmdSystem->AddCommand( "collisionModelInfo",	Cmd_CollisionModelInfo_f,	CMD_FL_GAME,				"shows collision model info" );
 	cmdSystem->AddCommand( "reloadanims",			Cmd_ReloadAnims_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"reloads animations" );
 	cmdSystem->AddCommand( "listAnims",				Cmd_ListAnims_f,			CMD_FL_GAME,				"lists all animations" );
+	cmdSystem->AddCommand( "reportAnimCompression",	Cmd_ReportAnimCompression_f,	CMD_FL_GAME,			"compresses the loaded anims and reports the memory saved and the joint error: reportAnimCompression [filter]" );
+	cmdSystem->AddCommand( "animStageBenchmark",		Cmd_AnimStageBenchmark_f,	CMD_FL_GAME,			"compares creating the animator frames on the game thread and on job threads, run it on a map with many animated entities: animStageBenchmark [frames]" );
+	cmdSystem->AddCommand( "skinningBenchmark",		Cmd_SkinningBenchmark_f,	CMD_FL_GAME,			"skins every MD5 model def through all its anims on the CPU and reports verts per second for the scalar, SIMD and parallel paths: skinningBenchmark [filter]" );
 	cmdSystem->AddCommand( "aasStats",				Cmd_AASStats_f,				CMD_FL_GAME,				"shows AAS stats" );
+	cmdSystem->AddCommand( "aasBuildRoutingTables",	Cmd_AASBuildRoutingTables_f,	CMD_FL_GAME | CMD_FL_CHEAT,	"precomputes the routing tables and writes them to the AAS file: aasBuildRoutingTables [travelFlags ...]" );
+	cmdSystem->AddCommand( "aasRoutingBenchmark",	Cmd_AASRoutingBenchmark_f,	CMD_FL_GAME | CMD_FL_CHEAT,	"times random routing queries with and without the routing tables: aasRoutingBenchmark [numQueries] [travelFlags]" );
+	cmdSystem->AddCommand( "aasCompareRouting",		Cmd_AASCompareRouting_f,	CMD_FL_GAME | CMD_FL_CHEAT,	"compares the hierarchical A* routing with the routing cache: aasCompareRouting [numQueries] [travelFlags]" );
 	cmdSystem->AddCommand( "testDamage",			Cmd_TestDamage_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"tests a damage def", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> );
 	cmdSystem->AddCommand( "weaponSplat",			Cmd_WeaponSplat_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"projects a blood splat on the player weapon" );
 	cmdSystem->AddCommand( "saveSelected",			Cmd_SaveSelected_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"saves the selected entity to the .map file" );
@@ -2732,6 +3055,8 @@ void idGameLocal::InitConsoleCommands()
 	cmdSystem->AddCommand( "gameError",				Cmd_GameError_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"causes a game error" );
 	
 	cmdSystem->AddCommand( "disasmScript",			Cmd_DisasmScript_f,			CMD_FL_GAME | CMD_FL_CHEAT,	"disassembles script" );
+	cmdSystem->AddCommand( "scriptBenchmark",		Cmd_ScriptBenchmark_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"compiles all map scripts with and without the bytecode optimizer" );
+	cmdSystem->AddCommand( "scriptOpcodeStats",		idInterpreter::OpcodeStats_f,	CMD_FL_GAME | CMD_FL_CHEAT,	"prints the executed script opcode histogram, 'reset' clears it" );
 	cmdSystem->AddCommand( "recordViewNotes",		Cmd_RecordViewNotes_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"record the current view position with notes" );
 	cmdSystem->AddCommand( "showViewNotes",			Cmd_ShowViewNotes_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"show any view notes for the current map, successive calls will cycle to the next note" );
 	cmdSystem->AddCommand( "closeViewNotes",		Cmd_CloseViewNotes_f,		CMD_FL_GAME | CMD_FL_CHEAT,	"close the view showing any notes for this map" );
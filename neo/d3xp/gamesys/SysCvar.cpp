@@ -83,8 +83,24 @@ idCVar g_gravity(					"g_gravity",		DEFAULT_GRAVITY_STRING, CVAR_GAME | CVAR_FLO
 idCVar g_skipFX(					"g_skipFX",					"0",			CVAR_GAME | CVAR_BOOL, "" );
 
 idCVar g_disasm(					"g_disasm",					"0",			CVAR_GAME | CVAR_BOOL, "disassemble script into base/script/disasm.txt on the local drive when script is compiled" );
+idCVar g_scriptOptimize(			"g_scriptOptimize",			"0",			CVAR_GAME | CVAR_BOOL, "run the bytecode optimizer on scripts after they are compiled.  changes the program checksum, so savegames only load with the same setting" );
+idCVar g_scriptNative(				"g_scriptNative",			"0",			CVAR_GAME | CVAR_BOOL, "run the native versions of script functions built into the game library, see scriptCompileNative" );
+idCVar g_scriptOpcodeStats(			"g_scriptOpcodeStats",		"0",			CVAR_GAME | CVAR_BOOL, "count executed script opcodes, see scriptOpcodeStats" );
 idCVar g_debugBounds(				"g_debugBounds",			"0",			CVAR_GAME | CVAR_BOOL, "checks for models with bounds > 2048" );
 idCVar g_debugAnim(					"g_debugAnim",				"-1",			CVAR_GAME | CVAR_INTEGER, "displays information on which animations are playing on the specified entity number.  set to -1 to disable." );
+idCVar g_animPoseCache(				"g_animPoseCache",			"1",			CVAR_GAME | CVAR_INTEGER, "share blended poses between animators playing the same anims in sync.  2 = blend shared poses anyway and measure how far they are off, see g_animPoseCacheStats", 0, 2, idCmdSystem::ArgCompletion_Integer<0, 2> );
+idCVar g_animPoseCacheSteps(		"g_animPoseCacheSteps",		"0",			CVAR_GAME | CVAR_INTEGER, "share poses between animators whose frame interpolation and blend weights round to the same of this many steps.  0 = only share identical poses" );
+idCVar g_animPoseCacheStats(		"g_animPoseCacheStats",		"0",			CVAR_GAME | CVAR_BOOL, "prints the pose cache hits and misses each frame" );
+idCVar g_animStage(					"g_animStage",				"1",			CVAR_GAME | CVAR_BOOL, "create the frames of the animators in view on job threads at the end of the game frame instead of when the joints are first needed" );
+idCVar g_animLOD(					"g_animLOD",				"0",			CVAR_GAME | CVAR_BOOL, "lower the animation rate of animated entities away from the player views and of those that aren't drawn" );
+idCVar g_animLODNearDistance(		"g_animLODNearDistance",	"1024",			CVAR_GAME | CVAR_FLOAT, "distance to the nearest player view beyond which animated entities only create a new frame every g_animLODNearInterval frames" );
+idCVar g_animLODFarDistance(		"g_animLODFarDistance",		"2048",			CVAR_GAME | CVAR_FLOAT, "distance to the nearest player view beyond which animated entities only create a new frame every g_animLODFarInterval frames" );
+idCVar g_animLODNearInterval(		"g_animLODNearInterval",	"2",			CVAR_GAME | CVAR_INTEGER, "frames between new frames of animated entities beyond g_animLODNearDistance", 1, 16 );
+idCVar g_animLODFarInterval(		"g_animLODFarInterval",		"4",			CVAR_GAME | CVAR_INTEGER, "frames between new frames of animated entities beyond g_animLODFarDistance", 1, 16 );
+idCVar g_animLODHiddenInterval(		"g_animLODHiddenInterval",	"8",			CVAR_GAME | CVAR_INTEGER, "frames between new frames of animated entities that aren't drawn", 1, 64 );
+idCVar g_animLODHiddenFrames(		"g_animLODHiddenFrames",	"2",			CVAR_GAME | CVAR_INTEGER, "renderer frames since an animated entity was last drawn after which it counts as hidden" );
+idCVar g_animLODFarJointDepth(		"g_animLODFarJointDepth",	"0",			CVAR_GAME | CVAR_INTEGER, "only blend the joints up to this depth in the hierarchy on animated entities beyond g_animLODFarDistance or hidden.  0 = all joints" );
+idCVar g_animLODStats(				"g_animLODStats",			"0",			CVAR_GAME | CVAR_BOOL, "prints the animated entities at each level of detail and the frames and joints created each frame" );
 idCVar g_debugMove(					"g_debugMove",				"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugDamage(				"g_debugDamage",			"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar g_debugWeapon(				"g_debugWeapon",			"0",			CVAR_GAME | CVAR_BOOL, "" );
@@ -118,6 +134,7 @@ idCVar g_showActiveEntities(		"g_showActiveEntities",		"0",			CVAR_GAME | CVAR_B
 idCVar g_showEnemies(				"g_showEnemies",			"0",			CVAR_GAME | CVAR_BOOL, "draws boxes around monsters that have targeted the the player" );
 
 idCVar g_frametime(					"g_frametime",				"0",			CVAR_GAME | CVAR_BOOL, "displays timing information for each game frame" );
+idCVar g_eventStats(				"g_eventStats",				"0",			CVAR_GAME | CVAR_BOOL, "prints the number of events scheduled, fired and cancelled each frame" );
 idCVar g_timeentities(				"g_timeEntities",			"0",			CVAR_GAME | CVAR_FLOAT, "when non-zero, shows entities whose think functions exceeded the # of milliseconds specified" );
 
 idCVar g_debugShockwave(			"g_debugShockwave",			"0",			CVAR_GAME | CVAR_BOOL, "Debug the shockwave" );
@@ -143,6 +160,9 @@ idCVar ai_showCombatNodes(			"ai_showCombatNodes",		"0",			CVAR_GAME | CVAR_BOOL
 idCVar ai_showPaths(				"ai_showPaths",				"0",			CVAR_GAME | CVAR_BOOL, "draws path_* entities" );
 idCVar ai_showObstacleAvoidance(	"ai_showObstacleAvoidance",	"0",			CVAR_GAME | CVAR_INTEGER, "draws obstacle avoidance information for monsters.  if 2, draws obstacles for player, as well", 0, 2, idCmdSystem::ArgCompletion_Integer<0,2> );
 idCVar ai_blockedFailSafe(			"ai_blockedFailSafe",		"1",			CVAR_GAME | CVAR_BOOL, "enable blocked fail safe handling" );
+idCVar ai_obstacleGrid(			"ai_obstacleGrid",			"0",			CVAR_GAME | CVAR_BOOL, "gather the obstacles for obstacle avoidance from a grid that is built once per frame" );
+idCVar ai_obstaclePathReuse(		"ai_obstaclePathReuse",		"0",			CVAR_GAME | CVAR_FLOAT, "reuse the obstacle avoidance path while the obstacles and seek position do not change and the monster moved less than this distance, 0 = never reuse" );
+idCVar ai_showObstacleStats(		"ai_showObstacleStats",		"0",			CVAR_GAME | CVAR_BOOL, "prints the number of obstacle avoidance queries and the time spent on them each frame" );
 
 idCVar ai_showHealth(				"ai_showHealth",			"0",			CVAR_GAME | CVAR_BOOL, "Draws the AI's health above its head" );
 
@@ -195,6 +215,8 @@ idCVar af_useLinearTime(			"af_useLinearTime",			"1",			CVAR_GAME | CVAR_BOOL, "
 idCVar af_useImpulseFriction(		"af_useImpulseFriction",	"0",			CVAR_GAME | CVAR_BOOL, "use impulse based contact friction" );
 idCVar af_useJointImpulseFriction(	"af_useJointImpulseFriction","0",			CVAR_GAME | CVAR_BOOL, "use impulse based joint friction" );
 idCVar af_useSymmetry(				"af_useSymmetry",			"1",			CVAR_GAME | CVAR_BOOL, "use constraint matrix symmetry" );
+idCVar af_useSparseLCP(				"af_useSparseLCP",			"0",			CVAR_GAME | CVAR_BOOL, "use the sparse warm started solver for the auxiliary constraints of all articulated figures" );
+idCVar af_lcpCompare(				"af_lcpCompare",			"0",			CVAR_GAME | CVAR_BOOL, "solve the auxiliary constraints with both the dense and the sparse solver and gather statistics, see af_lcpStats" );
 idCVar af_skipSelfCollision(		"af_skipSelfCollision",		"0",			CVAR_GAME | CVAR_BOOL, "skip self collision detection" );
 idCVar af_skipLimits(				"af_skipLimits",			"0",			CVAR_GAME | CVAR_BOOL, "skip joint limits" );
 idCVar af_skipFriction(				"af_skipFriction",			"0",			CVAR_GAME | CVAR_BOOL, "skip friction" );
@@ -229,6 +251,9 @@ idCVar rb_showInertia(				"rb_showInertia",			"0",			CVAR_GAME | CVAR_BOOL, "sho
 idCVar rb_showVelocity(				"rb_showVelocity",			"0",			CVAR_GAME | CVAR_BOOL, "show the velocity of each rigid body" );
 idCVar rb_showActive(				"rb_showActive",			"0",			CVAR_GAME | CVAR_BOOL, "show rigid bodies that are not at rest" );
 
+idCVar g_physicsIslands(			"g_physicsIslands",			"0",			CVAR_GAME | CVAR_BOOL, "touching rigid bodies and articulated figures only come to rest and wake up together" );
+idCVar g_physicsIslandStats(		"g_physicsIslandStats",		"0",			CVAR_GAME | CVAR_BOOL, "show physics island statistics each frame" );
+
 // The default values for player movement cvars are set in def/player.def
 idCVar pm_jumpheight(				"pm_jumpheight",			"48",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_FLOAT, "approximate hieght the player can jump" );
 idCVar pm_stepsize(					"pm_stepsize",				"16",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_FLOAT, "maximum height the player can step up without jumping" );
@@ -309,6 +334,8 @@ idCVar aas_pullPlayer(				"aas_pullPlayer",			"0",			CVAR_GAME | CVAR_INTEGER, "
 idCVar aas_randomPullPlayer(		"aas_randomPullPlayer",		"0",			CVAR_GAME | CVAR_BOOL, "" );
 idCVar aas_goalArea(				"aas_goalArea",				"0",			CVAR_GAME | CVAR_INTEGER, "" );
 idCVar aas_showPushIntoArea(		"aas_showPushIntoArea",		"0",			CVAR_GAME | CVAR_BOOL, "" );
+idCVar aas_useRoutingTables(		"aas_useRoutingTables",		"1",			CVAR_GAME | CVAR_BOOL, "use the precomputed routing tables stored in the AAS file" );
+idCVar aas_hierarchicalRouting(		"aas_hierarchicalRouting",	"0",			CVAR_GAME | CVAR_BOOL, "route with a hierarchical A* search over the cluster portals and areas instead of the routing cache" );
 
 idCVar g_countDown(					"g_countDown",				"15",			CVAR_GAME | CVAR_INTEGER | CVAR_ARCHIVE, "pregame countdown in seconds", 4, 3600 );
 idCVar g_gameReviewPause(			"g_gameReviewPause",		"10",			CVAR_GAME | CVAR_NETWORKSYNC | CVAR_INTEGER | CVAR_ARCHIVE, "scores review time in seconds (at end game)", 2, 3600 );
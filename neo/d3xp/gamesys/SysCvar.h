@@ -45,8 +45,24 @@ extern idCVar	g_projectileLights;
 extern idCVar	g_muzzleFlash;
 
 extern idCVar	g_disasm;
+extern idCVar	g_scriptOptimize;
+extern idCVar	g_scriptOpcodeStats;
+extern idCVar	g_scriptNative;
 extern idCVar	g_debugBounds;
 extern idCVar	g_debugAnim;
+extern idCVar	g_animPoseCache;
+extern idCVar	g_animPoseCacheSteps;
+extern idCVar	g_animPoseCacheStats;
+extern idCVar	g_animStage;
+extern idCVar	g_animLOD;
+extern idCVar	g_animLODNearDistance;
+extern idCVar	g_animLODFarDistance;
+extern idCVar	g_animLODNearInterval;
+extern idCVar	g_animLODFarInterval;
+extern idCVar	g_animLODHiddenInterval;
+extern idCVar	g_animLODHiddenFrames;
+extern idCVar	g_animLODFarJointDepth;
+extern idCVar	g_animLODStats;
 extern idCVar	g_debugMove;
 extern idCVar	g_debugDamage;
 extern idCVar	g_debugWeapon;
@@ -78,6 +94,7 @@ extern idCVar	g_showActiveEntities;
 extern idCVar	g_showEnemies;
 
 extern idCVar	g_frametime;
+extern idCVar	g_eventStats;
 extern idCVar	g_timeentities;
 
 extern idCVar	ai_debugScript;
@@ -88,6 +105,9 @@ extern idCVar	ai_showCombatNodes;
 extern idCVar	ai_showPaths;
 extern idCVar	ai_showObstacleAvoidance;
 extern idCVar	ai_blockedFailSafe;
+extern idCVar	ai_obstacleGrid;
+extern idCVar	ai_obstaclePathReuse;
+extern idCVar	ai_showObstacleStats;
 extern idCVar	ai_showHealth;
 
 extern idCVar	g_dvTime;
@@ -124,6 +144,8 @@ extern idCVar	af_useLinearTime;
 extern idCVar	af_useImpulseFriction;
 extern idCVar	af_useJointImpulseFriction;
 extern idCVar	af_useSymmetry;
+extern idCVar	af_useSparseLCP;
+extern idCVar	af_lcpCompare;
 extern idCVar	af_skipSelfCollision;
 extern idCVar	af_skipLimits;
 extern idCVar	af_skipFriction;
@@ -158,6 +180,9 @@ extern idCVar	rb_showInertia;
 extern idCVar	rb_showVelocity;
 extern idCVar	rb_showActive;
 
+extern idCVar	g_physicsIslands;
+extern idCVar	g_physicsIslandStats;
+
 extern idCVar	pm_jumpheight;
 extern idCVar	pm_stepsize;
 extern idCVar	pm_crouchspeed;
@@ -249,6 +274,8 @@ extern idCVar	aas_pullPlayer;
 extern idCVar	aas_randomPullPlayer;
 extern idCVar	aas_goalArea;
 extern idCVar	aas_showPushIntoArea;
+extern idCVar	aas_useRoutingTables;
+extern idCVar	aas_hierarchicalRouting;
 
 extern idCVar	net_clientPredictGUI;
 
@@ -5663,6 +5663,196 @@ void idPhysics_AF::PrimaryForces( float timeStep )
 	}
 }
 
+/*
+================
+AF_CompareLCP
+
+Solves the auxiliary constraint problem with both the dense and the sparse
+solver and accumulates the time and the complementarity error of each.
+================
+*/
+typedef struct afLCPStats_s
+{
+	int						numSolves;
+	int						numRows;
+	int						numSparseFailures;
+	int						numSparseIterations;
+	uint64					denseMicroseconds;
+	uint64					sparseMicroseconds;
+	float					denseMaxError;
+	float					sparseMaxError;
+	float					maxDifference;
+} afLCPStats_t;
+
+static afLCPStats_t afLCPStats;
+
+static void AF_CompareLCP( idLCP* dense, idLCP* sparse, const idMatX& jmk, const idVecX& warm, const idVecX& rhs, const idVecX& lo, const idVecX& hi, const int* boxIndex )
+{
+	const int n = jmk.GetNumRows();
+	idVecX x1, x2;
+	
+	x1.SetData( n, VECX_ALLOCA( n ) );
+	x2.SetData( n, VECX_ALLOCA( n ) );
+	x1 = warm;
+	x2 = warm;
+	
+	uint64 startTime = Sys_Microseconds();
+	bool denseOk = dense->Solve( jmk, x1, rhs, lo, hi, boxIndex );
+	uint64 midTime = Sys_Microseconds();
+	bool sparseOk = sparse->Solve( jmk, x2, rhs, lo, hi, boxIndex );
+	uint64 endTime = Sys_Microseconds();
+	
+	afLCPStats.numSolves++;
+	afLCPStats.numRows += n;
+	afLCPStats.denseMicroseconds += midTime - startTime;
+	afLCPStats.sparseMicroseconds += endTime - midTime;
+	if( !sparseOk )
+	{
+		afLCPStats.numSparseFailures++;
+		return;
+	}
+	afLCPStats.numSparseIterations += sparse->GetNumIterations();
+	afLCPStats.sparseMaxError = Max( afLCPStats.sparseMaxError, idLCP::ComplementarityError( jmk, x2, rhs, lo, hi, boxIndex ) );
+	if( denseOk )
+	{
+		afLCPStats.denseMaxError = Max( afLCPStats.denseMaxError, idLCP::ComplementarityError( jmk, x1, rhs, lo, hi, boxIndex ) );
+		for( int i = 0; i < n; i++ )
+		{
+			afLCPStats.maxDifference = Max( afLCPStats.maxDifference, idMath::Fabs( x1[i] - x2[i] ) );
+		}
+	}
+}
+
+/*
+================
+AF_LCPStats_f
+================
+*/
+CONSOLE_COMMAND( af_lcpStats, "print and reset the dense versus sparse auxiliary constraint solver comparison gathered with af_lcpCompare", 0 )
+{
+	const afLCPStats_t& s = afLCPStats;
+	
+	if( s.numSolves == 0 )
+	{
+		gameLocal.Printf( "no solves recorded, set af_lcpCompare 1\n" );
+		return;
+	}
+	
+	gameLocal.Printf( "%d solves, %.1f rows average\n", s.numSolves, ( float ) s.numRows / s.numSolves );
+	gameLocal.Printf( "dense : %6.1f usec average, max error %.6f\n", ( float ) s.denseMicroseconds / s.numSolves, s.denseMaxError );
+	gameLocal.Printf( "sparse: %6.1f usec average, max error %.6f, %.1f sweeps average, %d failures\n", ( float ) s.sparseMicroseconds / s.numSolves, s.sparseMaxError,
+					  ( float ) s.numSparseIterations / Max( 1, s.numSolves - s.numSparseFailures ), s.numSparseFailures );
+	gameLocal.Printf( "max force difference %.6f\n", s.maxDifference );
+	
+	memset( &afLCPStats, 0, sizeof( afLCPStats ) );
+}
+
+/*
+================
+idPhysics_AF::BuildAuxiliarySparsity
+
+  Builds the pattern of the non-zero off-diagonal entries of the auxiliary constraint
+  matrix from the body responses to the auxiliary constraint forces. Row k has an entry
+  for every auxiliary constraint that causes a response in one of the bodies constrained
+  by row k. Only the lower triangle is taken from the responses because with af_useSymmetry
+  the responses above the diagonal are not calculated. The pattern is only rebuilt when
+  the auxiliary constraints or the bodies they constrain change.
+================
+*/
+void idPhysics_AF::BuildAuxiliarySparsity( int numAuxConstraints )
+{
+	int i, j, k, m, m1, m2, n1, n2;
+	const idAFConstraint* constraint;
+	const idAFBody* body1, *body2;
+	idList<int> lowerStart, lowerColumns, fill;
+	
+	bool changed = ( auxiliaryKey.Num() != auxiliaryConstraints.Num() );
+	for( i = 0; i < auxiliaryConstraints.Num() && !changed; i++ )
+	{
+		constraint = auxiliaryConstraints[i];
+		const AFAuxiliaryKey_t& key = auxiliaryKey[i];
+		changed = ( key.constraint != constraint || key.body1 != constraint->body1 || key.body2 != constraint->body2 || key.numRows != constraint->J1.GetNumRows() );
+	}
+	if( !changed )
+	{
+		return;
+	}
+	
+	auxiliaryKey.SetNum( auxiliaryConstraints.Num() );
+	for( i = 0; i < auxiliaryConstraints.Num(); i++ )
+	{
+		constraint = auxiliaryConstraints[i];
+		AFAuxiliaryKey_t& key = auxiliaryKey[i];
+		key.constraint = constraint;
+		key.body1 = constraint->body1;
+		key.body2 = constraint->body2;
+		key.numRows = constraint->J1.GetNumRows();
+	}
+	
+	// gather the entries below the diagonal and count the entries per row
+	lowerStart.SetNum( numAuxConstraints + 1 );
+	auxiliaryRowStart.SetNum( numAuxConstraints + 1 );
+	memset( auxiliaryRowStart.Ptr(), 0, auxiliaryRowStart.Num() * sizeof( int ) );
+	for( k = 0, i = 0; i < auxiliaryConstraints.Num(); i++ )
+	{
+		constraint = auxiliaryConstraints[i];
+		body1 = constraint->body1;
+		body2 = constraint->body2;
+		
+		for( j = 0; j < constraint->J1.GetNumRows(); j++, k++ )
+		{
+			lowerStart[k] = lowerColumns.Num();
+			
+			// merge the sorted response indexes of both bodies
+			n1 = n2 = 0;
+			while( 1 )
+			{
+				m1 = ( n1 < body1->numResponses ) ? body1->responseIndex[n1] : k;
+				m2 = ( body2 != NULL && n2 < body2->numResponses ) ? body2->responseIndex[n2] : k;
+				m = Min( m1, m2 );
+				if( m >= k )
+				{
+					break;
+				}
+				lowerColumns.Append( m );
+				auxiliaryRowStart[k]++;
+				auxiliaryRowStart[m]++;
+				if( m1 == m )
+				{
+					n1++;
+				}
+				if( m2 == m )
+				{
+					n2++;
+				}
+			}
+		}
+	}
+	lowerStart[numAuxConstraints] = lowerColumns.Num();
+	
+	// mirror the entries above the diagonal
+	fill.SetNum( numAuxConstraints );
+	for( m = 0, k = 0; k < numAuxConstraints; k++ )
+	{
+		n1 = auxiliaryRowStart[k];
+		auxiliaryRowStart[k] = fill[k] = m;
+		m += n1;
+	}
+	auxiliaryRowStart[numAuxConstraints] = m;
+	auxiliaryColumns.SetNum( m );
+	for( k = 0; k < numAuxConstraints; k++ )
+	{
+		for( i = lowerStart[k]; i < lowerStart[k + 1]; i++ )
+		{
+			m = lowerColumns[i];
+			auxiliaryColumns[fill[k]++] = m;
+			auxiliaryColumns[fill[m]++] = k;
+		}
+	}
+	
+	sparseLcp->SetSparsity( numAuxConstraints, auxiliaryRowStart.Ptr(), auxiliaryColumns.Ptr() );
+}
+
 /*
 ================
 idPhysics_AF::AuxiliaryForces
@@ -5873,17 +6063,36 @@ void idPhysics_AF::AuxiliaryForces( float timeStep )
 				boxIndex[k] = -1;
 			}
 			jmk[k][k] += constraint->e[j] * invStep;
+			
+			// the multipliers of the previous evaluation are the initial guess for warm started solvers
+			lm[k] = ( j < constraint->lm.GetSize() ) ? constraint->lm[j] : 0.0f;
 		}
 	}
 	
+	idLCP* solver = ( sparseLCP || af_useSparseLCP.GetBool() ) ? sparseLcp : lcp;
+	
+	if( solver == sparseLcp || af_lcpCompare.GetBool() )
+	{
+		BuildAuxiliarySparsity( numAuxConstraints );
+	}
+	
+	if( af_lcpCompare.GetBool() )
+	{
+		AF_CompareLCP( lcp, sparseLcp, jmk, lm, rhs, lo, hi, boxIndex );
+	}
+	
 #ifdef AF_TIMINGS
 	timer_lcp.Start();
 #endif
 	
 	// calculate lagrange multipliers for auxiliary constraints
-	if( !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
+	if( !solver->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
 	{
-		return;		// bad monkey!
+		// fall back to the dense solver when the sparse solver does not converge
+		if( solver == lcp || !lcp->Solve( jmk, lm, rhs, lo, hi, boxIndex ) )
+		{
+			return;		// bad monkey!
+		}
 	}
 	
 #ifdef AF_TIMINGS
@@ -6805,6 +7014,7 @@ void idPhysics_AF::Activate()
 	current.atRest = -1;
 	current.noMoveTime = 0.0f;
 	self->BecomeActive( TH_PHYSICS );
+	gameLocal.physicsIslands.WakeIsland( self );
 }
 
 /*
@@ -7060,6 +7270,7 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	{
 		BuildTrees();
 		changedAF = false;
+		auxiliaryKey.Clear();
 		linearTime = af_useLinearTime.GetBool();
 	}
 	
@@ -7091,6 +7302,10 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	timer_total.Start();
 #endif
 	
+	const bool trackIsland = gameLocal.physicsIslands.IsTracking();
+	const uint64 evaluateStartTime = trackIsland ? Sys_Microseconds() : 0;
+	bool restCandidate = false;
+	
 #ifdef AF_TIMINGS
 	timer_collision.Start();
 #endif
@@ -7190,7 +7405,15 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 	// test if the simulation can be suspended because the whole figure is at rest
 	if( comeToRest && TestIfAtRest( timeStep ) )
 	{
-		Rest();
+		if( gameLocal.physicsIslands.IsEnabled() && current.atRest < 0 )
+		{
+			// the island puts the figure to rest at the end of the frame if all touching bodies can come to rest
+			restCandidate = true;
+		}
+		else
+		{
+			Rest();
+		}
 	}
 	else
 	{
@@ -7211,6 +7434,11 @@ bool idPhysics_AF::Evaluate( int timeStepMSec, int endTimeMSec )
 		Rest();
 	}
 	
+	if( trackIsland )
+	{
+		gameLocal.physicsIslands.AddBody( self, this, restCandidate || current.atRest >= 0, Sys_Microseconds() - evaluateStartTime );
+	}
+	
 #ifdef AF_TIMINGS
 	timer_total.Stop();
 	
@@ -7478,6 +7706,7 @@ idPhysics_AF::idPhysics_AF()
 	masterBody = NULL;
 	
 	lcp = idLCP::AllocSymmetric();
+	sparseLcp = idLCP::AllocSparse();
 	
 	memset( &current, 0, sizeof( current ) );
 	current.atRest = -1;
@@ -7523,6 +7752,7 @@ idPhysics_AF::idPhysics_AF()
 	noImpact = false;
 	worldConstraintsLocked = false;
 	forcePushable = false;
+	sparseLCP = false;
 	
 #ifdef AF_TIMINGS
 	lastTimerReset = 0;
@@ -7557,6 +7787,7 @@ idPhysics_AF::~idPhysics_AF()
 	}
 	
 	delete lcp;
+	delete sparseLcp;
 	
 	if( masterBody )
 	{
@@ -976,6 +976,14 @@ typedef struct AFCollision_s
 	idAFBody* 				body;
 } AFCollision_t;
 
+typedef struct AFAuxiliaryKey_s
+{
+	const idAFConstraint* 	constraint;
+	const idAFBody* 		body1;
+	const idAFBody* 		body2;
+	int						numRows;
+} AFAuxiliaryKey_t;
+
 
 class idPhysics_AF : public idPhysics_Base
 {
@@ -1067,6 +1075,11 @@ public:
 	{
 		comeToRest = enable;
 	}
+	// use the sparse iterative solver for the auxiliary constraints
+	void					SetSparseLCP( const bool enable )
+	{
+		sparseLCP = enable;
+	}
 	// call when structure of articulated figure changes
 	void					SetChanged()
 	{
@@ -1207,6 +1220,7 @@ private:
 	bool					noImpact;						// if true do not activate when another object collides
 	bool					worldConstraintsLocked;			// if true world constraints cannot be moved
 	bool					forcePushable;					// if true can be pushed even when bound to a master
+	bool					sparseLCP;						// if true use the sparse solver for the auxiliary constraints
 	
 	// physics state
 	AFPState_t				current;
@@ -1214,6 +1228,10 @@ private:
 	
 	idAFBody* 				masterBody;						// master body
 	idLCP* 					lcp;							// linear complementarity problem solver
+	idLCP* 					sparseLcp;						// sparse warm started solver for the auxiliary constraints
+	idList<AFAuxiliaryKey_t>	auxiliaryKey;				// auxiliary constraints the sparsity pattern was built for
+	idList<int>				auxiliaryRowStart;				// sparsity pattern of the auxiliary constraint matrix
+	idList<int>				auxiliaryColumns;
 	
 private:
 	void					BuildTrees();
@@ -1226,6 +1244,7 @@ private:
 	void					ApplyFriction( float timeStep, float endTimeMSec );
 	void					PrimaryForces( float timeStep );
 	void					AuxiliaryForces( float timeStep );
+	void					BuildAuxiliarySparsity( int numAuxConstraints );
 	void					VerifyContactConstraints();
 	void					SetupContactConstraints();
 	void					ApplyContactForces();
@@ -0,0 +1,501 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#include "precompiled.h"
+#pragma hdrstop
+
+#include "../Game_local.h"
+
+/*
+================
+idPhysicsIslands::idPhysicsIslands
+================
+*/
+idPhysicsIslands::idPhysicsIslands()
+{
+	numFreeIslands = 0;
+	benchmarkFrames = 0;
+	benchmarkFramesLeft = 0;
+	memset( &frameStats, 0, sizeof( frameStats ) );
+	memset( &benchmarkStats, 0, sizeof( benchmarkStats ) );
+}
+
+/*
+================
+idPhysicsIslands::Clear
+================
+*/
+void idPhysicsIslands::Clear()
+{
+	bodies.Clear();
+	bodyIndex.Clear();
+	parent.Clear();
+	sleepingIsland.Clear();
+	sleepingIslands.Clear();
+	numFreeIslands = 0;
+	benchmarkFramesLeft = 0;
+	memset( &frameStats, 0, sizeof( frameStats ) );
+}
+
+/*
+================
+idPhysicsIslands::IsEnabled
+================
+*/
+bool idPhysicsIslands::IsEnabled() const
+{
+	return g_physicsIslands.GetBool() && !common->IsClient();
+}
+
+/*
+================
+idPhysicsIslands::IsTracking
+================
+*/
+bool idPhysicsIslands::IsTracking() const
+{
+	return IsEnabled() || g_physicsIslandStats.GetBool() || benchmarkFramesLeft > 0;
+}
+
+/*
+================
+idPhysicsIslands::BeginFrame
+================
+*/
+void idPhysicsIslands::BeginFrame()
+{
+	if( bodyIndex.Num() != MAX_GENTITIES )
+	{
+		bodyIndex.SetNum( MAX_GENTITIES );
+		sleepingIsland.SetNum( MAX_GENTITIES );
+		memset( bodyIndex.Ptr(), -1, bodyIndex.Allocated() );
+		memset( sleepingIsland.Ptr(), -1, sleepingIsland.Allocated() );
+	}
+	
+	for( int i = 0; i < bodies.Num(); i++ )
+	{
+		bodyIndex[bodies[i].entityNum] = -1;
+	}
+	bodies.SetNum( 0 );
+	
+	memset( &frameStats, 0, sizeof( frameStats ) );
+}
+
+/*
+================
+idPhysicsIslands::AddBody
+================
+*/
+void idPhysicsIslands::AddBody( idEntity* self, idPhysics* physics, bool restCandidate, uint64 evaluateTime )
+{
+	frameStats.numEvaluated++;
+	frameStats.evaluateTime += evaluateTime;
+	
+	if( bodyIndex.Num() == 0 )
+	{
+		// not inside a game frame
+		if( restCandidate )
+		{
+			physics->PutToRest();
+		}
+		return;
+	}
+	
+	const int entityNum = self->entityNumber;
+	if( bodyIndex[entityNum] != -1 )
+	{
+		// evaluated more than once this frame
+		physicsIslandBody_t& body = bodies[bodyIndex[entityNum]];
+		body.restCandidate = restCandidate;
+		return;
+	}
+	
+	bodyIndex[entityNum] = bodies.Num();
+	physicsIslandBody_t& body = bodies.Alloc();
+	body.physics = physics;
+	body.entityNum = entityNum;
+	body.spawnId = gameLocal.spawnIds[entityNum];
+	body.restCandidate = restCandidate;
+}
+
+/*
+================
+idPhysicsIslands::GetBodyPhysics
+
+  Returns NULL if the entity was removed or changed physics since the body was added.
+================
+*/
+idPhysics* idPhysicsIslands::GetBodyPhysics( int index ) const
+{
+	const physicsIslandBody_t& body = bodies[index];
+	const idEntity* ent = gameLocal.entities[body.entityNum];
+	if( ent == NULL || gameLocal.spawnIds[body.entityNum] != body.spawnId || ent->GetPhysics() != body.physics )
+	{
+		return NULL;
+	}
+	return body.physics;
+}
+
+/*
+================
+idPhysicsIslands::FindRoot
+================
+*/
+int idPhysicsIslands::FindRoot( int index )
+{
+	int root = index;
+	while( parent[root] != root )
+	{
+		root = parent[root];
+	}
+	while( parent[index] != root )
+	{
+		int next = parent[index];
+		parent[index] = root;
+		index = next;
+	}
+	return root;
+}
+
+/*
+================
+idPhysicsIslands::AllocSleepingIsland
+================
+*/
+int idPhysicsIslands::AllocSleepingIsland()
+{
+	if( numFreeIslands > 0 )
+	{
+		for( int i = 0; i < sleepingIslands.Num(); i++ )
+		{
+			if( sleepingIslands[i].Num() == 0 )
+			{
+				numFreeIslands--;
+				return i;
+			}
+		}
+	}
+	sleepingIslands.Alloc();
+	return sleepingIslands.Num() - 1;
+}
+
+/*
+================
+idPhysicsIslands::AddToSleepingIsland
+
+  Adds the entity to the island, merges in the sleeping island the entity is already part of.
+================
+*/
+void idPhysicsIslands::AddToSleepingIsland( int island, int entityNum )
+{
+	const int oldIsland = sleepingIsland[entityNum];
+	if( oldIsland == island )
+	{
+		return;
+	}
+	
+	if( oldIsland != -1 )
+	{
+		idList<physicsIslandMember_t>& members = sleepingIslands[oldIsland];
+		for( int i = 0; i < members.Num(); i++ )
+		{
+			sleepingIsland[members[i].entityNum] = island;
+			sleepingIslands[island].Append( members[i] );
+		}
+		members.Clear();
+		numFreeIslands++;
+		return;
+	}
+	
+	physicsIslandMember_t& member = sleepingIslands[island].Alloc();
+	member.entityNum = entityNum;
+	member.spawnId = gameLocal.spawnIds[entityNum];
+	sleepingIsland[entityNum] = island;
+}
+
+/*
+================
+idPhysicsIslands::EndFrame
+================
+*/
+void idPhysicsIslands::EndFrame()
+{
+	int i, j;
+	
+	if( bodies.Num() > 0 && IsEnabled() )
+	{
+		parent.SetNum( bodies.Num() );
+		for( i = 0; i < bodies.Num(); i++ )
+		{
+			parent[i] = i;
+		}
+		
+		// connect touching active bodies
+		for( i = 0; i < bodies.Num(); i++ )
+		{
+			const idPhysics* physics = GetBodyPhysics( i );
+			if( physics == NULL )
+			{
+				continue;
+			}
+			for( j = 0; j < physics->GetNumContacts(); j++ )
+			{
+				const int entityNum = physics->GetContact( j ).entityNum;
+				if( entityNum < 0 || entityNum >= ENTITYNUM_MAX_NORMAL || bodyIndex[entityNum] == -1 )
+				{
+					continue;
+				}
+				if( GetBodyPhysics( bodyIndex[entityNum] ) == NULL )
+				{
+					continue;
+				}
+				int root1 = FindRoot( i );
+				int root2 = FindRoot( bodyIndex[entityNum] );
+				if( root1 != root2 )
+				{
+					parent[root1] = root2;
+				}
+			}
+		}
+		
+		// an island can only come to rest if all of its active bodies can
+		idList<int> islandState;		// -1 no bodies, 0 has moving bodies, 1 all bodies at rest, otherwise sleeping island + 2
+		islandState.SetNum( bodies.Num() );
+		memset( islandState.Ptr(), -1, islandState.Allocated() );
+		for( i = 0; i < bodies.Num(); i++ )
+		{
+			if( GetBodyPhysics( i ) == NULL )
+			{
+				continue;
+			}
+			int root = FindRoot( i );
+			if( islandState[root] == -1 )
+			{
+				islandState[root] = 1;
+				frameStats.numIslands++;
+			}
+			if( !bodies[i].restCandidate )
+			{
+				islandState[root] = 0;
+			}
+		}
+		
+		// put islands to rest together with the sleeping bodies they touch
+		for( i = 0; i < bodies.Num(); i++ )
+		{
+			idPhysics* physics = GetBodyPhysics( i );
+			if( physics == NULL )
+			{
+				continue;
+			}
+			int root = FindRoot( i );
+			if( islandState[root] == 0 )
+			{
+				continue;
+			}
+			if( islandState[root] == 1 )
+			{
+				islandState[root] = AllocSleepingIsland() + 2;
+			}
+			const int island = islandState[root] - 2;
+			
+			for( j = 0; j < physics->GetNumContacts(); j++ )
+			{
+				const int entityNum = physics->GetContact( j ).entityNum;
+				if( entityNum < 0 || entityNum >= ENTITYNUM_MAX_NORMAL || bodyIndex[entityNum] != -1 )
+				{
+					continue;
+				}
+				idEntity* ent = gameLocal.entities[entityNum];
+				if( ent == NULL || !ent->IsAtRest() )
+				{
+					continue;
+				}
+				const idPhysics* otherPhysics = ent->GetPhysics();
+				if( otherPhysics->IsType( idPhysics_RigidBody::Type ) || otherPhysics->IsType( idPhysics_AF::Type ) )
+				{
+					AddToSleepingIsland( island, entityNum );
+				}
+			}
+			
+			AddToSleepingIsland( island, bodies[i].entityNum );
+			physics->PutToRest();
+			frameStats.numSlept++;
+		}
+		
+		// single bodies don't need to be woken up as an island
+		for( i = 0; i < sleepingIslands.Num(); i++ )
+		{
+			idList<physicsIslandMember_t>& members = sleepingIslands[i];
+			if( members.Num() == 1 )
+			{
+				sleepingIsland[members[0].entityNum] = -1;
+				members.Clear();
+				numFreeIslands++;
+			}
+		}
+	}
+	
+	if( g_physicsIslandStats.GetBool() && frameStats.numEvaluated > 0 )
+	{
+		gameLocal.Printf( "%d: physics islands: %d bodies %d islands %d slept %d woken %.2f ms\n", gameLocal.time,
+						  frameStats.numEvaluated, frameStats.numIslands, frameStats.numSlept, frameStats.numWoken, frameStats.evaluateTime * 0.001f );
+	}
+	
+	if( benchmarkFramesLeft > 0 )
+	{
+		benchmarkStats.numEvaluated += frameStats.numEvaluated;
+		benchmarkStats.numIslands += frameStats.numIslands;
+		benchmarkStats.numSlept += frameStats.numSlept;
+		benchmarkStats.numWoken += frameStats.numWoken;
+		benchmarkStats.evaluateTime += frameStats.evaluateTime;
+		
+		if( --benchmarkFramesLeft == 0 )
+		{
+			const float ms = benchmarkStats.evaluateTime * 0.001f;
+			gameLocal.Printf( "physics benchmark over %d frames (islands %s):\n", benchmarkFrames, IsEnabled() ? "on" : "off" );
+			gameLocal.Printf( "  %.1f active bodies per frame, %.1f islands per frame\n", ( float )benchmarkStats.numEvaluated / benchmarkFrames,
+							  ( float )benchmarkStats.numIslands / benchmarkFrames );
+			gameLocal.Printf( "  %.3f ms per frame, %.1f bodies simulated per ms\n", ms / benchmarkFrames,
+							  ( ms > 0.0f ) ? benchmarkStats.numEvaluated / ms : 0.0f );
+			gameLocal.Printf( "  %d bodies slept, %d woken\n", benchmarkStats.numSlept, benchmarkStats.numWoken );
+		}
+	}
+}
+
+/*
+================
+idPhysicsIslands::WakeIsland
+================
+*/
+void idPhysicsIslands::WakeIsland( const idEntity* ent )
+{
+	if( sleepingIsland.Num() == 0 )
+	{
+		return;
+	}
+	
+	const int island = sleepingIsland[ent->entityNumber];
+	if( island == -1 )
+	{
+		return;
+	}
+	
+	// take the members out first because activating them wakes the island recursively
+	idList<physicsIslandMember_t> members;
+	members.Swap( sleepingIslands[island] );
+	numFreeIslands++;
+	for( int i = 0; i < members.Num(); i++ )
+	{
+		sleepingIsland[members[i].entityNum] = -1;
+	}
+	
+	for( int i = 0; i < members.Num(); i++ )
+	{
+		const physicsIslandMember_t& member = members[i];
+		idEntity* other = gameLocal.entities[member.entityNum];
+		if( other == NULL || other == ent || gameLocal.spawnIds[member.entityNum] != member.spawnId )
+		{
+			continue;
+		}
+		if( other->IsAtRest() )
+		{
+			other->GetPhysics()->Activate();
+			frameStats.numWoken++;
+		}
+	}
+}
+
+/*
+================
+idPhysicsIslands::StartBenchmark
+================
+*/
+void idPhysicsIslands::StartBenchmark( int numFrames )
+{
+	benchmarkFrames = numFrames;
+	benchmarkFramesLeft = numFrames;
+	memset( &benchmarkStats, 0, sizeof( benchmarkStats ) );
+}
+
+/*
+================
+physicsStressTest_f
+
+  Drops a pile of entities in front of the player and measures how many bodies are simulated per millisecond.
+================
+*/
+CONSOLE_COMMAND( physicsStressTest, "spawns a pile of moveables or ragdolls and benchmarks the physics: <entityDef> [count] [frames]", idCmdSystem::ArgCompletion_Decl<DECL_ENTITYDEF> )
+{
+	idPlayer* player = gameLocal.GetLocalPlayer();
+	if( player == NULL || !gameLocal.CheatsOk( false ) )
+	{
+		return;
+	}
+	
+	if( args.Argc() < 2 )
+	{
+		gameLocal.Printf( "usage: physicsStressTest <entityDef> [count] [frames]\n" );
+		return;
+	}
+	
+	const char* defName = args.Argv( 1 );
+	const int count = ( args.Argc() > 2 ) ? Max( 1, atoi( args.Argv( 2 ) ) ) : 64;
+	const int numFrames = ( args.Argc() > 3 ) ? Max( 1, atoi( args.Argv( 3 ) ) ) : 300;
+	
+	if( gameLocal.FindEntityDefDict( defName, false ) == NULL )
+	{
+		gameLocal.Printf( "unknown entityDef '%s'\n", defName );
+		return;
+	}
+	
+	const float yaw = player->viewAngles.yaw;
+	const idMat3 axis = idAngles( 0, yaw, 0 ).ToMat3();
+	const idVec3 center = player->GetPhysics()->GetOrigin() + axis[0] * 192.0f;
+	const int side = idMath::Ftoi( idMath::Ceil( idMath::Sqrt( ( float )count ) ) );
+	const float spacing = 40.0f;
+	
+	for( int i = 0; i < count; i++ )
+	{
+		const int layer = i / ( side * side );
+		const int row = ( i / side ) % side;
+		const int column = i % side;
+		idVec3 org = center + axis[0] * ( ( row - side * 0.5f ) * spacing ) + axis[1] * ( ( column - side * 0.5f ) * spacing );
+		org.z += 16.0f + layer * spacing;
+		
+		idDict dict;
+		dict.Set( "classname", defName );
+		dict.Set( "origin", org.ToString() );
+		dict.Set( "angle", va( "%f", yaw + 45.0f * i ) );
+		gameLocal.SpawnEntityDef( dict );
+	}
+	
+	gameLocal.physicsIslands.StartBenchmark( numFrames );
+	gameLocal.Printf( "spawned %d '%s', benchmarking %d frames\n", count, defName, numFrames );
+}
@@ -0,0 +1,124 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __PHYSICS_ISLANDS_H__
+#define __PHYSICS_ISLANDS_H__
+
+/*
+===============================================================================
+
+  Physics islands.
+
+  Rigid bodies and articulated figures that touch each other form an island.
+  Bodies that would come to rest only do so when every active body in their
+  island can come to rest, and the whole island is put to rest at the end of
+  the frame. An impulse or activation on any sleeping member wakes the
+  whole island again, so piles of moveables and ragdolls don't jitter as
+  individual bodies keep waking up their neighbours.
+
+  Bodies are still evaluated one after another during entity think, islands
+  only decide when bodies sleep and wake.  Evaluating islands on job threads
+  would need the clip model links, contact callbacks and entity activation
+  that physics evaluation goes through to be thread safe.
+
+===============================================================================
+*/
+
+class idPhysics;
+
+typedef struct physicsIslandBody_s
+{
+	idPhysics* 				physics;			// only valid while the entity with the spawn id exists
+	int						entityNum;
+	int						spawnId;
+	bool					restCandidate;		// the body could come to rest this frame
+} physicsIslandBody_t;
+
+typedef struct physicsIslandMember_s
+{
+	int						entityNum;
+	int						spawnId;
+} physicsIslandMember_t;
+
+typedef struct physicsIslandStats_s
+{
+	int						numEvaluated;		// active bodies evaluated
+	int						numIslands;			// islands with active bodies
+	int						numSlept;			// bodies put to rest together with their island
+	int						numWoken;			// bodies woken up together with their island
+	uint64					evaluateTime;		// microseconds spent evaluating active bodies
+} physicsIslandStats_t;
+
+class idPhysicsIslands
+{
+public:
+							idPhysicsIslands();
+	
+	void					Clear();
+	
+	bool					IsEnabled() const;
+	// true if evaluated bodies have to be added this frame, for the islands or the stats
+	bool					IsTracking() const;
+	
+	void					BeginFrame();
+	// adds an active body that was evaluated this frame
+	void					AddBody( idEntity* self, idPhysics* physics, bool restCandidate, uint64 evaluateTime );
+	// puts islands to rest where all active bodies can come to rest
+	void					EndFrame();
+	// wakes up all bodies in the sleeping island of the entity
+	void					WakeIsland( const idEntity* ent );
+	
+	const physicsIslandStats_t& GetFrameStats() const
+	{
+		return frameStats;
+	}
+	
+	// measures bodies simulated per millisecond over the given number of frames
+	void					StartBenchmark( int numFrames );
+	
+private:
+	idList<physicsIslandBody_t>	bodies;			// active bodies this frame
+	idList<int>				bodyIndex;			// body index per entity number, -1 if not active
+	idList<int>				parent;				// union-find over the active bodies
+	idList<int>				sleepingIsland;		// sleeping island per entity number, -1 if none
+	idList< idList<physicsIslandMember_t> > sleepingIslands;
+	int						numFreeIslands;
+	
+	physicsIslandStats_t	frameStats;
+	physicsIslandStats_t	benchmarkStats;
+	int						benchmarkFrames;
+	int						benchmarkFramesLeft;
+	
+	idPhysics* 				GetBodyPhysics( int index ) const;
+	int						FindRoot( int index );
+	int						AllocSleepingIsland();
+	void					AddToSleepingIsland( int island, int entityNum );
+};
+
+#endif /* !__PHYSICS_ISLANDS_H__ */
@@ -813,6 +813,7 @@ void idPhysics_RigidBody::Activate()
 {
 	current.atRest = -1;
 	self->BecomeActive( TH_PHYSICS );
+	gameLocal.physicsIslands.WakeIsland( self );
 }
 
 /*
@@ -906,7 +907,9 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 	idVec3 oldOrigin, masterOrigin;
 	idMat3 oldAxis, masterAxis;
 	float timeStep;
-	bool collided, cameToRest = false;
+	bool collided, cameToRest = false, restCandidate = false;
+	uint64 evaluateStartTime = 0;
+	const bool trackIsland = gameLocal.physicsIslands.IsTracking();
 	
 	timeStep = MS2SEC( timeStepMSec );
 	current.lastTimeStep = timeStep;
@@ -954,6 +957,11 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 	timer_total.Start();
 #endif
 	
+	if( trackIsland )
+	{
+		evaluateStartTime = Sys_Microseconds();
+	}
+	
 	// move the rigid body velocity into the frame of a pusher
 //	current.i.linearMomentum -= current.pushVelocity.SubVec3( 0 ) * mass;
 //	current.i.angularMomentum -= current.pushVelocity.SubVec3( 1 ) * inertiaTensor;
@@ -1009,8 +1017,17 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 		// check if the body has come to rest
 		if( TestIfAtRest() )
 		{
-			// put to rest
-			Rest();
+			if( gameLocal.physicsIslands.IsEnabled() && current.atRest < 0 )
+			{
+				// the island puts the body to rest at the end of the frame if all touching bodies can come to rest
+				restCandidate = true;
+				ContactFriction( timeStep );
+			}
+			else
+			{
+				// put to rest
+				Rest();
+			}
 			cameToRest = true;
 		}
 		else
@@ -1020,7 +1037,7 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 		}
 	}
 	
-	if( current.atRest < 0 )
+	if( current.atRest < 0 && !restCandidate )
 	{
 		ActivateContactEntities();
 	}
@@ -1052,6 +1069,11 @@ bool idPhysics_RigidBody::Evaluate( int timeStepMSec, int endTimeMSec )
 		Rest();
 	}
 	
+	if( trackIsland )
+	{
+		gameLocal.physicsIslands.AddBody( self, this, restCandidate || current.atRest >= 0, Sys_Microseconds() - evaluateStartTime );
+	}
+	
 #ifdef RB_TIMINGS
 	timer_total.Stop();
 	
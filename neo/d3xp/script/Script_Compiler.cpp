@@ -203,6 +203,19 @@ const opcode_t idCompiler::opcodes[] =
 	{ "&", "BITAND", 3, false, &def_float, &def_float, &def_float },
 	{ "|", "BITOR", 3, false, &def_float, &def_float, &def_float },
 	
+	{ "<IFNOT_LT>", "IFNOT_LT", -1, false, &def_float, &def_float, &def_jumpoffset },
+	{ "<IFNOT_LE>", "IFNOT_LE", -1, false, &def_float, &def_float, &def_jumpoffset },
+	{ "<IFNOT_GT>", "IFNOT_GT", -1, false, &def_float, &def_float, &def_jumpoffset },
+	{ "<IFNOT_GE>", "IFNOT_GE", -1, false, &def_float, &def_float, &def_jumpoffset },
+	{ "<IFNOT_EQ>", "IFNOT_EQ_F", -1, false, &def_float, &def_float, &def_jumpoffset },
+	{ "<IFNOT_NE>", "IFNOT_NE_F", -1, false, &def_float, &def_float, &def_jumpoffset },
+	{ "<IFNOT_EQ>", "IFNOT_EQ_E", -1, false, &def_entity, &def_entity, &def_jumpoffset },
+	{ "<IFNOT_NE>", "IFNOT_NE_E", -1, false, &def_entity, &def_entity, &def_jumpoffset },
+	{ "<STOREFIELD>", "STOREFIELD_F", -1, false, &def_entity, &def_field, &def_float },
+	{ "<STOREFIELD>", "STOREFIELD_V", -1, false, &def_entity, &def_field, &def_vector },
+	{ "<STOREFIELD>", "STOREFIELD_ENT", -1, false, &def_entity, &def_field, &def_entity },
+	{ "<STOREFIELD>", "STOREFIELD_BOOL", -1, false, &def_entity, &def_field, &def_boolean },
+	
 	{ "<BREAK>", "BREAK", -1, false, &def_float, &def_void, &def_void },
 	{ "<CONTINUE>", "CONTINUE", -1, false, &def_float, &def_void, &def_void },
 	
@@ -193,6 +193,20 @@ enum
 	OP_BITAND,
 	OP_BITOR,
 	
+	// superinstructions generated by idProgram::OptimizeStatements.  never emitted by the compiler
+	OP_IFNOT_LT,
+	OP_IFNOT_LE,
+	OP_IFNOT_GT,
+	OP_IFNOT_GE,
+	OP_IFNOT_EQ_F,
+	OP_IFNOT_NE_F,
+	OP_IFNOT_EQ_E,
+	OP_IFNOT_NE_E,
+	OP_STOREFIELD_F,
+	OP_STOREFIELD_V,
+	OP_STOREFIELD_ENT,
+	OP_STOREFIELD_BOOL,
+	
 	OP_BREAK,			// placeholder op.  not used in final code
 	OP_CONTINUE,		// placeholder op.  not used in final code
 	
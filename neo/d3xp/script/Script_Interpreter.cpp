@@ -33,6 +33,9 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "../Game_local.h"
 
+int64 idInterpreter::opcodeCounts[ NUM_OPCODES ];
+int64 idInterpreter::executeTime;
+
 /*
 ================
 idInterpreter::idInterpreter()
@@ -45,6 +48,9 @@ idInterpreter::idInterpreter()
 	debug = 0;
 	memset( localstack, 0, sizeof( localstack ) );
 	memset( callStack, 0, sizeof( callStack ) );
+	memset( profileStack, 0, sizeof( profileStack ) );
+	profileClock = 0;
+	profileResumeTime = 0;
 	Reset();
 }
 
@@ -171,6 +177,9 @@ void idInterpreter::Restore( idRestoreGame* savefile )
 	savefile->ReadBool( threadDying );
 	savefile->ReadBool( terminateOnExit );
 	savefile->ReadBool( debug );
+	
+	// functions entered before the restore are never profiled
+	memset( profileStack, 0, sizeof( profileStack ) );
 }
 
 /*
@@ -706,6 +715,14 @@ void idInterpreter::EnterFunction( const function_t* func, bool clearStack )
 	assert( !func->eventdef );
 	NextInstruction( func->firstStatement );
 	
+	profileFrame_t& frame = profileStack[ callStackDepth - 1 ];
+	frame.valid = scriptProfiler.IsEnabled();
+	if( frame.valid )
+	{
+		frame.startTime = ProfileClock();
+		frame.childTime = 0;
+	}
+	
 	// allocate space on the stack for locals
 	// parms are already on stack
 	c = func->locals - func->parmTotal;
@@ -781,6 +798,19 @@ void idInterpreter::LeaveFunction( idVarDef* returnDef )
 		}
 	}
 	
+	if( profileStack[ callStackDepth - 1 ].valid && scriptProfiler.IsEnabled() )
+	{
+		const profileFrame_t& frame = profileStack[ callStackDepth - 1 ];
+		const uint64 now = ProfileClock();
+		const uint64 inclusiveTime = ( now > frame.startTime ) ? now - frame.startTime : 0;
+		const uint64 exclusiveTime = ( inclusiveTime > frame.childTime ) ? inclusiveTime - frame.childTime : 0;
+		scriptProfiler.AddFunction( currentFunction, inclusiveTime, exclusiveTime );
+		if( callStackDepth > 1 )
+		{
+			profileStack[ callStackDepth - 2 ].childTime += inclusiveTime;
+		}
+	}
+	
 	// up stack
 	callStackDepth--;
 	stack = &callStack[ callStackDepth ];
@@ -797,6 +827,27 @@ void idInterpreter::LeaveFunction( idVarDef* returnDef )
 	}
 }
 
+/*
+================
+idInterpreter::RunNative
+
+  Runs the statements of the current function its native version can run,
+  starting at the next statement.  Only called when a function is entered,
+  when a call returns to it, after an event call and when a thread resumes,
+  the interpreter carries on with the statement the native version stopped at.
+================
+*/
+void idInterpreter::RunNative()
+{
+	if( currentFunction == NULL || currentFunction->native == NULL )
+	{
+		return;
+	}
+	
+	const int firstStatement = currentFunction->firstStatement;
+	NextInstruction( firstStatement + currentFunction->native( &localstack[ localstackBase ], gameLocal.program.GetVariables(), instructionPointer + 1 - firstStatement ) );
+}
+
 /*
 ================
 idInterpreter::CallEvent
@@ -927,7 +978,17 @@ void idInterpreter::CallEvent( const function_t* func, int argsize )
 	}
 	
 	popParms = argsize;
-	eventEntity->ProcessEventArgPtr( evdef, data );
+	if( scriptProfiler.IsEnabled() )
+	{
+		const int depth = callStackDepth;
+		const uint64 startTime = ProfileClock();
+		eventEntity->ProcessEventArgPtr( evdef, data );
+		ProfileEvent( evdef, depth, startTime );
+	}
+	else
+	{
+		eventEntity->ProcessEventArgPtr( evdef, data );
+	}
 	
 	if( !multiFrameEvent )
 	{
@@ -944,6 +1005,25 @@ void idInterpreter::CallEvent( const function_t* func, int argsize )
 	popParms = 0;
 }
 
+/*
+================
+idInterpreter::ProfileEvent
+
+Charges the time of a native event to the event and to the function that called it
+================
+*/
+void idInterpreter::ProfileEvent( const idEventDef* evdef, int depth, uint64 startTime )
+{
+	const uint64 now = ProfileClock();
+	const uint64 time = ( now > startTime ) ? now - startTime : 0;
+	
+	scriptProfiler.AddEvent( evdef, time );
+	if( depth > 0 )
+	{
+		profileStack[ depth - 1 ].childTime += time;
+	}
+}
+
 /*
 ================
 idInterpreter::BeginMultiFrameEvent
@@ -1076,7 +1156,17 @@ void idInterpreter::CallSysEvent( const function_t* func, int argsize )
 	}
 	
 	popParms = argsize;
-	thread->ProcessEventArgPtr( evdef, data );
+	if( scriptProfiler.IsEnabled() )
+	{
+		const int depth = callStackDepth;
+		const uint64 startTime = ProfileClock();
+		thread->ProcessEventArgPtr( evdef, data );
+		ProfileEvent( evdef, depth, startTime );
+	}
+	else
+	{
+		thread->ProcessEventArgPtr( evdef, data );
+	}
 	if( popParms )
 	{
 		PopParms( popParms );
@@ -1084,6 +1174,54 @@ void idInterpreter::CallSysEvent( const function_t* func, int argsize )
 	popParms = 0;
 }
 
+/*
+====================
+Script opcode dispatch
+
+  With GCC and Clang every opcode handler fetches the next statement and jumps
+  straight to its handler through a table of label addresses, which gives each
+  handler its own indirect branch to predict.  Other compilers use the switch.
+====================
+*/
+#if defined( __GNUC__ )
+#define SCRIPT_THREADED_DISPATCH
+#endif
+
+#define SCRIPT_FETCH_STATEMENT										\
+	instructionPointer++;											\
+	if( !--runaway )												\
+	{																\
+		Error( "runaway loop error" );								\
+	}																\
+	st = &gameLocal.program.GetStatement( instructionPointer );		\
+	if( opcodeStats )												\
+	{																\
+		opcodeCounts[ st->op ]++;									\
+	}
+
+#ifdef SCRIPT_THREADED_DISPATCH
+#define SCRIPT_DISPATCH( op )										\
+	if( ( unsigned )( op ) >= NUM_OPCODES )							\
+	{																\
+		goto SCRIPT_LABEL_DEFAULT;									\
+	}																\
+	goto *dispatchTable[ op ];
+#define SCRIPT_OPCODE_CASE( op )		SCRIPT_LABEL_##op
+#define SCRIPT_OPCODE_DEFAULT			SCRIPT_LABEL_DEFAULT
+#define SCRIPT_NEXT_STATEMENT										\
+	if( doneProcessing || threadDying )								\
+	{																\
+		break;														\
+	}																\
+	SCRIPT_FETCH_STATEMENT;											\
+	SCRIPT_DISPATCH( st->op )
+#else
+#define SCRIPT_DISPATCH( op )			switch( op )
+#define SCRIPT_OPCODE_CASE( op )		case op
+#define SCRIPT_OPCODE_DEFAULT			default
+#define SCRIPT_NEXT_STATEMENT			break
+#endif
+
 /*
 ====================
 idInterpreter::Execute
@@ -1107,6 +1245,48 @@ bool idInterpreter::Execute()
 		return true;
 	}
 	
+#ifdef SCRIPT_THREADED_DISPATCH
+	// handler of each opcode, in the order of the opcode enum in Script_Compiler.h
+	static void* const dispatchTable[] =
+	{
+		&&SCRIPT_LABEL_OP_RETURN, &&SCRIPT_LABEL_OP_UINC_F, &&SCRIPT_LABEL_OP_UINCP_F, &&SCRIPT_LABEL_OP_UDEC_F,
+		&&SCRIPT_LABEL_OP_UDECP_F, &&SCRIPT_LABEL_OP_COMP_F, &&SCRIPT_LABEL_OP_MUL_F, &&SCRIPT_LABEL_OP_MUL_V,
+		&&SCRIPT_LABEL_OP_MUL_FV, &&SCRIPT_LABEL_OP_MUL_VF, &&SCRIPT_LABEL_OP_DIV_F, &&SCRIPT_LABEL_OP_MOD_F,
+		&&SCRIPT_LABEL_OP_ADD_F, &&SCRIPT_LABEL_OP_ADD_V, &&SCRIPT_LABEL_OP_ADD_S, &&SCRIPT_LABEL_OP_ADD_FS,
+		&&SCRIPT_LABEL_OP_ADD_SF, &&SCRIPT_LABEL_OP_ADD_VS, &&SCRIPT_LABEL_OP_ADD_SV, &&SCRIPT_LABEL_OP_SUB_F,
+		&&SCRIPT_LABEL_OP_SUB_V, &&SCRIPT_LABEL_OP_EQ_F, &&SCRIPT_LABEL_OP_EQ_V, &&SCRIPT_LABEL_OP_EQ_S,
+		&&SCRIPT_LABEL_OP_EQ_E, &&SCRIPT_LABEL_OP_EQ_EO, &&SCRIPT_LABEL_OP_EQ_OE, &&SCRIPT_LABEL_OP_EQ_OO,
+		&&SCRIPT_LABEL_OP_NE_F, &&SCRIPT_LABEL_OP_NE_V, &&SCRIPT_LABEL_OP_NE_S, &&SCRIPT_LABEL_OP_NE_E,
+		&&SCRIPT_LABEL_OP_NE_EO, &&SCRIPT_LABEL_OP_NE_OE, &&SCRIPT_LABEL_OP_NE_OO, &&SCRIPT_LABEL_OP_LE,
+		&&SCRIPT_LABEL_OP_GE, &&SCRIPT_LABEL_OP_LT, &&SCRIPT_LABEL_OP_GT, &&SCRIPT_LABEL_OP_INDIRECT_F,
+		&&SCRIPT_LABEL_OP_INDIRECT_V, &&SCRIPT_LABEL_OP_INDIRECT_S, &&SCRIPT_LABEL_OP_INDIRECT_ENT, &&SCRIPT_LABEL_OP_INDIRECT_BOOL,
+		&&SCRIPT_LABEL_OP_INDIRECT_OBJ, &&SCRIPT_LABEL_OP_ADDRESS, &&SCRIPT_LABEL_OP_EVENTCALL, &&SCRIPT_LABEL_OP_OBJECTCALL,
+		&&SCRIPT_LABEL_OP_SYSCALL, &&SCRIPT_LABEL_OP_STORE_F, &&SCRIPT_LABEL_OP_STORE_V, &&SCRIPT_LABEL_OP_STORE_S,
+		&&SCRIPT_LABEL_OP_STORE_ENT, &&SCRIPT_LABEL_OP_STORE_BOOL, &&SCRIPT_LABEL_OP_STORE_OBJENT, &&SCRIPT_LABEL_OP_STORE_OBJ,
+		&&SCRIPT_LABEL_OP_STORE_ENTOBJ, &&SCRIPT_LABEL_OP_STORE_FTOS, &&SCRIPT_LABEL_OP_STORE_BTOS, &&SCRIPT_LABEL_OP_STORE_VTOS,
+		&&SCRIPT_LABEL_OP_STORE_FTOBOOL, &&SCRIPT_LABEL_OP_STORE_BOOLTOF, &&SCRIPT_LABEL_OP_STOREP_F, &&SCRIPT_LABEL_OP_STOREP_V,
+		&&SCRIPT_LABEL_OP_STOREP_S, &&SCRIPT_LABEL_OP_STOREP_ENT, &&SCRIPT_LABEL_OP_STOREP_FLD, &&SCRIPT_LABEL_OP_STOREP_BOOL,
+		&&SCRIPT_LABEL_OP_STOREP_OBJ, &&SCRIPT_LABEL_OP_STOREP_OBJENT, &&SCRIPT_LABEL_OP_STOREP_FTOS, &&SCRIPT_LABEL_OP_STOREP_BTOS,
+		&&SCRIPT_LABEL_OP_STOREP_VTOS, &&SCRIPT_LABEL_OP_STOREP_FTOBOOL, &&SCRIPT_LABEL_OP_STOREP_BOOLTOF, &&SCRIPT_LABEL_OP_UMUL_F,
+		&&SCRIPT_LABEL_OP_UMUL_V, &&SCRIPT_LABEL_OP_UDIV_F, &&SCRIPT_LABEL_OP_UDIV_V, &&SCRIPT_LABEL_OP_UMOD_F,
+		&&SCRIPT_LABEL_OP_UADD_F, &&SCRIPT_LABEL_OP_UADD_V, &&SCRIPT_LABEL_OP_USUB_F, &&SCRIPT_LABEL_OP_USUB_V,
+		&&SCRIPT_LABEL_OP_UAND_F, &&SCRIPT_LABEL_OP_UOR_F, &&SCRIPT_LABEL_OP_NOT_BOOL, &&SCRIPT_LABEL_OP_NOT_F,
+		&&SCRIPT_LABEL_OP_NOT_V, &&SCRIPT_LABEL_OP_NOT_S, &&SCRIPT_LABEL_OP_NOT_ENT, &&SCRIPT_LABEL_OP_NEG_F,
+		&&SCRIPT_LABEL_OP_NEG_V, &&SCRIPT_LABEL_OP_INT_F, &&SCRIPT_LABEL_OP_IF, &&SCRIPT_LABEL_OP_IFNOT,
+		&&SCRIPT_LABEL_OP_CALL, &&SCRIPT_LABEL_OP_THREAD, &&SCRIPT_LABEL_OP_OBJTHREAD, &&SCRIPT_LABEL_OP_PUSH_F,
+		&&SCRIPT_LABEL_OP_PUSH_V, &&SCRIPT_LABEL_OP_PUSH_S, &&SCRIPT_LABEL_OP_PUSH_ENT, &&SCRIPT_LABEL_OP_PUSH_OBJ,
+		&&SCRIPT_LABEL_OP_PUSH_OBJENT, &&SCRIPT_LABEL_OP_PUSH_FTOS, &&SCRIPT_LABEL_OP_PUSH_BTOF, &&SCRIPT_LABEL_OP_PUSH_FTOB,
+		&&SCRIPT_LABEL_OP_PUSH_VTOS, &&SCRIPT_LABEL_OP_PUSH_BTOS, &&SCRIPT_LABEL_OP_GOTO, &&SCRIPT_LABEL_OP_AND,
+		&&SCRIPT_LABEL_OP_AND_BOOLF, &&SCRIPT_LABEL_OP_AND_FBOOL, &&SCRIPT_LABEL_OP_AND_BOOLBOOL, &&SCRIPT_LABEL_OP_OR,
+		&&SCRIPT_LABEL_OP_OR_BOOLF, &&SCRIPT_LABEL_OP_OR_FBOOL, &&SCRIPT_LABEL_OP_OR_BOOLBOOL, &&SCRIPT_LABEL_OP_BITAND,
+		&&SCRIPT_LABEL_OP_BITOR, &&SCRIPT_LABEL_OP_IFNOT_LT, &&SCRIPT_LABEL_OP_IFNOT_LE, &&SCRIPT_LABEL_OP_IFNOT_GT,
+		&&SCRIPT_LABEL_OP_IFNOT_GE, &&SCRIPT_LABEL_OP_IFNOT_EQ_F, &&SCRIPT_LABEL_OP_IFNOT_NE_F, &&SCRIPT_LABEL_OP_IFNOT_EQ_E,
+		&&SCRIPT_LABEL_OP_IFNOT_NE_E, &&SCRIPT_LABEL_OP_STOREFIELD_F, &&SCRIPT_LABEL_OP_STOREFIELD_V, &&SCRIPT_LABEL_OP_STOREFIELD_ENT,
+		&&SCRIPT_LABEL_OP_STOREFIELD_BOOL, &&SCRIPT_LABEL_OP_BREAK, &&SCRIPT_LABEL_OP_CONTINUE
+	};
+	compile_time_assert( sizeof( dispatchTable ) / sizeof( dispatchTable[ 0 ] ) == NUM_OPCODES );
+#endif
+	
 	if( multiFrameEvent )
 	{
 		// move to previous instruction and call it again
@@ -1115,35 +1295,46 @@ bool idInterpreter::Execute()
 	
 	runaway = 5000000;
 	
+	const bool opcodeStats = g_scriptOpcodeStats.GetBool();
+	const int startTime = opcodeStats ? Sys_Microseconds() : 0;
+	// natives are skipped while debugging and counting opcodes so every statement is traced and counted
+	const bool useNative = g_scriptNative.GetBool() && !opcodeStats && !debug;
+	
+	if( scriptProfiler.IsEnabled() )
+	{
+		profileResumeTime = Sys_Microseconds();
+	}
+	
+	if( useNative )
+	{
+		RunNative();
+	}
+	
 	doneProcessing = false;
 	while( !doneProcessing && !threadDying )
 	{
-		instructionPointer++;
-		
-		if( !--runaway )
-		{
-			Error( "runaway loop error" );
-		}
+		SCRIPT_FETCH_STATEMENT;
 		
-		// next statement
-		st = &gameLocal.program.GetStatement( instructionPointer );
-		
-		switch( st->op )
+		SCRIPT_DISPATCH( st->op )
 		{
-			case OP_RETURN:
+			SCRIPT_OPCODE_CASE( OP_RETURN ):
 				LeaveFunction( st->a );
-				break;
+				if( useNative )
+				{
+					RunNative();
+				}
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_THREAD:
+			SCRIPT_OPCODE_CASE( OP_THREAD ):
 				newThread = new idThread( this, st->a->value.functionPtr, st->b->value.argSize );
 				newThread->Start();
 				
 				// return the thread number to the script
 				gameLocal.program.ReturnFloat( newThread->GetThreadNum() );
 				PopParms( st->b->value.argSize );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_OBJTHREAD:
+			SCRIPT_OPCODE_CASE( OP_OBJTHREAD ):
 				var_a = GetVariable( st->a );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if( obj )
@@ -1162,23 +1353,35 @@ bool idInterpreter::Execute()
 					gameLocal.program.ReturnFloat( 0.0f );
 				}
 				PopParms( st->c->value.argSize );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_CALL:
+			SCRIPT_OPCODE_CASE( OP_CALL ):
 				EnterFunction( st->a->value.functionPtr, false );
-				break;
+				if( useNative )
+				{
+					RunNative();
+				}
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_EVENTCALL:
+			SCRIPT_OPCODE_CASE( OP_EVENTCALL ):
 				CallEvent( st->a->value.functionPtr, st->b->value.argSize );
-				break;
+				if( useNative && !doneProcessing && !threadDying )
+				{
+					RunNative();
+				}
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_OBJECTCALL:
+			SCRIPT_OPCODE_CASE( OP_OBJECTCALL ):
 				var_a = GetVariable( st->a );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if( obj )
 				{
 					func = obj->GetTypeDef()->GetFunction( st->b->value.virtualFunction );
 					EnterFunction( func, false );
+					if( useNative )
+					{
+						RunNative();
+					}
 				}
 				else
 				{
@@ -1187,118 +1390,122 @@ bool idInterpreter::Execute()
 					gameLocal.program.ReturnString( "" );
 					PopParms( st->c->value.argSize );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_SYSCALL:
+			SCRIPT_OPCODE_CASE( OP_SYSCALL ):
 				CallSysEvent( st->a->value.functionPtr, st->b->value.argSize );
-				break;
+				if( useNative && !doneProcessing && !threadDying )
+				{
+					RunNative();
+				}
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_IFNOT:
+			SCRIPT_OPCODE_CASE( OP_IFNOT ):
 				var_a = GetVariable( st->a );
 				if( *var_a.intPtr == 0 )
 				{
 					NextInstruction( instructionPointer + st->b->value.jumpOffset );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_IF:
+			SCRIPT_OPCODE_CASE( OP_IF ):
 				var_a = GetVariable( st->a );
 				if( *var_a.intPtr != 0 )
 				{
 					NextInstruction( instructionPointer + st->b->value.jumpOffset );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_GOTO:
+			SCRIPT_OPCODE_CASE( OP_GOTO ):
 				NextInstruction( instructionPointer + st->a->value.jumpOffset );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_F:
+			SCRIPT_OPCODE_CASE( OP_ADD_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = *var_a.floatPtr + *var_b.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_V:
+			SCRIPT_OPCODE_CASE( OP_ADD_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.vectorPtr = *var_a.vectorPtr + *var_b.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_S:
+			SCRIPT_OPCODE_CASE( OP_ADD_S ):
 				SetString( st->c, GetString( st->a ) );
 				AppendString( st->c, GetString( st->b ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_FS:
+			SCRIPT_OPCODE_CASE( OP_ADD_FS ):
 				var_a = GetVariable( st->a );
 				SetString( st->c, FloatToString( *var_a.floatPtr ) );
 				AppendString( st->c, GetString( st->b ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_SF:
+			SCRIPT_OPCODE_CASE( OP_ADD_SF ):
 				var_b = GetVariable( st->b );
 				SetString( st->c, GetString( st->a ) );
 				AppendString( st->c, FloatToString( *var_b.floatPtr ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_VS:
+			SCRIPT_OPCODE_CASE( OP_ADD_VS ):
 				var_a = GetVariable( st->a );
 				SetString( st->c, var_a.vectorPtr->ToString() );
 				AppendString( st->c, GetString( st->b ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADD_SV:
+			SCRIPT_OPCODE_CASE( OP_ADD_SV ):
 				var_b = GetVariable( st->b );
 				SetString( st->c, GetString( st->a ) );
 				AppendString( st->c, var_b.vectorPtr->ToString() );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_SUB_F:
+			SCRIPT_OPCODE_CASE( OP_SUB_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = *var_a.floatPtr - *var_b.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_SUB_V:
+			SCRIPT_OPCODE_CASE( OP_SUB_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.vectorPtr = *var_a.vectorPtr - *var_b.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_MUL_F:
+			SCRIPT_OPCODE_CASE( OP_MUL_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = *var_a.floatPtr * *var_b.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_MUL_V:
+			SCRIPT_OPCODE_CASE( OP_MUL_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = *var_a.vectorPtr * *var_b.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_MUL_FV:
+			SCRIPT_OPCODE_CASE( OP_MUL_FV ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.vectorPtr = *var_a.floatPtr * *var_b.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_MUL_VF:
+			SCRIPT_OPCODE_CASE( OP_MUL_VF ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.vectorPtr = *var_a.vectorPtr * *var_b.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_DIV_F:
+			SCRIPT_OPCODE_CASE( OP_DIV_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
@@ -1312,9 +1519,9 @@ bool idInterpreter::Execute()
 				{
 					*var_c.floatPtr = *var_a.floatPtr / *var_b.floatPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_MOD_F:
+			SCRIPT_OPCODE_CASE( OP_MOD_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
@@ -1328,250 +1535,250 @@ bool idInterpreter::Execute()
 				{
 					*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) % static_cast<int>( *var_b.floatPtr );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_BITAND:
+			SCRIPT_OPCODE_CASE( OP_BITAND ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) & static_cast<int>( *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_BITOR:
+			SCRIPT_OPCODE_CASE( OP_BITOR ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr ) | static_cast<int>( *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_GE:
+			SCRIPT_OPCODE_CASE( OP_GE ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr >= *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_LE:
+			SCRIPT_OPCODE_CASE( OP_LE ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr <= *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_GT:
+			SCRIPT_OPCODE_CASE( OP_GT ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr > *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_LT:
+			SCRIPT_OPCODE_CASE( OP_LT ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr < *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_AND:
+			SCRIPT_OPCODE_CASE( OP_AND ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.floatPtr != 0.0f );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_AND_BOOLF:
+			SCRIPT_OPCODE_CASE( OP_AND_BOOLF ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.floatPtr != 0.0f );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_AND_FBOOL:
+			SCRIPT_OPCODE_CASE( OP_AND_FBOOL ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) && ( *var_b.intPtr != 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_AND_BOOLBOOL:
+			SCRIPT_OPCODE_CASE( OP_AND_BOOLBOOL ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.intPtr != 0 ) && ( *var_b.intPtr != 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_OR:
+			SCRIPT_OPCODE_CASE( OP_OR ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.floatPtr != 0.0f );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_OR_BOOLF:
+			SCRIPT_OPCODE_CASE( OP_OR_BOOLF ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.floatPtr != 0.0f );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_OR_FBOOL:
+			SCRIPT_OPCODE_CASE( OP_OR_FBOOL ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr != 0.0f ) || ( *var_b.intPtr != 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_OR_BOOLBOOL:
+			SCRIPT_OPCODE_CASE( OP_OR_BOOLBOOL ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.intPtr != 0 ) || ( *var_b.intPtr != 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NOT_BOOL:
+			SCRIPT_OPCODE_CASE( OP_NOT_BOOL ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.intPtr == 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NOT_F:
+			SCRIPT_OPCODE_CASE( OP_NOT_F ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr == 0.0f );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NOT_V:
+			SCRIPT_OPCODE_CASE( OP_NOT_V ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.vectorPtr == vec3_zero );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NOT_S:
+			SCRIPT_OPCODE_CASE( OP_NOT_S ):
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( strlen( GetString( st->a ) ) == 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NOT_ENT:
+			SCRIPT_OPCODE_CASE( OP_NOT_ENT ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( GetEntity( *var_a.entityNumberPtr ) == NULL );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NEG_F:
+			SCRIPT_OPCODE_CASE( OP_NEG_F ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = -*var_a.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NEG_V:
+			SCRIPT_OPCODE_CASE( OP_NEG_V ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.vectorPtr = -*var_a.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INT_F:
+			SCRIPT_OPCODE_CASE( OP_INT_F ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = static_cast<int>( *var_a.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_EQ_F:
+			SCRIPT_OPCODE_CASE( OP_EQ_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr == *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_EQ_V:
+			SCRIPT_OPCODE_CASE( OP_EQ_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.vectorPtr == *var_b.vectorPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_EQ_S:
+			SCRIPT_OPCODE_CASE( OP_EQ_S ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) == 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_EQ_E:
-			case OP_EQ_EO:
-			case OP_EQ_OE:
-			case OP_EQ_OO:
+			SCRIPT_OPCODE_CASE( OP_EQ_E ):
+			SCRIPT_OPCODE_CASE( OP_EQ_EO ):
+			SCRIPT_OPCODE_CASE( OP_EQ_OE ):
+			SCRIPT_OPCODE_CASE( OP_EQ_OO ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.entityNumberPtr == *var_b.entityNumberPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NE_F:
+			SCRIPT_OPCODE_CASE( OP_NE_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.floatPtr != *var_b.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NE_V:
+			SCRIPT_OPCODE_CASE( OP_NE_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.vectorPtr != *var_b.vectorPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NE_S:
+			SCRIPT_OPCODE_CASE( OP_NE_S ):
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( idStr::Cmp( GetString( st->a ), GetString( st->b ) ) != 0 );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_NE_E:
-			case OP_NE_EO:
-			case OP_NE_OE:
-			case OP_NE_OO:
+			SCRIPT_OPCODE_CASE( OP_NE_E ):
+			SCRIPT_OPCODE_CASE( OP_NE_EO ):
+			SCRIPT_OPCODE_CASE( OP_NE_OE ):
+			SCRIPT_OPCODE_CASE( OP_NE_OO ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ( *var_a.entityNumberPtr != *var_b.entityNumberPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UADD_F:
+			SCRIPT_OPCODE_CASE( OP_UADD_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr += *var_a.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UADD_V:
+			SCRIPT_OPCODE_CASE( OP_UADD_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.vectorPtr += *var_a.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_USUB_F:
+			SCRIPT_OPCODE_CASE( OP_USUB_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr -= *var_a.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_USUB_V:
+			SCRIPT_OPCODE_CASE( OP_USUB_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.vectorPtr -= *var_a.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UMUL_F:
+			SCRIPT_OPCODE_CASE( OP_UMUL_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr *= *var_a.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UMUL_V:
+			SCRIPT_OPCODE_CASE( OP_UMUL_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.vectorPtr *= *var_a.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UDIV_F:
+			SCRIPT_OPCODE_CASE( OP_UDIV_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				
@@ -1584,9 +1791,9 @@ bool idInterpreter::Execute()
 				{
 					*var_b.floatPtr = *var_b.floatPtr / *var_a.floatPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UDIV_V:
+			SCRIPT_OPCODE_CASE( OP_UDIV_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				
@@ -1599,9 +1806,9 @@ bool idInterpreter::Execute()
 				{
 					*var_b.vectorPtr = *var_b.vectorPtr / *var_a.floatPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UMOD_F:
+			SCRIPT_OPCODE_CASE( OP_UMOD_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				
@@ -1614,26 +1821,26 @@ bool idInterpreter::Execute()
 				{
 					*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) % static_cast<int>( *var_a.floatPtr );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UOR_F:
+			SCRIPT_OPCODE_CASE( OP_UOR_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) | static_cast<int>( *var_a.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UAND_F:
+			SCRIPT_OPCODE_CASE( OP_UAND_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr = static_cast<int>( *var_b.floatPtr ) & static_cast<int>( *var_a.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UINC_F:
+			SCRIPT_OPCODE_CASE( OP_UINC_F ):
 				var_a = GetVariable( st->a );
 				( *var_a.floatPtr )++;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UINCP_F:
+			SCRIPT_OPCODE_CASE( OP_UINCP_F ):
 				var_a = GetVariable( st->a );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if( obj )
@@ -1641,14 +1848,14 @@ bool idInterpreter::Execute()
 					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
 					( *var.floatPtr )++;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UDEC_F:
+			SCRIPT_OPCODE_CASE( OP_UDEC_F ):
 				var_a = GetVariable( st->a );
 				( *var_a.floatPtr )--;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_UDECP_F:
+			SCRIPT_OPCODE_CASE( OP_UDECP_F ):
 				var_a = GetVariable( st->a );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if( obj )
@@ -1656,33 +1863,33 @@ bool idInterpreter::Execute()
 					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
 					( *var.floatPtr )--;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_COMP_F:
+			SCRIPT_OPCODE_CASE( OP_COMP_F ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				*var_c.floatPtr = ~static_cast<int>( *var_a.floatPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_F:
+			SCRIPT_OPCODE_CASE( OP_STORE_F ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr = *var_a.floatPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_ENT:
+			SCRIPT_OPCODE_CASE( OP_STORE_ENT ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_BOOL:
+			SCRIPT_OPCODE_CASE( OP_STORE_BOOL ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.intPtr = *var_a.intPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_OBJENT:
+			SCRIPT_OPCODE_CASE( OP_STORE_OBJENT ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -1699,41 +1906,41 @@ bool idInterpreter::Execute()
 				{
 					*var_b.entityNumberPtr = *var_a.entityNumberPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_OBJ:
-			case OP_STORE_ENTOBJ:
+			SCRIPT_OPCODE_CASE( OP_STORE_OBJ ):
+			SCRIPT_OPCODE_CASE( OP_STORE_ENTOBJ ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.entityNumberPtr = *var_a.entityNumberPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_S:
+			SCRIPT_OPCODE_CASE( OP_STORE_S ):
 				SetString( st->b, GetString( st->a ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_V:
+			SCRIPT_OPCODE_CASE( OP_STORE_V ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.vectorPtr = *var_a.vectorPtr;
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_FTOS:
+			SCRIPT_OPCODE_CASE( OP_STORE_FTOS ):
 				var_a = GetVariable( st->a );
 				SetString( st->b, FloatToString( *var_a.floatPtr ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_BTOS:
+			SCRIPT_OPCODE_CASE( OP_STORE_BTOS ):
 				var_a = GetVariable( st->a );
 				SetString( st->b, *var_a.intPtr ? "true" : "false" );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_VTOS:
+			SCRIPT_OPCODE_CASE( OP_STORE_VTOS ):
 				var_a = GetVariable( st->a );
 				SetString( st->b, var_a.vectorPtr->ToString() );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_FTOBOOL:
+			SCRIPT_OPCODE_CASE( OP_STORE_FTOBOOL ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				if( *var_a.floatPtr != 0.0f )
@@ -1744,77 +1951,77 @@ bool idInterpreter::Execute()
 				{
 					*var_b.intPtr = 0;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STORE_BOOLTOF:
+			SCRIPT_OPCODE_CASE( OP_STORE_BOOLTOF ):
 				var_a = GetVariable( st->a );
 				var_b = GetVariable( st->b );
 				*var_b.floatPtr = static_cast<float>( *var_a.intPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_F:
+			SCRIPT_OPCODE_CASE( OP_STOREP_F ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->floatPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->floatPtr = *var_a.floatPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_ENT:
+			SCRIPT_OPCODE_CASE( OP_STOREP_ENT ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->entityNumberPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_FLD:
+			SCRIPT_OPCODE_CASE( OP_STOREP_FLD ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->intPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->intPtr = *var_a.intPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_BOOL:
+			SCRIPT_OPCODE_CASE( OP_STOREP_BOOL ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->intPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->intPtr = *var_a.intPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_S:
+			SCRIPT_OPCODE_CASE( OP_STOREP_S ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->stringPtr )
 				{
 					idStr::Copynz( var_b.evalPtr->stringPtr, GetString( st->a ), MAX_STRING_LEN );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_V:
+			SCRIPT_OPCODE_CASE( OP_STOREP_V ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->vectorPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->vectorPtr = *var_a.vectorPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_FTOS:
+			SCRIPT_OPCODE_CASE( OP_STOREP_FTOS ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->stringPtr )
 				{
 					var_a = GetVariable( st->a );
 					idStr::Copynz( var_b.evalPtr->stringPtr, FloatToString( *var_a.floatPtr ), MAX_STRING_LEN );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_BTOS:
+			SCRIPT_OPCODE_CASE( OP_STOREP_BTOS ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->stringPtr )
 				{
@@ -1828,18 +2035,18 @@ bool idInterpreter::Execute()
 						idStr::Copynz( var_b.evalPtr->stringPtr, "false", MAX_STRING_LEN );
 					}
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_VTOS:
+			SCRIPT_OPCODE_CASE( OP_STOREP_VTOS ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->stringPtr )
 				{
 					var_a = GetVariable( st->a );
 					idStr::Copynz( var_b.evalPtr->stringPtr, var_a.vectorPtr->ToString(), MAX_STRING_LEN );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_FTOBOOL:
+			SCRIPT_OPCODE_CASE( OP_STOREP_FTOBOOL ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->intPtr )
 				{
@@ -1853,27 +2060,27 @@ bool idInterpreter::Execute()
 						*var_b.evalPtr->intPtr = 0;
 					}
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_BOOLTOF:
+			SCRIPT_OPCODE_CASE( OP_STOREP_BOOLTOF ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->floatPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->floatPtr = static_cast<float>( *var_a.intPtr );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_OBJ:
+			SCRIPT_OPCODE_CASE( OP_STOREP_OBJ ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->entityNumberPtr )
 				{
 					var_a = GetVariable( st->a );
 					*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_STOREP_OBJENT:
+			SCRIPT_OPCODE_CASE( OP_STOREP_OBJENT ):
 				var_b = GetVariable( st->b );
 				if( var_b.evalPtr && var_b.evalPtr->entityNumberPtr )
 				{
@@ -1897,9 +2104,9 @@ bool idInterpreter::Execute()
 						*var_b.evalPtr->entityNumberPtr = *var_a.entityNumberPtr;
 					}
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_ADDRESS:
+			SCRIPT_OPCODE_CASE( OP_ADDRESS ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -1911,9 +2118,9 @@ bool idInterpreter::Execute()
 				{
 					var_c.evalPtr->bytePtr = NULL;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INDIRECT_F:
+			SCRIPT_OPCODE_CASE( OP_INDIRECT_F ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -1926,9 +2133,9 @@ bool idInterpreter::Execute()
 				{
 					*var_c.floatPtr = 0.0f;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INDIRECT_ENT:
+			SCRIPT_OPCODE_CASE( OP_INDIRECT_ENT ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -1941,9 +2148,9 @@ bool idInterpreter::Execute()
 				{
 					*var_c.entityNumberPtr = 0;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INDIRECT_BOOL:
+			SCRIPT_OPCODE_CASE( OP_INDIRECT_BOOL ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -1956,9 +2163,9 @@ bool idInterpreter::Execute()
 				{
 					*var_c.intPtr = 0;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INDIRECT_S:
+			SCRIPT_OPCODE_CASE( OP_INDIRECT_S ):
 				var_a = GetVariable( st->a );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
 				if( obj )
@@ -1970,9 +2177,9 @@ bool idInterpreter::Execute()
 				{
 					SetString( st->c, "" );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INDIRECT_V:
+			SCRIPT_OPCODE_CASE( OP_INDIRECT_V ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -1985,9 +2192,9 @@ bool idInterpreter::Execute()
 				{
 					var_c.vectorPtr->Zero();
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_INDIRECT_OBJ:
+			SCRIPT_OPCODE_CASE( OP_INDIRECT_OBJ ):
 				var_a = GetVariable( st->a );
 				var_c = GetVariable( st->c );
 				obj = GetScriptObject( *var_a.entityNumberPtr );
@@ -2000,25 +2207,25 @@ bool idInterpreter::Execute()
 					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
 					*var_c.entityNumberPtr = *var.entityNumberPtr;
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_F:
+			SCRIPT_OPCODE_CASE( OP_PUSH_F ):
 				var_a = GetVariable( st->a );
 				Push( *var_a.intPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_FTOS:
+			SCRIPT_OPCODE_CASE( OP_PUSH_FTOS ):
 				var_a = GetVariable( st->a );
 				PushString( FloatToString( *var_a.floatPtr ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_BTOF:
+			SCRIPT_OPCODE_CASE( OP_PUSH_BTOF ):
 				var_a = GetVariable( st->a );
 				floatVal = *var_a.intPtr;
 				Push( *reinterpret_cast<int*>( &floatVal ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_FTOB:
+			SCRIPT_OPCODE_CASE( OP_PUSH_FTOB ):
 				var_a = GetVariable( st->a );
 				if( *var_a.floatPtr != 0.0f )
 				{
@@ -2028,28 +2235,28 @@ bool idInterpreter::Execute()
 				{
 					Push( 0 );
 				}
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_VTOS:
+			SCRIPT_OPCODE_CASE( OP_PUSH_VTOS ):
 				var_a = GetVariable( st->a );
 				PushString( var_a.vectorPtr->ToString() );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_BTOS:
+			SCRIPT_OPCODE_CASE( OP_PUSH_BTOS ):
 				var_a = GetVariable( st->a );
 				PushString( *var_a.intPtr ? "true" : "false" );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_ENT:
+			SCRIPT_OPCODE_CASE( OP_PUSH_ENT ):
 				var_a = GetVariable( st->a );
 				Push( *var_a.entityNumberPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_S:
+			SCRIPT_OPCODE_CASE( OP_PUSH_S ):
 				PushString( GetString( st->a ) );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_V:
+			SCRIPT_OPCODE_CASE( OP_PUSH_V ):
 				var_a = GetVariable( st->a );
 				// RB: 64 bit fix, changed individual pushes with PushVector
 				/*
@@ -2059,29 +2266,216 @@ bool idInterpreter::Execute()
 				*/
 				PushVector( *var_a.vectorPtr );
 				// RB end
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_OBJ:
+			SCRIPT_OPCODE_CASE( OP_PUSH_OBJ ):
 				var_a = GetVariable( st->a );
 				Push( *var_a.entityNumberPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_PUSH_OBJENT:
+			SCRIPT_OPCODE_CASE( OP_PUSH_OBJENT ):
 				var_a = GetVariable( st->a );
 				Push( *var_a.entityNumberPtr );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 				
-			case OP_BREAK:
-			case OP_CONTINUE:
-			default:
+			SCRIPT_OPCODE_CASE( OP_IFNOT_LT ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.floatPtr < *var_b.floatPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_LE ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.floatPtr <= *var_b.floatPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_GT ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.floatPtr > *var_b.floatPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_GE ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.floatPtr >= *var_b.floatPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_EQ_F ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.floatPtr == *var_b.floatPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_NE_F ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.floatPtr != *var_b.floatPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_EQ_E ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.entityNumberPtr == *var_b.entityNumberPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_IFNOT_NE_E ):
+				var_a = GetVariable( st->a );
+				var_b = GetVariable( st->b );
+				if( !( *var_a.entityNumberPtr != *var_b.entityNumberPtr ) )
+				{
+					NextInstruction( instructionPointer + st->c->value.jumpOffset );
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_STOREFIELD_F ):
+				var_a = GetVariable( st->a );
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if( obj )
+				{
+					var_c = GetVariable( st->c );
+					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+					*var.floatPtr = *var_c.floatPtr;
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_STOREFIELD_V ):
+				var_a = GetVariable( st->a );
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if( obj )
+				{
+					var_c = GetVariable( st->c );
+					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+					*var.vectorPtr = *var_c.vectorPtr;
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_STOREFIELD_ENT ):
+				var_a = GetVariable( st->a );
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if( obj )
+				{
+					var_c = GetVariable( st->c );
+					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+					*var.entityNumberPtr = *var_c.entityNumberPtr;
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_STOREFIELD_BOOL ):
+				var_a = GetVariable( st->a );
+				obj = GetScriptObject( *var_a.entityNumberPtr );
+				if( obj )
+				{
+					var_c = GetVariable( st->c );
+					var.bytePtr = &obj->data[ st->b->value.ptrOffset ];
+					*var.intPtr = *var_c.intPtr;
+				}
+				SCRIPT_NEXT_STATEMENT;
+				
+			SCRIPT_OPCODE_CASE( OP_BREAK ):
+			SCRIPT_OPCODE_CASE( OP_CONTINUE ):
+			SCRIPT_OPCODE_DEFAULT:
 				Error( "Bad opcode %i", st->op );
-				break;
+				SCRIPT_NEXT_STATEMENT;
 		}
 	}
 	
+	if( opcodeStats )
+	{
+		executeTime += Sys_Microseconds() - startTime;
+	}
+	
+	if( profileResumeTime )
+	{
+		profileClock += Sys_Microseconds() - profileResumeTime;
+		profileResumeTime = 0;
+	}
+	
 	return threadDying;
 }
 
+#undef SCRIPT_FETCH_STATEMENT
+#undef SCRIPT_DISPATCH
+#undef SCRIPT_OPCODE_CASE
+#undef SCRIPT_OPCODE_DEFAULT
+#undef SCRIPT_NEXT_STATEMENT
+
+/*
+================
+idInterpreter::OpcodeStats_f
+
+Prints the opcodes executed since the last reset while g_scriptOpcodeStats was set
+================
+*/
+void idInterpreter::OpcodeStats_f( const idCmdArgs& args )
+{
+	int		i;
+	int64	total;
+	idList<int> sorted;
+	
+	if( !idStr::Icmp( args.Argv( 1 ), "reset" ) )
+	{
+		memset( opcodeCounts, 0, sizeof( opcodeCounts ) );
+		executeTime = 0;
+		return;
+	}
+	
+	total = 0;
+	for( i = 0; i < NUM_OPCODES; i++ )
+	{
+		if( opcodeCounts[ i ] )
+		{
+			sorted.Append( i );
+			total += opcodeCounts[ i ];
+		}
+	}
+	
+	// most executed first
+	for( i = 1; i < sorted.Num(); i++ )
+	{
+		int op = sorted[ i ];
+		int j = i;
+		while( ( j > 0 ) && ( opcodeCounts[ sorted[ j - 1 ] ] < opcodeCounts[ op ] ) )
+		{
+			sorted[ j ] = sorted[ j - 1 ];
+			j--;
+		}
+		sorted[ j ] = op;
+	}
+	
+	for( i = 0; i < sorted.Num(); i++ )
+	{
+		gameLocal.Printf( "%16s %12lld %6.2f%%\n", idCompiler::opcodes[ sorted[ i ] ].opname, opcodeCounts[ sorted[ i ] ], opcodeCounts[ sorted[ i ] ] * 100.0 / total );
+	}
+	gameLocal.Printf( "%lld statements executed in %lld usec\n", total, executeTime );
+	if( !g_scriptOpcodeStats.GetBool() )
+	{
+		gameLocal.Printf( "set g_scriptOpcodeStats 1 to count executed opcodes\n" );
+	}
+}
+
 // RB: moved from Script_Interpreter.h to avoid include problems with the script debugger
 /*
 ================
@@ -43,6 +43,13 @@ typedef struct prstack_s
 	int 				stackbase;
 } prstack_t;
 
+typedef struct profileFrame_s
+{
+	uint64				startTime;			// profile clock when the function was entered
+	uint64				childTime;			// time spent in called functions and events
+	bool				valid;				// entered while the script profiler was enabled
+} profileFrame_t;
+
 class idInterpreter
 {
 private:
@@ -64,6 +71,14 @@ private:
 	
 	idThread*			thread;
 	
+	static int64		opcodeCounts[ NUM_OPCODES ];
+	static int64		executeTime;
+	
+	// script profiler clock, only advances while Execute runs
+	profileFrame_t		profileStack[ MAX_STACK_DEPTH ];
+	uint64				profileClock;
+	uint64				profileResumeTime;
+	
 	void				PopParms( int numParms );
 	void				PushString( const char* string );
 	// RB begin
@@ -81,10 +96,13 @@ private:
 	idEntity*			GetEntity( int entnum ) const;
 	idScriptObject*		GetScriptObject( int entnum ) const;
 	void				NextInstruction( int position );
+	uint64				ProfileClock() const;
 	
 	void				LeaveFunction( idVarDef* returnDef );
+	void				RunNative();
 	void				CallEvent( const function_t* func, int argsize );
 	void				CallSysEvent( const function_t* func, int argsize );
+	void				ProfileEvent( const idEventDef* evdef, int depth, uint64 startTime );
 	
 public:
 	bool				doneProcessing;
@@ -126,6 +144,7 @@ public:
 	const function_t*	GetCurrentFunction() const;
 	idThread*			GetThread() const;
 	
+	static void			OpcodeStats_f( const idCmdArgs& args );
 };
 
 /*
@@ -296,4 +315,18 @@ ID_INLINE void idInterpreter::NextInstruction( int position )
 	instructionPointer = position - 1;
 }
 
+/*
+====================
+idInterpreter::ProfileClock
+====================
+*/
+ID_INLINE uint64 idInterpreter::ProfileClock() const
+{
+	if( profileResumeTime )
+	{
+		return profileClock + ( Sys_Microseconds() - profileResumeTime );
+	}
+	return profileClock;
+}
+
 #endif /* !__SCRIPT_INTERPRETER_H__ */
@@ -0,0 +1,574 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#pragma hdrstop
+#include "precompiled.h"
+
+
+#include "../Game_local.h"
+#include "Script_Native.h"
+
+/*
+===============================================================================
+
+	Script to C++ translator
+
+	Each opcode the translator handles has its C++ in the table below,
+	in which $a, $b and $c are replaced by the operands of the statement, $j
+	by a goto to the jump destination, or an SN_LOOP for backward jumps, and
+	$n by the index of the statement.
+	Locals are addressed through the stack frame (l) and globals through the
+	program's variables (g), float and vector immediates become literals.
+
+	The generated text doubles as the checksum input, so anything that
+	changes what a function does changes the checksum of its translation.
+
+===============================================================================
+*/
+
+typedef struct nativeOpcode_s
+{
+	int						op;
+	const char*				operands;		// types of a, b and c: f float, i int, v vector, j jump offset, - unused
+	int						result;			// operand written by the statement, -1 if none
+	const char*				code;
+} nativeOpcode_t;
+
+static const nativeOpcode_t nativeOpcodes[] =
+{
+	{ OP_UINC_F,			"f--",	0,	"$a++;" },
+	{ OP_UDEC_F,			"f--",	0,	"$a--;" },
+	{ OP_COMP_F,			"f-f",	2,	"$c = ~static_cast<int>( $a );" },
+	
+	{ OP_MUL_F,				"fff",	2,	"$c = $a * $b;" },
+	{ OP_MUL_V,				"vvf",	2,	"$c = $a * $b;" },
+	{ OP_MUL_FV,			"fvv",	2,	"$c = $a * $b;" },
+	{ OP_MUL_VF,			"vfv",	2,	"$c = $a * $b;" },
+	{ OP_DIV_F,				"fff",	2,	"if( $b == 0.0f )\n{\n\treturn $n;\n}\n$c = $a / $b;" },
+	{ OP_MOD_F,				"fff",	2,	"if( $b == 0.0f )\n{\n\treturn $n;\n}\n$c = static_cast<int>( $a ) % static_cast<int>( $b );" },
+	{ OP_ADD_F,				"fff",	2,	"$c = $a + $b;" },
+	{ OP_ADD_V,				"vvv",	2,	"$c = $a + $b;" },
+	{ OP_SUB_F,				"fff",	2,	"$c = $a - $b;" },
+	{ OP_SUB_V,				"vvv",	2,	"$c = $a - $b;" },
+	
+	{ OP_EQ_F,				"fff",	2,	"$c = ( $a == $b );" },
+	{ OP_EQ_V,				"vvf",	2,	"$c = ( $a == $b );" },
+	{ OP_EQ_E,				"iif",	2,	"$c = ( $a == $b );" },
+	{ OP_EQ_EO,				"iif",	2,	"$c = ( $a == $b );" },
+	{ OP_EQ_OE,				"iif",	2,	"$c = ( $a == $b );" },
+	{ OP_EQ_OO,				"iif",	2,	"$c = ( $a == $b );" },
+	{ OP_NE_F,				"fff",	2,	"$c = ( $a != $b );" },
+	{ OP_NE_V,				"vvf",	2,	"$c = ( $a != $b );" },
+	{ OP_NE_E,				"iif",	2,	"$c = ( $a != $b );" },
+	{ OP_NE_EO,				"iif",	2,	"$c = ( $a != $b );" },
+	{ OP_NE_OE,				"iif",	2,	"$c = ( $a != $b );" },
+	{ OP_NE_OO,				"iif",	2,	"$c = ( $a != $b );" },
+	{ OP_LE,				"fff",	2,	"$c = ( $a <= $b );" },
+	{ OP_GE,				"fff",	2,	"$c = ( $a >= $b );" },
+	{ OP_LT,				"fff",	2,	"$c = ( $a < $b );" },
+	{ OP_GT,				"fff",	2,	"$c = ( $a > $b );" },
+	
+	{ OP_STORE_F,			"ff-",	1,	"$b = $a;" },
+	{ OP_STORE_V,			"vv-",	1,	"$b = $a;" },
+	{ OP_STORE_ENT,			"ii-",	1,	"$b = $a;" },
+	{ OP_STORE_BOOL,		"ii-",	1,	"$b = $a;" },
+	{ OP_STORE_OBJ,			"ii-",	1,	"$b = $a;" },
+	{ OP_STORE_ENTOBJ,		"ii-",	1,	"$b = $a;" },
+	{ OP_STORE_FTOBOOL,		"fi-",	1,	"$b = ( $a != 0.0f ) ? 1 : 0;" },
+	{ OP_STORE_BOOLTOF,		"if-",	1,	"$b = static_cast<float>( $a );" },
+	
+	{ OP_UADD_F,			"ff-",	1,	"$b += $a;" },
+	{ OP_UADD_V,			"vv-",	1,	"$b += $a;" },
+	{ OP_USUB_F,			"ff-",	1,	"$b -= $a;" },
+	{ OP_USUB_V,			"vv-",	1,	"$b -= $a;" },
+	{ OP_UMUL_F,			"ff-",	1,	"$b *= $a;" },
+	{ OP_UMUL_V,			"fv-",	1,	"$b *= $a;" },
+	{ OP_UDIV_F,			"ff-",	1,	"if( $a == 0.0f )\n{\n\treturn $n;\n}\n$b = $b / $a;" },
+	{ OP_UDIV_V,			"fv-",	1,	"if( $a == 0.0f )\n{\n\treturn $n;\n}\n$b = $b / $a;" },
+	{ OP_UMOD_F,			"ff-",	1,	"if( $a == 0.0f )\n{\n\treturn $n;\n}\n$b = static_cast<int>( $b ) % static_cast<int>( $a );" },
+	{ OP_UOR_F,				"ff-",	1,	"$b = static_cast<int>( $b ) | static_cast<int>( $a );" },
+	{ OP_UAND_F,			"ff-",	1,	"$b = static_cast<int>( $b ) & static_cast<int>( $a );" },
+	
+	{ OP_NOT_BOOL,			"i-f",	2,	"$c = ( $a == 0 );" },
+	{ OP_NOT_F,				"f-f",	2,	"$c = ( $a == 0.0f );" },
+	{ OP_NOT_V,				"v-f",	2,	"$c = ( $a == vec3_zero );" },
+	{ OP_NEG_F,				"f-f",	2,	"$c = -$a;" },
+	{ OP_NEG_V,				"v-v",	2,	"$c = -$a;" },
+	{ OP_INT_F,				"f-f",	2,	"$c = static_cast<int>( $a );" },
+	
+	{ OP_IF,				"ij-",	-1,	"if( $a != 0 ) $j" },
+	{ OP_IFNOT,				"ij-",	-1,	"if( $a == 0 ) $j" },
+	{ OP_GOTO,				"j--",	-1,	"$j" },
+	
+	{ OP_AND,				"fff",	2,	"$c = ( $a != 0.0f ) && ( $b != 0.0f );" },
+	{ OP_AND_BOOLF,			"iff",	2,	"$c = ( $a != 0 ) && ( $b != 0.0f );" },
+	{ OP_AND_FBOOL,			"fif",	2,	"$c = ( $a != 0.0f ) && ( $b != 0 );" },
+	{ OP_AND_BOOLBOOL,		"iif",	2,	"$c = ( $a != 0 ) && ( $b != 0 );" },
+	{ OP_OR,				"fff",	2,	"$c = ( $a != 0.0f ) || ( $b != 0.0f );" },
+	{ OP_OR_BOOLF,			"iff",	2,	"$c = ( $a != 0 ) || ( $b != 0.0f );" },
+	{ OP_OR_FBOOL,			"fif",	2,	"$c = ( $a != 0.0f ) || ( $b != 0 );" },
+	{ OP_OR_BOOLBOOL,		"iif",	2,	"$c = ( $a != 0 ) || ( $b != 0 );" },
+	
+	{ OP_BITAND,			"fff",	2,	"$c = static_cast<int>( $a ) & static_cast<int>( $b );" },
+	{ OP_BITOR,				"fff",	2,	"$c = static_cast<int>( $a ) | static_cast<int>( $b );" },
+	
+	{ OP_IFNOT_LT,			"ffj",	-1,	"if( !( $a < $b ) ) $j" },
+	{ OP_IFNOT_LE,			"ffj",	-1,	"if( !( $a <= $b ) ) $j" },
+	{ OP_IFNOT_GT,			"ffj",	-1,	"if( !( $a > $b ) ) $j" },
+	{ OP_IFNOT_GE,			"ffj",	-1,	"if( !( $a >= $b ) ) $j" },
+	{ OP_IFNOT_EQ_F,		"ffj",	-1,	"if( !( $a == $b ) ) $j" },
+	{ OP_IFNOT_NE_F,		"ffj",	-1,	"if( !( $a != $b ) ) $j" },
+	{ OP_IFNOT_EQ_E,		"iij",	-1,	"if( !( $a == $b ) ) $j" },
+	{ OP_IFNOT_NE_E,		"iij",	-1,	"if( !( $a != $b ) ) $j" },
+	
+	{ -1,					NULL,	-1,	NULL }
+};
+
+/*
+================
+FindNativeOpcode
+================
+*/
+static const nativeOpcode_t* FindNativeOpcode( int op )
+{
+	static const nativeOpcode_t* table[ NUM_OPCODES ];
+	static bool initialized = false;
+	
+	if( !initialized )
+	{
+		memset( table, 0, sizeof( table ) );
+		for( int i = 0; nativeOpcodes[ i ].op != -1; i++ )
+		{
+			table[ nativeOpcodes[ i ].op ] = &nativeOpcodes[ i ];
+		}
+		initialized = true;
+	}
+	
+	if( ( op < 0 ) || ( op >= NUM_OPCODES ) )
+	{
+		return NULL;
+	}
+	return table[ op ];
+}
+
+/*
+================
+FloatLiteral
+
+Prints a float so that it reads back to exactly the same value
+================
+*/
+static bool FloatLiteral( float f, idStr& literal )
+{
+	char buffer[ 64 ];
+	
+	if( IEEE_FLT_IS_NAN( f ) || IEEE_FLT_IS_INF( f ) || IEEE_FLT_IS_DENORMAL( f ) )
+	{
+		return false;
+	}
+	
+	idStr::snPrintf( buffer, sizeof( buffer ), "%.9g", f );
+	literal = buffer;
+	if( ( strchr( buffer, '.' ) == NULL ) && ( strchr( buffer, 'e' ) == NULL ) )
+	{
+		literal += ".0";
+	}
+	literal += "f";
+	
+	if( f < 0.0f )
+	{
+		literal = "( " + literal + " )";
+	}
+	return true;
+}
+
+/*
+================
+NativeOperand
+
+Returns the C++ expression for a statement operand, false if the operand isn't a local or global variable
+================
+*/
+static bool NativeOperand( const idVarDef* def, char type, bool lvalue, const byte* variables, int numVariables, idStr& expr )
+{
+	const char*	accessor;
+	int			size;
+	idStr		x, y, z;
+	
+	switch( type )
+	{
+		case 'f':
+			accessor = "SN_FLOAT";
+			size = sizeof( float );
+			break;
+			
+		case 'i':
+			accessor = "SN_INT";
+			size = sizeof( int );
+			break;
+			
+		case 'v':
+			accessor = "SN_VEC";
+			size = sizeof( idVec3 );
+			break;
+			
+		default:
+			return false;
+	}
+	
+	if( def == NULL )
+	{
+		return false;
+	}
+	
+	if( def->initialized == idVarDef::stackVariable )
+	{
+		sprintf( expr, "%s( l, %d )", accessor, def->value.stackOffset );
+		return true;
+	}
+	
+	if( ( def->value.bytePtr < variables ) || ( def->value.bytePtr + size > variables + numVariables ) )
+	{
+		return false;
+	}
+	
+	// entity constants are assigned when the map spawns, so only immediates are safe to inline
+	if( !lvalue && ( def->initialized == idVarDef::initializedConstant ) && !idStr::Cmp( def->Name(), "<IMMEDIATE>" ) )
+	{
+		if( type == 'f' && FloatLiteral( *def->value.floatPtr, expr ) )
+		{
+			return true;
+		}
+		if( type == 'v' && FloatLiteral( def->value.vectorPtr->x, x ) && FloatLiteral( def->value.vectorPtr->y, y ) && FloatLiteral( def->value.vectorPtr->z, z ) )
+		{
+			sprintf( expr, "idVec3( %s, %s, %s )", x.c_str(), y.c_str(), z.c_str() );
+			return true;
+		}
+	}
+	
+	sprintf( expr, "%s( g, %d )", accessor, ( int )( def->value.bytePtr - variables ) );
+	return true;
+}
+
+/*
+================
+TranslateStatement
+
+Returns false if the statement has to be run by the interpreter, sets loop if it jumps backward
+================
+*/
+static bool TranslateStatement( const statement_t& st, int index, int numStatements, const byte* variables, int numVariables, idStr& code, bool& loop )
+{
+	const nativeOpcode_t* native = FindNativeOpcode( st.op );
+	if( native == NULL )
+	{
+		return false;
+	}
+	
+	const idVarDef* operands[ 3 ] = { st.a, st.b, st.c };
+	idStr expr[ 3 ];
+	idStr jump;
+	
+	for( int i = 0; i < 3; i++ )
+	{
+		const char type = native->operands[ i ];
+		if( type == '-' )
+		{
+			continue;
+		}
+		
+		if( type == 'j' )
+		{
+			if( operands[ i ] == NULL )
+			{
+				return false;
+			}
+			
+			const int target = index + operands[ i ]->value.jumpOffset;
+			if( ( target < 0 ) || ( target >= numStatements ) )
+			{
+				return false;
+			}
+			
+			// backward jumps count down the loop budget so the interpreter can still catch runaway loops
+			if( target <= index )
+			{
+				sprintf( jump, "SN_LOOP( %d, s%d );", index, target );
+				loop = true;
+			}
+			else
+			{
+				sprintf( jump, "goto s%d;", target );
+			}
+			continue;
+		}
+		
+		if( !NativeOperand( operands[ i ], type, ( i == native->result ), variables, numVariables, expr[ i ] ) )
+		{
+			return false;
+		}
+	}
+	
+	code.Clear();
+	for( const char* s = native->code; *s != '\0'; s++ )
+	{
+		if( s[ 0 ] != '$' )
+		{
+			code += s[ 0 ];
+			continue;
+		}
+		
+		s++;
+		switch( s[ 0 ] )
+		{
+			case 'a':
+				code += expr[ 0 ];
+				break;
+				
+			case 'b':
+				code += expr[ 1 ];
+				break;
+				
+			case 'c':
+				code += expr[ 2 ];
+				break;
+				
+			case 'j':
+				code += jump;
+				break;
+				
+			case 'n':
+				code += va( "%d", index );
+				break;
+		}
+	}
+	return true;
+}
+
+/*
+================
+idProgram::TranslateFunction
+
+Builds the body of the native version of a function.  Returns false if none of its statements could be translated.
+================
+*/
+bool idProgram::TranslateFunction( const function_t& func, idStr& body ) const
+{
+	idStr	code;
+	idStr	labels;
+	int		numTranslated;
+	bool	loop;
+	
+	body.Clear();
+	if( func.eventdef || ( func.numStatements <= 0 ) )
+	{
+		return false;
+	}
+	
+	numTranslated = 0;
+	loop = false;
+	labels = "\tswitch( statement )\n\t{\n";
+	for( int i = 0; i < func.numStatements; i++ )
+	{
+		const statement_t& st = statements[ func.firstStatement + i ];
+		
+		labels += va( "\t\tcase %d:\n\t\t\tgoto s%d;\n", i, i );
+		body += va( "s%d:\t// %s\n", i, idCompiler::opcodes[ st.op ].opname );
+		if( TranslateStatement( st, i, func.numStatements, variables, numVariables, code, loop ) )
+		{
+			code.Replace( "\n", "\n\t" );
+			body += "\t" + code + "\n";
+			numTranslated++;
+		}
+		else
+		{
+			body += va( "\treturn %d;\n", i );
+		}
+	}
+	labels += "\t}\n\treturn statement;\n";
+	
+	// falling off the end continues with whatever follows the function, same as in the interpreter
+	body = labels + body + va( "\treturn %d;\n", func.numStatements );
+	if( loop )
+	{
+		body = "\tint loops = SN_MAX_LOOPS;\n\t\n" + body;
+	}
+	
+	return ( numTranslated > 0 );
+}
+
+/*
+================
+idProgram::BindNativeFunctions
+
+Hooks the native functions up to the functions compiled since firstFunction
+================
+*/
+void idProgram::BindNativeFunctions( int firstFunction )
+{
+	idHashIndex	hash;
+	idStr		body;
+	int			numBound;
+	int			numStale;
+	
+	if( scriptNativeFunctions[ 0 ].name == NULL )
+	{
+		return;
+	}
+	
+	for( int i = 0; scriptNativeFunctions[ i ].name != NULL; i++ )
+	{
+		hash.Add( idStr::Hash( scriptNativeFunctions[ i ].name ), i );
+	}
+	
+	numBound = 0;
+	numStale = 0;
+	for( int i = firstFunction; i < functions.Num(); i++ )
+	{
+		function_t& func = functions[ i ];
+		func.native = NULL;
+		
+		const scriptNative_t* native = NULL;
+		for( int j = hash.First( idStr::Hash( func.Name() ) ); j != -1; j = hash.Next( j ) )
+		{
+			if( !idStr::Cmp( scriptNativeFunctions[ j ].name, func.Name() ) )
+			{
+				native = &scriptNativeFunctions[ j ];
+				break;
+			}
+		}
+		
+		if( native == NULL )
+		{
+			continue;
+		}
+		
+		if( TranslateFunction( func, body ) && ( CRC32_BlockChecksum( body.c_str(), body.Length() ) == native->checksum ) )
+		{
+			func.native = native->function;
+			numBound++;
+		}
+		else
+		{
+			numStale++;
+		}
+	}
+	
+	if( numBound || numStale )
+	{
+		gameLocal.Printf( "%d native script functions, %d out of date\n", numBound, numStale );
+	}
+}
+
+/*
+================
+idProgram::WriteNativeFunctions
+
+Writes the native versions of all functions to a C++ file that replaces script/Script_NativeFunctions.cpp.
+Returns the number of functions written or -1 if the file couldn't be opened.
+================
+*/
+int idProgram::WriteNativeFunctions( const char* fileName, bool profiledOnly ) const
+{
+	idStrList	names;
+	idList<unsigned int> checksums;
+	idStr		body;
+	
+	idFileLocal file( fileSystem->OpenFileWrite( fileName ) );
+	if( file == NULL )
+	{
+		return -1;
+	}
+	
+	file->Printf( "/*\n\tGenerated by scriptCompileNative from %d script functions, do not edit.\n*/\n\n", functions.Num() );
+	file->Printf( "#pragma hdrstop\n#include \"precompiled.h\"\n\n\n#include \"../Game_local.h\"\n#include \"Script_Native.h\"\n\n" );
+	
+	for( int i = 0; i < functions.Num(); i++ )
+	{
+		const function_t& func = functions[ i ];
+		if( profiledOnly && ( scriptProfiler.FindFunctionStats( func.Name() ) == NULL ) )
+		{
+			continue;
+		}
+		
+		if( !TranslateFunction( func, body ) )
+		{
+			continue;
+		}
+		
+		file->Printf( "/*\n================\n%s\n================\n*/\n", func.Name() );
+		file->Printf( "static int SN_Function%d( byte* l, byte* g, int statement )\n{\n", names.Num() );
+		file->Write( body.c_str(), body.Length() );
+		file->Printf( "}\n\n" );
+		
+		names.Append( func.Name() );
+		checksums.Append( CRC32_BlockChecksum( body.c_str(), body.Length() ) );
+	}
+	
+	file->Printf( "const scriptNative_t scriptNativeFunctions[] =\n{\n" );
+	for( int i = 0; i < names.Num(); i++ )
+	{
+		file->Printf( "\t{ \"%s\", 0x%08x, SN_Function%d },\n", names[ i ].c_str(), checksums[ i ], i );
+	}
+	file->Printf( "\t{ NULL, 0, NULL }\n};\n" );
+	
+	return names.Num();
+}
+
+/*
+================
+scriptCompileNative_f
+================
+*/
+CONSOLE_COMMAND( scriptCompileNative, "translates the loaded script functions to C++: [filename] [profiled]", 0 )
+{
+	idStr	fileName = "script/Script_NativeFunctions.cpp";
+	bool	profiledOnly = false;
+	
+	for( int i = 1; i < args.Argc(); i++ )
+	{
+		if( !idStr::Icmp( args.Argv( i ), "profiled" ) )
+		{
+			profiledOnly = true;
+		}
+		else
+		{
+			fileName = args.Argv( i );
+		}
+	}
+	
+	const int numWritten = gameLocal.program.WriteNativeFunctions( fileName, profiledOnly );
+	if( numWritten < 0 )
+	{
+		gameLocal.Warning( "couldn't write %s", fileName.c_str() );
+		return;
+	}
+	
+	gameLocal.Printf( "wrote %d native script functions to %s, copy it to neo/d3xp/script and rebuild the game\n", numWritten, fileName.c_str() );
+}
@@ -0,0 +1,80 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+
+#ifndef __SCRIPT_NATIVE_H__
+#define __SCRIPT_NATIVE_H__
+
+/*
+===============================================================================
+
+	Native script functions.
+
+	scriptCompileNative translates compiled script functions to C++ that is
+	built into the game library from Script_NativeFunctions.cpp.  A native
+	function runs the statements of a script function the translator could
+	turn into plain C++ (arithmetic, compares, stores and jumps) and returns
+	the index of the first statement it can't run, which is then executed by
+	the interpreter.  Calls, events, field access and string operations
+	always go through the interpreter, so threads can still wait.  Loops
+	run natively, but after SN_MAX_LOOPS backward jumps the loop is handed
+	back to the interpreter so runaway loops are still caught.
+
+	The native version runs when the function is entered, when a call
+	returns to it, after an event call and when its thread resumes.
+	Interpreter debugging and g_scriptOpcodeStats turn the native versions
+	off so they see every statement.
+
+	Every native function carries the CRC of the code it was translated
+	from.  When a program is compiled each function is translated again and
+	only bound to its native version if the CRCs match, so edited scripts
+	silently fall back to the interpreter.
+
+===============================================================================
+*/
+
+// accessors used by the generated code, the offsets are relative to the local stack frame or the global variables
+#define SN_FLOAT( base, offset )		( *( float* )( ( base ) + ( offset ) ) )
+#define SN_INT( base, offset )			( *( int* )( ( base ) + ( offset ) ) )
+#define SN_VEC( base, offset )			( *( idVec3* )( ( base ) + ( offset ) ) )
+
+// backward jump, returns the jump statement to the interpreter once the loop budget of the call is used up
+#define SN_MAX_LOOPS					10000
+#define SN_LOOP( statement, label )		do { if( --loops <= 0 ) { return ( statement ); } goto label; } while( 0 )
+
+typedef struct scriptNative_s
+{
+	const char*				name;			// global name of the script function
+	unsigned int			checksum;		// CRC of the translated code
+	scriptNativeFunction_t	function;
+} scriptNative_t;
+
+// terminated by an entry with a NULL name
+extern const scriptNative_t	scriptNativeFunctions[];
+
+#endif /* !__SCRIPT_NATIVE_H__ */
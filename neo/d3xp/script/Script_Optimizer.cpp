@@ -0,0 +1,658 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+
+#include "../Game_local.h"
+
+/*
+===============================================================================
+
+	Bytecode optimizer
+
+	Runs over the statements produced by a single CompileText call.  Every
+	function is optimized on its own, statements that are no longer needed are
+	flagged as removed, and the remaining code is then compacted with all jump
+	offsets relocated.  Statements compiled earlier are never touched, so
+	threads running older code are unaffected.
+
+	The peephole passes rely on the fact that the compiler only ever reads a
+	<RESULT> temporary later in the same expression it was written in.
+
+===============================================================================
+*/
+
+typedef struct optStatement_s
+{
+	int						target;			// local index of the jump destination, -1 if not a jump
+	int						numJumpsIn;
+	bool					removed;
+	bool					reachable;
+} optStatement_t;
+
+/*
+================
+IsResultDef
+================
+*/
+static bool IsResultDef( const idVarDef* def )
+{
+	return ( def != NULL ) && !strcmp( def->Name(), RESULT_STRING );
+}
+
+/*
+================
+JumpOperand
+
+Returns the operand holding the jump offset of a statement, or NULL if it isn't a jump
+================
+*/
+static idVarDef** JumpOperand( statement_t& st )
+{
+	switch( st.op )
+	{
+		case OP_GOTO:
+			return &st.a;
+			
+		case OP_IF:
+		case OP_IFNOT:
+			return &st.b;
+			
+		case OP_IFNOT_LT:
+		case OP_IFNOT_LE:
+		case OP_IFNOT_GT:
+		case OP_IFNOT_GE:
+		case OP_IFNOT_EQ_F:
+		case OP_IFNOT_NE_F:
+		case OP_IFNOT_EQ_E:
+		case OP_IFNOT_NE_E:
+			return &st.c;
+			
+		default:
+			return NULL;
+	}
+}
+
+/*
+================
+WritesResult
+
+Returns true if the opcode writes its c operand instead of reading it
+================
+*/
+static bool WritesResult( int op )
+{
+	if( ( op >= OP_IFNOT_LT ) && ( op <= OP_STOREFIELD_BOOL ) )
+	{
+		return false;
+	}
+	
+	return ( idCompiler::opcodes[ op ].type_c != &def_void ) && !idCompiler::opcodes[ op ].rightAssociative;
+}
+
+/*
+================
+FusedBranch
+
+Returns the superinstruction for a compare followed by an OP_IFNOT on its result, or -1
+================
+*/
+static int FusedBranch( int op )
+{
+	switch( op )
+	{
+		case OP_LT:
+			return OP_IFNOT_LT;
+		case OP_LE:
+			return OP_IFNOT_LE;
+		case OP_GT:
+			return OP_IFNOT_GT;
+		case OP_GE:
+			return OP_IFNOT_GE;
+		case OP_EQ_F:
+			return OP_IFNOT_EQ_F;
+		case OP_NE_F:
+			return OP_IFNOT_NE_F;
+		case OP_EQ_E:
+		case OP_EQ_EO:
+		case OP_EQ_OE:
+		case OP_EQ_OO:
+			return OP_IFNOT_EQ_E;
+		case OP_NE_E:
+		case OP_NE_EO:
+		case OP_NE_OE:
+		case OP_NE_OO:
+			return OP_IFNOT_NE_E;
+		default:
+			return -1;
+	}
+}
+
+/*
+================
+FusedFieldStore
+
+Returns the superinstruction for an OP_ADDRESS followed by a store through the pointer, or -1
+================
+*/
+static int FusedFieldStore( int op )
+{
+	switch( op )
+	{
+		case OP_STOREP_F:
+			return OP_STOREFIELD_F;
+		case OP_STOREP_V:
+			return OP_STOREFIELD_V;
+		case OP_STOREP_ENT:
+			return OP_STOREFIELD_ENT;
+		case OP_STOREP_BOOL:
+			return OP_STOREFIELD_BOOL;
+		default:
+			return -1;
+	}
+}
+
+/*
+================
+CanForwardResult
+
+Returns true if the opcode reads all of its operands before writing c, so c may
+alias a or b.  String ops build the result in place and are left alone.
+================
+*/
+static bool CanForwardResult( int op )
+{
+	switch( op )
+	{
+		case OP_ADD_F:
+		case OP_ADD_V:
+		case OP_SUB_F:
+		case OP_SUB_V:
+		case OP_MUL_F:
+		case OP_MUL_V:
+		case OP_MUL_FV:
+		case OP_MUL_VF:
+		case OP_DIV_F:
+		case OP_MOD_F:
+		case OP_BITAND:
+		case OP_BITOR:
+		case OP_GE:
+		case OP_LE:
+		case OP_GT:
+		case OP_LT:
+		case OP_AND:
+		case OP_AND_BOOLF:
+		case OP_AND_FBOOL:
+		case OP_AND_BOOLBOOL:
+		case OP_OR:
+		case OP_OR_BOOLF:
+		case OP_OR_FBOOL:
+		case OP_OR_BOOLBOOL:
+		case OP_NOT_BOOL:
+		case OP_NOT_F:
+		case OP_NOT_V:
+		case OP_NOT_ENT:
+		case OP_NEG_F:
+		case OP_NEG_V:
+		case OP_INT_F:
+		case OP_COMP_F:
+		case OP_EQ_F:
+		case OP_EQ_V:
+		case OP_EQ_E:
+		case OP_EQ_EO:
+		case OP_EQ_OE:
+		case OP_EQ_OO:
+		case OP_NE_F:
+		case OP_NE_V:
+		case OP_NE_E:
+		case OP_NE_EO:
+		case OP_NE_OE:
+		case OP_NE_OO:
+		case OP_INDIRECT_F:
+		case OP_INDIRECT_V:
+		case OP_INDIRECT_ENT:
+		case OP_INDIRECT_BOOL:
+			return true;
+			
+		default:
+			return false;
+	}
+}
+
+/*
+================
+IsStore
+================
+*/
+static bool IsStore( int op )
+{
+	return ( op == OP_STORE_F ) || ( op == OP_STORE_V ) || ( op == OP_STORE_ENT ) || ( op == OP_STORE_BOOL );
+}
+
+/*
+================
+SkipRemoved
+
+Returns the first statement at or after index that is still part of the code
+================
+*/
+static int SkipRemoved( const optStatement_t* info, int index, int end )
+{
+	while( ( index < end ) && info[ index ].removed )
+	{
+		index++;
+	}
+	return index;
+}
+
+/*
+================
+IsResultDead
+
+Returns true if the temporary isn't read again before it is overwritten or the function ends
+================
+*/
+static bool IsResultDead( const statement_t* code, const optStatement_t* info, int from, int end, const idVarDef* def )
+{
+	int i;
+	
+	for( i = from; i < end; i++ )
+	{
+		if( info[ i ].removed )
+		{
+			continue;
+		}
+		
+		const statement_t& st = code[ i ];
+		if( ( st.a == def ) || ( st.b == def ) )
+		{
+			return false;
+		}
+		if( st.c == def )
+		{
+			return WritesResult( st.op );
+		}
+	}
+	
+	return true;
+}
+
+/*
+================
+OptimizeFunction
+================
+*/
+static void OptimizeFunction( statement_t* code, optStatement_t* info, int first, int num, scriptOptimizeStats_t& stats )
+{
+	int					i;
+	int					j;
+	int					t;
+	int					hops;
+	int					end;
+	int					op;
+	bool				changed;
+	idList<int>			stack;
+	
+	end = first + num;
+	
+	// leave the function alone if the compiler produced a jump we don't understand
+	for( i = first; i < end; i++ )
+	{
+		if( ( info[ i ].target >= 0 ) && ( ( info[ i ].target < first ) || ( info[ i ].target >= end ) ) )
+		{
+			return;
+		}
+	}
+	
+	// fold conditional jumps on constants
+	for( i = first; i < end; i++ )
+	{
+		statement_t& st = code[ i ];
+		if( ( ( st.op != OP_IF ) && ( st.op != OP_IFNOT ) ) || ( st.a->initialized != idVarDef::initializedConstant ) || strcmp( st.a->Name(), "<IMMEDIATE>" ) )
+		{
+			continue;
+		}
+		
+		if( ( *st.a->value.intPtr != 0 ) == ( st.op == OP_IF ) )
+		{
+			st.op = OP_GOTO;
+			st.a = st.b;
+			st.b = NULL;
+		}
+		else
+		{
+			info[ i ].removed = true;
+			info[ i ].target = -1;
+		}
+		stats.numFoldedBranches++;
+	}
+	
+	// jump straight to the destination of gotos
+	for( i = first; i < end; i++ )
+	{
+		if( info[ i ].removed || ( info[ i ].target < 0 ) )
+		{
+			continue;
+		}
+		
+		t = SkipRemoved( info, info[ i ].target, end );
+		for( hops = 0; ( hops < 8 ) && ( t < end ) && ( code[ t ].op == OP_GOTO ) && ( info[ t ].target != t ); hops++ )
+		{
+			t = SkipRemoved( info, info[ t ].target, end );
+		}
+		
+		if( ( t < end ) && ( t != info[ i ].target ) )
+		{
+			info[ i ].target = t;
+			stats.numThreadedJumps++;
+		}
+	}
+	
+	// drop statements that can't be reached from the start of the function
+	stack.Append( first );
+	info[ first ].reachable = true;
+	while( stack.Num() )
+	{
+		i = stack[ stack.Num() - 1 ];
+		stack.RemoveIndex( stack.Num() - 1 );
+		
+		op = code[ i ].op;
+		if( !info[ i ].removed && ( info[ i ].target >= 0 ) )
+		{
+			t = info[ i ].target;
+			if( !info[ t ].reachable )
+			{
+				info[ t ].reachable = true;
+				stack.Append( t );
+			}
+			if( op == OP_GOTO )
+			{
+				continue;
+			}
+		}
+		else if( !info[ i ].removed && ( op == OP_RETURN ) )
+		{
+			continue;
+		}
+		
+		if( ( i + 1 < end ) && !info[ i + 1 ].reachable )
+		{
+			info[ i + 1 ].reachable = true;
+			stack.Append( i + 1 );
+		}
+	}
+	
+	for( i = first; i < end; i++ )
+	{
+		if( !info[ i ].reachable && !info[ i ].removed )
+		{
+			info[ i ].removed = true;
+			info[ i ].target = -1;
+			stats.numUnreachable++;
+		}
+	}
+	
+	for( i = first; i < end; i++ )
+	{
+		if( !info[ i ].removed && ( info[ i ].target >= 0 ) )
+		{
+			info[ i ].target = SkipRemoved( info, info[ i ].target, end );
+			info[ info[ i ].target ].numJumpsIn++;
+		}
+	}
+	
+	// fuse adjacent pairs where the second statement only consumes the result of the first
+	for( i = SkipRemoved( info, first, end ); i < end; i = SkipRemoved( info, i + 1, end ) )
+	{
+		j = SkipRemoved( info, i + 1, end );
+		if( ( j >= end ) || info[ j ].numJumpsIn )
+		{
+			continue;
+		}
+		
+		statement_t& st = code[ i ];
+		statement_t& next = code[ j ];
+		if( !IsResultDef( st.c ) || !WritesResult( st.op ) )
+		{
+			continue;
+		}
+		
+		if( ( next.op == OP_IFNOT ) && ( next.a == st.c ) && ( FusedBranch( st.op ) >= 0 ) && IsResultDead( code, info, j + 1, end, st.c ) )
+		{
+			// compare and branch
+			st.op = FusedBranch( st.op );
+			st.c = next.b;
+			info[ i ].target = info[ j ].target;
+			info[ j ].target = -1;
+			info[ j ].removed = true;
+			stats.numFusedBranches++;
+		}
+		else if( ( next.op == OP_IFNOT ) && ( next.a == st.c ) && ( st.op == OP_NOT_BOOL ) && IsResultDead( code, info, j + 1, end, st.c ) )
+		{
+			// "if ( !b )" is a jump when b is set
+			st.op = OP_IF;
+			st.b = next.b;
+			st.c = NULL;
+			info[ i ].target = info[ j ].target;
+			info[ j ].target = -1;
+			info[ j ].removed = true;
+			stats.numFusedBranches++;
+		}
+		else if( IsStore( next.op ) && ( next.a == st.c ) && CanForwardResult( st.op ) &&
+				 ( idCompiler::opcodes[ st.op ].type_c->Type() == idCompiler::opcodes[ next.op ].type_a->Type() ) &&
+				 IsResultDead( code, info, j + 1, end, st.c ) )
+		{
+			// write the result straight into the destination of the store
+			st.c = next.b;
+			info[ j ].removed = true;
+			stats.numForwardedStores++;
+		}
+		else if( ( st.op == OP_ADDRESS ) && ( next.b == st.c ) && ( next.a != st.c ) && ( FusedFieldStore( next.op ) >= 0 ) &&
+				 IsResultDead( code, info, j + 1, end, st.c ) )
+		{
+			// store into an object field without going through a pointer
+			st.op = FusedFieldStore( next.op );
+			st.c = next.a;
+			info[ j ].removed = true;
+			stats.numFusedStores++;
+		}
+	}
+	
+	// remove gotos that only jump to the next statement
+	do
+	{
+		changed = false;
+		for( i = first; i < end; i++ )
+		{
+			if( !info[ i ].removed && ( code[ i ].op == OP_GOTO ) && ( SkipRemoved( info, info[ i ].target, end ) == SkipRemoved( info, i + 1, end ) ) )
+			{
+				info[ i ].removed = true;
+				info[ i ].target = -1;
+				stats.numThreadedJumps++;
+				changed = true;
+			}
+		}
+	}
+	while( changed );
+}
+
+/*
+================
+idProgram::OptimizeStatements
+
+Optimizes all statements from firstStatement on.  Called once the compiler
+has successfully finished a batch of code.
+================
+*/
+void idProgram::OptimizeStatements( int firstStatement )
+{
+	int						i;
+	int						num;
+	int						numKept;
+	int						startTime;
+	statement_t*			code;
+	idVarDef*				def;
+	idVarDef**				jump;
+	idList<optStatement_t>	info;
+	idList<int>				remap;
+	idList<int>				targets;
+	idList<idVarDef*>		jumpDefs;
+	idHashIndex				jumpDefHash;
+	eval_t					eval;
+	
+	num = statements.Num() - firstStatement;
+	if( num <= 0 )
+	{
+		return;
+	}
+	
+	startTime = Sys_Microseconds();
+	
+	code = &statements[ firstStatement ];
+	
+	info.SetNum( num + 1 );
+	memset( info.Ptr(), 0, info.Allocated() );
+	
+	for( i = 0; i < num; i++ )
+	{
+		info[ i ].target = -1;
+		jump = JumpOperand( code[ i ] );
+		if( jump )
+		{
+			info[ i ].target = i + ( *jump )->value.jumpOffset;
+			if( ( info[ i ].target < 0 ) || ( info[ i ].target >= num ) )
+			{
+				gameLocal.Warning( "idProgram::OptimizeStatements: jump out of range in statement %d", firstStatement + i );
+				return;
+			}
+		}
+	}
+	
+	for( i = 0; i < functions.Num(); i++ )
+	{
+		function_t& func = functions[ i ];
+		if( func.eventdef || ( func.firstStatement < firstStatement ) || ( func.numStatements <= 0 ) )
+		{
+			continue;
+		}
+		OptimizeFunction( code, info.Ptr(), func.firstStatement - firstStatement, func.numStatements, optimizeStats );
+	}
+	
+	// removed statements map to the statement that follows them
+	remap.SetNum( num + 1 );
+	numKept = 0;
+	for( i = 0; i < num; i++ )
+	{
+		if( !info[ i ].removed )
+		{
+			remap[ i ] = numKept++;
+		}
+	}
+	remap[ num ] = numKept;
+	for( i = num - 1; i >= 0; i-- )
+	{
+		if( info[ i ].removed )
+		{
+			remap[ i ] = remap[ i + 1 ];
+		}
+	}
+	
+	targets.SetNum( numKept );
+	for( i = 0; i < num; i++ )
+	{
+		if( !info[ i ].removed )
+		{
+			code[ remap[ i ] ] = code[ i ];
+			targets[ remap[ i ] ] = ( info[ i ].target >= 0 ) ? remap[ info[ i ].target ] : -1;
+		}
+	}
+	
+	// jump offsets are shared immediates, so look them up rather than changing their value
+	for( def = GetDefList( "<IMMEDIATE>" ); def != NULL; def = def->Next() )
+	{
+		if( def->TypeDef() == &type_jumpoffset )
+		{
+			jumpDefHash.Add( def->value.jumpOffset, jumpDefs.Append( def ) );
+		}
+	}
+	
+	for( i = 0; i < numKept; i++ )
+	{
+		if( targets[ i ] < 0 )
+		{
+			continue;
+		}
+		
+		int offset = targets[ i ] - i;
+		
+		def = NULL;
+		for( int h = jumpDefHash.First( offset ); h != -1; h = jumpDefHash.Next( h ) )
+		{
+			if( jumpDefs[ h ]->value.jumpOffset == offset )
+			{
+				def = jumpDefs[ h ];
+				break;
+			}
+		}
+		
+		if( !def )
+		{
+			memset( &eval, 0, sizeof( eval ) );
+			eval._int = offset;
+			def = AllocDef( &type_jumpoffset, "<IMMEDIATE>", &def_namespace, true );
+			def->SetValue( eval, true );
+			jumpDefHash.Add( offset, jumpDefs.Append( def ) );
+		}
+		
+		def->numUsers++;
+		*JumpOperand( code[ i ] ) = def;
+	}
+	
+	for( i = 0; i < functions.Num(); i++ )
+	{
+		function_t& func = functions[ i ];
+		if( func.eventdef || ( func.firstStatement < firstStatement ) || ( func.numStatements <= 0 ) )
+		{
+			continue;
+		}
+		
+		int first = remap[ func.firstStatement - firstStatement ];
+		int end = remap[ func.firstStatement - firstStatement + func.numStatements ];
+		
+		func.firstStatement = firstStatement + first;
+		func.numStatements = end - first;
+	}
+	
+	statements.SetNum( firstStatement + numKept );
+	
+	optimizeStats.numStatements += num;
+	optimizeStats.numRemoved += num - numKept;
+	optimizeStats.optimizeTime += Sys_Microseconds() - startTime;
+}
@@ -0,0 +1,448 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+
+#include "../Game_local.h"
+#include "Script_Native.h"
+
+idCVar g_profileScript( "g_profileScript", "0", CVAR_GAME | CVAR_BOOL, "records script function, event and thread times, see profileScriptTop and profileScriptDump" );
+
+idScriptProfiler scriptProfiler;
+
+static const char* scriptProfileGroupNames[SCRIPTPROF_NUM_GROUPS] =
+{
+	"function",
+	"event",
+	"thread"
+};
+
+static const char* scriptProfileSortNames[SCRIPTPROF_NUM_SORTS] =
+{
+	"incl",
+	"excl",
+	"count"
+};
+
+/*
+================
+idScriptProfiler::idScriptProfiler
+================
+*/
+idScriptProfiler::idScriptProfiler()
+{
+	enabled = false;
+	numFrames = 0;
+	benchmarkFrames = 0;
+	benchmarkNative = false;
+	benchmarkRestore = false;
+	benchmarkNumFrames[0] = benchmarkNumFrames[1] = 0;
+	benchmarkTime[0] = benchmarkTime[1] = 0;
+}
+
+/*
+================
+idScriptProfiler::BeginFrame
+================
+*/
+void idScriptProfiler::BeginFrame()
+{
+	enabled = g_profileScript.GetBool();
+	if( enabled )
+	{
+		numFrames++;
+	}
+	
+	if( benchmarkFrames > 0 )
+	{
+		benchmarkFrames--;
+		if( benchmarkFrames == 0 )
+		{
+			FinishNativeBenchmark();
+		}
+		else
+		{
+			// alternate every frame so both modes see the same game situations
+			benchmarkNative = ( benchmarkFrames & 1 ) != 0;
+			g_scriptNative.SetBool( benchmarkNative );
+			benchmarkNumFrames[benchmarkNative]++;
+		}
+	}
+}
+
+/*
+================
+idScriptProfiler::StartNativeBenchmark
+
+Runs script threads interpreted and native on alternate frames and compares their times
+================
+*/
+void idScriptProfiler::StartNativeBenchmark( int numFrames )
+{
+	if( benchmarkFrames > 0 )
+	{
+		gameLocal.Printf( "native script benchmark already running\n" );
+		return;
+	}
+	
+	if( scriptNativeFunctions[0].name == NULL )
+	{
+		gameLocal.Warning( "no native script functions in this build, see scriptCompileNative" );
+	}
+	
+	benchmarkRestore = g_scriptNative.GetBool();
+	benchmarkNumFrames[0] = benchmarkNumFrames[1] = 0;
+	benchmarkTime[0] = benchmarkTime[1] = 0;
+	
+	// the last BeginFrame only prints the results
+	benchmarkFrames = numFrames * 2 + 1;
+	
+	gameLocal.Printf( "benchmarking native scripts over %d frames\n", numFrames * 2 );
+}
+
+/*
+================
+idScriptProfiler::FinishNativeBenchmark
+================
+*/
+void idScriptProfiler::FinishNativeBenchmark()
+{
+	g_scriptNative.SetBool( benchmarkRestore );
+	
+	const float interpreted = benchmarkTime[0] * 0.001f / Max( 1, benchmarkNumFrames[0] );
+	const float native = benchmarkTime[1] * 0.001f / Max( 1, benchmarkNumFrames[1] );
+	
+	gameLocal.Printf( "script threads over %d frames on %s:\n", benchmarkNumFrames[0] + benchmarkNumFrames[1], gameLocal.GetMapName() );
+	gameLocal.Printf( "   interpreted: %7.3f ms per frame\n", interpreted );
+	gameLocal.Printf( "        native: %7.3f ms per frame\n", native );
+	if( native > 0.0f )
+	{
+		gameLocal.Printf( "       speedup: %7.2fx\n", interpreted / native );
+	}
+}
+
+/*
+================
+idScriptProfiler::FindStats
+================
+*/
+scriptProfileStats_t& idScriptProfiler::FindStats( scriptProfileGroup_t group, const char* name )
+{
+	idList<scriptProfileStats_t>& list = stats[group];
+	const int hash = idStr::Hash( name );
+	for( int i = statsHash[group].First( hash ); i != -1; i = statsHash[group].Next( i ) )
+	{
+		if( list[i].name == name )
+		{
+			return list[i];
+		}
+	}
+	
+	scriptProfileStats_t& s = list.Alloc();
+	s.name = name;
+	s.count = 0;
+	s.inclusiveTime = 0;
+	s.exclusiveTime = 0;
+	s.maxTime = 0;
+	statsHash[group].Add( hash, list.Num() - 1 );
+	return s;
+}
+
+/*
+================
+idScriptProfiler::AddFunction
+================
+*/
+void idScriptProfiler::AddFunction( const function_t* func, uint64 inclusiveTime, uint64 exclusiveTime )
+{
+	scriptProfileStats_t& s = FindStats( SCRIPTPROF_GROUP_FUNCTION, func->Name() );
+	s.count++;
+	s.inclusiveTime += inclusiveTime;
+	s.exclusiveTime += exclusiveTime;
+	s.maxTime = Max( s.maxTime, inclusiveTime );
+}
+
+/*
+================
+idScriptProfiler::AddEvent
+================
+*/
+void idScriptProfiler::AddEvent( const idEventDef* evdef, uint64 time )
+{
+	scriptProfileStats_t& s = FindStats( SCRIPTPROF_GROUP_EVENT, evdef->GetName() );
+	s.count++;
+	s.inclusiveTime += time;
+	s.exclusiveTime += time;
+	s.maxTime = Max( s.maxTime, time );
+}
+
+/*
+================
+idScriptProfiler::AddThread
+================
+*/
+void idScriptProfiler::AddThread( const char* name, uint64 time )
+{
+	if( benchmarkFrames > 0 )
+	{
+		benchmarkTime[benchmarkNative] += time;
+	}
+	
+	if( !enabled )
+	{
+		return;
+	}
+	
+	scriptProfileStats_t& s = FindStats( SCRIPTPROF_GROUP_THREAD, name );
+	s.count++;
+	s.inclusiveTime += time;
+	s.exclusiveTime += time;
+	s.maxTime = Max( s.maxTime, time );
+}
+
+/*
+================
+idScriptProfiler::FindFunctionStats
+
+Returns NULL if the function hasn't been called since the last reset
+================
+*/
+const scriptProfileStats_t* idScriptProfiler::FindFunctionStats( const char* name ) const
+{
+	const idList<scriptProfileStats_t>& list = stats[SCRIPTPROF_GROUP_FUNCTION];
+	for( int i = statsHash[SCRIPTPROF_GROUP_FUNCTION].First( idStr::Hash( name ) ); i != -1; i = statsHash[SCRIPTPROF_GROUP_FUNCTION].Next( i ) )
+	{
+		if( list[i].name == name )
+		{
+			return &list[i];
+		}
+	}
+	return NULL;
+}
+
+/*
+================
+idScriptProfiler::Reset
+================
+*/
+void idScriptProfiler::Reset()
+{
+	for( int i = 0; i < SCRIPTPROF_NUM_GROUPS; i++ )
+	{
+		stats[i].Clear();
+		statsHash[i].Clear();
+	}
+	numFrames = 0;
+}
+
+/*
+================
+idScriptProfiler::SortStats
+================
+*/
+void idScriptProfiler::SortStats( scriptProfileGroup_t group, scriptProfileSort_t sort, idList<int>& order ) const
+{
+	const idList<scriptProfileStats_t>& list = stats[group];
+	
+	order.SetNum( list.Num() );
+	for( int i = 0; i < list.Num(); i++ )
+	{
+		order[i] = i;
+	}
+	
+	for( int i = 1; i < order.Num(); i++ )
+	{
+		int index = order[i];
+		int j = i - 1;
+		for( ; j >= 0; j-- )
+		{
+			const scriptProfileStats_t& a = list[order[j]];
+			const scriptProfileStats_t& b = list[index];
+			bool less;
+			switch( sort )
+			{
+				case SCRIPTPROF_SORT_EXCLUSIVE:
+					less = a.exclusiveTime < b.exclusiveTime;
+					break;
+				case SCRIPTPROF_SORT_COUNT:
+					less = a.count < b.count;
+					break;
+				default:
+					less = a.inclusiveTime < b.inclusiveTime;
+					break;
+			}
+			if( !less )
+			{
+				break;
+			}
+			order[j + 1] = order[j];
+		}
+		order[j + 1] = index;
+	}
+}
+
+/*
+================
+idScriptProfiler::PrintTop
+================
+*/
+void idScriptProfiler::PrintTop( scriptProfileGroup_t group, scriptProfileSort_t sort, int num ) const
+{
+	const idList<scriptProfileStats_t>& list = stats[group];
+	
+	if( numFrames == 0 )
+	{
+		gameLocal.Printf( "no frames profiled, set g_profileScript 1\n" );
+		return;
+	}
+	
+	idList<int> order;
+	SortStats( group, sort, order );
+	
+	const float scale = 0.001f / numFrames;
+	gameLocal.Printf( "top %d %ss by %s over %d frames (ms per frame, max single call in brackets):\n", num, scriptProfileGroupNames[group], scriptProfileSortNames[sort], numFrames );
+	gameLocal.Printf( "%-48s %10s %10s %10s %10s\n", scriptProfileGroupNames[group], "calls", "incl", "excl", "max" );
+	for( int i = 0; i < order.Num() && i < num; i++ )
+	{
+		const scriptProfileStats_t& s = list[order[i]];
+		gameLocal.Printf( "%-48s %10.1f %10.3f %10.3f (%7.2f)\n", s.name.c_str(), ( float )s.count / numFrames, s.inclusiveTime * scale, s.exclusiveTime * scale, s.maxTime * 0.001f );
+	}
+}
+
+/*
+================
+idScriptProfiler::WriteDump
+
+  Writes all groups as tab separated tables, times are in microseconds.
+================
+*/
+bool idScriptProfiler::WriteDump( const char* fileName ) const
+{
+	idFileLocal file( fileSystem->OpenFileWrite( fileName ) );
+	if( file == NULL )
+	{
+		gameLocal.Warning( "couldn't write %s", fileName );
+		return false;
+	}
+	
+	file->Printf( "script profile over %d frames, times in usec\n", numFrames );
+	for( int group = 0; group < SCRIPTPROF_NUM_GROUPS; group++ )
+	{
+		const idList<scriptProfileStats_t>& list = stats[group];
+		idList<int> order;
+		SortStats( ( scriptProfileGroup_t )group, SCRIPTPROF_SORT_INCLUSIVE, order );
+		
+		file->Printf( "\n%s\tcalls\tinclusive\texclusive\tmax\n", scriptProfileGroupNames[group] );
+		for( int i = 0; i < order.Num(); i++ )
+		{
+			const scriptProfileStats_t& s = list[order[i]];
+			file->Printf( "%s\t%d\t%lld\t%lld\t%lld\n", s.name.c_str(), s.count, ( long long )s.inclusiveTime, ( long long )s.exclusiveTime, ( long long )s.maxTime );
+		}
+	}
+	
+	return true;
+}
+
+/*
+================
+profileScriptTop_f
+================
+*/
+CONSOLE_COMMAND( profileScriptTop, "lists the most expensive script functions, events or threads: [function|event|thread] [incl|excl|count] [count]", 0 )
+{
+	scriptProfileGroup_t group = SCRIPTPROF_GROUP_FUNCTION;
+	scriptProfileSort_t sort = SCRIPTPROF_SORT_EXCLUSIVE;
+	int num = 20;
+	
+	for( int i = 1; i < args.Argc(); i++ )
+	{
+		const char* arg = args.Argv( i );
+		bool found = false;
+		for( int j = 0; j < SCRIPTPROF_NUM_GROUPS; j++ )
+		{
+			if( idStr::Icmp( arg, scriptProfileGroupNames[j] ) == 0 )
+			{
+				group = ( scriptProfileGroup_t )j;
+				found = true;
+			}
+		}
+		for( int j = 0; j < SCRIPTPROF_NUM_SORTS; j++ )
+		{
+			if( idStr::Icmp( arg, scriptProfileSortNames[j] ) == 0 )
+			{
+				sort = ( scriptProfileSort_t )j;
+				found = true;
+			}
+		}
+		if( !found )
+		{
+			num = Max( 1, atoi( arg ) );
+		}
+	}
+	
+	scriptProfiler.PrintTop( group, sort, num );
+}
+
+/*
+================
+profileScriptReset_f
+================
+*/
+CONSOLE_COMMAND( profileScriptReset, "clears the script profile", 0 )
+{
+	scriptProfiler.Reset();
+}
+
+/*
+================
+profileScriptDump_f
+================
+*/
+CONSOLE_COMMAND( profileScriptDump, "writes the complete script profile to a file: [filename]", 0 )
+{
+	idStr fileName = ( args.Argc() > 1 ) ? args.Argv( 1 ) : "scriptprofile.txt";
+	fileName.DefaultFileExtension( ".txt" );
+	
+	if( scriptProfiler.WriteDump( fileName ) )
+	{
+		gameLocal.Printf( "wrote script profile to %s\n", fileName.c_str() );
+	}
+}
+
+/*
+================
+scriptNativeBenchmark_f
+================
+*/
+CONSOLE_COMMAND( scriptNativeBenchmark, "compares script thread times with and without native script functions, run it on a map with many AI: [frames]", 0 )
+{
+	const int numFrames = ( args.Argc() > 1 ) ? Max( 1, atoi( args.Argv( 1 ) ) ) : 600;
+	scriptProfiler.StartNativeBenchmark( numFrames );
+}
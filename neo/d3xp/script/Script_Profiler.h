@@ -0,0 +1,122 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#ifndef __SCRIPT_PROFILER_H__
+#define __SCRIPT_PROFILER_H__
+
+/*
+===============================================================================
+
+	Script profiler.
+
+	Records call counts and times of script functions, of the native events
+	scripts call and of every script thread.  Function times are kept
+	inclusive and exclusive, where exclusive time leaves out both the script
+	functions and the events the function called.  Time a thread spends
+	waiting doesn't count towards the functions on its call stack.
+
+	The native benchmark times script threads with and without the native
+	script functions on alternate frames.
+
+===============================================================================
+*/
+
+enum scriptProfileGroup_t
+{
+	SCRIPTPROF_GROUP_FUNCTION,
+	SCRIPTPROF_GROUP_EVENT,
+	SCRIPTPROF_GROUP_THREAD,
+	SCRIPTPROF_NUM_GROUPS
+};
+
+enum scriptProfileSort_t
+{
+	SCRIPTPROF_SORT_INCLUSIVE,
+	SCRIPTPROF_SORT_EXCLUSIVE,
+	SCRIPTPROF_SORT_COUNT,
+	SCRIPTPROF_NUM_SORTS
+};
+
+typedef struct scriptProfileStats_s
+{
+	idStr					name;
+	int						count;				// number of calls
+	uint64					inclusiveTime;
+	uint64					exclusiveTime;
+	uint64					maxTime;			// longest single call, inclusive
+} scriptProfileStats_t;
+
+class idScriptProfiler
+{
+public:
+							idScriptProfiler();
+	
+	bool					IsEnabled() const
+	{
+		return enabled;
+	}
+	
+	bool					IsTimingThreads() const
+	{
+		return enabled || ( benchmarkFrames > 0 );
+	}
+	
+	void					BeginFrame();
+	void					StartNativeBenchmark( int numFrames );
+	
+	void					AddFunction( const function_t* func, uint64 inclusiveTime, uint64 exclusiveTime );
+	void					AddEvent( const idEventDef* evdef, uint64 time );
+	void					AddThread( const char* name, uint64 time );
+	
+	const scriptProfileStats_t* 	FindFunctionStats( const char* name ) const;
+	
+	void					Reset();
+	void					PrintTop( scriptProfileGroup_t group, scriptProfileSort_t sort, int num ) const;
+	bool					WriteDump( const char* fileName ) const;
+	
+private:
+	bool					enabled;
+	int						numFrames;			// number of frames profiled since the last reset
+	
+	int						benchmarkFrames;	// frames left in the native benchmark
+	bool					benchmarkNative;	// native functions are used this frame
+	bool					benchmarkRestore;	// value of g_scriptNative before the benchmark
+	int						benchmarkNumFrames[2];
+	uint64					benchmarkTime[2];
+	
+	idList<scriptProfileStats_t>	stats[SCRIPTPROF_NUM_GROUPS];
+	idHashIndex				statsHash[SCRIPTPROF_NUM_GROUPS];
+	
+	scriptProfileStats_t& 	FindStats( scriptProfileGroup_t group, const char* name );
+	void					SortStats( scriptProfileGroup_t group, scriptProfileSort_t sort, idList<int>& order ) const;
+	void					FinishNativeBenchmark();
+};
+
+extern idScriptProfiler		scriptProfiler;
+
+#endif /* !__SCRIPT_PROFILER_H__ */
@@ -130,6 +130,7 @@ void function_t::Clear()
 	parmTotal		= 0;
 	locals			= 0;
 	filenum			= 0;
+	native			= NULL;
 	name.Clear();
 	parmSize.Clear();
 }
@@ -2119,6 +2120,13 @@ void idProgram::CompileStats()
 	gameLocal.Printf( " Static data: %d bytes\n", sizeof( idProgram ) );
 	gameLocal.Printf( "   Allocated: %d bytes\n", memallocated );
 	gameLocal.Printf( " Thread size: %d bytes\n\n", sizeof( idThread ) );
+	
+	if( optimizeStats.numStatements )
+	{
+		gameLocal.Printf( "Optimizer: %d of %d statements removed in %d usec\n", optimizeStats.numRemoved, optimizeStats.numStatements, optimizeStats.optimizeTime );
+		gameLocal.Printf( "   %d folded branches, %d threaded jumps, %d unreachable\n", optimizeStats.numFoldedBranches, optimizeStats.numThreadedJumps, optimizeStats.numUnreachable );
+		gameLocal.Printf( "   %d forwarded stores, %d fused branches, %d fused field stores\n\n", optimizeStats.numForwardedStores, optimizeStats.numFusedBranches, optimizeStats.numFusedStores );
+	}
 }
 
 /*
@@ -2132,11 +2140,16 @@ bool idProgram::CompileText( const char* source, const char* text, bool console
 	int			i;
 	idVarDef*	def;
 	idStr		ospath;
+	int			firstStatement;
+	int			firstFunction;
 	
 	// use a full os path for GetFilenum since it calls OSPathToRelativePath to convert filenames from the parser
 	ospath = fileSystem->RelativePathToOSPath( source );
 	filenum = GetFilenum( ospath );
 	
+	firstStatement = statements.Num();
+	firstFunction = functions.Num();
+	
 #if defined(USE_EXCEPTIONS)
 	try
 #endif
@@ -2159,6 +2172,13 @@ bool idProgram::CompileText( const char* source, const char* text, bool console
 				}
 			}
 		}
+		
+		if( g_scriptOptimize.GetBool() )
+		{
+			OptimizeStatements( firstStatement );
+		}
+		
+		BindNativeFunctions( firstFunction );
 	}
 #if defined(USE_EXCEPTIONS)
 	catch( idCompileError& err )
@@ -2281,6 +2301,8 @@ void idProgram::FreeData()
 	top_defs		= 0;
 	top_files		= 0;
 	
+	memset( &optimizeStats, 0, sizeof( optimizeStats ) );
+	
 	filename = "";
 }
 
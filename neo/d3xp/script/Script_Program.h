@@ -52,6 +52,10 @@ typedef enum
 	ev_error = -1, ev_void, ev_scriptevent, ev_namespace, ev_string, ev_float, ev_vector, ev_entity, ev_field, ev_function, ev_virtualfunction, ev_pointer, ev_object, ev_jumpoffset, ev_argsize, ev_boolean
 } etype_t;
 
+// runs the translated statements of a script function starting at the given statement, relative to the
+// start of the function, and returns the statement the interpreter continues with.  see Script_Native.h
+typedef int ( *scriptNativeFunction_t )( byte* locals, byte* globals, int statement );
+
 class function_t
 {
 public:
@@ -74,6 +78,7 @@ public:
 	int 				locals; 			// total ints of parms + locals
 	int					filenum; 			// source file defined in
 	idList<int, TAG_SCRIPT>			parmSize;
+	scriptNativeFunction_t	native;				// translated version of the function, NULL if there is none
 };
 
 typedef union eval_s
@@ -471,6 +476,19 @@ typedef struct statement_s
 	unsigned short	file;
 } statement_t;
 
+typedef struct scriptOptimizeStats_s
+{
+	int							numStatements;			// statements handed to the optimizer
+	int							numRemoved;				// statements dropped from the final code
+	int							numFoldedBranches;		// conditional jumps on constants
+	int							numThreadedJumps;		// jumps retargeted past gotos
+	int							numUnreachable;			// statements no path reaches
+	int							numForwardedStores;		// results written straight into the store destination
+	int							numFusedBranches;		// compare + ifnot pairs
+	int							numFusedStores;			// address + storep pairs
+	int							optimizeTime;			// microseconds
+} scriptOptimizeStats_t;
+
 /***********************************************************************
 
 idProgram
@@ -508,7 +526,12 @@ private:
 	int											top_defs;
 	int											top_files;
 	
+	scriptOptimizeStats_t						optimizeStats;
+	
 	void										CompileStats();
+	void										OptimizeStatements( int firstStatement );
+	bool										TranslateFunction( const function_t& func, idStr& body ) const;
+	void										BindNativeFunctions( int firstFunction );
 	
 public:
 	idVarDef*									returnDef;
@@ -532,6 +555,7 @@ public:
 	void										FinishCompilation();
 	void										DisassembleStatement( idFile* file, int instructionPointer ) const;
 	void										Disassemble() const;
+	int											WriteNativeFunctions( const char* fileName, bool profiledOnly ) const;
 	void										FreeData();
 	
 	const char*									GetFilename( int num );
@@ -573,6 +597,16 @@ public:
 		return statements.Num();
 	}
 	
+	byte*										GetVariables()
+	{
+		return variables;
+	}
+	
+	const scriptOptimizeStats_t&					GetOptimizeStats() const
+	{
+		return optimizeStats;
+	}
+	
 	int 										GetReturnedInteger();
 	
 	void										ReturnFloat( float value );
@@ -727,18 +727,26 @@ bool idThread::Execute()
 {
 	idThread*	oldThread;
 	bool		done;
+	uint64		startTime;
 	
 	if( manualControl && ( waitingUntil > gameLocal.time ) )
 	{
 		return false;
 	}
 	
+	idScopedThinkProfile profile( THINKPROF_SCRIPT, NULL );
+	
 	oldThread = currentThread;
 	currentThread = this;
 	
 	lastExecuteTime = gameLocal.time;
 	ClearWaitFor();
+	startTime = scriptProfiler.IsTimingThreads() ? Sys_Microseconds() : 0;
 	done = interpreter.Execute();
+	if( startTime != 0 )
+	{
+		scriptProfiler.AddThread( threadName, Sys_Microseconds() - startTime );
+	}
 	if( done )
 	{
 		End();
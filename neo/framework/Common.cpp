@@ -1917,3 +1917,11 @@ CONSOLE_COMMAND( testSIMD, "test SIMD code", NULL )
 {
 	idSIMD::Test_f( args );
 }
+CONSOLE_COMMAND( testMatX, "test and time the SIMD idMatX kernels", NULL )
+{
+	idMatX::Test_f( args );
+}
+CONSOLE_COMMAND( testLCP, "compare the sparse and the dense LCP solvers", NULL )
+{
+	idLCP::Test_f( args );
+}
@@ -639,6 +639,8 @@ void idCommonLocal::ExecuteMapChange()
 		int indexMemUsedKB = vertexCache.staticData.indexMemUsed.GetValue() / 1024;
 		idLib::Printf( "Used %dkb of static vertex memory (%d%%)\n", vertexMemUsedKB, vertexMemUsedKB * 100 / ( STATIC_VERTEX_MEMORY / 1024 ) );
 		idLib::Printf( "Used %dkb of static index memory (%d%%)\n", indexMemUsedKB, indexMemUsedKB * 100 / ( STATIC_INDEX_MEMORY / 1024 ) );
+		idLib::Printf( "Saved %dkb of static vertex memory and %dkb of static index memory by sharing %d identical blocks\n",
+					   vertexCache.sharedStaticVertexBytes / 1024, vertexCache.sharedStaticIndexBytes / 1024, vertexCache.numSharedStaticBlocks );
 	}
 	
 	if( common->JapaneseCensorship() )
@@ -3242,6 +3242,243 @@ bool idLCP_Symmetric::Solve( const idMatX& o_m, idVecX& o_x, const idVecX& o_b,
 	return true;
 }
 
+/*
+================================================================================================
+
+	idLCP_Sparse
+
+================================================================================================
+*/
+
+const float LCP_SPARSE_DELTA_EPSILON	= 1e-6f;
+
+/*
+================================================
+idLCP_Sparse
+
+Projected Gauss-Seidel solver that only visits the non-zero entries of the
+matrix. Constraint matrices of articulated figures are mostly zero because
+constraints only couple the few bodies they share, so a sweep is linear in
+the number of non-zero entries instead of the cubic cost of a factorization.
+When warm starting, the 'x' passed to Solve (usually the forces of the
+previous frame) is used as the initial guess so only a few sweeps are
+needed when the figure changes little between frames.
+================================================
+*/
+class idLCP_Sparse : public idLCP
+{
+public:
+					idLCP_Sparse();
+					
+	virtual bool	Solve( const idMatX& o_m, idVecX& o_x, const idVecX& o_b, const idVecX& o_lo, const idVecX& o_hi, const int* o_boxIndex );
+	virtual void	SetSparsity( int numRows, const int* rowStart, const int* columns );
+	
+private:
+	int				numSparsityRows;	// number of rows of the pattern set with SetSparsity, -1 if not set
+	idList<int>		rowStart;			// first non-zero entry of each row
+	idList<int>		columns;			// column of each non-zero off-diagonal entry
+	idList<float>	values;				// value of each non-zero off-diagonal entry
+	idList<float>	invDiagonal;		// reciprocal of the diagonal
+	
+	bool			GatherMatrix( const idMatX& o_m );
+};
+
+/*
+========================
+idLCP_Sparse::idLCP_Sparse
+========================
+*/
+idLCP_Sparse::idLCP_Sparse()
+{
+	numSparsityRows = -1;
+}
+
+/*
+========================
+idLCP_Sparse::SetSparsity
+========================
+*/
+void idLCP_Sparse::SetSparsity( int numRows, const int* rowStart, const int* columns )
+{
+	if( rowStart == NULL )
+	{
+		numSparsityRows = -1;
+		return;
+	}
+	
+	numSparsityRows = numRows;
+	this->rowStart.SetNum( numRows + 1 );
+	memcpy( this->rowStart.Ptr(), rowStart, ( numRows + 1 ) * sizeof( int ) );
+	this->columns.SetNum( rowStart[numRows] );
+	memcpy( this->columns.Ptr(), columns, rowStart[numRows] * sizeof( int ) );
+}
+
+/*
+========================
+idLCP_Sparse::GatherMatrix
+
+Copies the diagonal and the non-zero off-diagonal entries out of the dense matrix.
+Only the entries in the sparsity pattern are visited when one is set, otherwise
+the pattern is gathered from the whole matrix.
+========================
+*/
+bool idLCP_Sparse::GatherMatrix( const idMatX& o_m )
+{
+	const int n = o_m.GetNumRows();
+	
+	invDiagonal.SetNum( n );
+	for( int i = 0; i < n; i++ )
+	{
+		const float d = o_m[i][i];
+		if( d <= 0.0f )
+		{
+			if( lcp_showFailures.GetBool() )
+			{
+				idLib::Printf( "idLCP_Sparse::Solve: non-positive diagonal %.4f at row %d\n", d, i );
+			}
+			return false;
+		}
+		invDiagonal[i] = 1.0f / d;
+	}
+	
+	if( numSparsityRows == n )
+	{
+		values.SetNum( columns.Num() );
+		for( int i = 0; i < n; i++ )
+		{
+			const float* row = o_m[i];
+			for( int k = rowStart[i]; k < rowStart[i + 1]; k++ )
+			{
+				values[k] = row[columns[k]];
+			}
+		}
+		return true;
+	}
+	
+	// the lists keep their memory between solves
+	rowStart.SetNum( n + 1 );
+	columns.SetNum( 0 );
+	values.SetNum( 0 );
+	for( int i = 0; i < n; i++ )
+	{
+		const float* row = o_m[i];
+		rowStart[i] = values.Num();
+		for( int j = 0; j < n; j++ )
+		{
+			if( row[j] != 0.0f && j != i )
+			{
+				columns.Append( j );
+				values.Append( row[j] );
+			}
+		}
+	}
+	rowStart[n] = values.Num();
+	
+	return true;
+}
+
+/*
+========================
+idLCP_Sparse::Solve
+========================
+*/
+bool idLCP_Sparse::Solve( const idMatX& o_m, idVecX& o_x, const idVecX& o_b, const idVecX& o_lo, const idVecX& o_hi, const int* o_boxIndex )
+{
+	const int n = o_m.GetNumRows();
+	
+	assert( o_m.GetNumRows() == o_m.GetNumColumns() );
+	assert( o_x.GetSize() == n );
+	
+	numIterations = 0;
+	
+	if( n == 0 )
+	{
+		return true;
+	}
+	
+	if( !GatherMatrix( o_m ) )
+	{
+		return false;
+	}
+	
+	float* x = o_x.ToFloatPtr();
+	
+	if( warmStart )
+	{
+		for( int i = 0; i < n; i++ )
+		{
+			if( IsNAN( x[i] ) )
+			{
+				x[i] = 0.0f;
+			}
+		}
+	}
+	else
+	{
+		o_x.Zero();
+	}
+	
+	bool converged = false;
+	for( int sweep = 0; sweep < maxIterations && !converged; sweep++ )
+	{
+		float maxDelta = 0.0f;
+		float maxForce = 0.0f;
+		
+		for( int i = 0; i < n; i++ )
+		{
+			float lo = o_lo[i];
+			float hi = o_hi[i];
+			if( o_boxIndex != NULL && o_boxIndex[i] != -1 )
+			{
+				const float s = x[o_boxIndex[i]];
+				if( lo != -idMath::INFINITY )
+				{
+					lo = - idMath::Fabs( lo * s );
+				}
+				if( hi != idMath::INFINITY )
+				{
+					hi = idMath::Fabs( hi * s );
+				}
+			}
+			
+			float sum = o_b[i];
+			for( int k = rowStart[i]; k < rowStart[i + 1]; k++ )
+			{
+				sum -= values[k] * x[columns[k]];
+			}
+			
+			float f = idMath::ClampFloat( lo, hi, sum * invDiagonal[i] );
+			maxDelta = Max( maxDelta, idMath::Fabs( f - x[i] ) );
+			maxForce = Max( maxForce, idMath::Fabs( f ) );
+			x[i] = f;
+		}
+		
+		if( IsNAN( maxDelta ) )
+		{
+			if( lcp_showFailures.GetBool() )
+			{
+				idLib::Printf( "idLCP_Sparse::Solve: diverged after %d sweeps\n", sweep + 1 );
+			}
+			o_x.Zero();
+			return false;
+		}
+		
+		numIterations = sweep + 1;
+		converged = ( maxDelta <= LCP_SPARSE_DELTA_EPSILON * ( 1.0f + maxForce ) );
+	}
+	
+	if( !converged )
+	{
+		if( lcp_showFailures.GetBool() )
+		{
+			idLib::Printf( "idLCP_Sparse::Solve: no convergence after %d sweeps\n", numIterations );
+		}
+		return false;
+	}
+	
+	return true;
+}
+
 /*
 ================================================================================================
 
@@ -3274,6 +3511,31 @@ idLCP* idLCP::AllocSymmetric()
 	return lcp;
 }
 
+/*
+========================
+idLCP::AllocSparse
+========================
+*/
+idLCP* idLCP::AllocSparse()
+{
+	idLCP* lcp = new idLCP_Sparse;
+	lcp->SetMaxIterations( 64 );
+	lcp->SetWarmStart( true );
+	return lcp;
+}
+
+/*
+========================
+idLCP::idLCP
+========================
+*/
+idLCP::idLCP()
+{
+	maxIterations = 0;
+	numIterations = 0;
+	warmStart = false;
+}
+
 /*
 ========================
 idLCP::~idLCP
@@ -3303,6 +3565,233 @@ int idLCP::GetMaxIterations()
 	return maxIterations;
 }
 
+/*
+========================
+idLCP::SetWarmStart
+========================
+*/
+void idLCP::SetWarmStart( bool enable )
+{
+	warmStart = enable;
+}
+
+/*
+========================
+idLCP::GetWarmStart
+========================
+*/
+bool idLCP::GetWarmStart() const
+{
+	return warmStart;
+}
+
+/*
+========================
+idLCP::GetNumIterations
+========================
+*/
+int idLCP::GetNumIterations() const
+{
+	return numIterations;
+}
+
+/*
+========================
+idLCP::SetSparsity
+========================
+*/
+void idLCP::SetSparsity( int numRows, const int* rowStart, const int* columns )
+{
+}
+
+/*
+========================
+idLCP::ClearSparsity
+========================
+*/
+void idLCP::ClearSparsity()
+{
+	SetSparsity( 0, NULL, NULL );
+}
+
+/*
+========================
+idLCP::ComplementarityError
+
+Returns the largest violation of the complementarity conditions by 'x'.
+========================
+*/
+float idLCP::ComplementarityError( const idMatX& A, const idVecX& x, const idVecX& b, const idVecX& lo, const idVecX& hi, const int* boxIndex )
+{
+	float maxError = 0.0f;
+	
+	for( int i = 0; i < A.GetNumRows(); i++ )
+	{
+		float l = lo[i];
+		float h = hi[i];
+		if( boxIndex != NULL && boxIndex[i] != -1 )
+		{
+			const float s = x[boxIndex[i]];
+			if( l != -idMath::INFINITY )
+			{
+				l = - idMath::Fabs( l * s );
+			}
+			if( h != idMath::INFINITY )
+			{
+				h = idMath::Fabs( h * s );
+			}
+		}
+		
+		float a = -b[i];
+		for( int j = 0; j < A.GetNumColumns(); j++ )
+		{
+			a += A[i][j] * x[j];
+		}
+		
+		float error;
+		if( x[i] < l - LCP_BOUND_EPSILON || x[i] > h + LCP_BOUND_EPSILON )
+		{
+			error = Max( l - x[i], x[i] - h );
+		}
+		else if( x[i] <= l + LCP_BOUND_EPSILON )
+		{
+			error = Max( -a, 0.0f );
+		}
+		else if( x[i] >= h - LCP_BOUND_EPSILON )
+		{
+			error = Max( a, 0.0f );
+		}
+		else
+		{
+			error = idMath::Fabs( a );
+		}
+		maxError = Max( maxError, error );
+	}
+	return maxError;
+}
+
+const int LCP_SPARSE_TEST_COUNT		= 50;
+
+/*
+========================
+LCP_PrintSparseTiming
+========================
+*/
+static void LCP_PrintSparseTiming( const char* string, double clocks, double symmetricClocks )
+{
+	idLib::Printf( "%-56s clcks = %9.0f, %5.1f%% of idLCP_Symmetric\n", string, clocks, clocks * 100.0 / Max( symmetricClocks, 1.0 ) );
+}
+
+/*
+========================
+LCP_Sparse_Test
+
+Compares the dense symmetric solver with the sparse solver on block sparse
+problems shaped like articulated figure contact and limit constraints.
+========================
+*/
+static void LCP_Sparse_Test()
+{
+	idRandom srnd( 13 );
+	idTimer timer;
+	bool converged = false;
+	
+	idLCP* symmetric = idLCP::AllocSymmetric();
+	idLCP* sparse = idLCP::AllocSparse();
+	
+	for( int size = 6; size <= 96; size += 6 )
+	{
+		// J * M^-1 * J' with each 3-row constraint touching two of size/3 bodies
+		const int numBodies = Max( 2, size / 3 );
+		idMatX J, A;
+		J.Zero( size, numBodies * 3 );
+		for( int i = 0; i < size; i += 3 )
+		{
+			int body1 = srnd.RandomInt( numBodies );
+			int body2 = ( body1 + 1 + srnd.RandomInt( numBodies - 1 ) ) % numBodies;
+			for( int r = 0; r < 3 && i + r < size; r++ )
+			{
+				for( int c = 0; c < 3; c++ )
+				{
+					J[i + r][body1 * 3 + c] = srnd.CRandomFloat();
+					J[i + r][body2 * 3 + c] = srnd.CRandomFloat();
+				}
+			}
+		}
+		A.SetSize( size, size );
+		A.Zero();
+		for( int i = 0; i < size; i++ )
+		{
+			for( int j = 0; j < size; j++ )
+			{
+				float dot = 0.0f;
+				for( int k = 0; k < J.GetNumColumns(); k++ )
+				{
+					dot += J[i][k] * J[j][k];
+				}
+				A[i][j] = dot;
+			}
+			A[i][i] += 0.01f;
+		}
+		
+		idVecX b, lo, hi, x1, x2;
+		b.SetSize( size );
+		lo.SetSize( size );
+		hi.SetSize( size );
+		for( int i = 0; i < size; i++ )
+		{
+			b[i] = srnd.CRandomFloat() * 10.0f;
+			lo[i] = ( i % 3 == 0 ) ? 0.0f : -5.0f;
+			hi[i] = ( i % 3 == 0 ) ? idMath::INFINITY : 5.0f;
+		}
+		
+		double clocksSymmetric = idMath::INFINITY;
+		for( int j = 0; j < LCP_SPARSE_TEST_COUNT; j++ )
+		{
+			x1.Zero( size );
+			timer.Clear();
+			timer.Start();
+			symmetric->Solve( A, x1, b, lo, hi );
+			timer.Stop();
+			clocksSymmetric = Min( clocksSymmetric, timer.ClockTicks() );
+		}
+		LCP_PrintSparseTiming( va( "idLCP_Symmetric %dx%d err %.4f", size, size, idLCP::ComplementarityError( A, x1, b, lo, hi ) ), clocksSymmetric, clocksSymmetric );
+		
+		double clocksSparse = idMath::INFINITY;
+		for( int j = 0; j < LCP_SPARSE_TEST_COUNT; j++ )
+		{
+			x2.Zero( size );
+			timer.Clear();
+			timer.Start();
+			converged = sparse->Solve( A, x2, b, lo, hi );
+			timer.Stop();
+			clocksSparse = Min( clocksSparse, timer.ClockTicks() );
+		}
+		LCP_PrintSparseTiming( va( "idLCP_Sparse %dx%d err %.4f sweeps %d%s", size, size, idLCP::ComplementarityError( A, x2, b, lo, hi ), sparse->GetNumIterations(), converged ? "" : " (no convergence)" ), clocksSparse, clocksSymmetric );
+		
+		// warm started from a slightly different solution like the previous frame
+		for( int i = 0; i < size; i++ )
+		{
+			x2[i] *= 1.0f + srnd.CRandomFloat() * 0.05f;
+		}
+		idVecX start = x2;
+		double clocksWarm = idMath::INFINITY;
+		for( int j = 0; j < LCP_SPARSE_TEST_COUNT; j++ )
+		{
+			x2 = start;
+			timer.Clear();
+			timer.Start();
+			converged = sparse->Solve( A, x2, b, lo, hi );
+			timer.Stop();
+			clocksWarm = Min( clocksWarm, timer.ClockTicks() );
+		}
+		LCP_PrintSparseTiming( va( "idLCP_Sparse warm %dx%d err %.4f sweeps %d%s", size, size, idLCP::ComplementarityError( A, x2, b, lo, hi ), sparse->GetNumIterations(), converged ? "" : " (no convergence)" ), clocksWarm, clocksSymmetric );
+	}
+	
+	delete symmetric;
+	delete sparse;
+}
+
 /*
 ========================
 idLCP::Test_f
@@ -3316,4 +3805,5 @@ void idLCP::Test_f( const idCmdArgs& args )
 	LowerTriangularSolveTranspose_Test();
 	LDLT_Factor_Test();
 #endif
+	LCP_Sparse_Test();
 }
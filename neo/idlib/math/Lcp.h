@@ -62,7 +62,9 @@ class idLCP
 public:
 	static idLCP* 	AllocSquare();		// 'A' must be a square matrix
 	static idLCP* 	AllocSymmetric();	// 'A' must be a symmetric matrix
+	static idLCP* 	AllocSparse();		// 'A' must be symmetric positive definite, iterative and warm started
 	
+	idLCP();
 	virtual			~idLCP();
 	
 	virtual bool	Solve( const idMatX& A, idVecX& x, const idVecX& b, const idVecX& lo,
@@ -71,10 +73,26 @@ public:
 	virtual void	SetMaxIterations( int max );
 	virtual int		GetMaxIterations();
 	
+	// when set iterative solvers use the 'x' passed to Solve as the initial guess
+	void			SetWarmStart( bool enable );
+	bool			GetWarmStart() const;
+	// number of iterations used by the last solve of an iterative solver
+	int				GetNumIterations() const;
+	// sets the columns of the non-zero off-diagonal entries of each row of 'A' for sparse solvers,
+	// 'rowStart' has numRows + 1 entries, sparse solvers gather the pattern from 'A' when it is not set
+	virtual void	SetSparsity( int numRows, const int* rowStart, const int* columns );
+	void			ClearSparsity();
+	
+	// largest violation of the complementarity conditions by 'x'
+	static float	ComplementarityError( const idMatX& A, const idVecX& x, const idVecX& b, const idVecX& lo,
+										  const idVecX& hi, const int* boxIndex = NULL );
+										  
 	static void		Test_f( const idCmdArgs& args );
 	
 protected:
 	int				maxIterations;
+	int				numIterations;
+	bool			warmStart;
 };
 
 #endif // !__MATH_LCP_H__
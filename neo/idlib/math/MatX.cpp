@@ -2951,7 +2951,7 @@ idMatX::Cholesky_Factor
 */
 bool idMatX::Cholesky_Factor()
 {
-	int i, j, k;
+	int i, j;
 	float* invSqrt;
 	double sum;
 	
@@ -2962,6 +2962,18 @@ bool idMatX::Cholesky_Factor()
 	for( i = 0; i < numRows; i++ )
 	{
 	
+#ifdef MATX_SIMD
+		float* rowi = ( *this )[i];
+		for( j = 0; j < i; j++ )
+		{
+			sum = rowi[j] - MatX_DotProduct_SIMD( rowi, ( *this )[j], j );
+			rowi[j] = sum * invSqrt[j];
+		}
+		
+		sum = rowi[i] - MatX_DotProduct_SIMD( rowi, rowi, i );
+#else
+		int k;
+		
 		for( j = 0; j < i; j++ )
 		{
 		
@@ -2978,6 +2990,7 @@ bool idMatX::Cholesky_Factor()
 		{
 			sum -= ( *this )[i][k] * ( *this )[i][k];
 		}
+#endif
 		
 		if( sum <= 0.0f )
 		{
@@ -3356,12 +3369,32 @@ idMatX::Cholesky_Solve
 */
 void idMatX::Cholesky_Solve( idVecX& x, const idVecX& b ) const
 {
-	int i, j;
-	double sum;
+	int i;
 	
 	assert( numRows == numColumns );
 	assert( x.GetSize() >= numRows && b.GetSize() >= numRows );
 	
+#ifdef MATX_SIMD
+	float* xPtr = x.ToFloatPtr();
+	
+	// solve L
+	for( i = 0; i < numRows; i++ )
+	{
+		const float* row = ( *this )[i];
+		xPtr[i] = ( b[i] - MatX_DotProduct_SIMD( row, xPtr, i ) ) / row[i];
+	}
+	
+	// solve Lt, once x[i] is final subtract its contribution from all earlier unknowns
+	for( i = numRows - 1; i >= 0; i-- )
+	{
+		const float* row = ( *this )[i];
+		xPtr[i] /= row[i];
+		MatX_MultiplyAdd_SIMD( xPtr, -xPtr[i], row, i );
+	}
+#else
+	int j;
+	double sum;
+	
 	// solve L
 	for( i = 0; i < numRows; i++ )
 	{
@@ -3383,6 +3416,7 @@ void idMatX::Cholesky_Solve( idVecX& x, const idVecX& b ) const
 		}
 		x[i] = sum / ( *this )[i][i];
 	}
+#endif
 }
 
 /*
@@ -3461,7 +3495,7 @@ idMatX::LDLT_Factor
 */
 bool idMatX::LDLT_Factor()
 {
-	int i, j, k;
+	int i, j;
 	float* v;
 	double d, sum;
 	
@@ -3490,11 +3524,17 @@ bool idMatX::LDLT_Factor()
 		
 		for( j = i + 1; j < numRows; j++ )
 		{
+#ifdef MATX_SIMD
+			float* rowj = ( *this )[j];
+			sum = rowj[i] - MatX_DotProduct_SIMD( rowj, v, i );
+#else
+			int k;
 			sum = ( *this )[j][i];
 			for( k = 0; k < i; k++ )
 			{
 				sum -= ( *this )[j][k] * v[k];
 			}
+#endif
 			( *this )[j][i] = sum * d;
 		}
 	}
@@ -3887,12 +3927,35 @@ idMatX::LDLT_Solve
 */
 void idMatX::LDLT_Solve( idVecX& x, const idVecX& b ) const
 {
-	int i, j;
-	double sum;
+	int i;
 	
 	assert( numRows == numColumns );
 	assert( x.GetSize() >= numRows && b.GetSize() >= numRows );
 	
+#ifdef MATX_SIMD
+	float* xPtr = x.ToFloatPtr();
+	
+	// solve L
+	for( i = 0; i < numRows; i++ )
+	{
+		xPtr[i] = b[i] - MatX_DotProduct_SIMD( ( *this )[i], xPtr, i );
+	}
+	
+	// solve D
+	for( i = 0; i < numRows; i++ )
+	{
+		xPtr[i] /= ( *this )[i][i];
+	}
+	
+	// solve Lt, once x[i] is final subtract its contribution from all earlier unknowns
+	for( i = numRows - 1; i > 0; i-- )
+	{
+		MatX_MultiplyAdd_SIMD( xPtr, -xPtr[i], ( *this )[i], i );
+	}
+#else
+	int j;
+	double sum;
+	
 	// solve L
 	for( i = 0; i < numRows; i++ )
 	{
@@ -3920,6 +3983,7 @@ void idMatX::LDLT_Solve( idVecX& x, const idVecX& b ) const
 		}
 		x[i] = sum;
 	}
+#endif
 }
 
 /*
@@ -6146,3 +6210,268 @@ void idMatX::Test()
 		idLib::common->Warning( "idMatX::Eigen_Solve failed" );
 	}
 }
+
+/*
+============
+MatX_Multiply_Generic
+============
+*/
+static void MatX_Multiply_Generic( float* dst, const idMatX& m, const float* v )
+{
+	for( int i = 0; i < m.GetNumRows(); i++ )
+	{
+		float sum = 0.0f;
+		for( int j = 0; j < m.GetNumColumns(); j++ )
+		{
+			sum += m[i][j] * v[j];
+		}
+		dst[i] = sum;
+	}
+}
+
+/*
+============
+MatX_TransposeMultiply_Generic
+============
+*/
+static void MatX_TransposeMultiply_Generic( float* dst, const idMatX& m, const float* v )
+{
+	for( int i = 0; i < m.GetNumColumns(); i++ )
+	{
+		float sum = 0.0f;
+		for( int j = 0; j < m.GetNumRows(); j++ )
+		{
+			sum += m[j][i] * v[j];
+		}
+		dst[i] = sum;
+	}
+}
+
+/*
+============
+MatX_MatrixMultiply_Generic
+============
+*/
+static void MatX_MatrixMultiply_Generic( idMatX& dst, const idMatX& m1, const idMatX& m2 )
+{
+	dst.SetSize( m1.GetNumRows(), m2.GetNumColumns() );
+	for( int i = 0; i < m1.GetNumRows(); i++ )
+	{
+		for( int j = 0; j < m2.GetNumColumns(); j++ )
+		{
+			float sum = 0.0f;
+			for( int k = 0; k < m1.GetNumColumns(); k++ )
+			{
+				sum += m1[i][k] * m2[k][j];
+			}
+			dst[i][j] = sum;
+		}
+	}
+}
+
+/*
+============
+MatX_LDLT_Factor_Generic
+============
+*/
+static bool MatX_LDLT_Factor_Generic( idMatX& m )
+{
+	const int n = m.GetNumRows();
+	float* v = ( float* ) _alloca16( n * sizeof( float ) );
+	
+	for( int i = 0; i < n; i++ )
+	{
+		double sum = m[i][i];
+		for( int j = 0; j < i; j++ )
+		{
+			v[j] = m[j][j] * m[i][j];
+			sum -= v[j] * m[i][j];
+		}
+		if( sum == 0.0f )
+		{
+			return false;
+		}
+		m[i][i] = sum;
+		double d = 1.0f / sum;
+		for( int j = i + 1; j < n; j++ )
+		{
+			sum = m[j][i];
+			for( int k = 0; k < i; k++ )
+			{
+				sum -= m[j][k] * v[k];
+			}
+			m[j][i] = sum * d;
+		}
+	}
+	return true;
+}
+
+/*
+============
+MatX_Cholesky_Factor_Generic
+============
+*/
+static bool MatX_Cholesky_Factor_Generic( idMatX& m )
+{
+	const int n = m.GetNumRows();
+	float* invSqrt = ( float* ) _alloca16( n * sizeof( float ) );
+	
+	for( int i = 0; i < n; i++ )
+	{
+		for( int j = 0; j < i; j++ )
+		{
+			double sum = m[i][j];
+			for( int k = 0; k < j; k++ )
+			{
+				sum -= m[i][k] * m[j][k];
+			}
+			m[i][j] = sum * invSqrt[j];
+		}
+		double sum = m[i][i];
+		for( int k = 0; k < i; k++ )
+		{
+			sum -= m[i][k] * m[i][k];
+		}
+		if( sum <= 0.0f )
+		{
+			return false;
+		}
+		invSqrt[i] = idMath::InvSqrt( sum );
+		m[i][i] = invSqrt[i] * sum;
+	}
+	return true;
+}
+
+/*
+============
+MatX_CompareLower
+============
+*/
+static bool MatX_CompareLower( const idMatX& m1, const idMatX& m2, const float epsilon )
+{
+	for( int i = 0; i < m1.GetNumRows(); i++ )
+	{
+		for( int j = 0; j <= i; j++ )
+		{
+			if( idMath::Fabs( m1[i][j] - m2[i][j] ) > epsilon * ( 1.0f + idMath::Fabs( m2[i][j] ) ) )
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+/*
+============
+MatX_CompareFloats
+============
+*/
+static bool MatX_CompareFloats( const float* a, const float* b, const int count, const float epsilon )
+{
+	for( int i = 0; i < count; i++ )
+	{
+		if( idMath::Fabs( a[i] - b[i] ) > epsilon * ( 1.0f + idMath::Fabs( b[i] ) ) )
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+#define MATX_TEST_EPSILON		1e-3f
+#define MATX_TEST_COUNT			50
+
+/*
+============
+MatX_PrintTiming
+============
+*/
+static void MatX_PrintTiming( const char* name, int size, double generic, double simd, bool ok )
+{
+	idLib::Printf( "%-28s %2d: generic %8.0f simd %8.0f clocks %5.2fx %s\n", name, size, generic, simd, simd > 0.0 ? generic / simd : 0.0, ok ? "ok" : S_COLOR_RED"X" );
+}
+
+/*
+============
+MATX_TIME
+============
+*/
+#define MATX_TIME( best, code )									\
+	best = idMath::INFINITY;									\
+	for( int count = 0; count < MATX_TEST_COUNT; count++ )		\
+	{															\
+		idTimer timer;											\
+		timer.Start();											\
+		code;													\
+		timer.Stop();											\
+		best = Min( best, timer.ClockTicks() );					\
+	}
+
+/*
+============
+idMatX::Test_f
+
+  Compares the SIMD matrix kernels with plain scalar loops and times both
+  for the matrix sizes used by the articulated figure and LCP solvers.
+============
+*/
+void idMatX::Test_f( const idCmdArgs& args )
+{
+	idMatX m, spd, m1, m2, product;
+	idVecX v, x, b, dst1, dst2;
+	double generic, simd;
+	
+	for( int size = 6; size <= 96; size += 6 )
+	{
+		// an odd number of columns to exercise the unaligned rows and the tails
+		m.Random( size, size + 1, size, -1.0f, 1.0f );
+		v.Random( size + 1, size + 2, -1.0f, 1.0f );
+		dst1.SetSize( size + 1 );
+		dst2.SetSize( size + 1 );
+		
+		MATX_TIME( generic, MatX_Multiply_Generic( dst1.ToFloatPtr(), m, v.ToFloatPtr() ) );
+		MATX_TIME( simd, m.Multiply( dst2, v ) );
+		MatX_PrintTiming( "idMatX::Multiply( vec )", size, generic, simd, MatX_CompareFloats( dst2.ToFloatPtr(), dst1.ToFloatPtr(), size, MATX_TEST_EPSILON ) );
+		
+		x.Random( size, size + 3, -1.0f, 1.0f );
+		MATX_TIME( generic, MatX_TransposeMultiply_Generic( dst1.ToFloatPtr(), m, x.ToFloatPtr() ) );
+		MATX_TIME( simd, m.TransposeMultiply( dst2, x ) );
+		MatX_PrintTiming( "idMatX::TransposeMultiply( vec )", size, generic, simd, MatX_CompareFloats( dst2.ToFloatPtr(), dst1.ToFloatPtr(), size + 1, MATX_TEST_EPSILON ) );
+		
+		m1.Random( size + 1, size, size + 4, -1.0f, 1.0f );
+		MATX_TIME( generic, MatX_MatrixMultiply_Generic( product, m, m1 ) );
+		MATX_TIME( simd, m.Multiply( m2, m1 ) );
+		MatX_PrintTiming( "idMatX::Multiply( mat )", size, generic, simd, m2.Compare( product, MATX_TEST_EPSILON * size ) );
+		
+		// symmetric positive definite matrix
+		m1 = m.Transpose();
+		MatX_MatrixMultiply_Generic( spd, m, m1 );
+		for( int i = 0; i < size; i++ )
+		{
+			spd[i][i] += 1.0f;
+		}
+		
+		MATX_TIME( generic, m1 = spd; MatX_LDLT_Factor_Generic( m1 ) );
+		MATX_TIME( simd, m2 = spd; m2.LDLT_Factor() );
+		MatX_PrintTiming( "idMatX::LDLT_Factor", size, generic, simd, MatX_CompareLower( m2, m1, MATX_TEST_EPSILON ) );
+		
+		b.Random( size, size + 5, -1.0f, 1.0f );
+		x.SetSize( size );
+		m2.LDLT_Solve( x, b );
+		spd.Multiply( dst1, x );
+		MATX_TIME( simd, m2.LDLT_Solve( x, b ) );
+		MatX_PrintTiming( "idMatX::LDLT_Solve", size, 0.0, simd, MatX_CompareFloats( dst1.ToFloatPtr(), b.ToFloatPtr(), size, MATX_TEST_EPSILON * size ) );
+		
+		MATX_TIME( generic, m1 = spd; MatX_Cholesky_Factor_Generic( m1 ) );
+		MATX_TIME( simd, m2 = spd; m2.Cholesky_Factor() );
+		MatX_PrintTiming( "idMatX::Cholesky_Factor", size, generic, simd, MatX_CompareLower( m2, m1, MATX_TEST_EPSILON ) );
+		
+		m2.Cholesky_Solve( x, b );
+		spd.Multiply( dst1, x );
+		MATX_TIME( simd, m2.Cholesky_Solve( x, b ) );
+		MatX_PrintTiming( "idMatX::Cholesky_Solve", size, 0.0, simd, MatX_CompareFloats( dst1.ToFloatPtr(), b.ToFloatPtr(), size, MATX_TEST_EPSILON * size ) );
+	}
+	
+	Test();
+}
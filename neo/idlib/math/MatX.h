@@ -251,6 +251,7 @@ public:
 	void			Eigen_SortDecreasing( idVecX& eigenValues );
 	
 	static void		Test();
+	static void		Test_f( const class idCmdArgs& args );	// correctness and timing of the SIMD kernels
 	
 private:
 	int				numRows;				// number of rows
@@ -1467,6 +1468,68 @@ ID_INLINE idMatX idMatX::TransposeMultiply( const idMatX& a ) const
 	return dst;
 }
 
+#ifdef MATX_SIMD
+
+/*
+========================
+MatX_DotProduct_SIMD
+
+dot = src0[0] * src1[0] + src0[1] * src1[1] + src0[2] * src1[2] + ...
+
+The rows of an idMatX are only 16 byte aligned when the number of columns
+is a multiple of 4, so unaligned loads are used.
+========================
+*/
+ID_INLINE float MatX_DotProduct_SIMD( const float* src0, const float* src1, const int count )
+{
+	__m128 sum0 = _mm_setzero_ps();
+	__m128 sum1 = _mm_setzero_ps();
+	int i = 0;
+	for( ; i + 8 <= count; i += 8 )
+	{
+		sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( src0 + i + 0 ), _mm_loadu_ps( src1 + i + 0 ) ) );
+		sum1 = _mm_add_ps( sum1, _mm_mul_ps( _mm_loadu_ps( src0 + i + 4 ), _mm_loadu_ps( src1 + i + 4 ) ) );
+	}
+	if( i + 4 <= count )
+	{
+		sum0 = _mm_add_ps( sum0, _mm_mul_ps( _mm_loadu_ps( src0 + i ), _mm_loadu_ps( src1 + i ) ) );
+		i += 4;
+	}
+	sum0 = _mm_add_ps( sum0, sum1 );
+	sum0 = _mm_add_ps( sum0, _mm_shuffle_ps( sum0, sum0, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+	sum0 = _mm_add_ps( sum0, _mm_shuffle_ps( sum0, sum0, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+	float dot;
+	_mm_store_ss( &dot, sum0 );
+	for( ; i < count; i++ )
+	{
+		dot += src0[i] * src1[i];
+	}
+	return dot;
+}
+
+/*
+========================
+MatX_MultiplyAdd_SIMD
+
+dst[i] += constant * src[i];
+========================
+*/
+ID_INLINE void MatX_MultiplyAdd_SIMD( float* dst, const float constant, const float* src, const int count )
+{
+	__m128 c = _mm_set1_ps( constant );
+	int i = 0;
+	for( ; i + 4 <= count; i += 4 )
+	{
+		_mm_storeu_ps( dst + i, _mm_add_ps( _mm_loadu_ps( dst + i ), _mm_mul_ps( _mm_loadu_ps( src + i ), c ) ) );
+	}
+	for( ; i < count; i++ )
+	{
+		dst[i] += constant * src[i];
+	}
+}
+
+#endif
+
 /*
 ========================
 idMatX::Multiply
@@ -1479,6 +1542,14 @@ ID_INLINE void idMatX::Multiply( idVecX& dst, const idVecX& vec ) const
 	const float* vPtr = vec.ToFloatPtr();
 	float* dstPtr = dst.ToFloatPtr();
 	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+#ifdef MATX_SIMD
+	for( int i = 0; i < numRows; i++ )
+	{
+		float sum = MatX_DotProduct_SIMD( mPtr, vPtr, numColumns );
+		temp[i] = sum;
+		mPtr += numColumns;
+	}
+#else
 	for( int i = 0; i < numRows; i++ )
 	{
 		float sum = mPtr[0] * vPtr[0];
@@ -1489,6 +1560,7 @@ ID_INLINE void idMatX::Multiply( idVecX& dst, const idVecX& vec ) const
 		temp[i] = sum;
 		mPtr += numColumns;
 	}
+#endif
 	for( int i = 0; i < numRows; i++ )
 	{
 		dstPtr[i] = temp[i];
@@ -1507,6 +1579,14 @@ ID_INLINE void idMatX::MultiplyAdd( idVecX& dst, const idVecX& vec ) const
 	const float* vPtr = vec.ToFloatPtr();
 	float* dstPtr = dst.ToFloatPtr();
 	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+#ifdef MATX_SIMD
+	for( int i = 0; i < numRows; i++ )
+	{
+		float sum = MatX_DotProduct_SIMD( mPtr, vPtr, numColumns );
+		temp[i] = dstPtr[i] + sum;
+		mPtr += numColumns;
+	}
+#else
 	for( int i = 0; i < numRows; i++ )
 	{
 		float sum = mPtr[0] * vPtr[0];
@@ -1517,6 +1597,7 @@ ID_INLINE void idMatX::MultiplyAdd( idVecX& dst, const idVecX& vec ) const
 		temp[i] = dstPtr[i] + sum;
 		mPtr += numColumns;
 	}
+#endif
 	for( int i = 0; i < numRows; i++ )
 	{
 		dstPtr[i] = temp[i];
@@ -1535,6 +1616,14 @@ ID_INLINE void idMatX::MultiplySub( idVecX& dst, const idVecX& vec ) const
 	const float* vPtr = vec.ToFloatPtr();
 	float* dstPtr = dst.ToFloatPtr();
 	float* temp = ( float* )_alloca16( numRows * sizeof( float ) );
+#ifdef MATX_SIMD
+	for( int i = 0; i < numRows; i++ )
+	{
+		float sum = MatX_DotProduct_SIMD( mPtr, vPtr, numColumns );
+		temp[i] = dstPtr[i] - sum;
+		mPtr += numColumns;
+	}
+#else
 	for( int i = 0; i < numRows; i++ )
 	{
 		float sum = mPtr[0] * vPtr[0];
@@ -1545,6 +1634,7 @@ ID_INLINE void idMatX::MultiplySub( idVecX& dst, const idVecX& vec ) const
 		temp[i] = dstPtr[i] - sum;
 		mPtr += numColumns;
 	}
+#endif
 	for( int i = 0; i < numRows; i++ )
 	{
 		dstPtr[i] = temp[i];
@@ -1562,6 +1652,14 @@ ID_INLINE void idMatX::TransposeMultiply( idVecX& dst, const idVecX& vec ) const
 	const float* vPtr = vec.ToFloatPtr();
 	float* dstPtr = dst.ToFloatPtr();
 	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+#ifdef MATX_SIMD
+	// accumulate the rows scaled by the vector elements
+	memset( temp, 0, numColumns * sizeof( float ) );
+	for( int j = 0; j < numRows; j++ )
+	{
+		MatX_MultiplyAdd_SIMD( temp, vPtr[j], mat + j * numColumns, numColumns );
+	}
+#else
 	for( int i = 0; i < numColumns; i++ )
 	{
 		const float* mPtr = mat + i;
@@ -1573,6 +1671,7 @@ ID_INLINE void idMatX::TransposeMultiply( idVecX& dst, const idVecX& vec ) const
 		}
 		temp[i] = sum;
 	}
+#endif
 	for( int i = 0; i < numColumns; i++ )
 	{
 		dstPtr[i] = temp[i];
@@ -1590,6 +1689,14 @@ ID_INLINE void idMatX::TransposeMultiplyAdd( idVecX& dst, const idVecX& vec ) co
 	const float* vPtr = vec.ToFloatPtr();
 	float* dstPtr = dst.ToFloatPtr();
 	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+#ifdef MATX_SIMD
+	// accumulate the rows scaled by the vector elements
+	memcpy( temp, dstPtr, numColumns * sizeof( float ) );
+	for( int j = 0; j < numRows; j++ )
+	{
+		MatX_MultiplyAdd_SIMD( temp, vPtr[j], mat + j * numColumns, numColumns );
+	}
+#else
 	for( int i = 0; i < numColumns; i++ )
 	{
 		const float* mPtr = mat + i;
@@ -1601,6 +1708,7 @@ ID_INLINE void idMatX::TransposeMultiplyAdd( idVecX& dst, const idVecX& vec ) co
 		}
 		temp[i] = dstPtr[i] + sum;
 	}
+#endif
 	for( int i = 0; i < numColumns; i++ )
 	{
 		dstPtr[i] = temp[i];
@@ -1618,6 +1726,14 @@ ID_INLINE void idMatX::TransposeMultiplySub( idVecX& dst, const idVecX& vec ) co
 	const float* vPtr = vec.ToFloatPtr();
 	float* dstPtr = dst.ToFloatPtr();
 	float* temp = ( float* )_alloca16( numColumns * sizeof( float ) );
+#ifdef MATX_SIMD
+	// accumulate the rows scaled by the vector elements
+	memcpy( temp, dstPtr, numColumns * sizeof( float ) );
+	for( int j = 0; j < numRows; j++ )
+	{
+		MatX_MultiplyAdd_SIMD( temp, -vPtr[j], mat + j * numColumns, numColumns );
+	}
+#else
 	for( int i = 0; i < numColumns; i++ )
 	{
 		const float* mPtr = mat + i;
@@ -1629,6 +1745,7 @@ ID_INLINE void idMatX::TransposeMultiplySub( idVecX& dst, const idVecX& vec ) co
 		}
 		temp[i] = dstPtr[i] - sum;
 	}
+#endif
 	for( int i = 0; i < numColumns; i++ )
 	{
 		dstPtr[i] = temp[i];
@@ -1650,6 +1767,21 @@ ID_INLINE void idMatX::Multiply( idMatX& dst, const idMatX& a ) const
 	const float* m1Ptr = ToFloatPtr();
 	int k = numRows;
 	int l = a.GetNumColumns();
+#ifdef MATX_SIMD
+	// each row of the product is a sum of the rows of 'a' scaled by the elements of a row of this matrix
+	for( int i = 0; i < k; i++ )
+	{
+		memset( dstPtr, 0, l * sizeof( float ) );
+		const float* m2Ptr = a.ToFloatPtr();
+		for( int n = 0; n < numColumns; n++ )
+		{
+			MatX_MultiplyAdd_SIMD( dstPtr, m1Ptr[n], m2Ptr, l );
+			m2Ptr += l;
+		}
+		dstPtr += l;
+		m1Ptr += numColumns;
+	}
+#else
 	for( int i = 0; i < k; i++ )
 	{
 		for( int j = 0; j < l; j++ )
@@ -1665,6 +1797,7 @@ ID_INLINE void idMatX::Multiply( idMatX& dst, const idMatX& a ) const
 		}
 		m1Ptr += numColumns;
 	}
+#endif
 }
 
 /*
@@ -1681,6 +1814,19 @@ ID_INLINE void idMatX::TransposeMultiply( idMatX& dst, const idMatX& a ) const
 	float* dstPtr = dst.ToFloatPtr();
 	int k = numColumns;
 	int l = a.numColumns;
+#ifdef MATX_SIMD
+	// each row of the product is a sum of the rows of 'a' scaled by the elements of a column of this matrix
+	memset( dstPtr, 0, k * l * sizeof( float ) );
+	for( int n = 0; n < numRows; n++ )
+	{
+		const float* m1Ptr = ToFloatPtr() + n * numColumns;
+		const float* m2Ptr = a.ToFloatPtr() + n * l;
+		for( int i = 0; i < k; i++ )
+		{
+			MatX_MultiplyAdd_SIMD( dstPtr + i * l, m1Ptr[i], m2Ptr, l );
+		}
+	}
+#else
 	for( int i = 0; i < k; i++ )
 	{
 		for( int j = 0; j < l; j++ )
@@ -1697,6 +1843,7 @@ ID_INLINE void idMatX::TransposeMultiply( idMatX& dst, const idMatX& a ) const
 			*dstPtr++ = sum;
 		}
 	}
+#endif
 }
 
 /*
@@ -112,6 +112,7 @@ public:
 	virtual void VPCALL ConvertJointMatsToJointQuats( idJointQuat* jointQuats, const idJointMat* jointMats, const int numJoints ) = 0;
 	virtual void VPCALL TransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint ) = 0;
 	virtual void VPCALL UntransformJoints( idJointMat* jointMats, const int* parents, const int firstJoint, const int lastJoint ) = 0;
+	virtual void VPCALL DecompressComponents( float* dst, const unsigned short* src1, const unsigned short* src2, const float lerp, const float* bias, const float* scale, const int count ) = 0;
 };
 
 // pointer to SIMD processor
@@ -235,3 +235,20 @@ void VPCALL idSIMD_Generic::UntransformJoints( idJointMat* jointMats, const int*
 		jointMats[i] /= jointMats[parents[i]];
 	}
 }
+
+/*
+============
+idSIMD_Generic::DecompressComponents
+
+  dst[i] = bias[i] + scale[i] * lerp( src1[i], src2[i] )
+============
+*/
+void VPCALL idSIMD_Generic::DecompressComponents( float* dst, const unsigned short* src1, const unsigned short* src2, const float lerp, const float* bias, const float* scale, const int count )
+{
+	for( int i = 0; i < count; i++ )
+	{
+		const float q1 = src1[i];
+		const float q2 = src2[i];
+		dst[i] = bias[i] + scale[i] * ( q1 + ( q2 - q1 ) * lerp );
+	}
+}
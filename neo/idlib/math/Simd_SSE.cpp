@@ -973,3 +973,44 @@ void VPCALL idSIMD_SSE::UntransformJoints( idJointMat* jointMats, const int* par
 	}
 }
 
+/*
+============
+idSIMD_SSE::DecompressComponents
+
+  dst[i] = bias[i] + scale[i] * lerp( src1[i], src2[i] )
+============
+*/
+void VPCALL idSIMD_SSE::DecompressComponents( float* dst, const unsigned short* src1, const unsigned short* src2, const float lerp, const float* bias, const float* scale, const int count )
+{
+	const __m128 vlerp = { lerp, lerp, lerp, lerp };
+	const __m128i vzero = _mm_setzero_si128();
+	
+	int i = 0;
+	for( ; i < count - 7; i += 8 )
+	{
+		__m128i q1 = _mm_loadu_si128( ( const __m128i* )( src1 + i ) );
+		__m128i q2 = _mm_loadu_si128( ( const __m128i* )( src2 + i ) );
+		
+		__m128 a0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( q1, vzero ) );
+		__m128 a1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( q1, vzero ) );
+		__m128 b0 = _mm_cvtepi32_ps( _mm_unpacklo_epi16( q2, vzero ) );
+		__m128 b1 = _mm_cvtepi32_ps( _mm_unpackhi_epi16( q2, vzero ) );
+		
+		a0 = _mm_add_ps( a0, _mm_mul_ps( _mm_sub_ps( b0, a0 ), vlerp ) );
+		a1 = _mm_add_ps( a1, _mm_mul_ps( _mm_sub_ps( b1, a1 ), vlerp ) );
+		
+		a0 = _mm_add_ps( _mm_loadu_ps( bias + i + 0 ), _mm_mul_ps( _mm_loadu_ps( scale + i + 0 ), a0 ) );
+		a1 = _mm_add_ps( _mm_loadu_ps( bias + i + 4 ), _mm_mul_ps( _mm_loadu_ps( scale + i + 4 ), a1 ) );
+		
+		_mm_storeu_ps( dst + i + 0, a0 );
+		_mm_storeu_ps( dst + i + 4, a1 );
+	}
+	
+	for( ; i < count; i++ )
+	{
+		const float q1 = src1[i];
+		const float q2 = src2[i];
+		dst[i] = bias[i] + scale[i] * ( q1 + ( q2 - q1 ) * lerp );
+	}
+}
+
@@ -40,7 +40,71 @@ If you have questions concerning this license or the applicable additional terms
 #include "DXT/DXTCodec.h"
 #include "Color/ColorSpace.h"
 
-idCVar image_highQualityCompression( "image_highQualityCompression", "0", CVAR_BOOL, "Use high quality (slow) compression" );
+enum dxtQuality_t
+{
+	DXT_QUALITY_FAST,		// end points from the bounding box of the block, for real-time use
+	DXT_QUALITY_HIGH,		// exhaustive search for the end points with the least error, very slow
+	DXT_NUM_QUALITIES
+};
+
+enum dxtMode_t
+{
+	DXT_MODE_DXT1,
+	DXT_MODE_DXT5,
+	DXT_MODE_YCOCG_DXT5,
+	DXT_MODE_NORMAL_DXT5,
+	DXT_NUM_MODES
+};
+
+static const idDxtParallelEncoder::compressFunc_t dxtCompressFuncs[DXT_NUM_MODES][DXT_NUM_QUALITIES] =
+{
+	{ &idDxtEncoder::CompressImageDXT1Fast,		&idDxtEncoder::CompressImageDXT1HQ },
+	{ &idDxtEncoder::CompressImageDXT5Fast,		&idDxtEncoder::CompressImageDXT5HQ },
+	{ &idDxtEncoder::CompressYCoCgDXT5Fast,		&idDxtEncoder::CompressYCoCgDXT5HQ },
+	{ &idDxtEncoder::CompressNormalMapDXT5Fast,	&idDxtEncoder::CompressNormalMapDXT5HQ }
+};
+
+static const int dxtBlockBytes[DXT_NUM_MODES] =
+{
+	idDxtParallelEncoder::DXT1_BLOCK_BYTES,
+	idDxtParallelEncoder::DXT5_BLOCK_BYTES,
+	idDxtParallelEncoder::DXT5_BLOCK_BYTES,
+	idDxtParallelEncoder::DXT5_BLOCK_BYTES
+};
+
+static const char* dxtModeNames[DXT_NUM_MODES] = { "DXT1", "DXT5", "YCoCg DXT5", "normal DXT5" };
+static const char* dxtQualityNames[DXT_NUM_QUALITIES] = { "fast", "high" };
+
+idCVar image_compressionQuality( "image_compressionQuality", "0", CVAR_INTEGER, "DXT compression quality used to generate images, 0 = fast, 1 = high (exhaustive search, very slow)", DXT_QUALITY_FAST, DXT_NUM_QUALITIES - 1 );
+idCVar image_highQualityCompression( "image_highQualityCompression", "0", CVAR_BOOL, "deprecated, same as image_compressionQuality 1" );
+idCVar image_parallelCompression( "image_parallelCompression", "1", CVAR_BOOL, "Compress strips of large images on the job threads" );
+
+/*
+========================
+CompressDXT
+========================
+*/
+static void CompressDXT( dxtMode_t mode, dxtQuality_t quality, const byte* inBuf, byte* outBuf, int width, int height, bool parallel )
+{
+	idDxtParallelEncoder::CompressImage( dxtCompressFuncs[mode][quality], dxtBlockBytes[mode], inBuf, outBuf, width, height, parallel );
+}
+
+/*
+========================
+SwizzleNormalMapDXT5
+
+The high quality normal map compression swizzles automatically, the fast one expects _Ny_Nx
+========================
+*/
+static void SwizzleNormalMapDXT5( byte* pic, int numPixels )
+{
+	for( int i = 0; i < numPixels; i++ )
+	{
+		pic[i * 4 + 3] = pic[i * 4 + 0];
+		pic[i * 4 + 0] = 0;
+		pic[i * 4 + 2] = 0;
+	}
+}
 
 /*
 ========================
@@ -56,6 +120,9 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 	fileData.height = height;
 	fileData.numLevels = numLevels;
 	
+	const dxtQuality_t quality = image_highQualityCompression.GetBool() ? DXT_QUALITY_HIGH : ( dxtQuality_t )image_compressionQuality.GetInteger();
+	const bool parallel = image_parallelCompression.GetBool();
+	
 	byte* pic = ( byte* )Mem_Alloc( width * height * 4, TAG_TEMP );
 	memcpy( pic, pic_const, width * height * 4 );
 	
@@ -66,15 +133,9 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 	}
 	else if( colorFormat == CFM_NORMAL_DXT5 )
 	{
-		// Blah, HQ swizzles automatically, Fast doesn't
-		if( !image_highQualityCompression.GetBool() )
+		if( quality == DXT_QUALITY_FAST )
 		{
-			for( int i = 0; i < width * height; i++ )
-			{
-				pic[i * 4 + 3] = pic[i * 4 + 0];
-				pic[i * 4 + 0] = 0;
-				pic[i * 4 + 2] = 0;
-			}
+			SwizzleNormalMapDXT5( pic, width * height );
 		}
 	}
 	else if( colorFormat == CFM_GREEN_ALPHA )
@@ -128,54 +189,24 @@ void idBinaryImage::Load2DFromMemory( int width, int height, const byte* pic_con
 		// compress data or convert floats as necessary
 		if( textureFormat == FMT_DXT1 )
 		{
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight / 2 );
-			if( image_highQualityCompression.GetBool() )
-			{
-				dxt.CompressImageDXT1HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-			}
-			else
-			{
-				dxt.CompressImageDXT1Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-			}
+			CompressDXT( DXT_MODE_DXT1, quality, dxtPic, img.data, dxtWidth, dxtHeight, parallel );
 		}
 		else if( textureFormat == FMT_DXT5 )
 		{
-			idDxtEncoder dxt;
 			img.Alloc( dxtWidth * dxtHeight );
 			if( colorFormat == CFM_NORMAL_DXT5 )
 			{
-				if( image_highQualityCompression.GetBool() )
-				{
-					dxt.CompressNormalMapDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-				else
-				{
-					dxt.CompressNormalMapDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
+				CompressDXT( DXT_MODE_NORMAL_DXT5, quality, dxtPic, img.data, dxtWidth, dxtHeight, parallel );
 			}
 			else if( colorFormat == CFM_YCOCG_DXT5 )
 			{
-				if( image_highQualityCompression.GetBool() )
-				{
-					dxt.CompressYCoCgDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-				else
-				{
-					dxt.CompressYCoCgDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
+				CompressDXT( DXT_MODE_YCOCG_DXT5, quality, dxtPic, img.data, dxtWidth, dxtHeight, parallel );
 			}
 			else
 			{
 				fileData.colorFormat = colorFormat = CFM_DEFAULT;
-				if( image_highQualityCompression.GetBool() )
-				{
-					dxt.CompressImageDXT5HQ( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
-				else
-				{
-					dxt.CompressImageDXT5Fast( dxtPic, img.data, dxtWidth, dxtHeight );
-				}
+				CompressDXT( DXT_MODE_DXT5, quality, dxtPic, img.data, dxtWidth, dxtHeight, parallel );
 			}
 		}
 		else if( textureFormat == FMT_LUM8 || textureFormat == FMT_INT8 )
@@ -330,14 +361,12 @@ void idBinaryImage::LoadCubeFromMemory( int width, const byte* pics[6], int numL
 			if( textureFormat == FMT_DXT1 )
 			{
 				img.Alloc( padSize * padSize / 2 );
-				idDxtEncoder dxt;
-				dxt.CompressImageDXT1Fast( padSrc, img.data, padSize, padSize );
+				CompressDXT( DXT_MODE_DXT1, DXT_QUALITY_FAST, padSrc, img.data, padSize, padSize, image_parallelCompression.GetBool() );
 			}
 			else if( textureFormat == FMT_DXT5 )
 			{
 				img.Alloc( padSize * padSize );
-				idDxtEncoder dxt;
-				dxt.CompressImageDXT5Fast( padSrc, img.data, padSize, padSize );
+				CompressDXT( DXT_MODE_DXT5, DXT_QUALITY_FAST, padSrc, img.data, padSize, padSize, image_parallelCompression.GetBool() );
 			}
 			else
 			{
@@ -423,7 +452,7 @@ idBinaryImage::LoadFromGeneratedFile
 Load the preprocessed image from the generated folder.
 ==========================
 */
-ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime )
+ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime, int maxSize )
 {
 	idStr binaryFileName;
 	MakeGeneratedFileName( binaryFileName );
@@ -432,7 +461,7 @@ ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime )
 	{
 		return FILE_NOT_FOUND_TIMESTAMP;
 	}
-	if( LoadFromGeneratedFile( bFile, sourceFileTime ) )
+	if( LoadFromGeneratedFile( bFile, sourceFileTime, maxSize ) )
 	{
 		return bFile->Timestamp();
 	}
@@ -444,9 +473,13 @@ ID_TIME_T idBinaryImage::LoadFromGeneratedFile( ID_TIME_T sourceFileTime )
 idBinaryImage::LoadFromGeneratedFile
 
 Load the preprocessed image from the generated folder.
+
+Streamed images skip the levels larger than maxSize, and the streaming requests
+skip the levels from endLevel down that are already resident.  The data of the
+skipped levels is seeked over so only the wanted levels are actually read.
 ==========================
 */
-bool idBinaryImage::LoadFromGeneratedFile( idFile* bFile, ID_TIME_T sourceFileTime )
+bool idBinaryImage::LoadFromGeneratedFile( idFile* bFile, ID_TIME_T sourceFileTime, int maxSize, int endLevel )
 {
 	if( bFile->Read( &fileData, sizeof( fileData ) ) <= 0 )
 	{
@@ -479,9 +512,10 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile* bFile, ID_TIME_T sourceFileTi
 	
 	images.SetNum( numImages );
 	
+	int numLoaded = 0;
 	for( int i = 0; i < numImages; i++ )
 	{
-		idBinaryImageData& img = images[ i ];
+		idBinaryImageData& img = images[ numLoaded ];
 		if( bFile->Read( &img, sizeof( bimageImage_t ) ) <= 0 )
 		{
 			return false;
@@ -499,6 +533,18 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile* bFile, ID_TIME_T sourceFileTi
 		// sizes are still retained, so the stored data size may be larger than
 		// just the multiplication of dimensions
 		assert( img.dataSize >= img.width * img.height * BitsForFormat( ( textureFormat_t )fileData.format ) / 8 );
+		
+		const bool tooLarge = ( maxSize > 0 && img.level < fileData.numLevels - 1 && Max( img.width, img.height ) > maxSize );
+		const bool resident = ( endLevel > 0 && img.level >= endLevel );
+		if( fileData.textureType == TT_2D && ( tooLarge || resident ) )
+		{
+			if( bFile->Seek( img.dataSize, FS_SEEK_CUR ) != 0 )
+			{
+				return false;
+			}
+			continue;
+		}
+		
 		img.Alloc( img.dataSize );
 		if( img.data == NULL )
 		{
@@ -509,8 +555,11 @@ bool idBinaryImage::LoadFromGeneratedFile( idFile* bFile, ID_TIME_T sourceFileTi
 		{
 			return false;
 		}
+		numLoaded++;
 	}
 	
+	images.SetNum( numLoaded );
+	
 	return true;
 }
 
@@ -538,3 +587,283 @@ void idBinaryImage::GetGeneratedFileName( idStr& gfn, const char* name )
 }
 
 
+
+/*
+================================================================================================
+
+	DXT compression benchmark
+
+================================================================================================
+*/
+
+static const int BENCHMARK_IMAGE_SIZE = 128;
+
+// channels compared for the error of each mode, the normal maps and YCoCg are compared in the
+// channels the encoders write, which leaves out the YCoCg scale in blue
+static const int dxtErrorChannels[DXT_NUM_MODES] = { 0x7, 0xF, 0xB, 0xA };
+
+struct dxtBenchmarkImage_t
+{
+	idStr	name;
+	byte* 	pic;
+	int		width;
+	int		height;
+};
+
+/*
+========================
+MakeBenchmarkImage
+
+Fixed synthetic images so results can be compared without any source art
+========================
+*/
+static byte* MakeBenchmarkImage( int type, int size )
+{
+	idRandom random( type );
+	byte* pic = ( byte* )Mem_Alloc( size * size * 4, TAG_TEMP );
+	
+	if( type == 0 )
+	{
+		// smooth gradients with a little noise
+		for( int y = 0; y < size; y++ )
+		{
+			for( int x = 0; x < size; x++ )
+			{
+				byte* p = pic + ( y * size + x ) * 4;
+				p[0] = ( byte )idMath::ClampInt( 0, 255, x * 255 / size + random.RandomInt( 13 ) - 6 );
+				p[1] = ( byte )idMath::ClampInt( 0, 255, y * 255 / size + random.RandomInt( 13 ) - 6 );
+				p[2] = ( byte )idMath::ClampInt( 0, 255, ( x + y ) * 255 / ( size * 2 ) + random.RandomInt( 13 ) - 6 );
+				p[3] = ( byte )idMath::ClampInt( 0, 255, 255 - y * 255 / size + random.RandomInt( 9 ) - 4 );
+			}
+		}
+	}
+	else
+	{
+		// tiles that don't line up with the 4x4 blocks, with moderate contrast between the tiles
+		const int tileSize = 6;
+		const int numTiles = ( size + tileSize - 1 ) / tileSize;
+		idTempArray<byte> tiles( numTiles * numTiles * 4 );
+		for( int i = 0; i < numTiles * numTiles * 4; i++ )
+		{
+			tiles[i] = ( byte )( 96 + random.RandomInt( 64 ) );
+		}
+		for( int y = 0; y < size; y++ )
+		{
+			for( int x = 0; x < size; x++ )
+			{
+				const byte* t = &tiles[( ( y / tileSize ) * numTiles + ( x / tileSize ) ) * 4];
+				byte* p = pic + ( y * size + x ) * 4;
+				p[0] = t[0];
+				p[1] = t[1];
+				p[2] = t[2];
+				p[3] = t[3];
+			}
+		}
+	}
+	return pic;
+}
+
+/*
+========================
+MakeBenchmarkNormalMap
+
+Derives a tangent space NxNyNz normal map from the luminance of an image
+========================
+*/
+static void MakeBenchmarkNormalMap( const byte* pic, byte* normalMap, int width, int height )
+{
+	for( int y = 0; y < height; y++ )
+	{
+		for( int x = 0; x < width; x++ )
+		{
+			const byte* l = pic + ( y * width + Max( x - 1, 0 ) ) * 4;
+			const byte* r = pic + ( y * width + Min( x + 1, width - 1 ) ) * 4;
+			const byte* d = pic + ( Max( y - 1, 0 ) * width + x ) * 4;
+			const byte* u = pic + ( Min( y + 1, height - 1 ) * width + x ) * 4;
+			
+			idVec3 normal;
+			normal.x = ( ( l[0] + l[1] + l[2] ) - ( r[0] + r[1] + r[2] ) ) / ( 3.0f * 255.0f );
+			normal.y = ( ( d[0] + d[1] + d[2] ) - ( u[0] + u[1] + u[2] ) ) / ( 3.0f * 255.0f );
+			normal.z = 0.25f;
+			normal.Normalize();
+			
+			byte* n = normalMap + ( y * width + x ) * 4;
+			n[0] = idMath::Ftob( ( normal.x + 1.0f ) * 127.5f );
+			n[1] = idMath::Ftob( ( normal.y + 1.0f ) * 127.5f );
+			n[2] = idMath::Ftob( ( normal.z + 1.0f ) * 127.5f );
+			n[3] = 255;
+		}
+	}
+}
+
+/*
+========================
+R_DXTBenchmark_f
+
+Compresses a fixed image corpus in every mode with every quality tier on this thread, and reports
+the speed and the root mean square error of the decompressed images per tier.
+
+dxtBenchmark [directory]
+========================
+*/
+void R_DXTBenchmark_f( const idCmdArgs& args )
+{
+	idList< dxtBenchmarkImage_t > corpus;
+	
+	if( args.Argc() > 1 )
+	{
+		const char* extensions[] = { ".tga", ".png", ".jpg" };
+		for( int i = 0; i < sizeof( extensions ) / sizeof( extensions[0] ); i++ )
+		{
+			idFileList* files = fileSystem->ListFilesTree( args.Argv( 1 ), extensions[i], true );
+			for( int j = 0; j < files->GetNumFiles(); j++ )
+			{
+				dxtBenchmarkImage_t image;
+				image.name = files->GetFile( j );
+				R_LoadImage( image.name, &image.pic, &image.width, &image.height, NULL, false );
+				if( image.pic == NULL )
+				{
+					continue;
+				}
+				if( image.width < 4 || image.height < 4 )
+				{
+					Mem_Free( image.pic );
+					continue;
+				}
+				// crop to whole blocks
+				const int width = image.width & ~3;
+				for( int y = 0; y < image.height; y++ )
+				{
+					memmove( image.pic + y * width * 4, image.pic + y * image.width * 4, width * 4 );
+				}
+				image.width = width;
+				image.height &= ~3;
+				corpus.Append( image );
+			}
+			fileSystem->FreeFileList( files );
+		}
+		if( corpus.Num() == 0 )
+		{
+			common->Printf( "no images found in %s\n", args.Argv( 1 ) );
+			return;
+		}
+	}
+	else
+	{
+		const char* names[] = { "_gradients", "_tiles" };
+		for( int i = 0; i < 2; i++ )
+		{
+			dxtBenchmarkImage_t image;
+			image.name = names[i];
+			image.width = image.height = BENCHMARK_IMAGE_SIZE;
+			image.pic = MakeBenchmarkImage( i, BENCHMARK_IMAGE_SIZE );
+			corpus.Append( image );
+		}
+	}
+	
+	common->Printf( "compressing %d images, the high quality tier may take a while...\n", corpus.Num() );
+	common->SetRefreshOnPrint( true );
+	
+	int64 numPixels[DXT_NUM_MODES] = { 0 };
+	uint64 time[DXT_NUM_MODES][DXT_NUM_QUALITIES] = { { 0 } };
+	double squaredError[DXT_NUM_MODES][DXT_NUM_QUALITIES] = { { 0 } };
+	int64 numSamples[DXT_NUM_MODES] = { 0 };
+	
+	idDxtDecoder decoder;
+	
+	for( int i = 0; i < corpus.Num(); i++ )
+	{
+		const dxtBenchmarkImage_t& image = corpus[i];
+		const int numImagePixels = image.width * image.height;
+		
+		idTempArray<byte> input( numImagePixels * 4 );
+		idTempArray<byte> reference( numImagePixels * 4 );
+		idTempArray<byte> compressed( numImagePixels );
+		idTempArray<byte> decompressed( numImagePixels * 4 );
+		
+		for( int mode = 0; mode < DXT_NUM_MODES; mode++ )
+		{
+			if( mode == DXT_MODE_YCOCG_DXT5 )
+			{
+				idColorSpace::ConvertRGBToCoCg_Y( reference.Ptr(), image.pic, image.width, image.height );
+			}
+			else if( mode == DXT_MODE_NORMAL_DXT5 )
+			{
+				MakeBenchmarkNormalMap( image.pic, reference.Ptr(), image.width, image.height );
+			}
+			else
+			{
+				memcpy( reference.Ptr(), image.pic, numImagePixels * 4 );
+			}
+			
+			for( int quality = 0; quality < DXT_NUM_QUALITIES; quality++ )
+			{
+				memcpy( input.Ptr(), reference.Ptr(), numImagePixels * 4 );
+				if( mode == DXT_MODE_NORMAL_DXT5 && quality == DXT_QUALITY_FAST )
+				{
+					SwizzleNormalMapDXT5( input.Ptr(), numImagePixels );
+				}
+				
+				const uint64 start = Sys_Microseconds();
+				CompressDXT( ( dxtMode_t )mode, ( dxtQuality_t )quality, input.Ptr(), compressed.Ptr(), image.width, image.height, false );
+				time[mode][quality] += Sys_Microseconds() - start;
+				
+				if( mode == DXT_MODE_DXT1 )
+				{
+					decoder.DecompressImageDXT1( compressed.Ptr(), decompressed.Ptr(), image.width, image.height );
+				}
+				else if( mode == DXT_MODE_YCOCG_DXT5 )
+				{
+					decoder.DecompressYCoCgDXT5( compressed.Ptr(), decompressed.Ptr(), image.width, image.height );
+				}
+				else
+				{
+					decoder.DecompressImageDXT5( compressed.Ptr(), decompressed.Ptr(), image.width, image.height );
+				}
+				
+				// the normal map encoders put Nx in alpha and Ny in green
+				const byte* expected = reference.Ptr();
+				if( mode == DXT_MODE_NORMAL_DXT5 )
+				{
+					memcpy( input.Ptr(), reference.Ptr(), numImagePixels * 4 );
+					SwizzleNormalMapDXT5( input.Ptr(), numImagePixels );
+					expected = input.Ptr();
+				}
+				
+				for( int j = 0; j < numImagePixels * 4; j++ )
+				{
+					if( dxtErrorChannels[mode] & ( 1 << ( j & 3 ) ) )
+					{
+						const int delta = decompressed[j] - expected[j];
+						squaredError[mode][quality] += delta * delta;
+					}
+				}
+			}
+			
+			numPixels[mode] += numImagePixels;
+			for( int c = 0; c < 4; c++ )
+			{
+				if( dxtErrorChannels[mode] & ( 1 << c ) )
+				{
+					numSamples[mode] += numImagePixels;
+				}
+			}
+		}
+		
+		common->Printf( "%4i/%i %s\n", i + 1, corpus.Num(), image.name.c_str() );
+		Mem_Free( image.pic );
+	}
+	
+	common->SetRefreshOnPrint( false );
+	
+	common->Printf( "mode         tier    MPixels/sec    RMSE\n" );
+	for( int mode = 0; mode < DXT_NUM_MODES; mode++ )
+	{
+		for( int quality = 0; quality < DXT_NUM_QUALITIES; quality++ )
+		{
+			const float seconds = Max( time[mode][quality], ( uint64 )1 ) * 0.000001f;
+			const float rmse = idMath::Sqrt( ( float )( squaredError[mode][quality] / numSamples[mode] ) );
+			common->Printf( "%-12s %-5s %12.2f %8.3f\n", dxtModeNames[mode], dxtQualityNames[quality], numPixels[mode] / seconds * 0.000001f, rmse );
+		}
+	}
+}
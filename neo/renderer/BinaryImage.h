@@ -55,7 +55,11 @@ public:
 	void				Load2DFromMemory( int width, int height, const byte* pic_const, int numLevels, textureFormat_t& textureFormat, textureColor_t& colorFormat, bool gammaMips );
 	void				LoadCubeFromMemory( int width, const byte* pics[6], int numLevels, textureFormat_t& textureFormat, bool gammaMips );
 	
-	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime );
+	// if maxSize is set, levels larger than maxSize are skipped, except for the smallest one
+	ID_TIME_T			LoadFromGeneratedFile( ID_TIME_T sourceFileTime, int maxSize = 0 );
+	// the image streaming thread reads from files opened on the main thread, if endLevel
+	// is set the levels from endLevel down are skipped as well
+	bool				LoadFromGeneratedFile( idFile* f, ID_TIME_T sourceFileTime, int maxSize = 0, int endLevel = 0 );
 	ID_TIME_T			WriteGeneratedFile( ID_TIME_T sourceFileTime );
 	
 	const bimageFile_t& 	GetFileHeader()
@@ -122,7 +126,6 @@ private:
 	
 private:
 	void				MakeGeneratedFileName( idStr& gfn );
-	bool				LoadFromGeneratedFile( idFile* f, ID_TIME_T sourceFileTime );
 };
 
 #endif // __BINARYIMAGE_H__
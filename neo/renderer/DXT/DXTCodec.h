@@ -236,10 +236,14 @@ private:
 	int					GetSquareAlphaError( const byte* colorBlock, const int alphaOffset, const byte minAlpha, const byte maxAlpha, int lastError ) const;
 	int					GetMinMaxAlphaHQ( const byte* colorBlock, const int alphaOffset, byte* minColor, byte* maxColor ) const;
 	int					GetSquareColorsError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const;
+	int					GetSquareColorsError_Generic( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const;
+	int					GetSquareColorsError_SSE2( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const;
 	int					GetMinMaxColorsHQ( const byte* colorBlock, byte* minColor, byte* maxColor, bool noBlack ) const;
 	int					GetSquareCTX1Error( const byte* colorBlock, const byte* color0, const byte* color1, int lastError ) const;
 	int					GetMinMaxCTX1HQ( const byte* colorBlock, byte* minColor, byte* maxColor ) const;
 	int					GetSquareNormalYError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const;
+	int					GetSquareNormalYError_Generic( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const;
+	int					GetSquareNormalYError_SSE2( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const;
 	int					GetMinMaxNormalYHQ( const byte* colorBlock, byte* minColor, byte* maxColor, bool noBlack, int scale ) const;
 	int					GetSquareNormalsDXT1Error( const int* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, unsigned int& colorIndices ) const;
 	int					GetMinMaxNormalsDXT1HQ( const byte* colorBlock, byte* minColor, byte* maxColor, unsigned int& colorIndices, bool noBlack ) const;
@@ -251,6 +255,8 @@ private:
 	void				RotateNormalsDXT1( byte* block ) const;
 	void				RotateNormalsDXT5( byte* block ) const;
 	int					FindColorIndices( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const;
+	int					FindColorIndices_Generic( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const;
+	int					FindColorIndices_SSE2( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const;
 	int					FindAlphaIndices( const byte* colorBlock, const int alphaOffset, const byte alpha0, const byte alpha1, byte* indexes ) const;
 	int					FindCTX1Indices( const byte* colorBlock, const byte* color0, const byte* color1, unsigned int& result ) const;
 	
@@ -378,6 +384,39 @@ ID_INLINE void idDxtEncoder::CompressNormalMapDXN2Fast( const byte* inBuf, byte*
 	CompressNormalMapDXN2Fast_Generic( inBuf, outBuf, width, height );
 }
 
+/*
+========================
+idDxtEncoder::GetSquareColorsError
+
+The high quality kernels only have SSE2 versions, like the rest of the encoder.
+There is no AVX2 version because the CPU detection has no AVX2 flag to select it.
+========================
+*/
+ID_INLINE int idDxtEncoder::GetSquareColorsError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const
+{
+	return GetSquareColorsError_SSE2( colorBlock, color0, color1, lastError );
+}
+
+/*
+========================
+idDxtEncoder::GetSquareNormalYError
+========================
+*/
+ID_INLINE int idDxtEncoder::GetSquareNormalYError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const
+{
+	return GetSquareNormalYError_SSE2( colorBlock, color0, color1, lastError, scale );
+}
+
+/*
+========================
+idDxtEncoder::FindColorIndices
+========================
+*/
+ID_INLINE int idDxtEncoder::FindColorIndices( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const
+{
+	return FindColorIndices_SSE2( colorBlock, color0, color1, result );
+}
+
 /*
 ========================
 idDxtEncoder::EmitByte
@@ -502,6 +541,37 @@ ID_INLINE byte idDxtEncoder::GreenFrom565( unsigned short c565 ) const
 	return ( c | ( c >> 6 ) );
 }
 
+/*
+================================================
+idDxtParallelEncoder compresses Images on the job threads. The Image is split into horizontal
+strips of whole 4x4 block rows, each strip is an independent sub-image that is compressed by
+its own idDxtEncoder, so any of the compression functions can be used for the strips.
+================================================
+*/
+class idDxtParallelEncoder
+{
+public:
+	typedef void ( idDxtEncoder::*compressFunc_t )( const byte* inBuf, byte* outBuf, int width, int height );
+	
+	static const int	DXT1_BLOCK_BYTES = 8;		// DXT1, CTX1, DXN1
+	static const int	DXT5_BLOCK_BYTES = 16;		// DXT5, YCoCg DXT5, DXN2
+	
+	static const int	MAX_STRIPS = 64;
+	static const int	MIN_STRIP_BLOCK_ROWS = 8;
+	
+	static void			Init();
+	static void			Shutdown();
+	
+	// compresses the image with the given compression function, small images and images that are not
+	// a multiple of 4 in size are compressed on the calling thread, as is everything when parallel is false
+	// or when another thread is already using the job threads
+	static void			CompressImage( compressFunc_t compress, int blockBytes, const byte* inBuf, byte* outBuf, int width, int height, bool parallel = true );
+	
+private:
+	static idParallelJobList* 	jobList;
+	static idSysMutex			jobListMutex;
+};
+
 /*
 ================================================
 idDxtDecoder decodes DXT-compressed Images. Raw output Images are in
@@ -548,7 +548,7 @@ int idDxtEncoder::GetMinMaxAlphaHQ( const byte* colorBlock, const int alphaOffse
 
 /*
 ========================
-idDxtEncoder::GetSquareColorsError
+idDxtEncoder::GetSquareColorsError_Generic
 
 params:	colorBlock	- 16 pixel block for which to find color indexes
 paramO:	color0		- 4 byte min color found
@@ -556,7 +556,7 @@ paramO:	color1		- 4 byte max color found
 return: 4 byte color index block
 ========================
 */
-int idDxtEncoder::GetSquareColorsError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const
+int idDxtEncoder::GetSquareColorsError_Generic( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const
 {
 	int i, j;
 	byte colors[4][4];
@@ -608,7 +608,7 @@ int idDxtEncoder::GetSquareColorsError( const byte* colorBlock, const unsigned s
 
 /*
 ========================
-idDxtEncoder::GetSquareNormalYError
+idDxtEncoder::GetSquareNormalYError_Generic
 
 params:	colorBlock	- 16 pixel block for which to find color indexes
 paramO:	color0		- 4 byte min color found
@@ -616,7 +616,7 @@ paramO:	color1		- 4 byte max color found
 return: 4 byte color index block
 ========================
 */
-int idDxtEncoder::GetSquareNormalYError( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const
+int idDxtEncoder::GetSquareNormalYError_Generic( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const
 {
 	int i, j;
 	byte colors[4][4];
@@ -1931,7 +1931,7 @@ int idDxtEncoder::GetMinMaxNormalsDXT5HQFast( const byte* colorBlock, byte* minC
 
 /*
 ========================
-idDxtEncoder::FindColorIndices
+idDxtEncoder::FindColorIndices_Generic
 
 params:	colorBlock	- 16 pixel block for which find color indexes
 paramO:	color0		- Min color found
@@ -1939,7 +1939,7 @@ paramO:	color1		- Max color found
 return: 4 byte color index block
 ========================
 */
-int idDxtEncoder::FindColorIndices( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const
+int idDxtEncoder::FindColorIndices_Generic( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const
 {
 	int i, j;
 	unsigned int indexes[16];
@@ -5210,3 +5210,121 @@ void idDxtEncoder::ConvertImageDXN1_DXT1( const byte* inBuf, byte* outBuf, int w
 		inBuf += srcPadding;
 	}
 }
+
+/*
+================================================================================================
+
+	idDxtParallelEncoder
+
+================================================================================================
+*/
+
+typedef struct dxtStrip_s
+{
+	idDxtParallelEncoder::compressFunc_t	compress;
+	const byte* 							inBuf;
+	byte* 									outBuf;
+	int										width;
+	int										height;
+} dxtStrip_t;
+
+idParallelJobList* idDxtParallelEncoder::jobList = NULL;
+idSysMutex idDxtParallelEncoder::jobListMutex;
+
+static dxtStrip_t dxtStrips[idDxtParallelEncoder::MAX_STRIPS];
+
+/*
+========================
+CompressStripJob
+========================
+*/
+void CompressStripJob( const dxtStrip_t* strip )
+{
+	idDxtEncoder dxt;
+	( dxt.*strip->compress )( strip->inBuf, strip->outBuf, strip->width, strip->height );
+}
+
+REGISTER_PARALLEL_JOB( CompressStripJob, "CompressStripJob" );
+
+/*
+========================
+idDxtParallelEncoder::Init
+========================
+*/
+void idDxtParallelEncoder::Init()
+{
+	if( jobList == NULL )
+	{
+		jobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, MAX_STRIPS, 0, NULL );
+	}
+}
+
+/*
+========================
+idDxtParallelEncoder::Shutdown
+========================
+*/
+void idDxtParallelEncoder::Shutdown()
+{
+	if( jobList != NULL )
+	{
+		idScopedCriticalSection lock( jobListMutex );
+		parallelJobManager->FreeJobList( jobList );
+		jobList = NULL;
+	}
+}
+
+/*
+========================
+idDxtParallelEncoder::CompressImage
+
+params:	compress	- compression function used for every strip
+params:	blockBytes	- number of bytes of a compressed 4x4 block
+params:	inBuf		- image to compress
+paramO:	outBuf		- result of compression
+params:	width		- width of image
+params:	height		- height of image
+params:	parallel	- compress the strips on the job threads
+========================
+*/
+void idDxtParallelEncoder::CompressImage( compressFunc_t compress, int blockBytes, const byte* inBuf, byte* outBuf, int width, int height, bool parallel )
+{
+	const int numBlockRows = height >> 2;
+	const int stripBlockRows = Max( MIN_STRIP_BLOCK_ROWS, ( numBlockRows + MAX_STRIPS - 1 ) / MAX_STRIPS );
+	
+	if( !parallel || jobList == NULL || width < 4 || ( width & 3 ) != 0 || ( height & 3 ) != 0 || numBlockRows <= stripBlockRows )
+	{
+		idDxtEncoder dxt;
+		( dxt.*compress )( inBuf, outBuf, width, height );
+		return;
+	}
+	
+	// only one image is compressed on the job threads at a time, when the job threads are busy it
+	// is faster to compress on this thread than to wait for them
+	if( !jobListMutex.Lock( false ) )
+	{
+		idDxtEncoder dxt;
+		( dxt.*compress )( inBuf, outBuf, width, height );
+		return;
+	}
+	
+	const int inRowBytes = width * 4 * 4;
+	const int outRowBytes = ( width >> 2 ) * blockBytes;
+	
+	int numStrips = 0;
+	for( int blockRow = 0; blockRow < numBlockRows; blockRow += stripBlockRows )
+	{
+		dxtStrip_t& strip = dxtStrips[numStrips++];
+		strip.compress = compress;
+		strip.inBuf = inBuf + blockRow * inRowBytes;
+		strip.outBuf = outBuf + blockRow * outRowBytes;
+		strip.width = width;
+		strip.height = Min( stripBlockRows, numBlockRows - blockRow ) * 4;
+		jobList->AddJob( ( jobRun_t )CompressStripJob, &strip );
+	}
+	
+	jobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+	jobList->Wait();
+	
+	jobListMutex.Unlock();
+}
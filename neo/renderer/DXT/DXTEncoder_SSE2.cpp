@@ -58,6 +58,7 @@ typedef uint32	dword;
 ALIGN16( static __m128i SIMD_SSE2_zero ) = _mm_set_epi32( 0, 0, 0, 0 );
 ALIGN16( static dword SIMD_SSE2_dword_byte_mask[4] ) = { 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF };
 ALIGN16( static dword SIMD_SSE2_dword_word_mask[4] ) = { 0x0000FFFF, 0x0000FFFF, 0x0000FFFF, 0x0000FFFF };
+ALIGN16( static dword SIMD_SSE2_dword_rgb_mask[4] )   = { 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF, 0x00FFFFFF };
 ALIGN16( static dword SIMD_SSE2_dword_red_mask[4] )   = { 0x000000FF, 0x000000FF, 0x000000FF, 0x000000FF };
 ALIGN16( static dword SIMD_SSE2_dword_green_mask[4] ) = { 0x0000FF00, 0x0000FF00, 0x0000FF00, 0x0000FF00 };
 ALIGN16( static dword SIMD_SSE2_dword_blue_mask[4] )  = { 0x00FF0000, 0x00FF0000, 0x00FF0000, 0x00FF0000 };
@@ -1627,3 +1628,250 @@ void idDxtEncoder::CompressNormalMapDXT5Fast_SSE2( const byte* inBuf, byte* outB
 #endif
 }
 
+/*
+========================
+ColorDistances_SSE2
+
+params:	pixels01	- pixels 0 and 1 unpacked to words with zero alpha
+params:	pixels23	- pixels 2 and 3 unpacked to words with zero alpha
+params:	color		- color unpacked to words with zero alpha, in both halves
+return: squared RGB distances of the 4 pixels to the color
+========================
+*/
+ID_INLINE static __m128i ColorDistances_SSE2( const __m128i& pixels01, const __m128i& pixels23, const __m128i& color )
+{
+	__m128i dist01 = _mm_sub_epi16( pixels01, color );
+	__m128i dist23 = _mm_sub_epi16( pixels23, color );
+	dist01 = _mm_madd_epi16( dist01, dist01 );
+	dist23 = _mm_madd_epi16( dist23, dist23 );
+	__m128 rg = _mm_shuffle_ps( _mm_castsi128_ps( dist01 ), _mm_castsi128_ps( dist23 ), R_SHUFFLE_D( 0, 2, 0, 2 ) );
+	__m128 ba = _mm_shuffle_ps( _mm_castsi128_ps( dist01 ), _mm_castsi128_ps( dist23 ), R_SHUFFLE_D( 1, 3, 1, 3 ) );
+	return _mm_add_epi32( _mm_castps_si128( rg ), _mm_castps_si128( ba ) );
+}
+
+/*
+========================
+HorizontalSum_SSE2
+========================
+*/
+ID_INLINE static int HorizontalSum_SSE2( const __m128i& v )
+{
+	__m128i sum = _mm_add_epi32( v, _mm_shuffle_epi32( v, R_SHUFFLE_D( 2, 3, 0, 1 ) ) );
+	sum = _mm_add_epi32( sum, _mm_shuffle_epi32( sum, R_SHUFFLE_D( 1, 0, 3, 2 ) ) );
+	return _mm_cvtsi128_si32( sum );
+}
+
+/*
+========================
+idDxtEncoder::GetSquareColorsError_SSE2
+
+params:	colorBlock	- 16 pixel block for which to find color indexes
+paramO:	color0		- 4 byte min color found
+paramO:	color1		- 4 byte max color found
+return: 4 byte color index block
+========================
+*/
+int idDxtEncoder::GetSquareColorsError_SSE2( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError ) const
+{
+	ALIGN16( byte colors[4][4] );
+	
+	ColorFrom565( color0, colors[0] );
+	ColorFrom565( color1, colors[1] );
+	
+	if( color0 > color1 )
+	{
+		colors[2][0] = ( 2 * colors[0][0] + 1 * colors[1][0] ) / 3;
+		colors[2][1] = ( 2 * colors[0][1] + 1 * colors[1][1] ) / 3;
+		colors[2][2] = ( 2 * colors[0][2] + 1 * colors[1][2] ) / 3;
+		colors[3][0] = ( 1 * colors[0][0] + 2 * colors[1][0] ) / 3;
+		colors[3][1] = ( 1 * colors[0][1] + 2 * colors[1][1] ) / 3;
+		colors[3][2] = ( 1 * colors[0][2] + 2 * colors[1][2] ) / 3;
+	}
+	else
+	{
+		colors[2][0] = ( 1 * colors[0][0] + 1 * colors[1][0] ) / 2;
+		colors[2][1] = ( 1 * colors[0][1] + 1 * colors[1][1] ) / 2;
+		colors[2][2] = ( 1 * colors[0][2] + 1 * colors[1][2] ) / 2;
+		colors[3][0] = 0;
+		colors[3][1] = 0;
+		colors[3][2] = 0;
+	}
+	colors[0][3] = colors[1][3] = colors[2][3] = colors[3][3] = 0;
+	
+	__m128i zero = _mm_setzero_si128();
+	__m128i palette[4];
+	for( int j = 0; j < 4; j++ )
+	{
+		palette[j] = _mm_unpacklo_epi8( _mm_shuffle_epi32( _mm_cvtsi32_si128( *( int* )colors[j] ), R_SHUFFLE_D( 0, 0, 0, 0 ) ), zero );
+	}
+	
+	__m128i error = zero;
+	for( int i = 0; i < 4; i++ )
+	{
+		__m128i pixels = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )&colorBlock[i * 16] ), ( const __m128i& )SIMD_SSE2_dword_rgb_mask );
+		__m128i pixels01 = _mm_unpacklo_epi8( pixels, zero );
+		__m128i pixels23 = _mm_unpackhi_epi8( pixels, zero );
+		
+		__m128i minDist = ColorDistances_SSE2( pixels01, pixels23, palette[0] );
+		for( int j = 1; j < 4; j++ )
+		{
+			__m128i dist = ColorDistances_SSE2( pixels01, pixels23, palette[j] );
+			__m128i less = _mm_cmplt_epi32( dist, minDist );
+			minDist = _mm_or_si128( _mm_and_si128( less, dist ), _mm_andnot_si128( less, minDist ) );
+		}
+		// accumulated error, early out like the generic version
+		error = _mm_add_epi32( error, minDist );
+		
+		if( HorizontalSum_SSE2( error ) > lastError )
+		{
+			break;
+		}
+	}
+	return HorizontalSum_SSE2( error );
+}
+
+/*
+========================
+idDxtEncoder::GetSquareNormalYError_SSE2
+
+params:	colorBlock	- 16 pixel block for which to find color indexes
+paramO:	color0		- 4 byte min color found
+paramO:	color1		- 4 byte max color found
+return: 4 byte color index block
+========================
+*/
+int idDxtEncoder::GetSquareNormalYError_SSE2( const byte* colorBlock, const unsigned short color0, const unsigned short color1, int lastError, int scale ) const
+{
+	byte colors[4][4];
+	
+	ColorFrom565( color0, colors[0] );
+	ColorFrom565( color1, colors[1] );
+	
+	if( color0 > color1 )
+	{
+		colors[2][0] = ( 2 * colors[0][0] + 1 * colors[1][0] ) / 3;
+		colors[2][1] = ( 2 * colors[0][1] + 1 * colors[1][1] ) / 3;
+		colors[2][2] = ( 2 * colors[0][2] + 1 * colors[1][2] ) / 3;
+		colors[3][0] = ( 1 * colors[0][0] + 2 * colors[1][0] ) / 3;
+		colors[3][1] = ( 1 * colors[0][1] + 2 * colors[1][1] ) / 3;
+		colors[3][2] = ( 1 * colors[0][2] + 2 * colors[1][2] ) / 3;
+	}
+	else
+	{
+		colors[2][0] = ( 1 * colors[0][0] + 1 * colors[1][0] ) / 2;
+		colors[2][1] = ( 1 * colors[0][1] + 1 * colors[1][1] ) / 2;
+		colors[2][2] = ( 1 * colors[0][2] + 1 * colors[1][2] ) / 2;
+		colors[3][0] = 0;
+		colors[3][1] = 0;
+		colors[3][2] = 0;
+	}
+	
+	// the divisions are kept so the truncated distances are exactly the same as the generic version
+	__m128 scaleY = _mm_set1_ps( ( float )scale );
+	__m128 paletteY[4];
+	for( int j = 0; j < 4; j++ )
+	{
+		paletteY[j] = _mm_set1_ps( ( float ) colors[j][1] / scale );
+	}
+	
+	__m128i error = _mm_setzero_si128();
+	for( int i = 0; i < 4; i++ )
+	{
+		__m128i pixels = _mm_loadu_si128( ( const __m128i* )&colorBlock[i * 16] );
+		__m128i green = _mm_and_si128( _mm_srli_epi32( pixels, 8 ), ( const __m128i& )SIMD_SSE2_dword_byte_mask );
+		__m128 y = _mm_div_ps( _mm_cvtepi32_ps( green ), scaleY );
+		
+		__m128 delta = _mm_sub_ps( y, paletteY[0] );
+		__m128 minDist = _mm_mul_ps( delta, delta );
+		for( int j = 1; j < 4; j++ )
+		{
+			delta = _mm_sub_ps( y, paletteY[j] );
+			minDist = _mm_min_ps( minDist, _mm_mul_ps( delta, delta ) );
+		}
+		// accumulated error, early out like the generic version
+		error = _mm_add_epi32( error, _mm_cvttps_epi32( minDist ) );
+		
+		if( HorizontalSum_SSE2( error ) > lastError )
+		{
+			break;
+		}
+	}
+	return HorizontalSum_SSE2( error );
+}
+
+/*
+========================
+idDxtEncoder::FindColorIndices_SSE2
+
+params:	colorBlock	- 16 pixel block for which find color indexes
+paramO:	color0		- Min color found
+paramO:	color1		- Max color found
+return: 4 byte color index block
+========================
+*/
+int idDxtEncoder::FindColorIndices_SSE2( const byte* colorBlock, const unsigned short color0, const unsigned short color1, unsigned int& result ) const
+{
+	ALIGN16( unsigned int indexes[16] );
+	ALIGN16( byte colors[4][4] );
+	
+	ColorFrom565( color0, colors[0] );
+	ColorFrom565( color1, colors[1] );
+	
+	if( color0 > color1 )
+	{
+		colors[2][0] = ( 2 * colors[0][0] + 1 * colors[1][0] ) / 3;
+		colors[2][1] = ( 2 * colors[0][1] + 1 * colors[1][1] ) / 3;
+		colors[2][2] = ( 2 * colors[0][2] + 1 * colors[1][2] ) / 3;
+		colors[3][0] = ( 1 * colors[0][0] + 2 * colors[1][0] ) / 3;
+		colors[3][1] = ( 1 * colors[0][1] + 2 * colors[1][1] ) / 3;
+		colors[3][2] = ( 1 * colors[0][2] + 2 * colors[1][2] ) / 3;
+	}
+	else
+	{
+		colors[2][0] = ( 1 * colors[0][0] + 1 * colors[1][0] ) / 2;
+		colors[2][1] = ( 1 * colors[0][1] + 1 * colors[1][1] ) / 2;
+		colors[2][2] = ( 1 * colors[0][2] + 1 * colors[1][2] ) / 2;
+		colors[3][0] = 0;
+		colors[3][1] = 0;
+		colors[3][2] = 0;
+	}
+	colors[0][3] = colors[1][3] = colors[2][3] = colors[3][3] = 0;
+	
+	__m128i zero = _mm_setzero_si128();
+	__m128i palette[4];
+	for( int j = 0; j < 4; j++ )
+	{
+		palette[j] = _mm_unpacklo_epi8( _mm_shuffle_epi32( _mm_cvtsi32_si128( *( int* )colors[j] ), R_SHUFFLE_D( 0, 0, 0, 0 ) ), zero );
+	}
+	
+	__m128i error = zero;
+	for( int i = 0; i < 4; i++ )
+	{
+		__m128i pixels = _mm_and_si128( _mm_loadu_si128( ( const __m128i* )&colorBlock[i * 16] ), ( const __m128i& )SIMD_SSE2_dword_rgb_mask );
+		__m128i pixels01 = _mm_unpacklo_epi8( pixels, zero );
+		__m128i pixels23 = _mm_unpackhi_epi8( pixels, zero );
+		
+		// ties keep the lowest index like the generic version
+		__m128i minDist = ColorDistances_SSE2( pixels01, pixels23, palette[0] );
+		__m128i minIndex = zero;
+		for( int j = 1; j < 4; j++ )
+		{
+			__m128i dist = ColorDistances_SSE2( pixels01, pixels23, palette[j] );
+			__m128i less = _mm_cmplt_epi32( dist, minDist );
+			minDist = _mm_or_si128( _mm_and_si128( less, dist ), _mm_andnot_si128( less, minDist ) );
+			minIndex = _mm_or_si128( _mm_and_si128( less, _mm_set1_epi32( j ) ), _mm_andnot_si128( less, minIndex ) );
+		}
+		_mm_store_si128( ( __m128i* )&indexes[i * 4], minIndex );
+		
+		// accumulated error
+		error = _mm_add_epi32( error, minDist );
+	}
+	
+	result = 0;
+	for( int i = 0; i < 16; i++ )
+	{
+		result |= ( indexes[i] << ( unsigned int )( i << 1 ) );
+	}
+	
+	return HorizontalSum_SSE2( error );
+}
@@ -108,6 +108,12 @@ void idGuiModel::EmitSurfaces( float modelMatrix[16], float modelViewMatrix[16],
 							   bool depthHack, bool allowFullScreenStereoDepth, bool linkAsEntity )
 {
 
+	// the handles of surfaces are built by offsetting into the blocks, which doesn't work if they overflowed
+	if( vertexCache.CacheIsOverflow( vertexBlock ) || vertexCache.CacheIsOverflow( indexBlock ) )
+	{
+		return;
+	}
+	
 	viewEntity_t* guiSpace = ( viewEntity_t* )R_ClearedFrameAlloc( sizeof( *guiSpace ), FRAME_ALLOC_VIEW_ENTITY );
 	memcpy( guiSpace->modelMatrix, modelMatrix, sizeof( guiSpace->modelMatrix ) );
 	memcpy( guiSpace->modelViewMatrix, modelViewMatrix, sizeof( guiSpace->modelViewMatrix ) );
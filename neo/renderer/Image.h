@@ -182,14 +182,38 @@ public:
 		return texnum != TEXTURE_NOT_LOADED;
 	}
 	
+	bool		IsStreamed() const
+	{
+		return streamed;
+	}
+	
+	// called by the frontend for every streamed image a visible surface samples, with
+	// the size in pixels the surface covers on screen
+	void		RecordStreamingUsage( int screenSize );
+	
 	static void			GetGeneratedName( idStr& _name, const textureUsage_t& _usage, const cubeFiles_t& _cube );
 	
 private:
 	friend class idImageManager;
 	
-	void				AllocImage();
+	void				AllocImage( int baseLevel = 0 );
 	void				DeriveOpts();
 	
+	// the steps of ActuallyLoadImage, LoadLevelImages reads and decodes the
+	// binary images on the job threads in between
+	void				PrepareLoad( idStr& generatedName );
+	bool				ApplyBinaryHeader( idBinaryImage& im );
+	void				UploadBinaryImage( idBinaryImage& im );
+	
+	// mip streaming, the levels above streamLevel have no storage and are
+	// excluded with GL_TEXTURE_BASE_LEVEL
+	bool				IsStreamable() const;
+	int					StreamResidentLevel() const;
+	int					StorageSize( int baseLevel ) const;
+	void				AllocLevel( int uploadTarget, int level, int width, int height );
+	void				AllocStreamLevels( int level );		// makes room for the levels down to level
+	void				PurgeStreamLevels( int level );		// releases the levels above level
+	
 	// parameters that define this image
 	idStr				imgName;				// game path, including extension (except for cube maps), may be an image program
 	cubeFiles_t			cubeFiles;				// If this is a cube map, and if so, what kind
@@ -209,6 +233,13 @@ private:
 	
 	int					refCount;				// overall ref count
 	
+	bool				streamed;				// only the levels from streamLevel down are resident
+	bool				streamPending;			// a streaming request is in flight
+	int					streamLevel;			// most detailed resident level
+	int					streamResidentLevel;	// level that always stays resident
+	int					streamWantedLevel;		// most detailed level the frontend asked for in streamUsedFrame
+	int					streamUsedFrame;		// tr.frameCount when a surface last used the image
+	
 	static const GLuint TEXTURE_NOT_LOADED = 0xFFFFFFFF;
 	
 	GLuint				texnum;				// gl texture binding
@@ -239,6 +270,13 @@ ID_INLINE idImage::idImage( const char* name ) : imgName( name )
 	sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	binaryFileTime = FILE_NOT_FOUND_TIMESTAMP;
 	refCount = 0;
+	
+	streamed = false;
+	streamPending = false;
+	streamLevel = 0;
+	streamResidentLevel = 0;
+	streamWantedLevel = 0;
+	streamUsedFrame = 0;
 }
 
 
@@ -247,6 +285,9 @@ void	R_WriteTGA( const char* filename, const byte* data, int width, int height,
 // data is in top-to-bottom raster order unless flipVertical is set
 
 
+class idScreenRect;
+class idImageStreamThread;
+struct imageLoadJob_t;
 
 class idImageManager
 {
@@ -256,6 +297,9 @@ public:
 	{
 		insideLevelLoad = false;
 		preloadingMapImages = false;
+		streamThread = NULL;
+		loadJobList = NULL;
+		ClearLevelLoadTimes();
 	}
 	
 	void				Init();
@@ -307,6 +351,36 @@ public:
 	// Loads unloaded level images
 	int					LoadLevelImages( bool pacifier );
 	
+	// LoadLevelImages reads the binary image files on this thread, decodes them on the
+	// job threads and uploads them on this thread again
+	void				ReadLoadJob( imageLoadJob_t& job, idImage* image );
+	void				FinishLoadJob( imageLoadJob_t& job );
+	
+	void				ClearLevelLoadTimes();
+	void				PrintLevelLoadTimes() const;
+	
+	// mip streaming, see Image_streaming.cpp
+	void				InitStreaming();
+	void				ShutdownStreaming();
+	
+	// called once a frame on the render thread, uploads the levels that finished
+	// loading, evicts levels over the budget and issues new requests
+	void				UpdateStreaming();
+	
+	// waits for the requests in flight and throws their data away, must be called
+	// before streamed images are purged
+	void				FlushStreaming();
+	
+	// records the images of all the material stages for streaming
+	void				RecordStreamingUsage( const idMaterial* material, const idScreenRect& rect );
+	
+	// uploads or throws away the data of the finished requests, returns the uploaded bytes
+	int					FinishStreamRequests( bool upload );
+	
+	// compresses the image file into its generated binary image, returns the number of
+	// source pixels or 0 if the file couldn't be loaded
+	int					GenerateBinaryImage( const char* name, textureUsage_t usage );
+	
 	// used to clear and then write the dds conversion batch file
 	void				StartBuild();
 	void				FinishBuild( bool removeDups = false );
@@ -344,6 +418,18 @@ public:
 	
 	bool				insideLevelLoad;			// don't actually load images now
 	bool				preloadingMapImages;		// unless this is set
+	
+	idImageStreamThread* streamThread;				// reads the streaming requests
+	
+	idParallelJobList* 	loadJobList;				// decodes the binary images in LoadLevelImages
+	
+	// time spent loading the images of the current level
+	int					levelLoadCount;
+	int					levelLoadSerialCount;			// images loaded with ActuallyLoadImage
+	uint64				levelLoadIOMicroSec;
+	uint64				levelLoadDecodeMicroSec;		// summed over the job threads
+	uint64				levelLoadUploadMicroSec;
+	uint64				levelLoadSerialMicroSec;
 };
 
 extern idImageManager*	globalImages;		// pointer to global list for the rest of the system
@@ -383,6 +469,9 @@ void R_LoadImage( const char* name, byte** pic, int* width, int* height, ID_TIME
 // pic is in top to bottom raster format
 bool R_LoadCubeImages( const char* cname, cubeFiles_t extensions, byte* pic[6], int* size, ID_TIME_T* timestamp );
 
+// compresses an image corpus with every DXT quality tier and reports speed and error
+void R_DXTBenchmark_f( const idCmdArgs& args );
+
 /*
 ====================================================================
 
@@ -31,6 +31,7 @@ If you have questions concerning this license or the applicable additional terms
 
 
 #include "tr_local.h"
+#include "DXT/DXTCodec.h"
 
 // do this with a pointer, in case we want to make the actual manager
 // a private virtual subclass
@@ -38,6 +39,24 @@ idImageManager	imageManager;
 idImageManager* globalImages = &imageManager;
 
 idCVar preLoad_Images( "preLoad_Images", "1", CVAR_SYSTEM | CVAR_BOOL, "preload images during beginlevelload" );
+idCVar image_parallelLoad( "image_parallelLoad", "1", CVAR_RENDERER | CVAR_BOOL, "decode the binary images of a level on the job threads" );
+
+static const int IMAGE_LOAD_BATCH = 32;
+
+struct imageLoadJob_t
+{
+	idImage* 			image;
+	idBinaryImage* 		im;					// NULL if the image is left to ActuallyLoadImage
+	void* 				buffer;				// contents of the binary image file
+	int					length;
+	ID_TIME_T			sourceFileTime;
+	ID_TIME_T			binaryFileTime;
+	bool				decoded;
+	int					decodeMicroSec;
+};
+
+// one batch is decoded while the one before it is uploaded
+static imageLoadJob_t imageLoadJobs[2][IMAGE_LOAD_BATCH];
 
 /*
 ===============
@@ -631,6 +650,8 @@ void idImageManager::PurgeAllImages()
 	int		i;
 	idImage*	image;
 	
+	FlushStreaming();
+	
 	for( i = 0; i < images.Num() ; i++ )
 	{
 		image = images[i];
@@ -645,6 +666,8 @@ ReloadImages
 */
 void idImageManager::ReloadImages( bool all )
 {
+	FlushStreaming();
+	
 	for( int i = 0 ; i < globalImages->images.Num() ; i++ )
 	{
 		globalImages->images[ i ]->Reload( all );
@@ -742,6 +765,88 @@ void R_CombineCubeImages_f( const idCmdArgs& args )
 	common->SetRefreshOnPrint( false );
 }
 
+/*
+===============
+R_CompressImages_f
+
+Regenerates the compressed binary images of all the image files in a directory tree
+
+compressImages <directory> [diffuse|specular|bump|default]
+===============
+*/
+void R_CompressImages_f( const idCmdArgs& args )
+{
+	if( args.Argc() < 2 || args.Argc() > 3 )
+	{
+		common->Printf( "usage: compressImages <directory> [diffuse|specular|bump|default]\n" );
+		return;
+	}
+	
+	textureUsage_t usage = TD_DIFFUSE;
+	if( args.Argc() == 3 )
+	{
+		const char* usageName = args.Argv( 2 );
+		if( idStr::Icmp( usageName, "specular" ) == 0 )
+		{
+			usage = TD_SPECULAR;
+		}
+		else if( idStr::Icmp( usageName, "bump" ) == 0 )
+		{
+			usage = TD_BUMP;
+		}
+		else if( idStr::Icmp( usageName, "default" ) == 0 )
+		{
+			usage = TD_DEFAULT;
+		}
+		else if( idStr::Icmp( usageName, "diffuse" ) != 0 )
+		{
+			common->Printf( "unknown usage '%s'\n", usageName );
+			return;
+		}
+	}
+	
+	const char* extensions[] = { ".tga", ".png", ".jpg" };
+	idStrList fileNames;
+	for( int i = 0; i < sizeof( extensions ) / sizeof( extensions[0] ); i++ )
+	{
+		idFileList* files = fileSystem->ListFilesTree( args.Argv( 1 ), extensions[i], true );
+		fileNames.Append( files->GetList() );
+		fileSystem->FreeFileList( files );
+	}
+	
+	if( fileNames.Num() == 0 )
+	{
+		common->Printf( "no images found in %s\n", args.Argv( 1 ) );
+		return;
+	}
+	
+	common->SetRefreshOnPrint( true );
+	
+	int numCompressed = 0;
+	int64 numPixels = 0;
+	const uint64 start = Sys_Microseconds();
+	for( int i = 0; i < fileNames.Num(); i++ )
+	{
+		common->Printf( "%4i/%i %s\n", i + 1, fileNames.Num(), fileNames[i].c_str() );
+		
+		const int pixels = globalImages->GenerateBinaryImage( fileNames[i], usage );
+		if( pixels == 0 )
+		{
+			common->Printf( "couldn't load %s\n", fileNames[i].c_str() );
+			continue;
+		}
+		numCompressed++;
+		numPixels += pixels;
+	}
+	const uint64 end = Sys_Microseconds();
+	
+	common->SetRefreshOnPrint( false );
+	
+	const float seconds = Max( end - start, ( uint64 )1 ) * 0.000001f;
+	common->Printf( "%i of %i images compressed in %.1f seconds, %.2f images/sec, %.2f MPixels/sec\n",
+					numCompressed, fileNames.Num(), seconds, numCompressed / seconds, numPixels / seconds * 0.000001f );
+}
+
 /*
 ===============
 UnbindAll
@@ -785,6 +890,14 @@ void idImageManager::Init()
 	cmdSystem->AddCommand( "reloadImages", R_ReloadImages_f, CMD_FL_RENDERER, "reloads images" );
 	cmdSystem->AddCommand( "listImages", R_ListImages_f, CMD_FL_RENDERER, "lists images" );
 	cmdSystem->AddCommand( "combineCubeImages", R_CombineCubeImages_f, CMD_FL_RENDERER, "combines six images for roq compression" );
+	cmdSystem->AddCommand( "compressImages", R_CompressImages_f, CMD_FL_RENDERER, "regenerates the compressed binary images of a directory" );
+	cmdSystem->AddCommand( "dxtBenchmark", R_DXTBenchmark_f, CMD_FL_RENDERER, "reports DXT compression speed and error for each quality tier" );
+	
+	idDxtParallelEncoder::Init();
+	
+	InitStreaming();
+	
+	loadJobList = parallelJobManager->AllocJobList( JOBLIST_UTILITY, JOBLIST_PRIORITY_MEDIUM, IMAGE_LOAD_BATCH, 0, NULL );
 	
 	// should forceLoadImages be here?
 }
@@ -796,9 +909,18 @@ Shutdown
 */
 void idImageManager::Shutdown()
 {
+	ShutdownStreaming();
+	
+	if( loadJobList != NULL )
+	{
+		parallelJobManager->FreeJobList( loadJobList );
+		loadJobList = NULL;
+	}
+	
 	images.DeleteContents( true );
 	imageHash.Clear();
 	
+	idDxtParallelEncoder::Shutdown();
 }
 
 /*
@@ -811,6 +933,9 @@ void idImageManager::BeginLevelLoad()
 {
 	insideLevelLoad = true;
 	
+	FlushStreaming();
+	ClearLevelLoadTimes();
+	
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
 		idImage*	image = images[ i ];
@@ -893,22 +1018,120 @@ void idImageManager::Preload( const idPreloadManifest& manifest, const bool& map
 	}
 }
 
+/*
+========================
+R_DecodeBinaryImageJob
+========================
+*/
+void R_DecodeBinaryImageJob( imageLoadJob_t* job )
+{
+	const uint64 start = Sys_Microseconds();
+	
+	idFile_Memory file( job->im->GetName(), ( const char* )job->buffer, job->length );
+	job->decoded = job->im->LoadFromGeneratedFile( &file, job->sourceFileTime );
+	
+	job->decodeMicroSec = ( int )( Sys_Microseconds() - start );
+}
+
+REGISTER_PARALLEL_JOB( R_DecodeBinaryImageJob, "R_DecodeBinaryImageJob" );
+
+/*
+===============
+idImageManager::ReadLoadJob
+===============
+*/
+void idImageManager::ReadLoadJob( imageLoadJob_t& job, idImage* image )
+{
+	const uint64 start = Sys_Microseconds();
+	
+	job.image = image;
+	job.im = NULL;
+	job.buffer = NULL;
+	job.length = 0;
+	job.decoded = false;
+	job.decodeMicroSec = 0;
+	
+	// streamed images only read their small levels, so they aren't worth a job
+	if( !image->IsStreamable() )
+	{
+		idStrStatic< MAX_OSPATH > generatedName;
+		image->PrepareLoad( generatedName );
+		
+		idStr binaryFileName;
+		idBinaryImage::GetGeneratedFileName( binaryFileName, generatedName );
+		job.length = fileSystem->ReadFile( binaryFileName, &job.buffer, &job.binaryFileTime );
+		if( job.buffer != NULL )
+		{
+			job.im = new( TAG_IMAGE ) idBinaryImage( generatedName );
+			job.sourceFileTime = image->sourceFileTime;
+		}
+	}
+	
+	levelLoadIOMicroSec += Sys_Microseconds() - start;
+}
+
+/*
+===============
+idImageManager::FinishLoadJob
+===============
+*/
+void idImageManager::FinishLoadJob( imageLoadJob_t& job )
+{
+	idImage* image = job.image;
+	
+	const uint64 start = Sys_Microseconds();
+	
+	bool uploaded = false;
+	if( job.decoded )
+	{
+		image->binaryFileTime = job.binaryFileTime;
+		if( image->ApplyBinaryHeader( *job.im ) )
+		{
+			image->UploadBinaryImage( *job.im );
+			uploaded = true;
+		}
+	}
+	
+	delete job.im;
+	job.im = NULL;
+	if( job.buffer != NULL )
+	{
+		fileSystem->FreeFile( job.buffer );
+		job.buffer = NULL;
+	}
+	
+	const uint64 end = Sys_Microseconds();
+	
+	if( uploaded )
+	{
+		levelLoadUploadMicroSec += end - start;
+	}
+	else
+	{
+		// missing or out of date binary images have to be generated again
+		image->ActuallyLoadImage( false );
+		levelLoadSerialCount++;
+		levelLoadSerialMicroSec += Sys_Microseconds() - end;
+	}
+	
+	levelLoadDecodeMicroSec += job.decodeMicroSec;
+	levelLoadCount++;
+}
+
 /*
 ===============
 idImageManager::LoadLevelImages
+
+The binary image files are read in batches on this thread, because the file
+system isn't thread safe.  While the job threads decode one batch, this thread
+uploads the one before it and then reads the next.
 ===============
 */
 int idImageManager::LoadLevelImages( bool pacifier )
 {
-	int	loadCount = 0;
+	idList< idImage*, TAG_IMAGE > loadImages;
 	for( int i = 0 ; i < images.Num() ; i++ )
 	{
-		if( pacifier )
-		{
-			common->UpdateLevelLoadPacifier();
-			
-		}
-		
 		idImage*	image = images[ i ];
 		if( image->generatorFunction )
 		{
@@ -916,11 +1139,105 @@ int idImageManager::LoadLevelImages( bool pacifier )
 		}
 		if( image->levelLoadReferenced && !image->IsLoaded() )
 		{
-			loadCount++;
-			image->ActuallyLoadImage( false );
+			loadImages.Append( image );
+		}
+	}
+	
+	if( loadJobList == NULL || !image_parallelLoad.GetBool() || !R_IsInitialized() )
+	{
+		for( int i = 0; i < loadImages.Num(); i++ )
+		{
+			if( pacifier )
+			{
+				common->UpdateLevelLoadPacifier();
+			}
+			
+			const uint64 start = Sys_Microseconds();
+			loadImages[i]->ActuallyLoadImage( false );
+			levelLoadSerialMicroSec += Sys_Microseconds() - start;
+			levelLoadSerialCount++;
+			levelLoadCount++;
+		}
+		return loadImages.Num();
+	}
+	
+	const int numBatches = ( loadImages.Num() + IMAGE_LOAD_BATCH - 1 ) / IMAGE_LOAD_BATCH;
+	int numDecoded = 0;
+	
+	for( int batch = 0; batch <= numBatches; batch++ )
+	{
+		imageLoadJob_t* jobs = imageLoadJobs[batch & 1];
+		imageLoadJob_t* decodedJobs = imageLoadJobs[( batch + 1 ) & 1];
+		
+		const int first = batch * IMAGE_LOAD_BATCH;
+		const int numJobs = Max( 0, Min( IMAGE_LOAD_BATCH, loadImages.Num() - first ) );
+		
+		// read this batch while the job threads decode the previous one
+		for( int i = 0; i < numJobs; i++ )
+		{
+			if( pacifier )
+			{
+				common->UpdateLevelLoadPacifier();
+			}
+			ReadLoadJob( jobs[i], loadImages[first + i] );
+		}
+		
+		loadJobList->Wait();
+		
+		bool submit = false;
+		for( int i = 0; i < numJobs; i++ )
+		{
+			if( jobs[i].im != NULL )
+			{
+				loadJobList->AddJob( ( jobRun_t )R_DecodeBinaryImageJob, &jobs[i] );
+				submit = true;
+			}
+		}
+		if( submit )
+		{
+			loadJobList->Submit( NULL, JOBLIST_PARALLELISM_MAX_CORES );
+		}
+		
+		// upload the previous batch while this one decodes
+		for( int i = 0; i < numDecoded; i++ )
+		{
+			if( pacifier )
+			{
+				common->UpdateLevelLoadPacifier();
+			}
+			FinishLoadJob( decodedJobs[i] );
 		}
+		numDecoded = numJobs;
 	}
-	return loadCount;
+	
+	return loadImages.Num();
+}
+
+/*
+===============
+idImageManager::ClearLevelLoadTimes
+===============
+*/
+void idImageManager::ClearLevelLoadTimes()
+{
+	levelLoadCount = 0;
+	levelLoadSerialCount = 0;
+	levelLoadIOMicroSec = 0;
+	levelLoadDecodeMicroSec = 0;
+	levelLoadUploadMicroSec = 0;
+	levelLoadSerialMicroSec = 0;
+}
+
+/*
+===============
+idImageManager::PrintLevelLoadTimes
+===============
+*/
+void idImageManager::PrintLevelLoadTimes() const
+{
+	common->Printf( "%5i images read in %5.1f seconds, decoded in %5.1f seconds on the job threads, uploaded in %5.1f seconds\n",
+					levelLoadCount - levelLoadSerialCount, levelLoadIOMicroSec * 0.000001, levelLoadDecodeMicroSec * 0.000001, levelLoadUploadMicroSec * 0.000001 );
+	common->Printf( "%5i images loaded serially in %5.1f seconds\n", levelLoadSerialCount, levelLoadSerialMicroSec * 0.000001 );
 }
 
 /*
@@ -938,10 +1255,47 @@ void idImageManager::EndLevelLoad()
 	
 	int	end = Sys_Milliseconds();
 	common->Printf( "%5i images loaded in %5.1f seconds\n", loadCount, ( end - start ) * 0.001 );
+	PrintLevelLoadTimes();
 	common->Printf( "----------------------------------------\n" );
 	//R_ListImages_f( idCmdArgs( "sorted sorted", false ) );
 }
 
+/*
+===============
+idImageManager::GenerateBinaryImage
+===============
+*/
+int idImageManager::GenerateBinaryImage( const char* name, textureUsage_t usage )
+{
+	idImage image( name );
+	image.usage = usage;
+	image.opts.textureType = TT_2D;
+	
+	int width, height;
+	byte* pic;
+	R_LoadImageProgram( name, &pic, &width, &height, &image.sourceFileTime, &image.usage );
+	if( pic == NULL )
+	{
+		return 0;
+	}
+	
+	image.opts.width = width;
+	image.opts.height = height;
+	image.opts.numLevels = 0;
+	image.DeriveOpts();
+	
+	idStrStatic< MAX_OSPATH > generatedName = name;
+	idImage::GetGeneratedName( generatedName, image.usage, CF_2D );
+	
+	idBinaryImage im( generatedName );
+	im.Load2DFromMemory( image.opts.width, image.opts.height, pic, image.opts.numLevels, image.opts.format, image.opts.colorFormat, image.opts.gammaMips );
+	im.WriteGeneratedFile( image.sourceFileTime );
+	
+	Mem_Free( pic );
+	
+	return width * height;
+}
+
 /*
 ===============
 idImageManager::StartBuild
@@ -31,6 +31,8 @@ If you have questions concerning this license or the applicable additional terms
 
 #include "tr_local.h"
 
+extern idCVar image_streamResidentSize;
+
 /*
 ================
 BitsForFormat
@@ -290,28 +292,14 @@ void idImage::GetGeneratedName( idStr& _name, const textureUsage_t& _usage, cons
 
 /*
 ===============
-ActuallyLoadImage
+PrepareLoad
 
-Absolutely every image goes through this path
-On exit, the idImage will have a valid OpenGL texture number that can be bound
+Finds the source file time and the storage options the generated
+binary image has to match.
 ===============
 */
-void idImage::ActuallyLoadImage( bool fromBackEnd )
+void idImage::PrepareLoad( idStr& generatedName )
 {
-
-	// if we don't have a rendering context yet, just return
-	if( !R_IsInitialized() )
-	{
-		return;
-	}
-	
-	// this is the ONLY place generatorFunction will ever be called
-	if( generatorFunction )
-	{
-		generatorFunction( this );
-		return;
-	}
-	
 	if( com_productionMode.GetInteger() != 0 )
 	{
 		sourceFileTime = FILE_NOT_FOUND_TIMESTAMP;
@@ -339,11 +327,100 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 	// Figure out opts.colorFormat and opts.format so we can make sure the binary image is up to date
 	DeriveOpts();
 	
-	idStrStatic< MAX_OSPATH > generatedName = GetName();
+	generatedName = GetName();
 	GetGeneratedName( generatedName, usage, cubeFiles );
+}
+
+/*
+===============
+ApplyBinaryHeader
+
+Takes the size and format from the binary image, returns false if the
+binary image is missing or out of date and has to be generated again.
+===============
+*/
+bool idImage::ApplyBinaryHeader( idBinaryImage& im )
+{
+	const bimageFile_t& header = im.GetFileHeader();
+	
+	if( ( fileSystem->InProductionMode() && binaryFileTime != FILE_NOT_FOUND_TIMESTAMP ) || ( ( binaryFileTime != FILE_NOT_FOUND_TIMESTAMP )
+			&& ( header.colorFormat == opts.colorFormat )
+			&& ( header.format == opts.format )
+			&& ( header.textureType == opts.textureType )
+																							) )
+	{
+		opts.width = header.width;
+		opts.height = header.height;
+		opts.numLevels = header.numLevels;
+		opts.colorFormat = ( textureColor_t )header.colorFormat;
+		opts.format = ( textureFormat_t )header.format;
+		opts.textureType = ( textureType_t )header.textureType;
+		if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
+		{
+			// for resource gathering write this image to the preload file for this map
+			fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
+		}
+		return true;
+	}
+	return false;
+}
+
+/*
+===============
+UploadBinaryImage
+===============
+*/
+void idImage::UploadBinaryImage( idBinaryImage& im )
+{
+	// streamed images start out with only the levels that stay resident
+	const int baseLevel = IsStreamable() ? StreamResidentLevel() : 0;
+	AllocImage( baseLevel );
+	
+	for( int i = 0; i < im.NumImages(); i++ )
+	{
+		const bimageImage_t& img = im.GetImageHeader( i );
+		if( img.level < baseLevel )
+		{
+			continue;
+		}
+		const byte* data = im.GetImageData( i );
+		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
+	}
+}
+
+/*
+===============
+ActuallyLoadImage
+
+Absolutely every image goes through this path
+On exit, the idImage will have a valid OpenGL texture number that can be bound
+===============
+*/
+void idImage::ActuallyLoadImage( bool fromBackEnd )
+{
+
+	// if we don't have a rendering context yet, just return
+	if( !R_IsInitialized() )
+	{
+		return;
+	}
+	
+	// this is the ONLY place generatorFunction will ever be called
+	if( generatorFunction )
+	{
+		generatorFunction( this );
+		return;
+	}
+	
+	idStrStatic< MAX_OSPATH > generatedName;
+	PrepareLoad( generatedName );
+	
+	// streamed images only read the levels that stay resident, the
+	// detailed levels are streamed in once a surface needs them
+	const int streamSize = IsStreamable() ? image_streamResidentSize.GetInteger() : 0;
 	
 	idBinaryImage im( generatedName );
-	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+	binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamSize );
 	
 	// BFHACK, do not want to tweak on buildgame so catch these images here
 	if( binaryFileTime == FILE_NOT_FOUND_TIMESTAMP && fileSystem->UsingResourceFiles() )
@@ -355,60 +432,40 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 			{
 				generatedName.Replace( "white#__0000", "white#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamSize );
 				break;
 			}
 			if( generatedName.Find( "guis/assets/white#__0100", false ) >= 0 )
 			{
 				generatedName.Replace( "white#__0100", "white#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamSize );
 				break;
 			}
 			if( generatedName.Find( "textures/black#__0100", false ) >= 0 )
 			{
 				generatedName.Replace( "black#__0100", "black#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamSize );
 				break;
 			}
 			if( generatedName.Find( "textures/decals/bulletglass1_d#__0100", false ) >= 0 )
 			{
 				generatedName.Replace( "bulletglass1_d#__0100", "bulletglass1_d#__0200" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamSize );
 				break;
 			}
 			if( generatedName.Find( "models/monsters/skeleton/skeleton01_d#__1000", false ) >= 0 )
 			{
 				generatedName.Replace( "skeleton01_d#__1000", "skeleton01_d#__0100" );
 				im.SetName( generatedName );
-				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime );
+				binaryFileTime = im.LoadFromGeneratedFile( sourceFileTime, streamSize );
 				break;
 			}
 		}
 	}
-	const bimageFile_t& header = im.GetFileHeader();
-	
-	if( ( fileSystem->InProductionMode() && binaryFileTime != FILE_NOT_FOUND_TIMESTAMP ) || ( ( binaryFileTime != FILE_NOT_FOUND_TIMESTAMP )
-			&& ( header.colorFormat == opts.colorFormat )
-			&& ( header.format == opts.format )
-			&& ( header.textureType == opts.textureType )
-																							) )
-	{
-		opts.width = header.width;
-		opts.height = header.height;
-		opts.numLevels = header.numLevels;
-		opts.colorFormat = ( textureColor_t )header.colorFormat;
-		opts.format = ( textureFormat_t )header.format;
-		opts.textureType = ( textureType_t )header.textureType;
-		if( cvarSystem->GetCVarBool( "fs_buildresources" ) )
-		{
-			// for resource gathering write this image to the preload file for this map
-			fileSystem->AddImagePreload( GetName(), filter, repeat, usage, cubeFiles );
-		}
-	}
-	else
+	if( !ApplyBinaryHeader( im ) )
 	{
 		if( cubeFiles != CF_2D )
 		{
@@ -478,15 +535,7 @@ void idImage::ActuallyLoadImage( bool fromBackEnd )
 		binaryFileTime = im.WriteGeneratedFile( sourceFileTime );
 	}
 	
-	AllocImage();
-	
-	
-	for( int i = 0; i < im.NumImages(); i++ )
-	{
-		const bimageImage_t& img = im.GetImageHeader( i );
-		const byte* data = im.GetImageData( i );
-		SubImageUpload( img.level, 0, 0, img.destZ, img.width, img.height, data );
-	}
+	UploadBinaryImage( im );
 }
 
 /*
@@ -656,8 +705,21 @@ int idImage::StorageSize() const
 	{
 		return 0;
 	}
-	int baseSize = opts.width * opts.height;
-	if( opts.numLevels > 1 )
+	// streamed images only count their resident levels
+	return StorageSize( streamLevel );
+}
+
+/*
+==================
+StorageSize
+
+Estimated size with the levels from baseLevel down resident.
+==================
+*/
+int idImage::StorageSize( int baseLevel ) const
+{
+	int baseSize = Max( 1, opts.width >> baseLevel ) * Max( 1, opts.height >> baseLevel );
+	if( opts.numLevels - baseLevel > 1 )
 	{
 		baseSize *= 4;
 		baseSize /= 3;
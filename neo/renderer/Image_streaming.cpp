@@ -0,0 +1,473 @@
+/*
+===========================================================================
+
+Doom 3 BFG Edition GPL Source Code
+Copyright (C) 1993-2012 id Software LLC, a ZeniMax Media company.
+
+This file is part of the Doom 3 BFG Edition GPL Source Code ("Doom 3 BFG Edition Source Code").
+
+Doom 3 BFG Edition Source Code is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+Doom 3 BFG Edition Source Code is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with Doom 3 BFG Edition Source Code.  If not, see <http://www.gnu.org/licenses/>.
+
+In addition, the Doom 3 BFG Edition Source Code is also subject to certain additional terms. You should have received a copy of these additional terms immediately following the terms and conditions of the GNU General Public License which accompanied the Doom 3 BFG Edition Source Code.  If not, please request a copy in writing from id Software at the address below.
+
+If you have questions concerning this license or the applicable additional terms, you may contact in writing id Software LLC, c/o ZeniMax Media Inc., Suite 120, Rockville, Maryland 20850 USA.
+
+===========================================================================
+*/
+
+#pragma hdrstop
+#include "precompiled.h"
+
+#include "tr_local.h"
+
+/*
+================================================================================================
+
+	Image mip streaming
+
+	Diffuse, specular and bump images loaded from files start out with only the levels up to
+	image_streamResidentSize, the detailed levels are left out of the texture with
+	GL_TEXTURE_BASE_LEVEL.  The frontend records the screen size of every surface, and once a
+	frame the levels those surfaces need are requested from a background thread, the levels that
+	are already resident aren't read again.  The main thread uploads them when the batch is done.
+	Streamed images that haven't been used for a while are evicted back down to their resident
+	levels whenever the streamed images use more than image_streamBudget.  When image_streamMips
+	is turned off the streamed images get all their levels back.
+
+	The file system isn't thread safe, so like the level load the files are opened on the main
+	thread, and the thread only reads through the handles it was given.  Resource containers
+	read all their files through one shared file handle, so with resource files the requests
+	are read on the main thread as well.
+
+================================================================================================
+*/
+
+idCVar image_streamMips( "image_streamMips", "0", CVAR_RENDERER | CVAR_BOOL | CVAR_ARCHIVE, "stream the detailed mip levels of diffuse, specular and bump images, takes effect when images are loaded" );
+idCVar image_streamResidentSize( "image_streamResidentSize", "64", CVAR_RENDERER | CVAR_INTEGER, "levels up to this size always stay resident", 4, 4096 );
+idCVar image_streamBudget( "image_streamBudget", "256", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megabytes the streamed images may use before the least recently used levels are evicted", 16, 4096 );
+idCVar image_streamLodBias( "image_streamLodBias", "1", CVAR_RENDERER | CVAR_INTEGER, "stream this many levels more detailed than the screen size of a surface asks for", 0, 4 );
+idCVar image_showStreaming( "image_showStreaming", "0", CVAR_RENDERER | CVAR_BOOL, "print the mip streaming counters every frame" );
+
+static const int MAX_STREAM_REQUESTS	= 32;
+static const int STREAM_IDLE_FRAMES		= 30;	// images not used for this long are evicted first
+
+struct streamRequest_t
+{
+	idImage* 			image;
+	idFile* 			file;
+	ID_TIME_T			sourceFileTime;
+	int					level;			// most detailed level to stream in
+	int					maxSize;		// size of that level
+	int					endLevel;		// resident level when the request was issued, not read again
+	idBinaryImage* 		result;			// NULL if the file couldn't be read
+};
+
+/*
+================================================
+idImageStreamThread reads a batch of streaming requests.  The main thread only
+touches the requests while the thread is idle.
+================================================
+*/
+class idImageStreamThread : public idSysThread
+{
+public:
+	idImageStreamThread() : numRequests( 0 ) {}
+	
+	virtual int			Run()
+	{
+		ReadRequests();
+		return 0;
+	}
+	
+	void				ReadRequests()
+	{
+		for( int i = 0; i < numRequests; i++ )
+		{
+			streamRequest_t& request = requests[i];
+			request.result = new( TAG_IMAGE ) idBinaryImage( request.image->GetName() );
+			if( !request.result->LoadFromGeneratedFile( request.file, request.sourceFileTime, request.maxSize, request.endLevel ) )
+			{
+				delete request.result;
+				request.result = NULL;
+			}
+		}
+	}
+	
+	streamRequest_t		requests[MAX_STREAM_REQUESTS];
+	int					numRequests;
+};
+
+struct streamCandidate_t
+{
+	idImage* 			image;
+	int					level;			// level to request
+	int					sortKey;
+};
+
+class idSort_StreamCandidate : public idSort_Quick< streamCandidate_t, idSort_StreamCandidate >
+{
+public:
+	int Compare( const streamCandidate_t& a, const streamCandidate_t& b ) const
+	{
+		return a.sortKey - b.sortKey;
+	}
+};
+
+static idList< streamCandidate_t, TAG_IMAGE >	streamRequests;
+static idList< streamCandidate_t, TAG_IMAGE >	streamEvictions;
+
+/*
+========================
+idImage::IsStreamable
+========================
+*/
+bool idImage::IsStreamable() const
+{
+	if( !image_streamMips.GetBool() || generatorFunction != NULL || cubeFiles != CF_2D )
+	{
+		return false;
+	}
+	return ( usage == TD_DIFFUSE || usage == TD_SPECULAR || usage == TD_BUMP );
+}
+
+/*
+========================
+idImage::StreamResidentLevel
+
+The first level that isn't larger than image_streamResidentSize, this matches the
+levels idBinaryImage::LoadFromGeneratedFile skips.
+========================
+*/
+int idImage::StreamResidentLevel() const
+{
+	const int residentSize = image_streamResidentSize.GetInteger();
+	int level = 0;
+	while( level < opts.numLevels - 1 && Max( opts.width >> level, opts.height >> level ) > residentSize )
+	{
+		level++;
+	}
+	return level;
+}
+
+/*
+========================
+idImage::RecordStreamingUsage
+
+Asks for the smallest level that still covers the surface on screen.  This doesn't
+know how the surface maps the image, so image_streamLodBias errs on the side of detail.
+========================
+*/
+void idImage::RecordStreamingUsage( int screenSize )
+{
+	const int size = Max( opts.width, opts.height );
+	int level = 0;
+	while( level < streamResidentLevel && ( size >> ( level + 1 ) ) >= screenSize )
+	{
+		level++;
+	}
+	level = Max( 0, level - image_streamLodBias.GetInteger() );
+	
+	if( streamUsedFrame != tr.frameCount )
+	{
+		streamUsedFrame = tr.frameCount;
+		streamWantedLevel = level;
+	}
+	else
+	{
+		streamWantedLevel = Min( streamWantedLevel, level );
+	}
+}
+
+/*
+========================
+idImageManager::RecordStreamingUsage
+========================
+*/
+void idImageManager::RecordStreamingUsage( const idMaterial* material, const idScreenRect& rect )
+{
+	if( material == NULL || !image_streamMips.GetBool() )
+	{
+		return;
+	}
+	
+	const int screenSize = Max( rect.GetWidth(), rect.GetHeight() );
+	
+	for( int i = 0; i < material->GetNumStages(); i++ )
+	{
+		const shaderStage_t* stage = material->GetStage( i );
+		
+		idImage* image = stage->texture.image;
+		if( image != NULL && image->IsStreamed() )
+		{
+			image->RecordStreamingUsage( screenSize );
+		}
+		
+		if( stage->newStage != NULL )
+		{
+			for( int j = 0; j < stage->newStage->numFragmentProgramImages; j++ )
+			{
+				image = stage->newStage->fragmentProgramImages[j];
+				if( image != NULL && image->IsStreamed() )
+				{
+					image->RecordStreamingUsage( screenSize );
+				}
+			}
+		}
+	}
+}
+
+/*
+========================
+idImageManager::InitStreaming
+========================
+*/
+void idImageManager::InitStreaming()
+{
+	streamThread = new( TAG_IMAGE ) idImageStreamThread();
+	streamThread->StartWorkerThread( "ImageStreaming", CORE_ANY, THREAD_BELOW_NORMAL );
+}
+
+/*
+========================
+idImageManager::ShutdownStreaming
+========================
+*/
+void idImageManager::ShutdownStreaming()
+{
+	FlushStreaming();
+	delete streamThread;
+	streamThread = NULL;
+}
+
+/*
+========================
+idImageManager::FlushStreaming
+========================
+*/
+void idImageManager::FlushStreaming()
+{
+	if( streamThread == NULL || streamThread->numRequests == 0 )
+	{
+		return;
+	}
+	streamThread->WaitForThread();
+	FinishStreamRequests( false );
+}
+
+/*
+========================
+idImageManager::FinishStreamRequests
+========================
+*/
+int idImageManager::FinishStreamRequests( bool upload )
+{
+	int uploadedBytes = 0;
+	
+	for( int i = 0; i < streamThread->numRequests; i++ )
+	{
+		streamRequest_t& request = streamThread->requests[i];
+		idImage* image = request.image;
+		idBinaryImage* im = request.result;
+		
+		image->streamPending = false;
+		
+		delete request.file;
+		request.file = NULL;
+		
+		// the image may have been purged, reloaded or regenerated since the request was issued
+		if( upload && im != NULL && image->IsLoaded() && image->IsStreamed() && image->streamLevel == request.endLevel )
+		{
+			const bimageFile_t& header = im->GetFileHeader();
+			if( ( int )header.width == image->opts.width && ( int )header.height == image->opts.height
+					&& ( int )header.numLevels == image->opts.numLevels && header.format == image->opts.format )
+			{
+				const int oldLevel = image->streamLevel;
+				image->AllocStreamLevels( request.level );
+				
+				for( int j = 0; j < im->NumImages(); j++ )
+				{
+					const bimageImage_t& img = im->GetImageHeader( j );
+					if( img.level >= request.level && img.level < oldLevel )
+					{
+						image->SubImageUpload( img.level, 0, 0, 0, img.width, img.height, im->GetImageData( j ) );
+						uploadedBytes += img.dataSize;
+					}
+				}
+			}
+		}
+		
+		delete im;
+		request.result = NULL;
+	}
+	streamThread->numRequests = 0;
+	
+	return uploadedBytes;
+}
+
+/*
+========================
+idImageManager::UpdateStreaming
+========================
+*/
+void idImageManager::UpdateStreaming()
+{
+	if( streamThread == NULL )
+	{
+		return;
+	}
+	
+	int streamedBytes = 0;
+	int evictedBytes = 0;
+	
+	if( streamThread->numRequests > 0 && streamThread->IsWorkDone() )
+	{
+		streamedBytes = FinishStreamRequests( true );
+	}
+	
+	// with streaming turned off the streamed images get all their levels back, regardless of the budget
+	const bool streaming = image_streamMips.GetBool();
+	
+	const int frame = tr.frameCount;
+	const int64 budget = ( int64 )image_streamBudget.GetInteger() * 1024 * 1024;
+	int64 residentBytes = 0;
+	int numStreamed = 0;
+	
+	streamRequests.SetNum( 0 );
+	streamEvictions.SetNum( 0 );
+	
+	for( int i = 0; i < images.Num(); i++ )
+	{
+		idImage* image = images[i];
+		if( !image->IsStreamed() || !image->IsLoaded() )
+		{
+			continue;
+		}
+		
+		numStreamed++;
+		residentBytes += image->StorageSize();
+		
+		if( image->streamPending )
+		{
+			continue;
+		}
+		
+		// the images missing the most levels are requested first
+		const int wantedLevel = streaming ? image->streamWantedLevel : 0;
+		if( ( !streaming || frame - image->streamUsedFrame <= 1 ) && wantedLevel < image->streamLevel )
+		{
+			streamCandidate_t& candidate = streamRequests.Alloc();
+			candidate.image = image;
+			candidate.level = wantedLevel;
+			candidate.sortKey = wantedLevel - image->streamLevel;
+		}
+		
+		// the least recently used images are evicted first
+		if( streaming && image->streamLevel < image->streamResidentLevel )
+		{
+			streamCandidate_t& candidate = streamEvictions.Alloc();
+			candidate.image = image;
+			candidate.sortKey = image->streamUsedFrame;
+		}
+	}
+	
+	if( residentBytes > budget )
+	{
+		streamEvictions.SortWithTemplate( idSort_StreamCandidate() );
+		
+		for( int i = 0; i < streamEvictions.Num() && residentBytes > budget; i++ )
+		{
+			idImage* image = streamEvictions[i].image;
+			const int oldSize = image->StorageSize();
+			
+			// images that are still in use only give up their most detailed level
+			if( frame - image->streamUsedFrame < STREAM_IDLE_FRAMES )
+			{
+				image->PurgeStreamLevels( image->streamLevel + 1 );
+			}
+			else
+			{
+				image->PurgeStreamLevels( image->streamResidentLevel );
+			}
+			
+			const int freedBytes = oldSize - image->StorageSize();
+			residentBytes -= freedBytes;
+			evictedBytes += freedBytes;
+		}
+	}
+	
+	// only issue new requests while the thread is idle and they fit the budget,
+	// so streamed levels are never evicted again right away
+	int64 requestedBytes = 0;
+	if( streamThread->numRequests == 0 && streamRequests.Num() > 0 )
+	{
+		streamRequests.SortWithTemplate( idSort_StreamCandidate() );
+		
+		for( int i = 0; i < streamRequests.Num() && streamThread->numRequests < MAX_STREAM_REQUESTS; i++ )
+		{
+			idImage* image = streamRequests[i].image;
+			const int level = streamRequests[i].level;
+			const int addedBytes = image->StorageSize( level ) - image->StorageSize();
+			if( streaming && residentBytes + requestedBytes + addedBytes > budget )
+			{
+				continue;
+			}
+			
+			idStrStatic< MAX_OSPATH > generatedName = image->GetName();
+			idImage::GetGeneratedName( generatedName, image->usage, image->cubeFiles );
+			idStr binaryFileName;
+			idBinaryImage::GetGeneratedFileName( binaryFileName, generatedName );
+			
+			idFile* file = fileSystem->OpenFileRead( binaryFileName );
+			if( file == NULL )
+			{
+				// nothing to stream from, the image keeps the levels it has
+				idLib::Warning( "Couldn't stream image: %s", binaryFileName.c_str() );
+				image->streamed = false;
+				continue;
+			}
+			
+			streamRequest_t& request = streamThread->requests[streamThread->numRequests++];
+			request.image = image;
+			request.file = file;
+			request.sourceFileTime = image->sourceFileTime;
+			request.level = level;
+			request.maxSize = Max( image->opts.width >> level, image->opts.height >> level );
+			request.endLevel = image->streamLevel;
+			request.result = NULL;
+			
+			image->streamPending = true;
+			requestedBytes += addedBytes;
+		}
+		
+		if( streamThread->numRequests > 0 )
+		{
+			if( fileSystem->UsingResourceFiles() )
+			{
+				streamThread->ReadRequests();
+			}
+			else
+			{
+				streamThread->SignalWork();
+			}
+		}
+	}
+	
+	if( image_showStreaming.GetBool() )
+	{
+		idLib::Printf( "%08d: streamed %dkB, evicted %dkB, %d requests %dkB, %d images resident %dkB of %dkB\n",
+					   frame, streamedBytes / 1024, evictedBytes / 1024,
+					   streamThread->numRequests, ( int )( requestedBytes / 1024 ),
+					   numStreamed, ( int )( residentBytes / 1024 ), ( int )( budget / 1024 ) );
+	}
+}
@@ -164,6 +164,16 @@ protected:
 ===============================================================================
 */
 
+// one mesh worth of CPU skinning, run after all the surfaces of a model have been setup
+typedef struct md5SkinningParms_s
+{
+	idDrawVert* 				verts;				// skinned verts kept for shadows, decals and overlays
+	idDrawVert* 				cacheVerts;			// skinned verts streamed to this frame's vertex cache, may be NULL
+	const idDrawVert* 			baseVerts;
+	int							numVerts;
+	const idJointMat* 			joints;
+} md5SkinningParms_t;
+
 class idMD5Mesh
 {
 	friend class				idRenderModelMD5;
@@ -183,8 +193,8 @@ public:
 		return numTris;
 	}
 	
-	void						UpdateSurface( const struct renderEntity_s* ent, const idJointMat* joints,
-			const idJointMat* entJointsInverted, modelSurface_t* surf );
+	bool						UpdateSurface( const struct renderEntity_s* ent, const idJointMat* joints,
+			const idJointMat* entJointsInverted, modelSurface_t* surf, md5SkinningParms_t& skinning );
 	void						CalculateBounds( const idJointMat* entJoints, idBounds& bounds ) const;
 	int							NearestJoint( int a, int b, int c ) const;
 	
@@ -32,6 +32,8 @@ If you have questions concerning this license or the applicable additional terms
 #include "tr_local.h"
 #include "Model_local.h"
 
+#include "../idlib/geometry/DrawVert_intrinsics.h"
+
 
 static const __m128 vector_float_posInfinity		= { idMath::INFINITY, idMath::INFINITY, idMath::INFINITY, idMath::INFINITY };
 static const __m128 vector_float_negInfinity		= { -idMath::INFINITY, -idMath::INFINITY, -idMath::INFINITY, -idMath::INFINITY };
@@ -43,6 +45,12 @@ static const byte MD5B_VERSION = 106;
 static const unsigned int MD5B_MAGIC = ( '5' << 24 ) | ( 'D' << 16 ) | ( 'M' << 8 ) | MD5B_VERSION;
 
 idCVar r_useGPUSkinning( "r_useGPUSkinning", "1", CVAR_INTEGER, "animate normals and tangents instead of deriving" );
+idCVar r_useSIMDSkinning( "r_useSIMDSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "use SIMD when skinning on the CPU and write the verts straight to the vertex cache" );
+idCVar r_useParallelSkinning( "r_useParallelSkinning", "1", CVAR_RENDERER | CVAR_BOOL, "skin the meshes of a model in parallel with jobs when skinning on the CPU" );
+
+extern idCVar r_useParallelAddModels;
+
+static idSysMutex skinningJobListMutex;		// the skinning job list can be used by one model at a time
 
 /***********************************************************************
 
@@ -476,13 +484,164 @@ void TransformVertsAndTangents( idDrawVert* targetVerts, const int numVerts, con
 	}
 }
 
+static const __m128 vector_float_2_over_255		= { 2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f, 2.0f / 255.0f };
+static const __m128 vector_float_one			= { 1.0f, 1.0f, 1.0f, 1.0f };
+static const __m128 vector_float_half			= { 0.5f, 0.5f, 0.5f, 0.5f };
+static const __m128 vector_float_255_over_2		= { 255.0f / 2.0f, 255.0f / 2.0f, 255.0f / 2.0f, 255.0f / 2.0f };
+static const __m128 vector_float_smallest		= { idMath::FLT_SMALLEST_NON_DENORMAL, idMath::FLT_SMALLEST_NON_DENORMAL, idMath::FLT_SMALLEST_NON_DENORMAL, idMath::FLT_SMALLEST_NON_DENORMAL };
+static const __m128i vector_int_keep_base		= _mm_set_epi32( -1, -1, ( int )0xFF000000, ( int )0xFF000000 );	// normal[3], tangent[3], color and color2
+
+/*
+============
+TransformVertsAndTangents_SSE
+
+Writes complete skinned verts, including the texture coordinates and the joint
+indices and weights, so the target doesn't have to be initialized with the base
+verts. When cacheVerts is not NULL the same verts are also written to it with
+streaming stores, which is meant for write combined vertex cache memory that
+is never read back on the CPU.
+============
+*/
+static void TransformVertsAndTangents_SSE( idDrawVert* targetVerts, idDrawVert* cacheVerts, const int numVerts, const idDrawVert* baseVerts, const idJointMat* joints )
+{
+	assert_16_byte_aligned( targetVerts );
+	assert_16_byte_aligned( cacheVerts );
+	assert_16_byte_aligned( baseVerts );
+	
+	for( int i = 0; i < numVerts; i++ )
+	{
+		const idDrawVert& base = baseVerts[i];
+		
+		const idJointMat& j0 = joints[base.color[0]];
+		const idJointMat& j1 = joints[base.color[1]];
+		const idJointMat& j2 = joints[base.color[2]];
+		const idJointMat& j3 = joints[base.color[3]];
+		
+		__m128i weights_b = _mm_cvtsi32_si128( *( const unsigned int* )base.color2 );
+		__m128i weights_s = _mm_unpacklo_epi8( weights_b, vector_int_zero );
+		__m128i weights_i = _mm_unpacklo_epi16( weights_s, vector_int_zero );
+		
+		__m128 weights = _mm_cvtepi32_ps( weights_i );
+		weights = _mm_mul_ps( weights, vector_float_1_over_255 );
+		
+		__m128 w0 = _mm_splat_ps( weights, 0 );
+		__m128 w1 = _mm_splat_ps( weights, 1 );
+		__m128 w2 = _mm_splat_ps( weights, 2 );
+		__m128 w3 = _mm_splat_ps( weights, 3 );
+		
+		__m128 matX = _mm_mul_ps( _mm_load_ps( j0.ToFloatPtr() + 0 * 4 ), w0 );
+		__m128 matY = _mm_mul_ps( _mm_load_ps( j0.ToFloatPtr() + 1 * 4 ), w0 );
+		__m128 matZ = _mm_mul_ps( _mm_load_ps( j0.ToFloatPtr() + 2 * 4 ), w0 );
+		
+		matX = _mm_madd_ps( _mm_load_ps( j1.ToFloatPtr() + 0 * 4 ), w1, matX );
+		matY = _mm_madd_ps( _mm_load_ps( j1.ToFloatPtr() + 1 * 4 ), w1, matY );
+		matZ = _mm_madd_ps( _mm_load_ps( j1.ToFloatPtr() + 2 * 4 ), w1, matZ );
+		
+		matX = _mm_madd_ps( _mm_load_ps( j2.ToFloatPtr() + 0 * 4 ), w2, matX );
+		matY = _mm_madd_ps( _mm_load_ps( j2.ToFloatPtr() + 1 * 4 ), w2, matY );
+		matZ = _mm_madd_ps( _mm_load_ps( j2.ToFloatPtr() + 2 * 4 ), w2, matZ );
+		
+		matX = _mm_madd_ps( _mm_load_ps( j3.ToFloatPtr() + 0 * 4 ), w3, matX );
+		matY = _mm_madd_ps( _mm_load_ps( j3.ToFloatPtr() + 1 * 4 ), w3, matY );
+		matZ = _mm_madd_ps( _mm_load_ps( j3.ToFloatPtr() + 2 * 4 ), w3, matZ );
+		
+		// transpose the blended rows to columns so the position, normal and tangent are all plain multiply adds
+		__m128 s0 = _mm_unpacklo_ps( matX, matZ );			// x0, z0, x1, z1
+		__m128 s1 = _mm_unpackhi_ps( matX, matZ );			// x2, z2, x3, z3
+		__m128 s2 = _mm_unpacklo_ps( matY, _mm_setzero_ps() );	// y0, 0, y1, 0
+		__m128 s3 = _mm_unpackhi_ps( matY, _mm_setzero_ps() );	// y2, 0, y3, 0
+		
+		__m128 col0 = _mm_unpacklo_ps( s0, s2 );	// x0, y0, z0, 0
+		__m128 col1 = _mm_unpackhi_ps( s0, s2 );	// x1, y1, z1, 0
+		__m128 col2 = _mm_unpacklo_ps( s1, s3 );	// x2, y2, z2, 0
+		__m128 col3 = _mm_unpackhi_ps( s1, s3 );	// x3, y3, z3, 0
+		
+		// the first 16 bytes are the position and the texture coordinates
+		__m128 v = _mm_load_ps( base.xyz.ToFloatPtr() );
+		__m128 p = _mm_madd_ps( col0, _mm_splat_ps( v, 0 ), col3 );
+		p = _mm_madd_ps( col1, _mm_splat_ps( v, 1 ), p );
+		p = _mm_madd_ps( col2, _mm_splat_ps( v, 2 ), p );
+		p = _mm_sel_ps( v, p, vector_float_mask_clear_last );
+		
+		// the next 8 bytes are the normal and tangent
+		__m128i nt_b = _mm_loadl_epi64( ( const __m128i* )base.normal );
+		__m128i nt_s = _mm_unpacklo_epi8( nt_b, vector_int_zero );
+		__m128 n = _mm_cvtepi32_ps( _mm_unpacklo_epi16( nt_s, vector_int_zero ) );
+		__m128 t = _mm_cvtepi32_ps( _mm_unpackhi_epi16( nt_s, vector_int_zero ) );
+		n = _mm_sub_ps( _mm_mul_ps( n, vector_float_2_over_255 ), vector_float_one );
+		t = _mm_sub_ps( _mm_mul_ps( t, vector_float_2_over_255 ), vector_float_one );
+		
+		__m128 sn = _mm_mul_ps( col0, _mm_splat_ps( n, 0 ) );
+		__m128 st = _mm_mul_ps( col0, _mm_splat_ps( t, 0 ) );
+		sn = _mm_madd_ps( col1, _mm_splat_ps( n, 1 ), sn );
+		st = _mm_madd_ps( col1, _mm_splat_ps( t, 1 ), st );
+		sn = _mm_madd_ps( col2, _mm_splat_ps( n, 2 ), sn );
+		st = _mm_madd_ps( col2, _mm_splat_ps( t, 2 ), st );
+		
+		// the blended matrix isn't orthonormal so renormalize
+		__m128 lenN = _mm_max_ps( _mm_msum3_ps( sn, sn ), vector_float_smallest );
+		__m128 lenT = _mm_max_ps( _mm_msum3_ps( st, st ), vector_float_smallest );
+		sn = _mm_mul_ps( sn, _mm_rsqrt_ps( lenN ) );
+		st = _mm_mul_ps( st, _mm_rsqrt_ps( lenT ) );
+		
+		// same rounding as VertexFloatToByte
+		__m128i sn_i = _mm_cvtps_epi32( _mm_madd_ps( _mm_add_ps( sn, vector_float_one ), vector_float_255_over_2, vector_float_half ) );
+		__m128i st_i = _mm_cvtps_epi32( _mm_madd_ps( _mm_add_ps( st, vector_float_one ), vector_float_255_over_2, vector_float_half ) );
+		__m128i nt_i = _mm_packus_epi16( _mm_packs_epi32( sn_i, st_i ), vector_int_zero );
+		
+		// the last 8 bytes are the joint indices and weights which are copied along with normal[3] and tangent[3]
+		__m128i rest = _mm_load_si128( ( const __m128i* )base.normal );
+		rest = _mm_sel_si128( nt_i, rest, vector_int_keep_base );
+		
+		_mm_store_ps( targetVerts[i].xyz.ToFloatPtr(), p );
+		_mm_store_si128( ( __m128i* )targetVerts[i].normal, rest );
+		
+		if( cacheVerts != NULL )
+		{
+			_mm_stream_ps( cacheVerts[i].xyz.ToFloatPtr(), p );
+			_mm_stream_si128( ( __m128i* )cacheVerts[i].normal, rest );
+		}
+	}
+	
+	if( cacheVerts != NULL )
+	{
+		_mm_sfence();
+	}
+}
+
+/*
+============
+SkinMeshJob
+============
+*/
+void SkinMeshJob( const md5SkinningParms_t* parms )
+{
+	if( r_useSIMDSkinning.GetBool() )
+	{
+		TransformVertsAndTangents_SSE( parms->verts, parms->cacheVerts, parms->numVerts, parms->baseVerts, parms->joints );
+	}
+	else
+	{
+		TransformVertsAndTangents( parms->verts, parms->numVerts, parms->baseVerts, parms->joints );
+		if( parms->cacheVerts != NULL )
+		{
+			memcpy( parms->cacheVerts, parms->verts, parms->numVerts * sizeof( parms->verts[0] ) );
+		}
+	}
+}
+
+REGISTER_PARALLEL_JOB( SkinMeshJob, "SkinMeshJob" );
+
 /*
 ====================
 idMD5Mesh::UpdateSurface
+
+Returns true if the surface has to be skinned on the CPU, which is deferred
+until all surfaces of the model are setup so the meshes can be skinned in parallel.
 ====================
 */
-void idMD5Mesh::UpdateSurface( const struct renderEntity_s* ent, const idJointMat* entJoints,
-							   const idJointMat* entJointsInverted, modelSurface_t* surf )
+bool idMD5Mesh::UpdateSurface( const struct renderEntity_s* ent, const idJointMat* entJoints,
+							   const idJointMat* entJointsInverted, modelSurface_t* surf, md5SkinningParms_t& skinning )
 {
 
 	tr.pc.c_deformedSurfaces++;
@@ -536,22 +695,30 @@ void idMD5Mesh::UpdateSurface( const struct renderEntity_s* ent, const idJointMa
 		tri->ambientCache = deformInfo->staticAmbientCache;
 		tri->shadowCache = deformInfo->staticShadowCache;
 		tri->referencedVerts = true;
+		tri->tangentsCalculated = true;
+		
+		CalculateBounds( entJoints, tri->bounds );
+		return false;
 	}
-	else
+	
+	if( tri->verts == NULL || tri->verts == deformInfo->verts )
 	{
-		if( tri->verts == NULL || tri->verts == deformInfo->verts )
-		{
-			tri->verts = NULL;
-			R_AllocStaticTriSurfVerts( tri, deformInfo->numOutputVerts );
-			assert( tri->verts != NULL );	// quiet analyze warning
-			memcpy( tri->verts, deformInfo->verts, deformInfo->numOutputVerts * sizeof( deformInfo->verts[0] ) );	// copy over the texture coordinates
-		}
-		TransformVertsAndTangents( tri->verts, deformInfo->numOutputVerts, deformInfo->verts, entJointsInverted );
-		tri->referencedVerts = false;
+		tri->verts = NULL;
+		R_AllocStaticTriSurfVerts( tri, deformInfo->numOutputVerts );
+		assert( tri->verts != NULL );	// quiet analyze warning
+		memcpy( tri->verts, deformInfo->verts, deformInfo->numOutputVerts * sizeof( deformInfo->verts[0] ) );	// copy over the texture coordinates
 	}
+	tri->referencedVerts = false;
 	tri->tangentsCalculated = true;
 	
+	skinning.verts = tri->verts;
+	skinning.cacheVerts = NULL;
+	skinning.baseVerts = deformInfo->verts;
+	skinning.numVerts = deformInfo->numOutputVerts;
+	skinning.joints = entJointsInverted;
+	
 	CalculateBounds( entJoints, tri->bounds );
+	return true;
 }
 
 /*
@@ -1379,6 +1546,10 @@ idRenderModel* idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 	
 	TransformJoints( staticModel->jointsInverted, joints.Num(), ent->joints, invertedDefaultPose.Ptr() );
 	
+	// the CPU skinning of the meshes is deferred until all the surfaces are setup
+	md5SkinningParms_t* skinning = ( md5SkinningParms_t* )_alloca16( meshes.Num() * sizeof( skinning[0] ) );
+	int numSkinning = 0;
+	
 	// create all the surfaces
 	idMD5Mesh* mesh = meshes.Ptr();
 	for( int i = 0; i < meshes.Num(); i++, mesh++ )
@@ -1412,7 +1583,17 @@ idRenderModel* idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 			surf->id = i;
 		}
 		
-		mesh->UpdateSurface( ent, ent->joints, staticModel->jointsInverted, surf );
+		if( mesh->UpdateSurface( ent, ent->joints, staticModel->jointsInverted, surf, skinning[numSkinning] ) )
+		{
+			// write the skinned verts straight to this frame's vertex cache so they don't have to be copied when the surface is drawn
+			if( view != NULL && shader->IsDrawn() && r_useSIMDSkinning.GetBool() )
+			{
+				srfTriangles_t* tri = surf->geometry;
+				tri->ambientCache = vertexCache.AllocVertex( NULL, ALIGN( tri->numVerts * sizeof( idDrawVert ), VERTEX_CACHE_ALIGN ) );
+				skinning[numSkinning].cacheVerts = ( idDrawVert* )vertexCache.MappedVertexBuffer( tri->ambientCache );
+			}
+			numSkinning++;
+		}
 		assert( surf->geometry != NULL );	// to get around compiler warning
 		
 		// the deformation of the tangents can be deferred until each surface is added to the view
@@ -1421,6 +1602,26 @@ idRenderModel* idRenderModelMD5::InstantiateDynamicModel( const struct renderEnt
 		staticModel->bounds.AddBounds( surf->geometry->bounds );
 	}
 	
+	// R_AddSingleModel can't wait on another job list when the models are added in parallel
+	const bool parallelSkinning = r_useParallelSkinning.GetBool() && numSkinning > 1 && ( view == NULL || !r_useParallelAddModels.GetBool() );
+	if( parallelSkinning && skinningJobListMutex.Lock( false ) )
+	{
+		for( int i = 0; i < numSkinning; i++ )
+		{
+			tr.skinningJobList->AddJob( ( jobRun_t )SkinMeshJob, &skinning[i] );
+		}
+		tr.skinningJobList->Submit();
+		tr.skinningJobList->Wait();
+		skinningJobListMutex.Unlock();
+	}
+	else
+	{
+		for( int i = 0; i < numSkinning; i++ )
+		{
+			SkinMeshJob( &skinning[i] );
+		}
+	}
+	
 	return staticModel;
 }
 
@@ -321,6 +321,57 @@ void idImage::SetTexParameters()
 	}
 }
 
+/*
+========================
+idImage::AllocLevel
+
+Allocates a single mip level with undefined contents.
+========================
+*/
+void idImage::AllocLevel( int uploadTarget, int level, int width, int height )
+{
+	// clear out any previous error
+	GL_CheckErrors();
+	
+	if( IsCompressed() )
+	{
+		int compressedSize = ( ( ( width + 3 ) / 4 ) * ( ( height + 3 ) / 4 ) * int64( 16 ) * BitsForFormat( opts.format ) ) / 8;
+		
+		// Even though the OpenGL specification allows the 'data' pointer to be NULL, for some
+		// drivers we actually need to upload data to get it to allocate the texture.
+		// However, on 32-bit systems we may fail to allocate a large block of memory for large
+		// textures. We handle this case by using HeapAlloc directly and allowing the allocation
+		// to fail in which case we simply pass down NULL to glCompressedTexImage2D and hope for the best.
+		// As of 2011-10-6 using NVIDIA hardware and drivers we have to allocate the memory with HeapAlloc
+		// with the exact size otherwise large image allocation (for instance for physical page textures)
+		// may fail on Vista 32-bit.
+		
+		// RB begin
+#if defined(_WIN32)
+		void* data = HeapAlloc( GetProcessHeap(), 0, compressedSize );
+		qglCompressedTexImage2DARB( uploadTarget, level, internalFormat, width, height, 0, compressedSize, data );
+		if( data != NULL )
+		{
+			HeapFree( GetProcessHeap(), 0, data );
+		}
+#else
+		byte* data = ( byte* )Mem_Alloc( compressedSize, TAG_TEMP );
+		qglCompressedTexImage2DARB( uploadTarget, level, internalFormat, width, height, 0, compressedSize, data );
+		if( data != NULL )
+		{
+			Mem_Free( data );
+		}
+#endif
+		// RB end
+	}
+	else
+	{
+		qglTexImage2D( uploadTarget, level, internalFormat, width, height, 0, dataFormat, dataType, NULL );
+	}
+	
+	GL_CheckErrors();
+}
+
 /*
 ========================
 idImage::AllocImage
@@ -329,13 +380,21 @@ Every image will pass through this function. Allocates all the necessary MipMap
 Image, but doesn't put anything in them.
 
 This should not be done during normal game-play, if you can avoid it.
+
+Streamed images pass the level they start out with as baseLevel, the more
+detailed levels only get storage when they are streamed in.
 ========================
 */
-void idImage::AllocImage()
+void idImage::AllocImage( int baseLevel )
 {
 	GL_CheckErrors();
 	PurgeImage();
 	
+	streamed = ( baseLevel > 0 );
+	streamLevel = baseLevel;
+	streamResidentLevel = baseLevel;
+	streamWantedLevel = baseLevel;
+	
 	switch( opts.format )
 	{
 		case FMT_RGBA8:
@@ -472,53 +531,18 @@ void idImage::AllocImage()
 		}
 		for( int level = 0; level < opts.numLevels; level++ )
 		{
-		
-			// clear out any previous error
-			GL_CheckErrors();
-			
-			if( IsCompressed() )
-			{
-				int compressedSize = ( ( ( w + 3 ) / 4 ) * ( ( h + 3 ) / 4 ) * int64( 16 ) * BitsForFormat( opts.format ) ) / 8;
-				
-				// Even though the OpenGL specification allows the 'data' pointer to be NULL, for some
-				// drivers we actually need to upload data to get it to allocate the texture.
-				// However, on 32-bit systems we may fail to allocate a large block of memory for large
-				// textures. We handle this case by using HeapAlloc directly and allowing the allocation
-				// to fail in which case we simply pass down NULL to glCompressedTexImage2D and hope for the best.
-				// As of 2011-10-6 using NVIDIA hardware and drivers we have to allocate the memory with HeapAlloc
-				// with the exact size otherwise large image allocation (for instance for physical page textures)
-				// may fail on Vista 32-bit.
-				
-				// RB begin
-#if defined(_WIN32)
-				void* data = HeapAlloc( GetProcessHeap(), 0, compressedSize );
-				qglCompressedTexImage2DARB( uploadTarget + side, level, internalFormat, w, h, 0, compressedSize, data );
-				if( data != NULL )
-				{
-					HeapFree( GetProcessHeap(), 0, data );
-				}
-#else
-				byte* data = ( byte* )Mem_Alloc( compressedSize, TAG_TEMP );
-				qglCompressedTexImage2DARB( uploadTarget + side, level, internalFormat, w, h, 0, compressedSize, data );
-				if( data != NULL )
-				{
-					Mem_Free( data );
-				}
-#endif
-				// RB end
-			}
-			else
+			// streamed images leave the detailed levels for later
+			if( level >= streamLevel )
 			{
-				qglTexImage2D( uploadTarget + side, level, internalFormat, w, h, 0, dataFormat, dataType, NULL );
+				AllocLevel( uploadTarget + side, level, w, h );
 			}
 			
-			GL_CheckErrors();
-			
 			w = Max( 1, w >> 1 );
 			h = Max( 1, h >> 1 );
 		}
 	}
 	
+	qglTexParameteri( target, GL_TEXTURE_BASE_LEVEL, streamLevel );
 	qglTexParameteri( target, GL_TEXTURE_MAX_LEVEL, opts.numLevels - 1 );
 	
 	// see if we messed anything up
@@ -541,6 +565,9 @@ void idImage::PurgeImage()
 		qglDeleteTextures( 1, ( GLuint* )&texnum );	// this should be the ONLY place it is ever called!
 		texnum = TEXTURE_NOT_LOADED;
 	}
+	streamed = false;
+	streamLevel = 0;
+	
 	// clear all the current binding caches, so the next bind will do a real one
 	for( int i = 0 ; i < MAX_MULTITEXTURE_UNITS ; i++ )
 	{
@@ -549,6 +576,57 @@ void idImage::PurgeImage()
 	}
 }
 
+/*
+========================
+idImage::AllocStreamLevels
+
+Gives the levels from level up to the current streamLevel storage and makes
+level the base level, the caller uploads their contents right after.
+========================
+*/
+void idImage::AllocStreamLevels( int level )
+{
+	assert( opts.textureType == TT_2D && level >= 0 && level < streamLevel );
+	
+	qglBindTexture( GL_TEXTURE_2D, texnum );
+	for( int i = level; i < streamLevel; i++ )
+	{
+		AllocLevel( GL_TEXTURE_2D, i, Max( 1, opts.width >> i ), Max( 1, opts.height >> i ) );
+	}
+	qglTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level );
+	
+	streamLevel = level;
+}
+
+/*
+========================
+idImage::PurgeStreamLevels
+
+Respecifies the levels above level with zero size so the driver can
+release their memory.
+========================
+*/
+void idImage::PurgeStreamLevels( int level )
+{
+	assert( opts.textureType == TT_2D && level > streamLevel && level < opts.numLevels );
+	
+	qglBindTexture( GL_TEXTURE_2D, texnum );
+	qglTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, level );
+	for( int i = streamLevel; i < level; i++ )
+	{
+		if( IsCompressed() )
+		{
+			qglCompressedTexImage2DARB( GL_TEXTURE_2D, i, internalFormat, 0, 0, 0, 0, NULL );
+		}
+		else
+		{
+			qglTexImage2D( GL_TEXTURE_2D, i, internalFormat, 0, 0, 0, dataFormat, dataType, NULL );
+		}
+	}
+	
+	streamLevel = level;
+}
+
 /*
 ========================
 idImage::Resize
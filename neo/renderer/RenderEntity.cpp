@@ -47,6 +47,7 @@ idRenderEntityLocal::idRenderEntityLocal()
 	globalReferenceBounds	= bounds_zero;
 	viewCount				= 0;
 	viewEntity				= NULL;
+	lastVisibleFrame		= -1;
 	decals					= NULL;
 	overlays				= NULL;
 	entityRefs				= NULL;
@@ -800,6 +800,9 @@ const emptyCommand_t* idRenderSystemLocal::SwapCommandBuffers_FinishCommandBuffe
 	// unmap the buffer objects so they can be used by the GPU
 	vertexCache.BeginBackEnd();
 	
+	// upload the streamed image levels that finished loading and request new ones
+	globalImages->UpdateStreaming();
+	
 	// save off this command buffer
 	const emptyCommand_t* commandBufferHead = frameData->cmdHead;
 	
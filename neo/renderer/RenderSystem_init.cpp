@@ -2174,6 +2174,7 @@ void R_InitCommands()
 	cmdSystem->AddCommand( "listRenderLightDefs", R_ListRenderLightDefs_f, CMD_FL_RENDERER, "lists the light defs" );
 	cmdSystem->AddCommand( "listModes", R_ListModes_f, CMD_FL_RENDERER, "lists all video modes" );
 	cmdSystem->AddCommand( "reloadSurface", R_ReloadSurface_f, CMD_FL_RENDERER, "reloads the decl and images for selected surface" );
+	cmdSystem->AddCommand( "vertexCacheStats", R_VertexCacheStats_f, CMD_FL_RENDERER, "shows the vertex cache sizes, high water marks and overflows" );
 }
 
 /*
@@ -2226,6 +2227,7 @@ void idRenderSystemLocal::Clear()
 	}
 	
 	frontEndJobList = NULL;
+	skinningJobList = NULL;
 }
 
 /*
@@ -2488,6 +2490,7 @@ void idRenderSystemLocal::Init()
 	}
 	
 	frontEndJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 2048, 0, NULL );
+	skinningJobList = parallelJobManager->AllocJobList( JOBLIST_RENDERER_FRONTEND, JOBLIST_PRIORITY_MEDIUM, 256, 0, NULL );
 	
 	// make sure the command buffers are ready to accept the first screen update
 	SwapCommandBuffers( NULL, NULL, NULL, NULL );
@@ -2531,6 +2534,7 @@ void idRenderSystemLocal::Shutdown()
 	delete guiModel;
 	
 	parallelJobManager->FreeJobList( frontEndJobList );
+	parallelJobManager->FreeJobList( skinningJobList );
 	
 	Clear();
 	
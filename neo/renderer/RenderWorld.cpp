@@ -439,6 +439,21 @@ const renderEntity_t* idRenderWorldLocal::GetRenderEntity( qhandle_t entityHandl
 	return &def->parms;
 }
 
+/*
+==================
+GetEntityLastVisibleFrame
+==================
+*/
+int idRenderWorldLocal::GetEntityLastVisibleFrame( qhandle_t entityHandle ) const
+{
+	if( entityHandle < 0 || entityHandle >= entityDefs.Num() || entityDefs[entityHandle] == NULL )
+	{
+		return -1;
+	}
+	
+	return entityDefs[entityHandle]->lastVisibleFrame;
+}
+
 /*
 ==================
 AddLightDef
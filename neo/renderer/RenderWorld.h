@@ -309,6 +309,8 @@ public:
 	virtual	void			UpdateEntityDef( qhandle_t entityHandle, const renderEntity_t* re ) = 0;
 	virtual	void			FreeEntityDef( qhandle_t entityHandle ) = 0;
 	virtual const renderEntity_t* GetRenderEntity( qhandle_t entityHandle ) const = 0;
+	// returns the renderSystem frame count of the last frame the model or its shadows were drawn in, -1 if never
+	virtual int				GetEntityLastVisibleFrame( qhandle_t entityHandle ) const = 0;
 	
 	virtual	qhandle_t		AddLightDef( const renderLight_t* rlight ) = 0;
 	virtual	void			UpdateLightDef( qhandle_t lightHandle, const renderLight_t* rlight ) = 0;
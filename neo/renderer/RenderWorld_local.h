@@ -109,6 +109,7 @@ public:
 	virtual	void			UpdateEntityDef( qhandle_t entityHandle, const renderEntity_t* re );
 	virtual	void			FreeEntityDef( qhandle_t entityHandle );
 	virtual const renderEntity_t* GetRenderEntity( qhandle_t entityHandle ) const;
+	virtual int				GetEntityLastVisibleFrame( qhandle_t entityHandle ) const;
 	
 	virtual	qhandle_t		AddLightDef( const renderLight_t* rlight );
 	virtual	void			UpdateLightDef( qhandle_t lightHandle, const renderLight_t* rlight );
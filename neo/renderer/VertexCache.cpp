@@ -34,7 +34,12 @@ If you have questions concerning this license or the applicable additional terms
 idVertexCache vertexCache;
 
 idCVar r_showVertexCache( "r_showVertexCache", "0", CVAR_RENDERER | CVAR_BOOL, "Print stats about the vertex cache every frame" );
-idCVar r_showVertexCacheTimings( "r_showVertexCache", "0", CVAR_RENDERER | CVAR_BOOL, "Print stats about the vertex cache every frame" );
+idCVar r_showVertexCacheTimings( "r_showVertexCacheTimings", "0", CVAR_RENDERER | CVAR_BOOL, "Print the time it takes to map and unmap the vertex cache" );
+idCVar r_shareStaticVertexCache( "r_shareStaticVertexCache", "1", CVAR_RENDERER | CVAR_BOOL, "identical static vertex and index data shares one allocation" );
+idCVar r_vertexCacheFrames( "r_vertexCacheFrames", "3", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "number of per-frame vertex cache buffers in the ring, takes effect on vid_restart", 2, VERTCACHE_MAX_FRAMES );
+idCVar r_vertexCacheVertexMemory( "r_vertexCacheVertexMemory", "31", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megs of vertex memory per frame, takes effect on vid_restart", 1, VERTCACHE_OFFSET_MASK / ( 1024 * 1024 ) );
+idCVar r_vertexCacheIndexMemory( "r_vertexCacheIndexMemory", "31", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "megs of index memory per frame, takes effect on vid_restart", 1, VERTCACHE_OFFSET_MASK / ( 1024 * 1024 ) );
+idCVar r_vertexCacheJointMemory( "r_vertexCacheJointMemory", "256", CVAR_RENDERER | CVAR_INTEGER | CVAR_ARCHIVE, "kilobytes of joint memory per frame, takes effect on vid_restart", 64, 65536 );
 
 
 /*
@@ -47,7 +52,9 @@ static void ClearGeoBufferSet( geoBufferSet_t& gbs )
 	gbs.indexMemUsed.SetValue( 0 );
 	gbs.vertexMemUsed.SetValue( 0 );
 	gbs.jointMemUsed.SetValue( 0 );
-	gbs.allocations = 0;
+	gbs.allocations.SetValue( 0 );
+	gbs.overflowAllocations.SetValue( 0 );
+	gbs.overflowBytes.SetValue( 0 );
 }
 
 /*
@@ -119,15 +126,31 @@ idVertexCache::Init
 void idVertexCache::Init( bool restart )
 {
 	currentFrame = 0;
+	numFrames = idMath::ClampInt( 2, VERTCACHE_MAX_FRAMES, r_vertexCacheFrames.GetInteger() );
 	listNum = 0;
+	drawListNum = 0;
 	
 	mostUsedVertex = 0;
 	mostUsedIndex = 0;
 	mostUsedJoint = 0;
 	
-	for( int i = 0; i < VERTCACHE_NUM_FRAMES; i++ )
+	overflowFrames = 0;
+	mostOverflowBytes = 0;
+	overflowBase = NULL;
+	overflowSize = 0;
+	
+	staticBlocks.Clear();
+	staticBlockHash.Clear( 4096, 4096 );
+	numSharedStaticBlocks = 0;
+	sharedStaticVertexBytes = 0;
+	sharedStaticIndexBytes = 0;
+	
+	const int vertexBytes = r_vertexCacheVertexMemory.GetInteger() * 1024 * 1024;
+	const int indexBytes = r_vertexCacheIndexMemory.GetInteger() * 1024 * 1024;
+	const int jointBytes = r_vertexCacheJointMemory.GetInteger() * 1024;
+	for( int i = 0; i < numFrames; i++ )
 	{
-		AllocGeoBufferSet( frameData[i], VERTCACHE_VERTEX_MEMORY_PER_FRAME, VERTCACHE_INDEX_MEMORY_PER_FRAME, VERTCACHE_JOINT_MEMORY_PER_FRAME );
+		AllocGeoBufferSet( frameData[i], vertexBytes, indexBytes, jointBytes );
 	}
 	AllocGeoBufferSet( staticData, STATIC_VERTEX_MEMORY, STATIC_INDEX_MEMORY, 0 );
 	
@@ -141,12 +164,16 @@ idVertexCache::Shutdown
 */
 void idVertexCache::Shutdown()
 {
-	for( int i = 0; i < VERTCACHE_NUM_FRAMES; i++ )
+	for( int i = 0; i < numFrames; i++ )
 	{
 		frameData[i].vertexBuffer.FreeBufferObject();
 		frameData[i].indexBuffer.FreeBufferObject();
 		frameData[i].jointBuffer.FreeBufferObject();
 	}
+	
+	Mem_Free16( overflowBase );
+	overflowBase = NULL;
+	overflowSize = 0;
 }
 
 /*
@@ -173,6 +200,117 @@ void idVertexCache::FreeStaticData()
 	mostUsedVertex = 0;
 	mostUsedIndex = 0;
 	mostUsedJoint = 0;
+	overflowFrames = 0;
+	mostOverflowBytes = 0;
+	
+	staticBlocks.Clear();
+	staticBlockHash.Clear();
+	numSharedStaticBlocks = 0;
+	sharedStaticVertexBytes = 0;
+	sharedStaticIndexBytes = 0;
+}
+
+/*
+==============
+idVertexCache::AllocOverflow
+
+Allocates the scratch memory handed out for allocations that don't fit in this
+frame's buffers. It is allocated the first time anything overflows and sized so
+it never has to move while other threads may be writing to it.
+==============
+*/
+byte* idVertexCache::AllocOverflow( int bytes )
+{
+	idScopedCriticalSection lock( overflowMutex );
+	
+	if( overflowBase == NULL )
+	{
+		overflowSize = Max( frameData[0].vertexBuffer.GetAllocedSize(), frameData[0].indexBuffer.GetAllocedSize() );
+		overflowBase = ( byte* )Mem_Alloc16( overflowSize, TAG_RENDER );
+	}
+	if( bytes > overflowSize )
+	{
+		idLib::Error( "Vertex cache allocation of %d bytes is larger than the per-frame buffers", bytes );
+	}
+	return overflowBase;
+}
+
+/*
+==============
+idVertexCache::AllocStatic
+
+Static data is hashed so identical surfaces, like the same model placed many times
+in a map, share a single allocation. The MD5 of the contents is used as the identity
+because the static buffers can't be read back to compare them.
+==============
+*/
+vertCacheHandle_t idVertexCache::AllocStatic( const void* data, int bytes, cacheType_t type )
+{
+	byte digest[16];
+	const bool share = ( data != NULL ) && ( bytes != 0 ) && r_shareStaticVertexCache.GetBool();
+	if( share )
+	{
+		MD5_CTX ctx;
+		MD5_Init( &ctx );
+		MD5_Update( &ctx, ( const unsigned char* )data, bytes );
+		MD5_Final( &ctx, digest );
+	}
+	
+	idScopedCriticalSection lock( staticBlockMutex );
+	
+	int hash = 0;
+	if( share )
+	{
+		int key;
+		memcpy( &key, digest, sizeof( key ) );
+		hash = staticBlockHash.GenerateKey( key );
+		for( int i = staticBlockHash.First( hash ); i != -1; i = staticBlockHash.Next( i ) )
+		{
+			const staticBlock_t& block = staticBlocks[i];
+			if( block.type == type && block.bytes == bytes && memcmp( block.digest, digest, sizeof( digest ) ) == 0 )
+			{
+				numSharedStaticBlocks++;
+				if( type == CACHE_VERTEX )
+				{
+					sharedStaticVertexBytes += bytes;
+				}
+				else
+				{
+					sharedStaticIndexBytes += bytes;
+				}
+				return block.handle;
+			}
+		}
+	}
+	
+	if( type == CACHE_VERTEX )
+	{
+		if( staticData.vertexMemUsed.GetValue() + bytes > STATIC_VERTEX_MEMORY )
+		{
+			idLib::FatalError( "AllocStaticVertex failed, increase STATIC_VERTEX_MEMORY" );
+		}
+	}
+	else
+	{
+		if( staticData.indexMemUsed.GetValue() + bytes > STATIC_INDEX_MEMORY )
+		{
+			idLib::FatalError( "AllocStaticIndex failed, increase STATIC_INDEX_MEMORY" );
+		}
+	}
+	
+	const vertCacheHandle_t handle = ActuallyAlloc( staticData, data, bytes, type );
+	
+	if( share )
+	{
+		staticBlock_t& block = staticBlocks.Alloc();
+		memcpy( block.digest, digest, sizeof( block.digest ) );
+		block.bytes = bytes;
+		block.type = type;
+		block.handle = handle;
+		staticBlockHash.Add( hash, staticBlocks.Num() - 1 );
+	}
+	
+	return handle;
 }
 
 /*
@@ -202,7 +340,11 @@ vertCacheHandle_t idVertexCache::ActuallyAlloc( geoBufferSet_t& vcs, const void*
 		endPos = vcs.indexMemUsed.Add( bytes );
 		if( endPos > vcs.indexBuffer.GetAllocedSize() )
 		{
-			idLib::Error( "Out of index cache" );
+			if( &vcs == &staticData )
+			{
+				idLib::Error( "Out of index cache" );
+			}
+			endPos = -1;
 		}
 	}
 	else if( type == CACHE_VERTEX )
@@ -211,7 +353,11 @@ vertCacheHandle_t idVertexCache::ActuallyAlloc( geoBufferSet_t& vcs, const void*
 		endPos = vcs.vertexMemUsed.Add( bytes );
 		if( endPos > vcs.vertexBuffer.GetAllocedSize() )
 		{
-			idLib::Error( "Out of vertex cache" );
+			if( &vcs == &staticData )
+			{
+				idLib::Error( "Out of vertex cache" );
+			}
+			endPos = -1;
 		}
 	}
 	else if( type == CACHE_JOINT )
@@ -220,7 +366,11 @@ vertCacheHandle_t idVertexCache::ActuallyAlloc( geoBufferSet_t& vcs, const void*
 		endPos = vcs.jointMemUsed.Add( bytes );
 		if( endPos > vcs.jointBuffer.GetAllocedSize() )
 		{
-			idLib::Error( "Out of joint buffer cache" );
+			if( &vcs == &staticData )
+			{
+				idLib::Error( "Out of joint buffer cache" );
+			}
+			endPos = -1;
 		}
 	}
 	else
@@ -228,7 +378,24 @@ vertCacheHandle_t idVertexCache::ActuallyAlloc( geoBufferSet_t& vcs, const void*
 		assert( false );
 	}
 	
-	vcs.allocations++;
+	vcs.allocations.Increment();
+	
+	assert( ( bytes >> VERTCACHE_SIZE_UNIT_SHIFT ) <= VERTCACHE_SIZE_MASK );
+	const uint64 sizeBits = ( uint64 )( ( bytes >> VERTCACHE_SIZE_UNIT_SHIFT ) & VERTCACHE_SIZE_MASK ) << VERTCACHE_SIZE_SHIFT;
+	
+	if( endPos < 0 )
+	{
+		// it doesn't fit in this frame's buffers, the handle is tagged with the previous frame so it
+		// is never current and the memory for callers that write the data themselves is never drawn
+		vcs.overflowAllocations.Increment();
+		vcs.overflowBytes.Add( bytes );
+		if( data == NULL )
+		{
+			AllocOverflow( bytes );
+		}
+		return	( ( uint64 )( ( currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) << VERTCACHE_FRAME_SHIFT ) |
+				( ( uint64 )VERTCACHE_OVERFLOW_OFFSET << VERTCACHE_OFFSET_SHIFT ) | sizeBits;
+	}
 	
 	int offset = endPos - bytes;
 	
@@ -240,8 +407,7 @@ vertCacheHandle_t idVertexCache::ActuallyAlloc( geoBufferSet_t& vcs, const void*
 	}
 	
 	vertCacheHandle_t handle =	( ( uint64 )( currentFrame & VERTCACHE_FRAME_MASK ) << VERTCACHE_FRAME_SHIFT ) |
-								( ( uint64 )( offset & VERTCACHE_OFFSET_MASK ) << VERTCACHE_OFFSET_SHIFT ) |
-								( ( uint64 )( bytes & VERTCACHE_SIZE_MASK ) << VERTCACHE_SIZE_SHIFT );
+								( ( uint64 )( offset & VERTCACHE_OFFSET_MASK ) << VERTCACHE_OFFSET_SHIFT ) | sizeBits;
 	if( &vcs == &staticData )
 	{
 		handle |= VERTCACHE_STATIC;
@@ -257,7 +423,7 @@ idVertexCache::GetVertexBuffer
 bool idVertexCache::GetVertexBuffer( vertCacheHandle_t handle, idVertexBuffer* vb )
 {
 	const int isStatic = handle & VERTCACHE_STATIC;
-	const uint64 size = ( int )( handle >> VERTCACHE_SIZE_SHIFT ) & VERTCACHE_SIZE_MASK;
+	const uint64 size = ( uint64 )( ( int )( handle >> VERTCACHE_SIZE_SHIFT ) & VERTCACHE_SIZE_MASK ) << VERTCACHE_SIZE_UNIT_SHIFT;
 	const uint64 offset = ( int )( handle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
 	const uint64 frameNum = ( int )( handle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 	if( isStatic )
@@ -281,7 +447,7 @@ idVertexCache::GetIndexBuffer
 bool idVertexCache::GetIndexBuffer( vertCacheHandle_t handle, idIndexBuffer* ib )
 {
 	const int isStatic = handle & VERTCACHE_STATIC;
-	const uint64 size = ( int )( handle >> VERTCACHE_SIZE_SHIFT ) & VERTCACHE_SIZE_MASK;
+	const uint64 size = ( uint64 )( ( int )( handle >> VERTCACHE_SIZE_SHIFT ) & VERTCACHE_SIZE_MASK ) << VERTCACHE_SIZE_UNIT_SHIFT;
 	const uint64 offset = ( int )( handle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
 	const uint64 frameNum = ( int )( handle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 	if( isStatic )
@@ -305,7 +471,7 @@ idVertexCache::GetJointBuffer
 bool idVertexCache::GetJointBuffer( vertCacheHandle_t handle, idJointBuffer* jb )
 {
 	const int isStatic = handle & VERTCACHE_STATIC;
-	const uint64 numBytes = ( int )( handle >> VERTCACHE_SIZE_SHIFT ) & VERTCACHE_SIZE_MASK;
+	const uint64 numBytes = ( uint64 )( ( int )( handle >> VERTCACHE_SIZE_SHIFT ) & VERTCACHE_SIZE_MASK ) << VERTCACHE_SIZE_UNIT_SHIFT;
 	const uint64 jointOffset = ( int )( handle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
 	const uint64 frameNum = ( int )( handle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 	const uint64 numJoints = numBytes / sizeof( idJointMat );
@@ -333,13 +499,41 @@ void idVertexCache::BeginBackEnd()
 	mostUsedIndex = Max( mostUsedIndex, frameData[listNum].indexMemUsed.GetValue() );
 	mostUsedJoint = Max( mostUsedJoint, frameData[listNum].jointMemUsed.GetValue() );
 	
+	// the used values keep counting past the end of the buffers, so they show how much would have been needed
+	const int overflowAllocations = frameData[listNum].overflowAllocations.GetValue();
+	const int overflowBytes = frameData[listNum].overflowBytes.GetValue();
+	if( overflowAllocations > 0 )
+	{
+		if( overflowFrames == 0 || overflowBytes > mostOverflowBytes )
+		{
+			const geoBufferSet_t& gbs = frameData[listNum];
+			idStr cvars;
+			if( gbs.vertexMemUsed.GetValue() > gbs.vertexBuffer.GetAllocedSize() )
+			{
+				cvars += " r_vertexCacheVertexMemory";
+			}
+			if( gbs.indexMemUsed.GetValue() > gbs.indexBuffer.GetAllocedSize() )
+			{
+				cvars += " r_vertexCacheIndexMemory";
+			}
+			if( gbs.jointMemUsed.GetValue() > gbs.jointBuffer.GetAllocedSize() )
+			{
+				cvars += " r_vertexCacheJointMemory";
+			}
+			idLib::Warning( "vertex cache overflowed by %d allocations, %dkB, increase%s", overflowAllocations, overflowBytes / 1024, cvars.c_str() );
+		}
+		overflowFrames++;
+		mostOverflowBytes = Max( mostOverflowBytes, overflowBytes );
+	}
+	
 	if( r_showVertexCache.GetBool() )
 	{
-		idLib::Printf( "%08d: %d allocations, %dkB vertex, %dkB index, %kB joint : %dkB vertex, %dkB index, %kB joint\n",
-					   currentFrame, frameData[listNum].allocations,
+		idLib::Printf( "%08d: %d allocations, %dkB vertex, %dkB index, %dkB joint, %d overflowed %dkB : %dkB vertex, %dkB index, %dkB joint\n",
+					   currentFrame, frameData[listNum].allocations.GetValue(),
 					   frameData[listNum].vertexMemUsed.GetValue() / 1024,
 					   frameData[listNum].indexMemUsed.GetValue() / 1024,
 					   frameData[listNum].jointMemUsed.GetValue() / 1024,
+					   overflowAllocations, overflowBytes / 1024,
 					   mostUsedVertex / 1024,
 					   mostUsedIndex / 1024,
 					   mostUsedJoint / 1024 );
@@ -359,7 +553,7 @@ void idVertexCache::BeginBackEnd()
 	// prepare the next frame for writing to by the CPU
 	currentFrame++;
 	
-	listNum = currentFrame % VERTCACHE_NUM_FRAMES;
+	listNum = currentFrame % numFrames;
 	const int startMap = Sys_Milliseconds();
 	MapGeoBufferSet( frameData[listNum] );
 	const int endMap = Sys_Milliseconds();
@@ -384,3 +578,31 @@ void idVertexCache::BeginBackEnd()
 	
 }
 
+/*
+==============
+idVertexCache::PrintStats
+==============
+*/
+void idVertexCache::PrintStats() const
+{
+	idLib::Printf( "%d frames of %dkB vertex, %dkB index, %dkB joint memory\n", numFrames,
+				   frameData[0].vertexBuffer.GetAllocedSize() / 1024,
+				   frameData[0].indexBuffer.GetAllocedSize() / 1024,
+				   frameData[0].jointBuffer.GetAllocedSize() / 1024 );
+	idLib::Printf( "most used per frame: %dkB vertex, %dkB index, %dkB joint\n", mostUsedVertex / 1024, mostUsedIndex / 1024, mostUsedJoint / 1024 );
+	idLib::Printf( "%d frames overflowed, at most by %dkB\n", overflowFrames, mostOverflowBytes / 1024 );
+	idLib::Printf( "%dkB of static vertex memory, %dkB of static index memory used\n",
+				   staticData.vertexMemUsed.GetValue() / 1024, staticData.indexMemUsed.GetValue() / 1024 );
+	idLib::Printf( "%d static blocks shared, saving %dkB of static vertex memory and %dkB of static index memory\n",
+				   numSharedStaticBlocks, sharedStaticVertexBytes / 1024, sharedStaticIndexBytes / 1024 );
+}
+
+/*
+==============
+R_VertexCacheStats_f
+==============
+*/
+void R_VertexCacheStats_f( const idCmdArgs& args )
+{
+	vertexCache.PrintStats();
+}
@@ -28,11 +28,11 @@ If you have questions concerning this license or the applicable additional terms
 #ifndef __VERTEXCACHE2_H__
 #define __VERTEXCACHE2_H__
 
-const int VERTCACHE_INDEX_MEMORY_PER_FRAME = 31 * 1024 * 1024;
-const int VERTCACHE_VERTEX_MEMORY_PER_FRAME = 31 * 1024 * 1024;
-const int VERTCACHE_JOINT_MEMORY_PER_FRAME = 256 * 1024;
+// the per-frame memory is set with r_vertexCacheIndexMemory, r_vertexCacheVertexMemory and r_vertexCacheJointMemory
 
-const int VERTCACHE_NUM_FRAMES = 2;
+// the per-frame buffers are used as a ring of r_vertexCacheFrames buffers, more frames let the GPU fall
+// further behind before the CPU writes into a buffer that may still be read, the buffers are mapped unsynchronized
+const int VERTCACHE_MAX_FRAMES = 4;
 
 // there are a lot more static indexes than vertexes, because interactions are just new
 // index lists that reference existing vertexes
@@ -40,14 +40,21 @@ const int STATIC_INDEX_MEMORY = 31 * 1024 * 1024;
 const int STATIC_VERTEX_MEMORY = 31 * 1024 * 1024;	// make sure it fits in VERTCACHE_OFFSET_MASK!
 
 // vertCacheHandle_t packs size, offset, and frame number into 64 bits
+// the size is stored in 16 byte units because all allocations are multiples of 16 bytes,
+// the offset is stored in bytes so handles can point inside an allocation (see idGuiModel)
 typedef uint64 vertCacheHandle_t;
 const int VERTCACHE_STATIC = 1;					// in the static set, not the per-frame set
 const int VERTCACHE_SIZE_SHIFT = 1;
-const int VERTCACHE_SIZE_MASK = 0x7fffff;		// 8 megs
-const int VERTCACHE_OFFSET_SHIFT = 24;
-const int VERTCACHE_OFFSET_MASK = 0x1ffffff;	// 32 megs
-const int VERTCACHE_FRAME_SHIFT = 49;
-const int VERTCACHE_FRAME_MASK = 0x7fff;		// 15 bits = 32k frames to wrap around
+const int VERTCACHE_SIZE_MASK = 0xfffff;		// 20 bits of 16 bytes = 16 megs
+const int VERTCACHE_SIZE_UNIT_SHIFT = 4;
+const int VERTCACHE_OFFSET_SHIFT = 21;
+const int VERTCACHE_OFFSET_MASK = 0x1fffffff;	// 512 megs
+const int VERTCACHE_FRAME_SHIFT = 50;
+const int VERTCACHE_FRAME_MASK = 0x3fff;		// 14 bits = 16k frames to wrap around
+
+// allocations that don't fit in the per-frame buffers get this offset, their memory
+// is a scratch buffer that is never drawn
+const int VERTCACHE_OVERFLOW_OFFSET = VERTCACHE_OFFSET_MASK;
 
 const int VERTEX_CACHE_ALIGN		= 32;
 const int INDEX_CACHE_ALIGN			= 16;
@@ -71,7 +78,18 @@ struct geoBufferSet_t
 	idSysInterlockedInteger	indexMemUsed;
 	idSysInterlockedInteger	vertexMemUsed;
 	idSysInterlockedInteger	jointMemUsed;
-	int						allocations;	// number of index and vertex allocations combined
+	idSysInterlockedInteger	allocations;	// number of index and vertex allocations combined
+	idSysInterlockedInteger	overflowAllocations;	// allocations that didn't fit this frame
+	idSysInterlockedInteger	overflowBytes;
+};
+
+// a static block that identical static data can share
+struct staticBlock_t
+{
+	byte					digest[16];		// MD5 of the contents
+	int						bytes;
+	cacheType_t				type;
+	vertCacheHandle_t		handle;
 };
 
 class idVertexCache
@@ -99,26 +117,23 @@ public:
 	}
 	
 	// this data is valid until the next map load
+	// identical data shares a single allocation, so it must never be written through the handle
 	vertCacheHandle_t	AllocStaticVertex( const void* data, int bytes )
 	{
-		if( staticData.vertexMemUsed.GetValue() + bytes > STATIC_VERTEX_MEMORY )
-		{
-			idLib::FatalError( "AllocStaticVertex failed, increase STATIC_VERTEX_MEMORY" );
-		}
-		return ActuallyAlloc( staticData, data, bytes, CACHE_VERTEX );
+		return AllocStatic( data, bytes, CACHE_VERTEX );
 	}
 	vertCacheHandle_t	AllocStaticIndex( const void* data, int bytes )
 	{
-		if( staticData.indexMemUsed.GetValue() + bytes > STATIC_INDEX_MEMORY )
-		{
-			idLib::FatalError( "AllocStaticIndex failed, increase STATIC_INDEX_MEMORY" );
-		}
-		return ActuallyAlloc( staticData, data, bytes, CACHE_INDEX );
+		return AllocStatic( data, bytes, CACHE_INDEX );
 	}
 	
 	byte* 			MappedVertexBuffer( vertCacheHandle_t handle )
 	{
 		release_assert( !CacheIsStatic( handle ) );
+		if( CacheIsOverflow( handle ) )
+		{
+			return overflowBase;
+		}
 		const uint64 offset = ( int )( handle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
 		const uint64 frameNum = ( int )( handle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 		release_assert( frameNum == ( currentFrame & VERTCACHE_FRAME_MASK ) );
@@ -128,6 +143,10 @@ public:
 	byte* 			MappedIndexBuffer( vertCacheHandle_t handle )
 	{
 		release_assert( !CacheIsStatic( handle ) );
+		if( CacheIsOverflow( handle ) )
+		{
+			return overflowBase;
+		}
 		const uint64 offset = ( int )( handle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK;
 		const uint64 frameNum = ( int )( handle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 		release_assert( frameNum == ( currentFrame & VERTCACHE_FRAME_MASK ) );
@@ -157,6 +176,13 @@ public:
 		return ( handle & VERTCACHE_STATIC ) != 0;
 	}
 	
+	// overflowed handles are never current, so the front end will try to allocate again and
+	// the back end will skip them
+	static bool		CacheIsOverflow( const vertCacheHandle_t handle )
+	{
+		return ( ( ( int )( handle >> VERTCACHE_OFFSET_SHIFT ) & VERTCACHE_OFFSET_MASK ) == VERTCACHE_OVERFLOW_OFFSET ) && !CacheIsStatic( handle );
+	}
+	
 	// vb/ib is a temporary reference -- don't store it
 	bool			GetVertexBuffer( vertCacheHandle_t handle, idVertexBuffer* vb );
 	bool			GetIndexBuffer( vertCacheHandle_t handle, idIndexBuffer* ib );
@@ -164,19 +190,43 @@ public:
 	
 	void			BeginBackEnd();
 	
+	void			PrintStats() const;
+	
 public:
 	int				currentFrame;	// for determining the active buffers
-	int				listNum;		// currentFrame % VERTCACHE_NUM_FRAMES
-	int				drawListNum;	// (currentFrame-1) % VERTCACHE_NUM_FRAMES
+	int				numFrames;		// number of per-frame buffers in the ring
+	int				listNum;		// currentFrame % numFrames
+	int				drawListNum;	// (currentFrame-1) % numFrames
 	
 	geoBufferSet_t	staticData;
-	geoBufferSet_t	frameData[VERTCACHE_NUM_FRAMES];
+	geoBufferSet_t	frameData[VERTCACHE_MAX_FRAMES];
 	
 	// High water marks for the per-frame buffers
 	int				mostUsedVertex;
 	int				mostUsedIndex;
 	int				mostUsedJoint;
 	
+	// static blocks for sharing identical static data, cleared on map load
+	idList<staticBlock_t, TAG_RENDER>	staticBlocks;
+	idHashIndex		staticBlockHash;
+	idSysMutex		staticBlockMutex;
+	int				numSharedStaticBlocks;
+	int				sharedStaticVertexBytes;	// static memory saved by sharing since the last map load
+	int				sharedStaticIndexBytes;
+	
+	// overflow statistics since the last map load
+	int				overflowFrames;			// frames with at least one allocation that didn't fit
+	int				mostOverflowBytes;		// most bytes that didn't fit in a single frame
+	
+	// memory returned for allocations that don't fit, big enough for any single allocation
+	byte* 			overflowBase;
+	int				overflowSize;
+	idSysMutex		overflowMutex;
+	
+	byte* 			AllocOverflow( int bytes );
+	
+	vertCacheHandle_t	AllocStatic( const void* data, int bytes, cacheType_t type );
+	
 	// Try to make room for <bytes> bytes
 	vertCacheHandle_t	ActuallyAlloc( geoBufferSet_t& vcs, const void* data, int bytes, cacheType_t type );
 };
@@ -187,4 +237,6 @@ void CopyBuffer( byte* dst, const byte* src, int numBytes );
 
 extern	idVertexCache	vertexCache;
 
+void R_VertexCacheStats_f( const idCmdArgs& args );
+
 #endif // __VERTEXCACHE2_H__
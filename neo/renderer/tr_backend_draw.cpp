@@ -147,7 +147,11 @@ void RB_DrawElementsWithCounters( const drawSurf_t* surf )
 		const uint64 frameNum = ( int )( vbHandle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 		if( frameNum != ( ( vertexCache.currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) )
 		{
-			idLib::Warning( "RB_DrawElementsWithCounters, vertexBuffer == NULL" );
+			// allocations that overflowed the vertex cache are skipped silently
+			if( !vertexCache.CacheIsOverflow( vbHandle ) )
+			{
+				idLib::Warning( "RB_DrawElementsWithCounters, vertexBuffer == NULL" );
+			}
 			return;
 		}
 		vertexBuffer = &vertexCache.frameData[vertexCache.drawListNum].vertexBuffer;
@@ -166,7 +170,10 @@ void RB_DrawElementsWithCounters( const drawSurf_t* surf )
 		const uint64 frameNum = ( int )( ibHandle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 		if( frameNum != ( ( vertexCache.currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) )
 		{
-			idLib::Warning( "RB_DrawElementsWithCounters, indexBuffer == NULL" );
+			if( !vertexCache.CacheIsOverflow( ibHandle ) )
+			{
+				idLib::Warning( "RB_DrawElementsWithCounters, indexBuffer == NULL" );
+			}
 			return;
 		}
 		indexBuffer = &vertexCache.frameData[vertexCache.drawListNum].indexBuffer;
@@ -206,7 +213,10 @@ void RB_DrawElementsWithCounters( const drawSurf_t* surf )
 		idJointBuffer jointBuffer;
 		if( !vertexCache.GetJointBuffer( surf->jointCache, &jointBuffer ) )
 		{
-			idLib::Warning( "RB_DrawElementsWithCounters, jointBuffer == NULL" );
+			if( !vertexCache.CacheIsOverflow( surf->jointCache ) )
+			{
+				idLib::Warning( "RB_DrawElementsWithCounters, jointBuffer == NULL" );
+			}
 			return;
 		}
 		assert( ( jointBuffer.GetOffset() & ( glConfig.uniformBufferOffsetAlignment - 1 ) ) == 0 );
@@ -1701,7 +1711,10 @@ static void RB_StencilShadowPass( const drawSurf_t* drawSurfs, const viewLight_t
 			const uint64 frameNum = ( int )( vbHandle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 			if( frameNum != ( ( vertexCache.currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) )
 			{
-				idLib::Warning( "RB_DrawElementsWithCounters, vertexBuffer == NULL" );
+				if( !vertexCache.CacheIsOverflow( vbHandle ) )
+				{
+					idLib::Warning( "RB_DrawElementsWithCounters, vertexBuffer == NULL" );
+				}
 				continue;
 			}
 			vertexBuffer = &vertexCache.frameData[vertexCache.drawListNum].vertexBuffer;
@@ -1720,7 +1733,10 @@ static void RB_StencilShadowPass( const drawSurf_t* drawSurfs, const viewLight_t
 			const uint64 frameNum = ( int )( ibHandle >> VERTCACHE_FRAME_SHIFT ) & VERTCACHE_FRAME_MASK;
 			if( frameNum != ( ( vertexCache.currentFrame - 1 ) & VERTCACHE_FRAME_MASK ) )
 			{
-				idLib::Warning( "RB_DrawElementsWithCounters, indexBuffer == NULL" );
+				if( !vertexCache.CacheIsOverflow( ibHandle ) )
+				{
+					idLib::Warning( "RB_DrawElementsWithCounters, indexBuffer == NULL" );
+				}
 				continue;
 			}
 			indexBuffer = &vertexCache.frameData[vertexCache.drawListNum].indexBuffer;
@@ -1743,7 +1759,10 @@ static void RB_StencilShadowPass( const drawSurf_t* drawSurfs, const viewLight_t
 			idJointBuffer jointBuffer;
 			if( !vertexCache.GetJointBuffer( drawSurf->jointCache, &jointBuffer ) )
 			{
-				idLib::Warning( "RB_DrawElementsWithCounters, jointBuffer == NULL" );
+				if( !vertexCache.CacheIsOverflow( drawSurf->jointCache ) )
+				{
+					idLib::Warning( "RB_DrawElementsWithCounters, jointBuffer == NULL" );
+				}
 				continue;
 			}
 			assert( ( jointBuffer.GetOffset() & ( glConfig.uniformBufferOffsetAlignment - 1 ) ) == 0 );
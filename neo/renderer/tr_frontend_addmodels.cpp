@@ -496,6 +496,10 @@ void R_AddSingleModel( viewEntity_t* vEntity )
 	// create a dynamic model if the geometry isn't static
 	//---------------------------
 	idRenderModel* model = R_EntityDefDynamicModel( entityDef );
+	
+	// the game lowers the animation rate of models that weren't drawn for a while,
+	// set after the callback so it can tell whether the model was drawn in the last frame
+	entityDef->lastVisibleFrame = tr.frameCount;
 	if( model == NULL || model->NumSurfaces() <= 0 )
 	{
 		return;
@@ -1228,6 +1232,10 @@ void R_AddModels()
 		for( drawSurf_t* ds = vEntity->drawSurfs; ds != NULL; )
 		{
 			drawSurf_t* next = ds->nextOnLight;
+			
+			// streamed images get the levels the surface needs on screen
+			globalImages->RecordStreamingUsage( ds->material, ds->scissorRect );
+			
 			if( ds->linkChain == NULL )
 			{
 				R_LinkDrawSurfToView( ds, tr.viewDef );
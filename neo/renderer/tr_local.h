@@ -265,6 +265,7 @@ public:
 	int						viewCount;				// if tr.viewCount == viewCount, viewEntity is valid,
 	// but the entity may still be off screen
 	viewEntity_t* 			viewEntity;				// in frame temporary memory
+	int						lastVisibleFrame;		// tr.frameCount when the model or its shadows were last drawn
 	
 	idRenderModelDecal* 	decals;					// decals that have been projected on this model
 	idRenderModelOverlay* 	overlays;				// blood overlays on animated models
@@ -851,6 +852,7 @@ public:
 	drawSurf_t				testImageSurface_;
 	
 	idParallelJobList* 		frontEndJobList;
+	idParallelJobList* 		skinningJobList;	// skins the meshes of a CPU skinned model
 	
 	unsigned				timerQueryId;		// for GL_TIME_ELAPSED_EXT queries
 };